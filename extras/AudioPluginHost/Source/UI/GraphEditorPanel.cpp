@@ -181,6 +181,7 @@ struct GraphEditorPanel::PinComponent final : public Component,
 //==============================================================================
 struct GraphEditorPanel::PluginComponent final : public Component,
                                                  public Timer,
+                                                 public TooltipClient,
                                                  private AudioProcessorParameter::Listener,
                                                  private AsyncUpdater
 {
@@ -433,6 +434,11 @@ struct GraphEditorPanel::PluginComponent final : public Component,
         menu->addItem ("Show all programs", [this] { showWindow (PluginWindow::Type::programs); });
         menu->addItem ("Show all parameters", [this] { showWindow (PluginWindow::Type::generic); });
         menu->addItem ("Show debug log", [this] { showWindow (PluginWindow::Type::debug); });
+        menu->addItem ("Profile graph", true, graph.graph.isProfilingEnabled(), [this]
+        {
+            graph.graph.setProfilingEnabled (! graph.graph.isProfilingEnabled());
+            graph.graph.resetProfile();
+        });
 
        #if JUCE_PLUGINHOST_ARA && (JUCE_MAC || JUCE_WINDOWS || JUCE_LINUX)
         if (auto* instance = dynamic_cast<AudioPluginInstance*> (getProcessor()))
@@ -482,6 +488,27 @@ struct GraphEditorPanel::PluginComponent final : public Component,
         showPopupMenu();
     }
 
+    String getTooltip() override
+    {
+        if (! graph.graph.isProfilingEnabled())
+            return {};
+
+        for (const auto& node : graph.graph.getProfile().nodes)
+        {
+            if (node.nodeID != pluginID)
+                continue;
+
+            const auto& t = node.processTime;
+
+            String tip;
+            tip << getName() << ": median " << String (t.p50Ms, 3) << " ms, 99% " << String (t.p99Ms, 3)
+                << " ms, max " << String (t.maxMs, 3) << " ms, caused " << node.numOverruns << " overruns";
+            return tip;
+        }
+
+        return {};
+    }
+
     void parameterValueChanged (int, float) override
     {
         // Parameter changes might come from the audio thread or elsewhere, but
@@ -97,9 +97,16 @@ int main (int argc, char **argv)
     }();
 
     if (args.containsOption ("--category"))
+    {
         runner.runTestsInCategory (args.getValueForOption ("--category"), seed);
+    }
     else
-        runner.runAllTests (seed);
+    {
+        // The benchmarks take a while, so they only run when their category is requested
+        auto tests = UnitTest::getAllTests();
+        tests.removeIf ([] (UnitTest* test) { return test->getCategory() == UnitTestCategories::benchmarks; });
+        runner.runTests (tests, seed);
+    }
 
     std::vector<String> failures;
 
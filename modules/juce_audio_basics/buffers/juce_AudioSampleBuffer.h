@@ -127,6 +127,63 @@ public:
         allocateChannels (dataToReferTo, startSample);
     }
 
+    /** Creates a buffer whose sample data is allocated from a MonotonicArena.
+
+        This won't call malloc unless there are 32 or more channels (the buffer's own list
+        of channel pointers has room for 31 of them, plus a terminating null), so it can be
+        used to make temporary buffers on the audio thread. The buffer refers to the arena's
+        memory in the same way as a buffer created with setDataToReferTo(), so it mustn't be
+        used after the arena has been reset.
+
+        The contents of the buffer will initially be undefined. If the arena doesn't have
+        enough space left, this creates an empty buffer - getArenaSizeNeeded() tells you
+        how much space it needs.
+
+        @see getArenaSizeNeeded
+    */
+    AudioBuffer (MonotonicArena& arena,
+                 int numChannelsToAllocate,
+                 int numSamplesToAllocate)
+       : channels (static_cast<Type**> (preallocatedChannelSpace))
+    {
+        jassert (numChannelsToAllocate >= 0 && numSamplesToAllocate >= 0);
+
+        // The channel pointers go straight into the buffer's own list, so only the
+        // sample data comes from the arena
+        if (numChannelsToAllocate >= (int) numElementsInArray (preallocatedChannelSpace))
+        {
+            allocatedData.malloc (numChannelsToAllocate + 1, sizeof (Type*));
+            channels = unalignedPointerCast<Type**> (allocatedData.get());
+        }
+
+        const MonotonicArena::Marker start = arena.getMarker();
+
+        for (int i = 0; i < numChannelsToAllocate; ++i)
+        {
+            channels[i] = static_cast<Type*> (arena.allocate ((size_t) numSamplesToAllocate * sizeof (Type), maxAlignment));
+
+            if (channels[i] == nullptr)
+            {
+                arena.rewindTo (start);
+                channels = static_cast<Type**> (preallocatedChannelSpace);
+                channels[0] = nullptr;
+                return;
+            }
+        }
+
+        numChannels = numChannelsToAllocate;
+        size = numSamplesToAllocate;
+        channels[numChannels] = nullptr;
+    }
+
+    /** Returns the number of bytes of a MonotonicArena that the constructor which
+        takes an arena will use for a buffer of the given size.
+    */
+    static constexpr size_t getArenaSizeNeeded (int numChannelsToAllocate, int numSamplesToAllocate) noexcept
+    {
+        return MonotonicArena::getSizeNeededFor<Type> ((size_t) numSamplesToAllocate, (size_t) numChannelsToAllocate, maxAlignment);
+    }
+
     /** Copies another buffer.
 
         This buffer will make its own copy of the other's data, unless the buffer was created
@@ -0,0 +1,2084 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static constexpr const char* outOfProcessPluginCommandLineID = "jucePluginWorker";
+
+enum
+{
+    outOfProcessConnectionBufferSize = 1 << 20,
+    outOfProcessLoadTimeoutMs        = 30000,
+    outOfProcessRequestTimeoutMs     = 10000,
+    outOfProcessHungWorkerTimeoutMs  = 5000
+};
+
+/*  Every control message starts with one of these, followed by a request ID, which is
+    non-zero for messages that expect a reply.
+*/
+enum class OutOfProcessMessageType : int
+{
+    load,
+    prepare,
+    release,
+    reset,
+    setNonRealtime,
+    setParameters,
+    setProgram,
+    getState,
+    setState,
+    getParameterText,
+    getParameterValueForText,
+    scanFile,
+
+    reply,
+    parametersChanged,
+    parameterText,
+    latencyChanged,
+    programChanged
+};
+
+template <typename WritePayload>
+static MemoryBlock createOutOfProcessMessage (OutOfProcessMessageType type, int requestID, WritePayload&& writePayload)
+{
+    MemoryOutputStream out;
+    out.writeInt ((int) type);
+    out.writeInt (requestID);
+    writePayload (out);
+    return out.getMemoryBlock();
+}
+
+static void writeNothing (MemoryOutputStream&) {}
+
+static int64 getProcessCpuNanoseconds() noexcept
+{
+   #if JUCE_LINUX
+    timespec t{};
+
+    if (clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &t) == 0)
+        return (int64) t.tv_sec * 1000000000 + (int64) t.tv_nsec;
+   #endif
+
+    return 0;
+}
+
+//==============================================================================
+/*  A shared memory region holding one block of audio, MIDI, parameter changes and
+    transport info. The host writes a block and increments requestCount; the worker
+    processes it in place and sets responseCount to match. Each side sleeps on the
+    other's counter with a futex.
+*/
+class OutOfProcessPluginInstance::SharedAudioBlock
+{
+public:
+    static constexpr int maxMidiBytes = 1 << 16;
+
+    enum TransportFlags : uint32
+    {
+        hasPosition                  = 1 << 0,
+        isPlaying                    = 1 << 1,
+        isRecording                  = 1 << 2,
+        isLooping                    = 1 << 3,
+        hasTimeInSamples             = 1 << 4,
+        hasTimeInSeconds             = 1 << 5,
+        hasBpm                       = 1 << 6,
+        hasPpqPosition               = 1 << 7,
+        hasPpqPositionOfLastBarStart = 1 << 8,
+        hasTimeSignature             = 1 << 9
+    };
+
+    struct ParameterChange
+    {
+        int32 index;
+        float value;
+    };
+
+    struct Header
+    {
+        uint32 magic = magicNumber;
+        int32 numChannels = 0, maxBlockSize = 0, numParameters = 0;
+
+        std::atomic<uint32> requestCount { 0 }, responseCount { 0 };
+
+        int32 numSamples = 0, numMidiInputBytes = 0, numMidiOutputBytes = 0, numParameterChanges = 0;
+
+        uint32 transportFlags = 0;
+        int32 timeSigNumerator = 4, timeSigDenominator = 4;
+        int64 timeInSamples = 0;
+        double timeInSeconds = 0, bpm = 0, ppqPosition = 0, ppqPositionOfLastBarStart = 0;
+
+        int64 processingNanoseconds = 0, workerCpuNanoseconds = 0;
+    };
+
+    static_assert (std::atomic<uint32>::is_always_lock_free && sizeof (std::atomic<uint32>) == sizeof (uint32),
+                   "The counters must be plain 32-bit words to be used as futexes");
+
+    ~SharedAudioBlock()
+    {
+       #if JUCE_LINUX
+        if (data != nullptr)
+            munmap (data, layout.totalSize);
+
+        if (isOwner)
+            shm_unlink (name.toRawUTF8());
+       #endif
+    }
+
+    static std::unique_ptr<SharedAudioBlock> create (int numChannels, int maxBlockSize, int numParameters)
+    {
+       #if JUCE_LINUX
+        const auto newLayout = Layout (numChannels, maxBlockSize, numParameters);
+
+        for (int attempts = 8; --attempts >= 0;)
+        {
+            const auto newName = "/juce_plugin_" + String::toHexString (Random::getSystemRandom().nextInt64());
+            const auto fd = shm_open (newName.toRawUTF8(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+            if (fd < 0)
+            {
+                if (errno == EEXIST)
+                    continue;
+
+                return {};
+            }
+
+            std::unique_ptr<SharedAudioBlock> block (new SharedAudioBlock (newName, newLayout, true));
+
+            if (ftruncate (fd, (off_t) newLayout.totalSize) == 0)
+                block->map (fd);
+
+            ::close (fd);
+
+            if (block->data == nullptr)
+                return {};
+
+            auto* header = new (block->data) Header();
+            header->numChannels = numChannels;
+            header->maxBlockSize = maxBlockSize;
+            header->numParameters = numParameters;
+
+            for (int i = 0; i < numChannels; ++i)
+                block->channels.push_back (block->getChannel (i));
+
+            return block;
+        }
+       #else
+        ignoreUnused (numChannels, maxBlockSize, numParameters);
+       #endif
+
+        return {};
+    }
+
+    /*  Maps a region that was created by the other process. This removes its name, so
+        that nothing is left behind if either process dies.
+    */
+    static std::unique_ptr<SharedAudioBlock> open (const String& nameToOpen)
+    {
+       #if JUCE_LINUX
+        const auto fd = shm_open (nameToOpen.toRawUTF8(), O_RDWR, 0);
+
+        if (fd < 0)
+            return {};
+
+        shm_unlink (nameToOpen.toRawUTF8());
+
+        struct stat info;
+        std::unique_ptr<SharedAudioBlock> block;
+
+        if (fstat (fd, &info) == 0 && (size_t) info.st_size >= sizeof (Header))
+        {
+            block.reset (new SharedAudioBlock (nameToOpen, {}, false));
+            block->layout.totalSize = (size_t) info.st_size;
+            block->map (fd);
+        }
+
+        ::close (fd);
+
+        if (block == nullptr || block->data == nullptr)
+            return {};
+
+        const auto& header = block->getHeader();
+
+        if (header.magic != magicNumber || header.numChannels < 0 || header.maxBlockSize <= 0 || header.numParameters < 0)
+            return {};
+
+        const auto expectedLayout = Layout (header.numChannels, header.maxBlockSize, header.numParameters);
+
+        if (expectedLayout.totalSize != block->layout.totalSize)
+            return {};
+
+        block->layout = expectedLayout;
+
+        for (int i = 0; i < header.numChannels; ++i)
+            block->channels.push_back (block->getChannel (i));
+
+        return block;
+       #else
+        ignoreUnused (nameToOpen);
+        return {};
+       #endif
+    }
+
+    const String& getName() const noexcept                  { return name; }
+    Header& getHeader() const noexcept                      { return *static_cast<Header*> (data); }
+    ParameterChange* getParameterChanges() const noexcept   { return addBytesToPointer (static_cast<ParameterChange*> (data), layout.parameterChanges); }
+    float* getChannel (int index) const noexcept            { return addBytesToPointer (static_cast<float*> (data), layout.channels + (size_t) index * layout.channelSize); }
+    float* const* getChannels() const noexcept              { return channels.data(); }
+    uint8* getMidiInput() const noexcept                    { return addBytesToPointer (static_cast<uint8*> (data), layout.midiInput); }
+    uint8* getMidiOutput() const noexcept                   { return addBytesToPointer (static_cast<uint8*> (data), layout.midiOutput); }
+
+    //==============================================================================
+    static void wait (std::atomic<uint32>& counter, uint32 currentValue, int64 timeoutNanoseconds) noexcept
+    {
+       #if JUCE_LINUX
+        timespec timeout { (time_t) (timeoutNanoseconds / 1000000000), (long) (timeoutNanoseconds % 1000000000) };
+        syscall (SYS_futex, reinterpret_cast<uint32*> (&counter), FUTEX_WAIT, currentValue, &timeout, nullptr, 0);
+       #else
+        ignoreUnused (counter, currentValue, timeoutNanoseconds);
+       #endif
+    }
+
+    static void wake (std::atomic<uint32>& counter) noexcept
+    {
+       #if JUCE_LINUX
+        syscall (SYS_futex, reinterpret_cast<uint32*> (&counter), FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+       #else
+        ignoreUnused (counter);
+       #endif
+    }
+
+    //==============================================================================
+    /*  Events are stored as a sample position and size, followed by the data padded to
+        a multiple of 4 bytes. Returns the number of bytes written.
+    */
+    static int writeMidi (const MidiBuffer& source, int startSample, int numSamples, uint8* dest) noexcept
+    {
+        int numBytes = 0;
+
+        for (auto it = source.findNextSamplePosition (startSample), end = source.findNextSamplePosition (startSample + numSamples); it != end; ++it)
+        {
+            const auto metadata = *it;
+            const auto eventSize = (int) (2 * sizeof (int32)) + ((metadata.numBytes + 3) & ~3);
+
+            if (numBytes + eventSize > maxMidiBytes)
+            {
+                jassertfalse; // too many MIDI events in one block!
+                break;
+            }
+
+            writeUnaligned<int32> (dest + numBytes, metadata.samplePosition - startSample);
+            writeUnaligned<int32> (dest + numBytes + sizeof (int32), metadata.numBytes);
+            memcpy (dest + numBytes + 2 * sizeof (int32), metadata.data, (size_t) metadata.numBytes);
+            numBytes += eventSize;
+        }
+
+        return numBytes;
+    }
+
+    static void readMidi (const uint8* source, int numBytes, MidiBuffer& dest, int sampleOffset)
+    {
+        numBytes = jlimit (0, maxMidiBytes, numBytes);
+
+        for (int pos = 0; pos + (int) (2 * sizeof (int32)) <= numBytes;)
+        {
+            const auto samplePosition = readUnaligned<int32> (source + pos);
+            const auto size = readUnaligned<int32> (source + pos + sizeof (int32));
+            pos += (int) (2 * sizeof (int32));
+
+            if (size <= 0 || pos + size > numBytes)
+                break;
+
+            dest.addEvent (source + pos, size, samplePosition + sampleOffset);
+            pos += (size + 3) & ~3;
+        }
+    }
+
+    static void writeTransport (Header& header, AudioPlayHead* playHead)
+    {
+        header.transportFlags = 0;
+
+        if (playHead == nullptr)
+            return;
+
+        const auto position = playHead->getPosition();
+
+        if (! position.hasValue())
+            return;
+
+        uint32 flags = hasPosition;
+
+        if (position->getIsPlaying())    flags |= isPlaying;
+        if (position->getIsRecording())  flags |= isRecording;
+        if (position->getIsLooping())    flags |= isLooping;
+
+        if (const auto t = position->getTimeInSamples())                { flags |= hasTimeInSamples;             header.timeInSamples = *t; }
+        if (const auto t = position->getTimeInSeconds())                { flags |= hasTimeInSeconds;             header.timeInSeconds = *t; }
+        if (const auto bpm = position->getBpm())                        { flags |= hasBpm;                       header.bpm = *bpm; }
+        if (const auto ppq = position->getPpqPosition())                { flags |= hasPpqPosition;               header.ppqPosition = *ppq; }
+        if (const auto ppq = position->getPpqPositionOfLastBarStart())  { flags |= hasPpqPositionOfLastBarStart; header.ppqPositionOfLastBarStart = *ppq; }
+
+        if (const auto sig = position->getTimeSignature())
+        {
+            flags |= hasTimeSignature;
+            header.timeSigNumerator = sig->numerator;
+            header.timeSigDenominator = sig->denominator;
+        }
+
+        header.transportFlags = flags;
+    }
+
+    static Optional<AudioPlayHead::PositionInfo> readTransport (const Header& header)
+    {
+        const auto flags = header.transportFlags;
+
+        if ((flags & hasPosition) == 0)
+            return {};
+
+        AudioPlayHead::PositionInfo position;
+        position.setIsPlaying ((flags & isPlaying) != 0);
+        position.setIsRecording ((flags & isRecording) != 0);
+        position.setIsLooping ((flags & isLooping) != 0);
+
+        if ((flags & hasTimeInSamples) != 0)               position.setTimeInSamples (header.timeInSamples);
+        if ((flags & hasTimeInSeconds) != 0)               position.setTimeInSeconds (header.timeInSeconds);
+        if ((flags & hasBpm) != 0)                         position.setBpm (header.bpm);
+        if ((flags & hasPpqPosition) != 0)                 position.setPpqPosition (header.ppqPosition);
+        if ((flags & hasPpqPositionOfLastBarStart) != 0)   position.setPpqPositionOfLastBarStart (header.ppqPositionOfLastBarStart);
+        if ((flags & hasTimeSignature) != 0)               position.setTimeSignature (AudioPlayHead::TimeSignature { header.timeSigNumerator, header.timeSigDenominator });
+
+        return position;
+    }
+
+private:
+    static constexpr uint32 magicNumber = 0x4a4f4f50;
+
+    struct Layout
+    {
+        Layout() = default;
+
+        Layout (int numChannels, int maxBlockSize, int numParameters)
+            : parameterChanges (align (sizeof (Header))),
+              channels (parameterChanges + align (sizeof (ParameterChange) * (size_t) numParameters)),
+              channelSize (align (sizeof (float) * (size_t) maxBlockSize)),
+              midiInput (channels + channelSize * (size_t) numChannels),
+              midiOutput (midiInput + (size_t) maxMidiBytes),
+              totalSize (midiOutput + (size_t) maxMidiBytes)
+        {}
+
+        static size_t align (size_t size) noexcept    { return (size + 63) & ~(size_t) 63; }
+
+        size_t parameterChanges = 0, channels = 0, channelSize = 0, midiInput = 0, midiOutput = 0, totalSize = 0;
+    };
+
+    SharedAudioBlock (const String& regionName, const Layout& regionLayout, bool shouldUnlink)
+        : name (regionName), layout (regionLayout), isOwner (shouldUnlink)
+    {}
+
+    void map (int fd)
+    {
+       #if JUCE_LINUX
+        auto* address = mmap (nullptr, layout.totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (address != MAP_FAILED)
+            data = address;
+       #else
+        ignoreUnused (fd);
+       #endif
+    }
+
+    String name;
+    Layout layout;
+    void* data = nullptr;
+    std::vector<float*> channels;
+    const bool isOwner;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedAudioBlock)
+};
+
+//==============================================================================
+struct OutOfProcessPluginInstance::PluginInfo
+{
+    struct Bus
+    {
+        String name;
+        AudioChannelSet layout;
+        bool isEnabled = false;
+    };
+
+    struct Parameter
+    {
+        String name, label, parameterID, text;
+        float defaultValue = 0.0f, value = 0.0f;
+        int numSteps = 0, category = 0;
+        bool isDiscrete = false, isBoolean = false, isAutomatable = true, isMetaParameter = false, isOrientationInverted = false;
+    };
+
+    PluginDescription description;
+    std::vector<Bus> inputBuses, outputBuses;
+    std::vector<Parameter> parameters;
+    StringArray programNames;
+    int currentProgram = 0, latencySamples = 0;
+    double tailLengthSeconds = 0.0;
+    bool acceptsMidi = false, producesMidi = false, isMidiEffect = false;
+
+    //==============================================================================
+    static PluginInfo fromPlugin (AudioPluginInstance& plugin)
+    {
+        PluginInfo info;
+        info.description = plugin.getPluginDescription();
+
+        for (auto isInput : { true, false })
+        {
+            for (int i = 0; i < plugin.getBusCount (isInput); ++i)
+            {
+                auto* bus = plugin.getBus (isInput, i);
+                (isInput ? info.inputBuses : info.outputBuses).push_back ({ bus->getName(), bus->getLastEnabledLayout(), bus->isEnabled() });
+            }
+        }
+
+        for (auto* p : plugin.getParameters())
+        {
+            Parameter param;
+            param.name = p->getName (1024);
+            param.label = p->getLabel();
+            param.text = p->getCurrentValueAsText();
+            param.defaultValue = p->getDefaultValue();
+            param.value = p->getValue();
+            param.numSteps = p->getNumSteps();
+            param.category = (int) p->getCategory();
+            param.isDiscrete = p->isDiscrete();
+            param.isBoolean = p->isBoolean();
+            param.isAutomatable = p->isAutomatable();
+            param.isMetaParameter = p->isMetaParameter();
+            param.isOrientationInverted = p->isOrientationInverted();
+
+            if (auto* hosted = dynamic_cast<HostedAudioProcessorParameter*> (p))
+                param.parameterID = hosted->getParameterID();
+            else if (auto* withID = dynamic_cast<AudioProcessorParameterWithID*> (p))
+                param.parameterID = withID->getParameterID();
+            else
+                param.parameterID = String (p->getParameterIndex());
+
+            info.parameters.push_back (param);
+        }
+
+        for (int i = 0; i < plugin.getNumPrograms(); ++i)
+            info.programNames.add (plugin.getProgramName (i));
+
+        info.currentProgram = plugin.getCurrentProgram();
+        info.latencySamples = plugin.getLatencySamples();
+        info.tailLengthSeconds = plugin.getTailLengthSeconds();
+        info.acceptsMidi = plugin.acceptsMidi();
+        info.producesMidi = plugin.producesMidi();
+        info.isMidiEffect = plugin.isMidiEffect();
+        return info;
+    }
+
+    AudioProcessor::BusesProperties getBusesProperties() const
+    {
+        AudioProcessor::BusesProperties properties;
+
+        for (const auto& bus : inputBuses)
+            properties.addBus (true, bus.name, bus.layout, bus.isEnabled);
+
+        for (const auto& bus : outputBuses)
+            properties.addBus (false, bus.name, bus.layout, bus.isEnabled);
+
+        return properties;
+    }
+
+    //==============================================================================
+    void writeTo (OutputStream& out) const
+    {
+        out.writeString (description.createXml()->toString());
+
+        for (const auto* buses : { &inputBuses, &outputBuses })
+        {
+            out.writeInt ((int) buses->size());
+
+            for (const auto& bus : *buses)
+            {
+                out.writeString (bus.name);
+                out.writeBool (bus.isEnabled);
+                out.writeInt (bus.layout.size());
+
+                for (auto type : bus.layout.getChannelTypes())
+                    out.writeInt ((int) type);
+            }
+        }
+
+        out.writeInt ((int) parameters.size());
+
+        for (const auto& param : parameters)
+        {
+            out.writeString (param.name);
+            out.writeString (param.label);
+            out.writeString (param.parameterID);
+            out.writeString (param.text);
+            out.writeFloat (param.defaultValue);
+            out.writeFloat (param.value);
+            out.writeInt (param.numSteps);
+            out.writeInt (param.category);
+            out.writeBool (param.isDiscrete);
+            out.writeBool (param.isBoolean);
+            out.writeBool (param.isAutomatable);
+            out.writeBool (param.isMetaParameter);
+            out.writeBool (param.isOrientationInverted);
+        }
+
+        out.writeInt (programNames.size());
+
+        for (const auto& programName : programNames)
+            out.writeString (programName);
+
+        out.writeInt (currentProgram);
+        out.writeInt (latencySamples);
+        out.writeDouble (tailLengthSeconds);
+        out.writeBool (acceptsMidi);
+        out.writeBool (producesMidi);
+        out.writeBool (isMidiEffect);
+    }
+
+    bool readFrom (InputStream& in)
+    {
+        const auto xml = parseXML (in.readString());
+
+        if (xml == nullptr || ! description.loadFromXml (*xml))
+            return false;
+
+        for (auto* buses : { &inputBuses, &outputBuses })
+        {
+            const auto numBuses = in.readInt();
+
+            if (! isPositiveAndBelow (numBuses, 256))
+                return false;
+
+            for (int i = 0; i < numBuses; ++i)
+            {
+                Bus bus;
+                bus.name = in.readString();
+                bus.isEnabled = in.readBool();
+
+                Array<AudioChannelSet::ChannelType> types;
+
+                for (int numChannels = in.readInt(); --numChannels >= 0 && ! in.isExhausted();)
+                    types.add ((AudioChannelSet::ChannelType) in.readInt());
+
+                bus.layout = AudioChannelSet::channelSetWithChannels (types);
+                buses->push_back (bus);
+            }
+        }
+
+        for (int numParameters = in.readInt(); --numParameters >= 0;)
+        {
+            if (in.isExhausted())
+                return false;
+
+            Parameter param;
+            param.name = in.readString();
+            param.label = in.readString();
+            param.parameterID = in.readString();
+            param.text = in.readString();
+            param.defaultValue = in.readFloat();
+            param.value = in.readFloat();
+            param.numSteps = in.readInt();
+            param.category = in.readInt();
+            param.isDiscrete = in.readBool();
+            param.isBoolean = in.readBool();
+            param.isAutomatable = in.readBool();
+            param.isMetaParameter = in.readBool();
+            param.isOrientationInverted = in.readBool();
+            parameters.push_back (param);
+        }
+
+        for (int numPrograms = in.readInt(); --numPrograms >= 0 && ! in.isExhausted();)
+            programNames.add (in.readString());
+
+        currentProgram = in.readInt();
+        latencySamples = in.readInt();
+        tailLengthSeconds = in.readDouble();
+        acceptsMidi = in.readBool();
+        producesMidi = in.readBool();
+        isMidiEffect = in.readBool();
+        return true;
+    }
+};
+
+//==============================================================================
+class OutOfProcessPluginInstance::Coordinator final : public ChildProcessCoordinator
+{
+public:
+    Coordinator()
+    {
+        setSharedMemoryBufferSize (outOfProcessConnectionBufferSize);
+    }
+
+    ~Coordinator() override
+    {
+        killWorkerProcess();
+    }
+
+    bool launch (const File& workerExecutable)
+    {
+        // The worker's output is never read, so it mustn't go into a pipe that could fill up
+        return launchWorkerProcess (workerExecutable, outOfProcessPluginCommandLineID, 0, 0);
+    }
+
+    void setOwner (OutOfProcessPluginInstance* newOwner)
+    {
+        const ScopedLock sl (ownerLock);
+        owner = newOwner;
+    }
+
+    bool hasFailed() const noexcept     { return connectionLost; }
+
+    /*  Sends a message and blocks until the worker replies to it. If it doesn't reply in
+        time, or shouldAbort returns true while waiting, it's assumed to be stuck, and is killed.
+    */
+    template <typename WritePayload>
+    std::optional<MemoryBlock> sendRequest (OutOfProcessMessageType type, int timeoutMs, WritePayload&& writePayload,
+                                            const std::function<bool()>& shouldAbort = nullptr)
+    {
+        const ScopedLock sl (requestLock);
+
+        if (connectionLost)
+            return {};
+
+        const auto requestID = ++lastRequestID;
+
+        {
+            const ScopedLock rl (replyLock);
+            expectedReplyID = requestID;
+            reply.reset();
+        }
+
+        replyReceived.reset();
+
+        if (sendMessageToWorker (createOutOfProcessMessage (type, requestID, writePayload)))
+        {
+            if (shouldAbort == nullptr)
+            {
+                replyReceived.wait (timeoutMs);
+            }
+            else
+            {
+                const auto startTime = Time::getMillisecondCounter();
+
+                for (;;)
+                {
+                    const auto remaining = timeoutMs - (int) (Time::getMillisecondCounter() - startTime);
+
+                    if (remaining <= 0 || replyReceived.wait (jmin (remaining, 50)) || shouldAbort())
+                        break;
+                }
+            }
+        }
+
+        std::optional<MemoryBlock> result;
+
+        {
+            const ScopedLock rl (replyLock);
+            expectedReplyID = 0;
+            std::swap (result, reply);
+        }
+
+        if (! result.has_value() && ! connectionLost.exchange (true))
+        {
+            killWorkerProcess();
+            notifyOwnerOfFailure();
+        }
+
+        return result;
+    }
+
+    template <typename WritePayload>
+    bool sendAsync (OutOfProcessMessageType type, WritePayload&& writePayload)
+    {
+        return ! connectionLost && sendMessageToWorker (createOutOfProcessMessage (type, 0, writePayload));
+    }
+
+    void handleMessageFromWorker (const MemoryBlock& message) override
+    {
+        MemoryInputStream in (message, false);
+        const auto type = (OutOfProcessMessageType) in.readInt();
+        const auto requestID = in.readInt();
+
+        if (type == OutOfProcessMessageType::reply)
+        {
+            const ScopedLock rl (replyLock);
+
+            if (requestID != 0 && requestID == expectedReplyID)
+            {
+                const auto headerSize = (size_t) in.getPosition();
+                reply = MemoryBlock (addBytesToPointer (message.getData(), headerSize), message.getSize() - headerSize);
+                replyReceived.signal();
+            }
+
+            return;
+        }
+
+        const ScopedLock sl (ownerLock);
+
+        if (owner != nullptr)
+            owner->handleMessageFromWorker (message);
+    }
+
+    void handleConnectionLost() override
+    {
+        connectionLost = true;
+        replyReceived.signal();
+        notifyOwnerOfFailure();
+    }
+
+private:
+    void notifyOwnerOfFailure()
+    {
+        const ScopedLock sl (ownerLock);
+
+        if (owner != nullptr)
+            owner->workerFailed();
+    }
+
+    CriticalSection requestLock, replyLock, ownerLock;
+    OutOfProcessPluginInstance* owner = nullptr;
+    WaitableEvent replyReceived;
+    std::optional<MemoryBlock> reply;
+    int lastRequestID = 0, expectedReplyID = 0;
+    std::atomic<bool> connectionLost { false };
+
+    JUCE_DECLARE_NON_COPYABLE (Coordinator)
+};
+
+//==============================================================================
+struct OutOfProcessPluginInstance::ParameterValues
+{
+    explicit ParameterValues (size_t numParameters)  : values (numParameters) {}
+
+    // A parameter is flagged when the host changes it, until the change is sent to the worker
+    FlaggedFloatCache<1> values;
+};
+
+//==============================================================================
+class OutOfProcessPluginInstance::RemoteParameter final : public HostedAudioProcessorParameter
+{
+public:
+    RemoteParameter (OutOfProcessPluginInstance& o, size_t indexInPlugin, const PluginInfo::Parameter& parameterInfo)
+        : owner (o), index (indexInPlugin), info (parameterInfo)
+    {
+        owner.parameterValues->values.exchangeValue (index, info.value);
+        addText (info.value, info.text);
+    }
+
+    float getValue() const override
+    {
+        return owner.parameterValues->values.get (index);
+    }
+
+    void setValue (float newValue) override
+    {
+        owner.parameterValues->values.setValueAndBits (index, newValue, 1);
+
+        if (! owner.prepared)
+            owner.triggerAsyncUpdate();
+    }
+
+    void updateFromWorker (float newValue, const String& newText)
+    {
+        addText (newValue, newText);
+
+        if (! exactlyEqual (owner.parameterValues->values.exchangeValue (index, newValue), newValue))
+            sendValueChangedMessageToListeners (newValue);
+    }
+
+    // Returns true if the text was for the current value, in which case the host should be told to ask for it again
+    bool textReceivedFromWorker (float value, const String& text)
+    {
+        {
+            const SpinLock::ScopedLockType sl (textLock);
+            requestedTextValues.erase (value);
+        }
+
+        addText (value, text);
+        return exactlyEqual (value, getValue());
+    }
+
+    /*  Asking the worker for the text would mean waiting for it on the message thread, so
+        if it isn't already known, this asks for it in the background and returns a number
+        for now. The answer gets cached, and if it's for the current value, the host is
+        told that the parameter info has changed so that it can ask again.
+    */
+    String getText (float value, int maximumStringLength) const override
+    {
+        {
+            const SpinLock::ScopedLockType sl (textLock);
+
+            if (const auto iter = textCache.find (value); iter != textCache.end())
+                return iter->second.substring (0, maximumStringLength);
+
+            if (requestedTextValues.size() >= maxNumCachedTexts)
+                requestedTextValues.clear();
+
+            if (! requestedTextValues.insert (value).second)
+                return String (value, 2).substring (0, maximumStringLength);
+        }
+
+        owner.requestParameterText ((int) index, value);
+        return String (value, 2).substring (0, maximumStringLength);
+    }
+
+    float getValueForText (const String& text) const override
+    {
+        return owner.getParameterValueForText ((int) index, text);
+    }
+
+    float getDefaultValue() const override                      { return info.defaultValue; }
+    String getName (int maximumStringLength) const override     { return info.name.substring (0, maximumStringLength); }
+    String getLabel() const override                            { return info.label; }
+    int getNumSteps() const override                            { return info.numSteps; }
+    bool isDiscrete() const override                            { return info.isDiscrete; }
+    bool isBoolean() const override                             { return info.isBoolean; }
+    bool isOrientationInverted() const override                 { return info.isOrientationInverted; }
+    bool isAutomatable() const override                         { return info.isAutomatable; }
+    bool isMetaParameter() const override                       { return info.isMetaParameter; }
+    Category getCategory() const override                       { return (Category) info.category; }
+    String getParameterID() const override                      { return info.parameterID; }
+
+private:
+    OutOfProcessPluginInstance& owner;
+    const size_t index;
+    const PluginInfo::Parameter info;
+
+    static constexpr size_t maxNumCachedTexts = 64;
+
+    mutable SpinLock textLock;
+    std::map<float, String> textCache;
+    mutable std::set<float> requestedTextValues;
+
+    void addText (float value, const String& text)
+    {
+        const SpinLock::ScopedLockType sl (textLock);
+
+        if (textCache.size() >= maxNumCachedTexts && textCache.count (value) == 0)
+            textCache.erase (textCache.begin());
+
+        textCache[value] = text;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RemoteParameter)
+};
+
+//==============================================================================
+std::unique_ptr<OutOfProcessPluginInstance> OutOfProcessPluginInstance::create (const File& workerExecutable,
+                                                                                const PluginDescription& pluginDescription,
+                                                                                double initialSampleRate,
+                                                                                int initialBufferSize,
+                                                                                String& errorMessage)
+{
+    if (! InterprocessConnection::isSharedMemoryAvailable())
+    {
+        errorMessage = NEEDS_TRANS ("Out-of-process plugins aren't supported on this platform");
+        return {};
+    }
+
+    auto newCoordinator = std::make_unique<Coordinator>();
+
+    if (! newCoordinator->launch (workerExecutable))
+    {
+        errorMessage = NEEDS_TRANS ("Couldn't launch the plugin worker process");
+        return {};
+    }
+
+    const auto reply = newCoordinator->sendRequest (OutOfProcessMessageType::load, outOfProcessLoadTimeoutMs, [&] (MemoryOutputStream& out)
+    {
+        out.writeString (pluginDescription.createXml()->toString());
+        out.writeDouble (initialSampleRate);
+        out.writeInt (initialBufferSize);
+    });
+
+    if (! reply.has_value())
+    {
+        errorMessage = NEEDS_TRANS ("The plugin worker process stopped responding");
+        return {};
+    }
+
+    MemoryInputStream in (*reply, false);
+    PluginInfo info;
+
+    if (! in.readBool())
+    {
+        errorMessage = in.readString();
+        return {};
+    }
+
+    if (! info.readFrom (in))
+    {
+        errorMessage = NEEDS_TRANS ("The plugin worker process sent an invalid reply");
+        return {};
+    }
+
+    std::unique_ptr<OutOfProcessPluginInstance> instance (new OutOfProcessPluginInstance (std::move (newCoordinator), info));
+    instance->setRateAndBufferSizeDetails (initialSampleRate, initialBufferSize);
+    return instance;
+}
+
+OutOfProcessPluginInstance::OutOfProcessPluginInstance (std::unique_ptr<Coordinator> c, const PluginInfo& info)
+    : AudioPluginInstance (info.getBusesProperties()),
+      coordinator (std::move (c)),
+      layout (getBusesLayout()),
+      description (info.description),
+      parameterValues (std::make_unique<ParameterValues> (info.parameters.size())),
+      tailLengthSeconds (info.tailLengthSeconds),
+      pluginAcceptsMidi (info.acceptsMidi),
+      pluginProducesMidi (info.producesMidi),
+      pluginIsMidiEffect (info.isMidiEffect),
+      programNames (info.programNames),
+      currentProgram (info.currentProgram)
+{
+    for (size_t i = 0; i < info.parameters.size(); ++i)
+        addHostedParameter (std::make_unique<RemoteParameter> (*this, i, info.parameters[i]));
+
+    setLatencySamples (info.latencySamples);
+    resetStatistics();
+    coordinator->setOwner (this);
+}
+
+OutOfProcessPluginInstance::~OutOfProcessPluginInstance()
+{
+    coordinator->setOwner (nullptr);
+    cancelPendingUpdate();
+    coordinator.reset();
+    audioBlock.reset();
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::fillInPluginDescription (PluginDescription& d) const  { d = description; }
+const String OutOfProcessPluginInstance::getName() const                              { return description.name; }
+double OutOfProcessPluginInstance::getTailLengthSeconds() const                       { return tailLengthSeconds; }
+bool OutOfProcessPluginInstance::acceptsMidi() const                                  { return pluginAcceptsMidi; }
+bool OutOfProcessPluginInstance::producesMidi() const                                 { return pluginProducesMidi; }
+bool OutOfProcessPluginInstance::isMidiEffect() const                                 { return pluginIsMidiEffect; }
+
+bool OutOfProcessPluginInstance::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+    // The buses are fixed to whatever the plugin was using when it was loaded
+    return layouts == layout;
+}
+
+bool OutOfProcessPluginInstance::hasWorkerFailed() const noexcept
+{
+    return failed || coordinator->hasFailed();
+}
+
+void OutOfProcessPluginInstance::setProcessTimeout (double milliseconds) noexcept
+{
+    processTimeoutMs = milliseconds;
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::prepareToPlay (double sampleRate, int maximumExpectedSamplesPerBlock)
+{
+    prepared = false;
+    audioBlock.reset();
+    setRateAndBufferSizeDetails (sampleRate, maximumExpectedSamplesPerBlock);
+    midiOutput.ensureSize (SharedAudioBlock::maxMidiBytes);
+
+    if (hasWorkerFailed())
+        return;
+
+    auto newBlock = SharedAudioBlock::create (jmax (getTotalNumInputChannels(), getTotalNumOutputChannels()),
+                                              jmax (1, maximumExpectedSamplesPerBlock),
+                                              getParameters().size());
+
+    if (newBlock == nullptr)
+    {
+        jassertfalse; // couldn't create the shared memory region
+        return;
+    }
+
+    // Any parameter changes made while the plugin wasn't running need to arrive first
+    sendPendingParameterChanges();
+
+    const auto reply = coordinator->sendRequest (OutOfProcessMessageType::prepare, outOfProcessRequestTimeoutMs, [&] (MemoryOutputStream& out)
+    {
+        out.writeString (newBlock->getName());
+        out.writeDouble (sampleRate);
+        out.writeInt (maximumExpectedSamplesPerBlock);
+        out.writeBool (isNonRealtime());
+    });
+
+    if (! reply.has_value())
+        return;
+
+    MemoryInputStream in (*reply, false);
+
+    if (! in.readBool())
+        return;
+
+    setLatencySamples (in.readInt());
+    audioBlock = std::move (newBlock);
+    lastResponseTicks = Time::getHighResolutionTicks();
+    prepared = true;
+}
+
+void OutOfProcessPluginInstance::releaseResources()
+{
+    prepared = false;
+
+    if (audioBlock != nullptr)
+    {
+        coordinator->sendRequest (OutOfProcessMessageType::release, outOfProcessRequestTimeoutMs, writeNothing);
+        audioBlock.reset();
+    }
+
+    sendPendingParameterChanges();
+}
+
+void OutOfProcessPluginInstance::reset()
+{
+    coordinator->sendAsync (OutOfProcessMessageType::reset, writeNothing);
+}
+
+void OutOfProcessPluginInstance::setNonRealtime (bool isNonRealtime) noexcept
+{
+    AudioPluginInstance::setNonRealtime (isNonRealtime);
+
+    coordinator->sendAsync (OutOfProcessMessageType::setNonRealtime, [isNonRealtime] (MemoryOutputStream& out)
+    {
+        out.writeBool (isNonRealtime);
+    });
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
+{
+    const auto numSamples = buffer.getNumSamples();
+    midiOutput.clear();
+
+    if (audioBlock == nullptr)
+    {
+        buffer.clear();
+        midiMessages.clear();
+        return;
+    }
+
+    const auto maxBlockSize = audioBlock->getHeader().maxBlockSize;
+
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+    {
+        const auto num = jmin (maxBlockSize, numSamples - start);
+
+        if (! processChunk (buffer, start, num, midiMessages, midiOutput))
+            buffer.clear (start, num);
+    }
+
+    midiMessages.swapWith (midiOutput);
+}
+
+bool OutOfProcessPluginInstance::processChunk (AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                               const MidiBuffer& midiIn, MidiBuffer& midiOut)
+{
+    auto& header = audioBlock->getHeader();
+    const auto request = header.requestCount.load (std::memory_order_relaxed);
+    const auto startTicks = Time::getHighResolutionTicks();
+
+    const auto missedBlock = [&]
+    {
+        ++numMissedBlocks;
+
+        // If the worker hasn't returned anything for a long time, give up on it
+        if (! failed && Time::highResolutionTicksToSeconds (startTicks - lastResponseTicks) * 1000.0 > outOfProcessHungWorkerTimeoutMs)
+        {
+            failed = true;
+            triggerAsyncUpdate();
+        }
+
+        return false;
+    };
+
+    // If the worker is still busy with the last block that timed out, skip this one
+    if (hasWorkerFailed() || header.responseCount.load (std::memory_order_acquire) != request)
+        return missedBlock();
+
+    const auto numBufferChannels = jmin (buffer.getNumChannels(), header.numChannels);
+
+    for (int i = 0; i < header.numChannels; ++i)
+    {
+        if (i < numBufferChannels)
+            FloatVectorOperations::copy (audioBlock->getChannel (i), buffer.getReadPointer (i, startSample), numSamples);
+        else
+            FloatVectorOperations::clear (audioBlock->getChannel (i), numSamples);
+    }
+
+    header.numSamples = numSamples;
+    header.numMidiInputBytes = SharedAudioBlock::writeMidi (midiIn, startSample, numSamples, audioBlock->getMidiInput());
+    SharedAudioBlock::writeTransport (header, getPlayHead());
+
+    auto* parameterChanges = audioBlock->getParameterChanges();
+    int numParameterChanges = 0;
+
+    parameterValues->values.ifSet ([&] (size_t index, float value, uint32)
+    {
+        if (numParameterChanges < header.numParameters)
+            parameterChanges[numParameterChanges++] = { (int32) index, value };
+    });
+
+    header.numParameterChanges = numParameterChanges;
+
+    header.requestCount.store (request + 1, std::memory_order_release);
+    SharedAudioBlock::wake (header.requestCount);
+
+    const auto timeoutMs = processTimeoutMs.load();
+    const auto timeoutSeconds = isNonRealtime() ? outOfProcessHungWorkerTimeoutMs / 1000.0
+                                                : (timeoutMs >= 0 ? timeoutMs / 1000.0 : numSamples / jmax (1.0, getSampleRate()));
+    const auto deadline = startTicks + Time::secondsToHighResolutionTicks (timeoutSeconds);
+
+    // The worker usually answers within a few microseconds, so spin briefly before sleeping
+    for (int spins = 0;; ++spins)
+    {
+        const auto response = header.responseCount.load (std::memory_order_acquire);
+
+        if (response == request + 1)
+            break;
+
+        if (spins < 1000)
+            continue;
+
+        const auto now = Time::getHighResolutionTicks();
+
+        if (now >= deadline)
+            return missedBlock();
+
+        SharedAudioBlock::wait (header.responseCount, response,
+                                (int64) (Time::highResolutionTicksToSeconds (deadline - now) * 1.0e9) + 1);
+    }
+
+    const auto endTicks = Time::getHighResolutionTicks();
+    lastResponseTicks = endTicks;
+
+    for (int i = 0; i < numBufferChannels; ++i)
+        FloatVectorOperations::copy (buffer.getWritePointer (i, startSample), audioBlock->getChannel (i), numSamples);
+
+    SharedAudioBlock::readMidi (audioBlock->getMidiOutput(), header.numMidiOutputBytes, midiOut, startSample);
+
+    const auto roundTripTicks = endTicks - startTicks;
+    ++numBlocks;
+    totalRoundTripTicks += roundTripTicks;
+    totalProcessingNanoseconds += header.processingNanoseconds;
+    workerCpuNanoseconds = header.workerCpuNanoseconds;
+
+    if (roundTripTicks > maxRoundTripTicks)
+        maxRoundTripTicks = roundTripTicks;
+
+    return true;
+}
+
+//==============================================================================
+OutOfProcessPluginInstance::Statistics OutOfProcessPluginInstance::getStatistics() const
+{
+    Statistics stats;
+    stats.numBlocks = numBlocks;
+    stats.numMissedBlocks = numMissedBlocks;
+    stats.maxRoundTripMs = Time::highResolutionTicksToSeconds (maxRoundTripTicks) * 1000.0;
+
+    if (stats.numBlocks > 0)
+    {
+        stats.averageRoundTripMs = Time::highResolutionTicksToSeconds (totalRoundTripTicks) * 1000.0 / (double) stats.numBlocks;
+        stats.averageProcessingMs = (double) totalProcessingNanoseconds * 1.0e-6 / (double) stats.numBlocks;
+    }
+
+    const auto elapsedSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - statisticsResetTicks);
+
+    if (elapsedSeconds > 0 && workerCpuNanoseconds > workerCpuNanosecondsAtReset)
+        stats.workerCpuLoad = (double) (workerCpuNanoseconds - workerCpuNanosecondsAtReset) * 1.0e-9 / elapsedSeconds;
+
+    return stats;
+}
+
+void OutOfProcessPluginInstance::resetStatistics()
+{
+    numBlocks = 0;
+    numMissedBlocks = 0;
+    totalRoundTripTicks = 0;
+    maxRoundTripTicks = 0;
+    totalProcessingNanoseconds = 0;
+    workerCpuNanosecondsAtReset = workerCpuNanoseconds.load();
+    statisticsResetTicks = Time::getHighResolutionTicks();
+}
+
+//==============================================================================
+void OutOfProcessPluginInstance::sendPendingParameterChanges()
+{
+    MemoryOutputStream changes;
+
+    parameterValues->values.ifSet ([&] (size_t index, float value, uint32)
+    {
+        changes.writeInt ((int) index);
+        changes.writeFloat (value);
+    });
+
+    if (changes.getDataSize() > 0)
+        coordinator->sendAsync (OutOfProcessMessageType::setParameters, [&] (MemoryOutputStream& out)
+        {
+            out.write (changes.getData(), changes.getDataSize());
+        });
+}
+
+void OutOfProcessPluginInstance::requestParameterText (int index, float value)
+{
+    // The worker sends back a parameterText message
+    coordinator->sendAsync (OutOfProcessMessageType::getParameterText, [&] (MemoryOutputStream& out)
+    {
+        out.writeInt (index);
+        out.writeFloat (value);
+    });
+}
+
+float OutOfProcessPluginInstance::getParameterValueForText (int index, const String& text)
+{
+    const auto reply = coordinator->sendRequest (OutOfProcessMessageType::getParameterValueForText, outOfProcessRequestTimeoutMs, [&] (MemoryOutputStream& out)
+    {
+        out.writeInt (index);
+        out.writeString (text);
+    });
+
+    if (reply.has_value())
+        return MemoryInputStream (*reply, false).readFloat();
+
+    return text.getFloatValue();
+}
+
+void OutOfProcessPluginInstance::handleMessageFromWorker (const MemoryBlock& message)
+{
+    MemoryInputStream in (message, false);
+    const auto type = (OutOfProcessMessageType) in.readInt();
+    in.readInt(); // request ID
+
+    switch (type)
+    {
+        case OutOfProcessMessageType::parametersChanged:
+        {
+            const auto& parameters = getParameters();
+
+            while (! in.isExhausted())
+            {
+                const auto index = in.readInt();
+                const auto value = in.readFloat();
+                const auto text = in.readString();
+
+                if (auto* param = dynamic_cast<RemoteParameter*> (parameters[index]))
+                    param->updateFromWorker (value, text);
+            }
+
+            break;
+        }
+
+        case OutOfProcessMessageType::parameterText:
+        {
+            const auto index = in.readInt();
+            const auto value = in.readFloat();
+            const auto text = in.readString();
+
+            if (auto* param = dynamic_cast<RemoteParameter*> (getParameters()[index]))
+            {
+                if (param->textReceivedFromWorker (value, text))
+                {
+                    pendingParameterInfoChange = true;
+                    triggerAsyncUpdate();
+                }
+            }
+
+            break;
+        }
+
+        case OutOfProcessMessageType::latencyChanged:
+            pendingLatency = in.readInt();
+            triggerAsyncUpdate();
+            break;
+
+        case OutOfProcessMessageType::programChanged:
+            currentProgram = in.readInt();
+            pendingProgramChange = true;
+            triggerAsyncUpdate();
+            break;
+
+        case OutOfProcessMessageType::load:
+        case OutOfProcessMessageType::prepare:
+        case OutOfProcessMessageType::release:
+        case OutOfProcessMessageType::reset:
+        case OutOfProcessMessageType::setNonRealtime:
+        case OutOfProcessMessageType::setParameters:
+        case OutOfProcessMessageType::setProgram:
+        case OutOfProcessMessageType::getState:
+        case OutOfProcessMessageType::setState:
+        case OutOfProcessMessageType::getParameterText:
+        case OutOfProcessMessageType::getParameterValueForText:
+        case OutOfProcessMessageType::scanFile:
+        case OutOfProcessMessageType::reply:
+        default:
+            break;
+    }
+}
+
+void OutOfProcessPluginInstance::workerFailed()
+{
+    failed = true;
+    triggerAsyncUpdate();
+}
+
+void OutOfProcessPluginInstance::handleAsyncUpdate()
+{
+    if (hasWorkerFailed())
+    {
+        coordinator->killWorkerProcess();
+        return;
+    }
+
+    const auto latency = pendingLatency.exchange (-1);
+
+    if (latency >= 0)
+        setLatencySamples (latency);
+
+    if (pendingProgramChange.exchange (false))
+        updateHostDisplay (ChangeDetails().withProgramChanged (true));
+
+    if (pendingParameterInfoChange.exchange (false))
+        updateHostDisplay (ChangeDetails().withParameterInfoChanged (true));
+
+    if (! prepared)
+        sendPendingParameterChanges();
+}
+
+//==============================================================================
+int OutOfProcessPluginInstance::getNumPrograms()                     { return programNames.size(); }
+int OutOfProcessPluginInstance::getCurrentProgram()                  { return currentProgram; }
+const String OutOfProcessPluginInstance::getProgramName (int index)  { return programNames[index]; }
+
+void OutOfProcessPluginInstance::setCurrentProgram (int index)
+{
+    if (! isPositiveAndBelow (index, programNames.size()))
+        return;
+
+    currentProgram = index;
+
+    coordinator->sendAsync (OutOfProcessMessageType::setProgram, [index] (MemoryOutputStream& out)
+    {
+        out.writeInt (index);
+    });
+}
+
+void OutOfProcessPluginInstance::getStateInformation (MemoryBlock& destData)                    { getState (destData, false); }
+void OutOfProcessPluginInstance::getCurrentProgramStateInformation (MemoryBlock& destData)      { getState (destData, true); }
+void OutOfProcessPluginInstance::setStateInformation (const void* data, int size)               { setState (data, size, false); }
+void OutOfProcessPluginInstance::setCurrentProgramStateInformation (const void* data, int size) { setState (data, size, true); }
+
+void OutOfProcessPluginInstance::getState (MemoryBlock& destData, bool currentProgramOnly)
+{
+    // Make sure the plugin has seen the latest parameter values before it saves them
+    sendPendingParameterChanges();
+
+    const auto reply = coordinator->sendRequest (OutOfProcessMessageType::getState, outOfProcessRequestTimeoutMs, [&] (MemoryOutputStream& out)
+    {
+        out.writeBool (currentProgramOnly);
+    });
+
+    if (reply.has_value())
+        destData = *reply;
+}
+
+void OutOfProcessPluginInstance::setState (const void* data, int size, bool currentProgramOnly)
+{
+    coordinator->sendRequest (OutOfProcessMessageType::setState, outOfProcessRequestTimeoutMs, [&] (MemoryOutputStream& out)
+    {
+        out.writeBool (currentProgramOnly);
+        out.write (data, (size_t) size);
+    });
+}
+
+//==============================================================================
+class OutOfProcessPluginWorker::Implementation final : public ChildProcessWorker,
+                                                       private AudioProcessorListener,
+                                                       private AsyncUpdater,
+                                                       private Thread
+{
+public:
+    using SharedAudioBlock = OutOfProcessPluginInstance::SharedAudioBlock;
+    using PluginInfo = OutOfProcessPluginInstance::PluginInfo;
+
+    explicit Implementation (OutOfProcessPluginWorker& o)
+        : Thread (SystemStats::getJUCEVersion() + ": plugin worker audio"),
+          owner (o)
+    {
+        selfReference = this;
+    }
+
+    ~Implementation() override
+    {
+        stopAudioThread();
+        cancelPendingUpdate();
+
+        if (plugin != nullptr)
+            plugin->removeListener (this);
+    }
+
+    //==============================================================================
+    void handleMessageFromCoordinator (const MemoryBlock& message) override
+    {
+        // Plugins generally expect to be controlled from the message thread
+        MessageManager::callAsync ([weakThis = selfReference, message]
+        {
+            if (auto* self = weakThis.get())
+                self->handleCommand (message);
+        });
+    }
+
+    void handleConnectionLost() override
+    {
+        connectionLost = true;
+        triggerAsyncUpdate();
+
+        if (watchdogStarted.exchange (true))
+            return;
+
+        // If the message thread is stuck inside the plugin, the process would never get
+        // a chance to quit, so give it a moment and then end it the hard way
+        Thread::launch ([shutdownStarted = shutdownStarted]
+        {
+            Thread::sleep (outOfProcessHungWorkerTimeoutMs);
+
+            if (! shutdownStarted->load())
+                Process::terminate();
+        });
+    }
+
+private:
+    //==============================================================================
+    struct RemotePlayHead final : public AudioPlayHead
+    {
+        Optional<PositionInfo> getPosition() const override     { return position; }
+
+        Optional<PositionInfo> position;
+    };
+
+    //==============================================================================
+    void handleCommand (const MemoryBlock& message)
+    {
+        MemoryInputStream in (message, false);
+        const auto type = (OutOfProcessMessageType) in.readInt();
+        const auto requestID = in.readInt();
+
+        switch (type)
+        {
+            case OutOfProcessMessageType::load:
+                sendReply (requestID, [&] (MemoryOutputStream& out) { load (in, out); });
+                break;
+
+            case OutOfProcessMessageType::prepare:
+                sendReply (requestID, [&] (MemoryOutputStream& out) { prepare (in, out); });
+                break;
+
+            case OutOfProcessMessageType::release:
+                release();
+                sendReply (requestID, writeNothing);
+                break;
+
+            case OutOfProcessMessageType::reset:
+                if (plugin != nullptr)
+                    plugin->reset();
+
+                break;
+
+            case OutOfProcessMessageType::setNonRealtime:
+                if (plugin != nullptr)
+                    plugin->setNonRealtime (in.readBool());
+
+                break;
+
+            case OutOfProcessMessageType::setParameters:
+                while (! in.isExhausted())
+                {
+                    const auto index = in.readInt();
+                    const auto value = in.readFloat();
+
+                    if (auto* param = getParameter (index))
+                        param->setValue (value);
+                }
+
+                break;
+
+            case OutOfProcessMessageType::setProgram:
+                if (plugin != nullptr)
+                {
+                    plugin->setCurrentProgram (in.readInt());
+                    markAllParametersChanged();
+                }
+
+                break;
+
+            case OutOfProcessMessageType::getState:
+            {
+                MemoryBlock state;
+
+                if (plugin != nullptr)
+                {
+                    if (in.readBool())
+                        plugin->getCurrentProgramStateInformation (state);
+                    else
+                        plugin->getStateInformation (state);
+                }
+
+                sendReply (requestID, [&] (MemoryOutputStream& out) { out.write (state.getData(), state.getSize()); });
+                break;
+            }
+
+            case OutOfProcessMessageType::setState:
+            {
+                const auto currentProgramOnly = in.readBool();
+                const auto* data = addBytesToPointer (message.getData(), in.getPosition());
+                const auto size = (int) in.getNumBytesRemaining();
+
+                if (plugin != nullptr)
+                {
+                    if (currentProgramOnly)
+                        plugin->setCurrentProgramStateInformation (data, size);
+                    else
+                        plugin->setStateInformation (data, size);
+
+                    markAllParametersChanged();
+                }
+
+                sendReply (requestID, writeNothing);
+                break;
+            }
+
+            case OutOfProcessMessageType::getParameterText:
+            {
+                const auto index = in.readInt();
+                const auto value = in.readFloat();
+                auto* param = getParameter (index);
+                const auto text = param != nullptr ? param->getText (value, 1024) : String();
+
+                sendMessageToCoordinator (createOutOfProcessMessage (OutOfProcessMessageType::parameterText, 0, [&] (MemoryOutputStream& out)
+                {
+                    out.writeInt (index);
+                    out.writeFloat (value);
+                    out.writeString (text);
+                }));
+
+                break;
+            }
+
+            case OutOfProcessMessageType::getParameterValueForText:
+            {
+                const auto index = in.readInt();
+                const auto text = in.readString();
+                auto* param = getParameter (index);
+                const auto value = param != nullptr ? param->getValueForText (text) : 0.0f;
+
+                sendReply (requestID, [&] (MemoryOutputStream& out) { out.writeFloat (value); });
+                break;
+            }
+
+            case OutOfProcessMessageType::scanFile:
+            {
+                const auto formatName = in.readString();
+                const auto fileOrIdentifier = in.readString();
+                OwnedArray<PluginDescription> found;
+
+                for (auto* format : owner.formatManager.getFormats())
+                    if (format->getName() == formatName)
+                        format->findAllTypesForFile (found, fileOrIdentifier);
+
+                sendReply (requestID, [&] (MemoryOutputStream& out)
+                {
+                    out.writeInt (found.size());
+
+                    for (auto* desc : found)
+                        out.writeString (desc->createXml()->toString());
+                });
+
+                break;
+            }
+
+            case OutOfProcessMessageType::reply:
+            case OutOfProcessMessageType::parametersChanged:
+            case OutOfProcessMessageType::parameterText:
+            case OutOfProcessMessageType::latencyChanged:
+            case OutOfProcessMessageType::programChanged:
+            default:
+                break;
+        }
+    }
+
+    template <typename WritePayload>
+    void sendReply (int requestID, WritePayload&& writePayload)
+    {
+        sendMessageToCoordinator (createOutOfProcessMessage (OutOfProcessMessageType::reply, requestID, writePayload));
+    }
+
+    AudioProcessorParameter* getParameter (int index) const
+    {
+        return plugin != nullptr ? plugin->getParameters()[index] : nullptr;
+    }
+
+    //==============================================================================
+    void load (MemoryInputStream& in, MemoryOutputStream& out)
+    {
+        const auto xml = parseXML (in.readString());
+        const auto sampleRate = in.readDouble();
+        const auto blockSize = in.readInt();
+
+        PluginDescription description;
+        String error;
+
+        if (plugin == nullptr && xml != nullptr && description.loadFromXml (*xml))
+            plugin = owner.formatManager.createPluginInstance (description, sampleRate, blockSize, error);
+
+        if (plugin == nullptr)
+        {
+            out.writeBool (false);
+            out.writeString (error.isNotEmpty() ? error : NEEDS_TRANS ("Couldn't load the plugin"));
+            return;
+        }
+
+        changedParameters = std::make_unique<FlagCache<1>> ((size_t) plugin->getParameters().size());
+        plugin->setPlayHead (&playHead);
+        plugin->addListener (this);
+
+        out.writeBool (true);
+        PluginInfo::fromPlugin (*plugin).writeTo (out);
+    }
+
+    void prepare (MemoryInputStream& in, MemoryOutputStream& out)
+    {
+        const auto name = in.readString();
+        const auto sampleRate = in.readDouble();
+        const auto blockSize = in.readInt();
+        const auto isNonRealtime = in.readBool();
+
+        stopAudioThread();
+        block = SharedAudioBlock::open (name);
+
+        if (plugin == nullptr || block == nullptr
+             || block->getHeader().maxBlockSize < blockSize
+             || block->getHeader().numChannels < jmax (plugin->getTotalNumInputChannels(), plugin->getTotalNumOutputChannels()))
+        {
+            block.reset();
+            out.writeBool (false);
+            return;
+        }
+
+        plugin->setNonRealtime (isNonRealtime);
+        plugin->setRateAndBufferSizeDetails (sampleRate, blockSize);
+        plugin->prepareToPlay (sampleRate, blockSize);
+        midiBuffer.ensureSize (SharedAudioBlock::maxMidiBytes);
+
+        if (! startRealtimeThread (RealtimeOptions{}.withApproximateAudioProcessingTime (blockSize, sampleRate)))
+            startThread (Priority::highest);
+
+        out.writeBool (true);
+        out.writeInt (plugin->getLatencySamples());
+    }
+
+    void release()
+    {
+        stopAudioThread();
+        block.reset();
+
+        if (plugin != nullptr)
+            plugin->releaseResources();
+    }
+
+    void stopAudioThread()
+    {
+        if (block != nullptr)
+        {
+            signalThreadShouldExit();
+            SharedAudioBlock::wake (block->getHeader().requestCount);
+        }
+
+        stopThread (-1);
+    }
+
+    //==============================================================================
+    void run() override
+    {
+        auto& header = block->getHeader();
+        auto lastRequest = header.responseCount.load (std::memory_order_relaxed);
+
+        while (! threadShouldExit())
+        {
+            const auto request = header.requestCount.load (std::memory_order_acquire);
+
+            if (request == lastRequest)
+            {
+                SharedAudioBlock::wait (header.requestCount, request, 100000000);
+                continue;
+            }
+
+            processBlock (header);
+            lastRequest = request;
+
+            header.responseCount.store (request, std::memory_order_release);
+            SharedAudioBlock::wake (header.responseCount);
+        }
+    }
+
+    void processBlock (SharedAudioBlock::Header& header)
+    {
+        const auto startTicks = Time::getHighResolutionTicks();
+        const auto numSamples = jlimit (0, header.maxBlockSize, header.numSamples);
+
+        const auto& parameters = plugin->getParameters();
+        const auto* parameterChanges = block->getParameterChanges();
+
+        for (int i = 0; i < jmin (header.numParameterChanges, header.numParameters); ++i)
+            if (auto* param = parameters[parameterChanges[i].index])
+                param->setValue (parameterChanges[i].value);
+
+        midiBuffer.clear();
+        SharedAudioBlock::readMidi (block->getMidiInput(), header.numMidiInputBytes, midiBuffer, 0);
+        playHead.position = SharedAudioBlock::readTransport (header);
+
+        AudioBuffer<float> buffer (block->getChannels(), header.numChannels, numSamples);
+
+        {
+            const ScopedLock sl (plugin->getCallbackLock());
+
+            if (plugin->isSuspended())
+            {
+                buffer.clear();
+                midiBuffer.clear();
+            }
+            else
+            {
+                plugin->processBlock (buffer, midiBuffer);
+            }
+        }
+
+        header.numMidiOutputBytes = SharedAudioBlock::writeMidi (midiBuffer, 0, numSamples, block->getMidiOutput());
+        header.processingNanoseconds = (int64) (Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks) * 1.0e9);
+        header.workerCpuNanoseconds = getProcessCpuNanoseconds();
+    }
+
+    //==============================================================================
+    void audioProcessorParameterChanged (AudioProcessor*, int parameterIndex, float) override
+    {
+        if (changedParameters != nullptr && isPositiveAndBelow (parameterIndex, plugin->getParameters().size()))
+        {
+            changedParameters->set ((size_t) parameterIndex, 1);
+            triggerAsyncUpdate();
+        }
+    }
+
+    void audioProcessorChanged (AudioProcessor*, const ChangeDetails& details) override
+    {
+        if (details.latencyChanged)
+            latencyChanged = true;
+
+        if (details.programChanged)
+            programChanged = true;
+
+        if (details.programChanged || details.parameterInfoChanged)
+            markAllParametersChanged();
+
+        triggerAsyncUpdate();
+    }
+
+    void markAllParametersChanged()
+    {
+        if (changedParameters == nullptr)
+            return;
+
+        for (size_t i = 0, num = (size_t) plugin->getParameters().size(); i < num; ++i)
+            changedParameters->set (i, 1);
+
+        triggerAsyncUpdate();
+    }
+
+    void handleAsyncUpdate() override
+    {
+        if (connectionLost.exchange (false))
+        {
+            *shutdownStarted = true;
+            stopAudioThread();
+
+            if (owner.onConnectionLost != nullptr)
+                owner.onConnectionLost();
+            else
+                JUCEApplicationBase::quit();
+
+            return;
+        }
+
+        if (plugin == nullptr)
+            return;
+
+        const auto& parameters = plugin->getParameters();
+        MemoryOutputStream changes;
+
+        changedParameters->ifSet ([&] (size_t index, uint32)
+        {
+            if (auto* param = parameters[(int) index])
+            {
+                changes.writeInt ((int) index);
+                changes.writeFloat (param->getValue());
+                changes.writeString (param->getCurrentValueAsText());
+            }
+        });
+
+        if (changes.getDataSize() > 0)
+            sendMessageToCoordinator (createOutOfProcessMessage (OutOfProcessMessageType::parametersChanged, 0, [&] (MemoryOutputStream& out)
+            {
+                out.write (changes.getData(), changes.getDataSize());
+            }));
+
+        if (latencyChanged.exchange (false))
+            sendMessageToCoordinator (createOutOfProcessMessage (OutOfProcessMessageType::latencyChanged, 0, [this] (MemoryOutputStream& out)
+            {
+                out.writeInt (plugin->getLatencySamples());
+            }));
+
+        if (programChanged.exchange (false))
+            sendMessageToCoordinator (createOutOfProcessMessage (OutOfProcessMessageType::programChanged, 0, [this] (MemoryOutputStream& out)
+            {
+                out.writeInt (plugin->getCurrentProgram());
+            }));
+    }
+
+    //==============================================================================
+    OutOfProcessPluginWorker& owner;
+    WeakReference<Implementation> selfReference;
+
+    std::unique_ptr<AudioPluginInstance> plugin;
+    std::unique_ptr<SharedAudioBlock> block;
+    std::unique_ptr<FlagCache<1>> changedParameters;
+    RemotePlayHead playHead;
+    MidiBuffer midiBuffer;
+
+    std::atomic<bool> connectionLost { false }, latencyChanged { false }, programChanged { false };
+    std::atomic<bool> watchdogStarted { false };
+    std::shared_ptr<std::atomic<bool>> shutdownStarted = std::make_shared<std::atomic<bool>> (false);
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (Implementation)
+    JUCE_DECLARE_NON_COPYABLE (Implementation)
+};
+
+//==============================================================================
+OutOfProcessPluginWorker::OutOfProcessPluginWorker (AudioPluginFormatManager& formatsToUse)
+    : formatManager (formatsToUse)
+{
+}
+
+OutOfProcessPluginWorker::~OutOfProcessPluginWorker() = default;
+
+bool OutOfProcessPluginWorker::initialiseFromCommandLine (const String& commandLine)
+{
+    auto newImplementation = std::make_unique<Implementation> (*this);
+
+    if (! newImplementation->initialiseFromCommandLine (commandLine, outOfProcessPluginCommandLineID))
+        return false;
+
+    implementation = std::move (newImplementation);
+    return true;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct SharedAudioBlockTests final : public UnitTest
+{
+    SharedAudioBlockTests()
+        : UnitTest ("OutOfProcessPluginInstance shared audio block", UnitTestCategories::audioProcessors)
+    {}
+
+    using SharedAudioBlock = OutOfProcessPluginInstance::SharedAudioBlock;
+
+    void runTest() override
+    {
+        beginTest ("MIDI events in the block's range are written and read back in order");
+        {
+            const uint8 sysex[] = { 0xf0, 0x7e, 0x01, 0x02, 0x03, 0x04, 0xf7 };
+
+            MidiBuffer source;
+            source.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 2);
+            source.addEvent (MidiMessage::noteOn (1, 62, (uint8) 90), 5);
+            source.addEvent (MidiMessage::controllerEvent (2, 7, 64), 5);
+            source.addEvent (sysex, (int) sizeof (sysex), 10);
+            source.addEvent (MidiMessage::noteOff (1, 62), 34);
+            source.addEvent (MidiMessage::noteOff (1, 60), 35);
+
+            std::vector<uint8> data ((size_t) SharedAudioBlock::maxMidiBytes);
+            const auto numBytes = SharedAudioBlock::writeMidi (source, 5, 30, data.data());
+
+            MidiBuffer result;
+            SharedAudioBlock::readMidi (data.data(), numBytes, result, 100);
+
+            MidiBuffer expected;
+            expected.addEvent (MidiMessage::noteOn (1, 62, (uint8) 90), 100);
+            expected.addEvent (MidiMessage::controllerEvent (2, 7, 64), 100);
+            expected.addEvent (sysex, (int) sizeof (sysex), 105);
+            expected.addEvent (MidiMessage::noteOff (1, 62), 129);
+
+            expect (areEqual (result, expected));
+        }
+
+        beginTest ("Reading MIDI stops at an event that doesn't fit");
+        {
+            MidiBuffer source;
+            source.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+            source.addEvent (MidiMessage::noteOn (1, 61, (uint8) 100), 1);
+            source.addEvent (MidiMessage::noteOn (1, 62, (uint8) 100), 2);
+
+            std::vector<uint8> data ((size_t) SharedAudioBlock::maxMidiBytes);
+            const auto numBytes = SharedAudioBlock::writeMidi (source, 0, 10, data.data());
+            const auto eventSize = numBytes / 3;
+
+            MidiBuffer firstOnly;
+            firstOnly.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+
+            for (auto badSize : { -1, 0, 1000 })
+            {
+                auto corrupted = data;
+                writeUnaligned<int32> (corrupted.data() + eventSize + sizeof (int32), badSize);
+
+                MidiBuffer result;
+                SharedAudioBlock::readMidi (corrupted.data(), numBytes, result, 0);
+                expect (areEqual (result, firstOnly));
+            }
+
+            // The last event's data is cut short, but only the padding after it is optional
+            for (auto [numBytesToRead, numEventsExpected] : { std::pair { numBytes - 1, 3 }, std::pair { numBytes - 2, 2 } })
+            {
+                MidiBuffer result;
+                SharedAudioBlock::readMidi (data.data(), numBytesToRead, result, 0);
+                expectEquals (result.getNumEvents(), numEventsExpected);
+            }
+        }
+
+        beginTest ("Transport info survives a round trip");
+        {
+            TestPlayHead playHead;
+            SharedAudioBlock::Header header;
+
+            SharedAudioBlock::writeTransport (header, nullptr);
+            expect (! SharedAudioBlock::readTransport (header).hasValue());
+
+            SharedAudioBlock::writeTransport (header, &playHead);
+            expect (! SharedAudioBlock::readTransport (header).hasValue());
+
+            AudioPlayHead::PositionInfo full;
+            full.setIsPlaying (true);
+            full.setIsLooping (true);
+            full.setTimeInSamples (123456789);
+            full.setTimeInSeconds (2.5);
+            full.setBpm (97.5);
+            full.setPpqPosition (33.25);
+            full.setPpqPositionOfLastBarStart (32.0);
+            full.setTimeSignature (AudioPlayHead::TimeSignature { 7, 8 });
+
+            AudioPlayHead::PositionInfo partial;
+            partial.setIsRecording (true);
+            partial.setBpm (120.0);
+
+            for (const auto& position : { full, partial, AudioPlayHead::PositionInfo{} })
+            {
+                playHead.position = position;
+                SharedAudioBlock::writeTransport (header, &playHead);
+
+                const auto result = SharedAudioBlock::readTransport (header);
+                expect (result.hasValue() && *result == position);
+            }
+        }
+
+       #if JUCE_LINUX
+        beginTest ("A block created by one side can be opened by the other");
+        {
+            auto block = SharedAudioBlock::create (3, 256, 4);
+            expect (block != nullptr);
+
+            if (block == nullptr)
+                return;
+
+            block->getHeader().numSamples = 200;
+            block->getChannel (2)[199] = 0.5f;
+            block->getParameterChanges()[3] = { 3, 0.25f };
+            block->getMidiInput()[0] = 0x90;
+
+            auto other = SharedAudioBlock::open (block->getName());
+            expect (other != nullptr);
+
+            if (other == nullptr)
+                return;
+
+            expectEquals (other->getHeader().numChannels, 3);
+            expectEquals (other->getHeader().maxBlockSize, 256);
+            expectEquals (other->getHeader().numSamples, 200);
+            expectEquals (other->getChannels()[2][199], 0.5f);
+            expectEquals (other->getParameterChanges()[3].value, 0.25f);
+            expectEquals ((int) other->getMidiInput()[0], 0x90);
+
+            // Opening it removes its name
+            expect (SharedAudioBlock::open (block->getName()) == nullptr);
+        }
+       #endif
+    }
+
+    struct TestPlayHead final : public AudioPlayHead
+    {
+        Optional<PositionInfo> getPosition() const override     { return position; }
+
+        Optional<PositionInfo> position;
+    };
+
+    static bool areEqual (const MidiBuffer& a, const MidiBuffer& b)
+    {
+        if (a.getNumEvents() != b.getNumEvents())
+            return false;
+
+        return std::equal (a.begin(), a.end(), b.begin(), [] (const MidiMessageMetadata& x, const MidiMessageMetadata& y)
+        {
+            return x.samplePosition == y.samplePosition
+                && x.numBytes == y.numBytes
+                && std::memcmp (x.data, y.data, (size_t) x.numBytes) == 0;
+        });
+    }
+};
+
+static SharedAudioBlockTests sharedAudioBlockTests;
+
+#endif
+
+} // namespace juce
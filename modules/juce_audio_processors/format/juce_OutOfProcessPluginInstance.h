@@ -0,0 +1,260 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An AudioPluginInstance that loads a plugin into a separate worker process, so
+    that a plugin which crashes or hangs can't take the host down with it.
+
+    The worker is started from an executable that you provide - this can be your own
+    app, as long as its startup code hands its command line to an OutOfProcessPluginWorker.
+    If the worker dies, or stops responding for more than a few seconds, this instance
+    will just output silence from then on, and hasWorkerFailed() will return true.
+
+    Each block of audio and MIDI is passed to the worker through shared memory, and
+    the two processes wake each other up with futexes, so the extra cost per block is
+    a couple of context switches. Parameter changes, programs and state are forwarded
+    to the plugin in the worker, and its parameter values and latency are mirrored
+    back. Parameter text that hasn't been seen before is fetched in the background, so
+    getText() may briefly return a plain number until the host is told to ask again.
+    The plugin's editor isn't available through this class.
+
+    Shared memory connections are currently only supported on Linux, so on other
+    platforms create() will always fail.
+
+    @see OutOfProcessPluginWorker, AudioPluginFormatManager
+
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginInstance   : public AudioPluginInstance,
+                                               private AsyncUpdater
+{
+public:
+    /** Launches a worker process and asks it to load the given plugin.
+
+        Returns nullptr and fills in errorMessage if the worker can't be launched or
+        the plugin fails to load.
+    */
+    static std::unique_ptr<OutOfProcessPluginInstance> create (const File& workerExecutable,
+                                                               const PluginDescription& pluginDescription,
+                                                               double initialSampleRate,
+                                                               int initialBufferSize,
+                                                               String& errorMessage);
+
+    /** Destructor. This kills the worker process. */
+    ~OutOfProcessPluginInstance() override;
+
+    //==============================================================================
+    /** Timing information about the blocks that have been sent to the worker. */
+    struct Statistics
+    {
+        int64 numBlocks = 0;                /**< The number of blocks that the worker has processed. */
+        int64 numMissedBlocks = 0;          /**< The number of blocks that were replaced by silence because the worker was late or had failed. */
+        double averageRoundTripMs = 0;      /**< The average time between handing a block to the worker and getting it back. */
+        double maxRoundTripMs = 0;          /**< The longest round trip. */
+        double averageProcessingMs = 0;     /**< The average time spent inside the plugin's processBlock() in the worker. */
+        double workerCpuLoad = 0;           /**< The CPU time used by the whole worker process, as a proportion of the real time that has elapsed. */
+    };
+
+    /** Returns the timings gathered since the instance was created, or since the last call to resetStatistics(). */
+    Statistics getStatistics() const;
+
+    /** Clears the statistics. */
+    void resetStatistics();
+
+    /** Sets how long processBlock() will wait for the worker to return a block before giving
+        up and outputting silence for it. By default this is the duration of the block itself.
+    */
+    void setProcessTimeout (double milliseconds) noexcept;
+
+    /** Returns true if the worker process has crashed, disconnected or stopped responding. */
+    bool hasWorkerFailed() const noexcept;
+
+    //==============================================================================
+    /** @internal */
+    void fillInPluginDescription (PluginDescription&) const override;
+    /** @internal */
+    const String getName() const override;
+    /** @internal */
+    bool isBusesLayoutSupported (const BusesLayout&) const override;
+    /** @internal */
+    void prepareToPlay (double sampleRate, int maximumExpectedSamplesPerBlock) override;
+    /** @internal */
+    void releaseResources() override;
+    /** @internal */
+    void processBlock (AudioBuffer<float>&, MidiBuffer&) override;
+    using AudioProcessor::processBlock;
+    /** @internal */
+    void reset() override;
+    /** @internal */
+    void setNonRealtime (bool isNonRealtime) noexcept override;
+    /** @internal */
+    double getTailLengthSeconds() const override;
+    /** @internal */
+    bool acceptsMidi() const override;
+    /** @internal */
+    bool producesMidi() const override;
+    /** @internal */
+    bool isMidiEffect() const override;
+    /** @internal */
+    bool hasEditor() const override                 { return false; }
+    /** @internal */
+    AudioProcessorEditor* createEditor() override   { return nullptr; }
+    /** @internal */
+    int getNumPrograms() override;
+    /** @internal */
+    int getCurrentProgram() override;
+    /** @internal */
+    void setCurrentProgram (int) override;
+    /** @internal */
+    const String getProgramName (int) override;
+    /** @internal */
+    void changeProgramName (int, const String&) override {}
+    /** @internal */
+    void getStateInformation (MemoryBlock&) override;
+    /** @internal */
+    void getCurrentProgramStateInformation (MemoryBlock&) override;
+    /** @internal */
+    void setStateInformation (const void*, int) override;
+    /** @internal */
+    void setCurrentProgramStateInformation (const void*, int) override;
+
+private:
+    //==============================================================================
+    class Coordinator;
+    class RemoteParameter;
+    class SharedAudioBlock;
+    struct ParameterValues;
+    struct PluginInfo;
+    friend class OutOfProcessPluginWorker;
+    friend class OutOfProcessPluginScanner;
+    friend struct SharedAudioBlockTests;
+
+    OutOfProcessPluginInstance (std::unique_ptr<Coordinator>, const PluginInfo&);
+
+    void handleAsyncUpdate() override;
+    void handleMessageFromWorker (const MemoryBlock&);
+    void workerFailed();
+    void sendPendingParameterChanges();
+    void requestParameterText (int index, float value);
+    float getParameterValueForText (int index, const String& text);
+    bool processChunk (AudioBuffer<float>&, int startSample, int numSamples, const MidiBuffer& midiIn, MidiBuffer& midiOut);
+    void getState (MemoryBlock&, bool currentProgramOnly);
+    void setState (const void*, int, bool currentProgramOnly);
+
+    std::unique_ptr<Coordinator> coordinator;
+    std::unique_ptr<SharedAudioBlock> audioBlock;
+    const BusesLayout layout;
+    PluginDescription description;
+    std::unique_ptr<ParameterValues> parameterValues;
+    MidiBuffer midiOutput;
+
+    const double tailLengthSeconds;
+    const bool pluginAcceptsMidi, pluginProducesMidi, pluginIsMidiEffect;
+    StringArray programNames;
+    std::atomic<int> currentProgram { 0 }, pendingLatency { -1 };
+    std::atomic<bool> failed { false }, prepared { false }, pendingProgramChange { false }, pendingParameterInfoChange { false };
+    std::atomic<double> processTimeoutMs { -1.0 };
+    int64 lastResponseTicks = 0;
+
+    std::atomic<int64> numBlocks { 0 }, numMissedBlocks { 0 }, totalRoundTripTicks { 0 }, maxRoundTripTicks { 0 },
+                       totalProcessingNanoseconds { 0 }, workerCpuNanoseconds { 0 }, workerCpuNanosecondsAtReset { 0 },
+                       statisticsResetTicks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginInstance)
+};
+
+//==============================================================================
+/**
+    Hosts plugins on behalf of OutOfProcessPluginInstance objects in another process,
+    and scans plugin files for an OutOfProcessPluginScanner.
+
+    Create one of these in the startup code of the executable that you pass to
+    OutOfProcessPluginInstance::create() or OutOfProcessPluginScanner, and call
+    initialiseFromCommandLine(). If that returns true, the process was launched as a
+    worker, and should keep its message loop running until the host disconnects, at
+    which point onConnectionLost is called.
+
+    @code
+    void initialise (const String& commandLine) override
+    {
+        formatManager.addDefaultFormats();
+        pluginWorker = std::make_unique<OutOfProcessPluginWorker> (formatManager);
+
+        if (pluginWorker->initialiseFromCommandLine (commandLine))
+            return;
+
+        // ..otherwise carry on starting up the app normally
+    }
+    @endcode
+
+    @see OutOfProcessPluginInstance, OutOfProcessPluginScanner
+
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginWorker
+{
+public:
+    /** Creates a worker that will use the given formats to load plugins. The format
+        manager must outlive this object.
+    */
+    explicit OutOfProcessPluginWorker (AudioPluginFormatManager& formatsToUse);
+
+    /** Destructor. */
+    ~OutOfProcessPluginWorker();
+
+    /** Checks whether the command line was generated by OutOfProcessPluginInstance::create()
+        or an OutOfProcessPluginScanner, and if so, connects to the host process that launched it.
+
+        Returns true if this process is a worker and the connection was made.
+    */
+    bool initialiseFromCommandLine (const String& commandLine);
+
+    /** Called on the message thread when the host process disconnects or dies. If this
+        isn't set, JUCEApplicationBase::quit() will be called instead.
+    */
+    std::function<void()> onConnectionLost;
+
+private:
+    class Implementation;
+    AudioPluginFormatManager& formatManager;
+    std::unique_ptr<Implementation> implementation;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginWorker)
+};
+
+} // namespace juce
@@ -882,11 +882,8 @@ private:
 
 enum class Realtime { no, yes };
 
-// Must be trivial!
 struct WorkResponder
 {
-    static WorkResponder getDefault() { return { nullptr, nullptr }; }
-
     LV2_Worker_Status processResponse (uint32_t size, const void* data) const
     {
         return worker->work_response (handle, size, data);
@@ -926,11 +923,8 @@ struct RespondHandle
     Realtime realtime;
 };
 
-// Must be trivial!
 struct WorkSubmitter
 {
-    static WorkSubmitter getDefault() { return { nullptr, nullptr, nullptr, nullptr }; }
-
     LV2_Worker_Status doWork (Realtime realtime, uint32_t size, const void* data) const
     {
         // The Worker spec says that the host "MUST NOT make concurrent calls to [work] from
@@ -963,87 +957,77 @@ static auto toChars (Trivial value)
     return result;
 }
 
-template <typename Context>
+/*
+    A queue of variable-sized messages, which may be written by one thread and read by
+    another without locking. All of the storage is allocated up-front, so neither end
+    will allocate, as long as the buffer passed to pop() has enough capacity.
+*/
 class WorkQueue
 {
 public:
-    static_assert (std::is_trivial_v<Context>, "Context must be copyable as bytes");
-
     explicit WorkQueue (int size)
         : fifo (size), data (static_cast<size_t> (size)) {}
 
-    LV2_Worker_Status push (Context context, size_t size, const void* contents)
+    LV2_Worker_Status push (uint32_t size, const void* contents)
     {
-        const auto* bytes = static_cast<const char*> (contents);
-        const auto numToWrite = sizeof (Header) + size;
-
-        if (static_cast<size_t> (fifo.getFreeSpace()) < numToWrite)
+        if (size >= data.size())
             return LV2_WORKER_ERR_NO_SPACE;
 
-        Header header { size, context };
-        const auto headerBuffer = toChars (header);
+        const auto numToWrite = static_cast<int> (sizeof (size) + size);
 
-        const auto scope = fifo.write (static_cast<int> (numToWrite));
-        jassert (scope.blockSize1 + scope.blockSize2 == static_cast<int> (numToWrite));
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numToWrite, start1, size1, start2, size2);
 
-        size_t index = 0;
-        scope.forEach ([&] (int i)
-        {
-            data[static_cast<size_t> (i)] = index < headerBuffer.size() ? headerBuffer[index]
-                                                                        : bytes[index - headerBuffer.size()];
-            ++index;
-        });
+        if (size1 + size2 < numToWrite)
+            return LV2_WORKER_ERR_NO_SPACE;
 
+        copyIn (start1, &size, sizeof (size));
+        copyIn (start1 + (int) sizeof (size), contents, size);
+
+        // The header and body become visible to the reader together
+        fifo.finishedWrite (numToWrite);
         return LV2_WORKER_SUCCESS;
     }
 
-    Context pop (std::vector<char>& dest)
+    bool pop (std::vector<char>& dest)
     {
-        // If the vector is too small we'll have to resize it on the audio thread
-        jassert (dest.capacity() >= data.size());
-        dest.clear();
-
-        const auto numReady = fifo.getNumReady();
-
-        if (static_cast<size_t> (numReady) < sizeof (Header))
-        {
-            jassert (numReady == 0);
-            return Context::getDefault();
-        }
-
-        std::array<char, sizeof (Header)> headerBuffer;
-
-        {
-            size_t index = 0;
-            fifo.read (sizeof (Header)).forEach ([&] (int i)
-            {
-                headerBuffer[index++] = data[static_cast<size_t> (i)];
-            });
-        }
+        int start1, size1, start2, size2;
+        fifo.prepareToRead ((int) sizeof (uint32_t), start1, size1, start2, size2);
 
-        const auto header = readUnaligned<Header> (headerBuffer.data());
+        if (size1 + size2 < (int) sizeof (uint32_t))
+            return false;
 
-        jassert (static_cast<size_t> (fifo.getNumReady()) >= header.size);
+        uint32_t size = 0;
+        copyOut (start1, &size, sizeof (size));
 
-        dest.resize (header.size);
+        jassert ((size_t) fifo.getNumReady() >= sizeof (size) + size);
 
-        {
-            size_t index = 0;
-            fifo.read (static_cast<int> (header.size)).forEach ([&] (int i)
-            {
-                dest[index++] = data[static_cast<size_t> (i)];
-            });
-        }
+        // If the vector is too small we'll have to resize it on the audio thread
+        jassert (dest.capacity() >= size);
+        dest.resize (size);
 
-        return header.context;
+        copyOut (start1 + (int) sizeof (size), dest.data(), size);
+        fifo.finishedRead ((int) (sizeof (size) + size));
+        return true;
     }
 
 private:
-    struct Header
+    // The fifo hands out regions that may wrap around the end of the buffer
+    void copyIn (int index, const void* source, size_t numBytes)
     {
-        size_t size;
-        Context context;
-    };
+        const auto start = (size_t) index % data.size();
+        const auto numBeforeEnd = jmin (numBytes, data.size() - start);
+        std::memcpy (data.data() + start, source, numBeforeEnd);
+        std::memcpy (data.data(), static_cast<const char*> (source) + numBeforeEnd, numBytes - numBeforeEnd);
+    }
+
+    void copyOut (int index, void* dest, size_t numBytes) const
+    {
+        const auto start = (size_t) index % data.size();
+        const auto numBeforeEnd = jmin (numBytes, data.size() - start);
+        std::memcpy (dest, data.data() + start, numBeforeEnd);
+        std::memcpy (static_cast<char*> (dest) + numBeforeEnd, data.data(), numBytes - numBeforeEnd);
+    }
 
     AbstractFifo fifo;
     std::vector<char> data;
@@ -1051,41 +1035,51 @@ private:
     JUCE_LEAK_DETECTOR (WorkQueue)
 };
 
+class WorkScheduler;
+
 /*
-    Keeps track of active plugin instances, so that we can avoid sending work
-    messages to dead plugins.
+    A thread that does the realtime work for all of the active plugin instances.
+
+    Each WorkScheduler has its own queues, so the audio thread never has to take a lock
+    to schedule work or to collect responses. The list of schedulers is only touched by
+    this thread and by the thread that creates and destroys plugin instances, and this
+    thread only locks it to pick the next scheduler, so a plugin that takes a long time
+    over its work won't hold up the creation or destruction of other instances.
 */
-class HandleRegistry
+class SharedThreadedWorker
 {
 public:
-    void insert (LV2_Handle handle)
+    ~SharedThreadedWorker() noexcept
     {
-        const SpinLock::ScopedLockType lock (mutex);
-        handles.insert (handle);
+        shouldExit = true;
+        thread.join();
     }
 
-    void erase (LV2_Handle handle)
+    void addScheduler (WorkScheduler& scheduler)
     {
-        const SpinLock::ScopedLockType lock (mutex);
-        handles.erase (handle);
+        const ScopedLock lock (mutex);
+        schedulers.insert (&scheduler);
     }
 
-    template <typename Fn>
-    LV2_Worker_Status ifContains (LV2_Handle handle, Fn&& callback)
-    {
-        const SpinLock::ScopedLockType lock (mutex);
+    // Once this returns, the worker won't call into the scheduler's plugin again
+    void removeScheduler (WorkScheduler&);
 
-        if (handles.find (handle) != handles.cend())
-            return callback();
+private:
+    void run();
 
-        return LV2_WORKER_ERR_UNKNOWN;
-    }
+    CriticalSection mutex;
+    std::set<WorkScheduler*> schedulers;
+    std::atomic<bool> shouldExit { false };
+    std::thread thread { [this] { run(); } };
 
-private:
-    std::set<LV2_Handle> handles;
-    SpinLock mutex;
+    JUCE_LEAK_DETECTOR (SharedThreadedWorker)
+};
 
-    JUCE_LEAK_DETECTOR (HandleRegistry)
+struct HandleHolder
+{
+    virtual ~HandleHolder() = default;
+    virtual LV2_Handle getHandle() const = 0;
+    virtual const LV2_Worker_Interface* getWorkerInterface() const = 0;
 };
 
 /*
@@ -1096,112 +1090,66 @@ private:
     returns garbage, so make sure to check that the plugin `hasExtensionData` before
     constructing one of these!
 */
-class SharedThreadedWorker final : public WorkerResponseListener
+class WorkScheduler final : private WorkerResponseListener
 {
 public:
-    ~SharedThreadedWorker() noexcept override
-    {
-        shouldExit = true;
-        thread.join();
-    }
-
-    LV2_Worker_Status schedule (WorkSubmitter submitter,
-                                uint32_t size,
-                                const void* data)
-    {
-        return registry.ifContains (submitter.handle, [&]
-        {
-            return incoming.push (submitter, size, data);
-        });
-    }
-
-    LV2_Worker_Status responseGenerated (WorkResponder responder,
-                                         uint32_t size,
-                                         const void* data) override
-    {
-        return registry.ifContains (responder.handle, [&]
-        {
-            return outgoing.push (responder, size, data);
-        });
-    }
+    explicit WorkScheduler (HandleHolder& handleHolderIn)
+        : handleHolder (handleHolderIn) {}
 
+    // Called on the audio thread after each run(), to pass the worker's responses to the plugin
     void processResponses()
     {
-        for (;;)
-        {
-            auto workerResponder = outgoing.pop (message);
+        const WorkResponder responder { handleHolder.getHandle(), handleHolder.getWorkerInterface() };
 
-            if (! message.empty() && workerResponder.isValid())
-                workerResponder.processResponse (static_cast<uint32_t> (message.size()), message.data());
-            else
-                break;
-        }
+        while (outgoing.pop (response))
+            if (responder.isValid())
+                responder.processResponse (static_cast<uint32_t> (response.size()), response.data());
     }
 
-    void registerHandle   (LV2_Handle handle) { registry.insert (handle); }
-    void deregisterHandle (LV2_Handle handle) { registry.erase  (handle); }
-
-private:
-    static constexpr auto queueSize = 8192;
-    std::atomic<bool> shouldExit { false };
-    WorkQueue<WorkSubmitter> incoming { queueSize };
-    WorkQueue<WorkResponder> outgoing { queueSize };
-    std::vector<char> message = std::vector<char> (queueSize);
-    std::thread thread { [this]
+    // Called on the worker thread. Returns true if there was any work to do.
+    bool doNextPieceOfWork (std::vector<char>& buffer)
     {
-        std::vector<char> buffer (queueSize);
-
-        while (! shouldExit)
-        {
-            const auto submitter = incoming.pop (buffer);
-
-            if (! buffer.empty() && submitter.isValid())
-                submitter.doWork (Realtime::yes, (uint32_t) buffer.size(), buffer.data());
-            else
-                std::this_thread::sleep_for (std::chrono::milliseconds (1));
-        }
-    } };
-    HandleRegistry registry;
+        if (! incoming.pop (buffer))
+            return false;
 
-    JUCE_LEAK_DETECTOR (SharedThreadedWorker)
-};
+        const auto submitter = createSubmitter();
 
-struct HandleHolder
-{
-    virtual ~HandleHolder() = default;
-    virtual LV2_Handle getHandle() const = 0;
-    virtual const LV2_Worker_Interface* getWorkerInterface() const = 0;
-};
+        if (submitter.isValid())
+            submitter.doWork (Realtime::yes, static_cast<uint32_t> (buffer.size()), buffer.data());
 
-class WorkScheduler
-{
-public:
-    explicit WorkScheduler (HandleHolder& handleHolderIn)
-        : handleHolder (handleHolderIn) {}
-
-    void processResponses() { workerThread->processResponses(); }
+        return true;
+    }
 
     LV2_Worker_Schedule& getWorkerSchedule() { return schedule; }
 
     void setNonRealtime (bool nonRealtime) { realtime = ! nonRealtime; }
 
-    void registerHandle   (LV2_Handle handle) { workerThread->registerHandle   (handle); }
-    void deregisterHandle (LV2_Handle handle) { workerThread->deregisterHandle (handle); }
+    void startWorker() { workerThread->addScheduler    (*this); }
+    void stopWorker()  { workerThread->removeScheduler (*this); }
+
+    static constexpr auto queueSize = 8192;
 
 private:
-    LV2_Worker_Status scheduleWork (uint32_t size, const void* data)
+    friend class SharedThreadedWorker;
+
+    WorkSubmitter createSubmitter()
     {
-        WorkSubmitter submitter { handleHolder.getHandle(),
-                                  handleHolder.getWorkerInterface(),
-                                  workerThread,
-                                  &workMutex };
+        return { handleHolder.getHandle(), handleHolder.getWorkerInterface(), this, &workMutex };
+    }
 
+    LV2_Worker_Status responseGenerated (WorkResponder, uint32_t size, const void* data) override
+    {
+        return outgoing.push (size, data);
+    }
+
+    LV2_Worker_Status scheduleWork (uint32_t size, const void* data)
+    {
         // If we're in realtime mode, the work should go onto a background thread,
         // and we'll process it later.
         // If we're offline, we can just do the work immediately, without worrying about
         // drop-outs
-        return realtime ? workerThread->schedule (submitter, size, data)
-                        : submitter.doWork (Realtime::no, size, data);
+        return realtime ? incoming.push (size, data)
+                        : createSubmitter().doWork (Realtime::no, size, data);
     }
 
     static LV2_Worker_Status scheduleWork (LV2_Worker_Schedule_Handle handle,
@@ -1211,15 +1159,67 @@ private:
         return static_cast<WorkScheduler*> (handle)->scheduleWork (size, data);
     }
 
-    SharedResourcePointer<SharedThreadedWorker> workerThread;
     HandleHolder& handleHolder;
+    WorkQueue incoming { queueSize }, outgoing { queueSize };
+    std::vector<char> response = std::vector<char> (queueSize);
+    SharedResourcePointer<SharedThreadedWorker> workerThread;
     LV2_Worker_Schedule schedule { this, scheduleWork };
     CriticalSection workMutex;
-    bool realtime = true;
+    CriticalSection workerThreadLock; // held by the worker thread while it's using this scheduler
+    std::atomic<bool> realtime { true };
 
     JUCE_LEAK_DETECTOR (WorkScheduler)
 };
 
+void SharedThreadedWorker::removeScheduler (WorkScheduler& scheduler)
+{
+    {
+        const ScopedLock lock (mutex);
+        schedulers.erase (&scheduler);
+    }
+
+    // Wait for any work that the thread had already started for this scheduler
+    const ScopedLock lock (scheduler.workerThreadLock);
+}
+
+void SharedThreadedWorker::run()
+{
+    std::vector<char> buffer (WorkScheduler::queueSize);
+
+    while (! shouldExit)
+    {
+        auto didWork = false;
+
+        // Take one piece of work from each plugin in turn, so that one busy plugin
+        // can't hold up the others
+        for (WorkScheduler* previous = nullptr;;)
+        {
+            WorkScheduler* scheduler = nullptr;
+
+            {
+                const ScopedLock lock (mutex);
+                const auto next = previous == nullptr ? schedulers.begin()
+                                                      : schedulers.upper_bound (previous);
+
+                if (next == schedulers.end())
+                    break;
+
+                // This is taken before the list is unlocked, so that removeScheduler() can't
+                // return between the scheduler being chosen and its work starting
+                scheduler = *next;
+                scheduler->workerThreadLock.enter();
+            }
+
+            didWork = scheduler->doNextPieceOfWork (buffer) || didWork;
+            scheduler->workerThreadLock.exit();
+            previous = scheduler;
+        }
+
+        if (! didWork)
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+}
+
 struct FeaturesDataListener
 {
     virtual ~FeaturesDataListener() = default;
@@ -1268,7 +1268,7 @@ public:
 
     int32_t getMaxBlockSize() const noexcept { return maxBlockSize; }
 
-    void setNonRealtime (bool newValue) { realtime = ! newValue; }
+    void setNonRealtime (bool newValue) { workScheduler.setNonRealtime (newValue); }
 
     const LV2_Feature* const* getFeatureArray() const noexcept { return features.pointers.data(); }
 
@@ -1279,8 +1279,8 @@ public:
 
     void processResponses() { workScheduler.processResponses(); }
 
-    void registerHandle   (LV2_Handle handle) { workScheduler.registerHandle   (handle); }
-    void deregisterHandle (LV2_Handle handle) { workScheduler.deregisterHandle (handle); }
+    void startWorker() { workScheduler.startWorker(); }
+    void stopWorker()  { workScheduler.stopWorker(); }
 
 private:
     static std::vector<LV2_Feature> makeFeatures (LV2_URID_Map* map,
@@ -1338,8 +1338,6 @@ private:
                                       &resize.getFeature(),
                                       log.getLogFeature()) };
 
-    bool realtime = true;
-
     JUCE_LEAK_DETECTOR (FeaturesData)
 };
 
@@ -2029,13 +2027,13 @@ public:
         for (auto& port : ports.getAudioPorts())
             instance.connectPort (port.header.index, nullptr);
 
-        features.registerHandle (instance.getHandle());
+        features.startWorker();
     }
 
     ~InstanceWithSupports() override
     {
         if (instance != nullptr)
-            features.deregisterHandle (instance.getHandle());
+            features.stopWorker();
     }
 
     std::unique_ptr<SymbolMap> symap;
@@ -4353,6 +4351,43 @@ public:
 };
 
 //==============================================================================
+/*  Accumulates the time that an instance spends inside the plugin, and in the host code
+    that moves data to and from the plugin's ports. This is written on the audio thread
+    and may be read from any thread.
+*/
+class ProcessingTimer
+{
+public:
+    void addBlock (int64 ticksInPlugin, int64 ticksInHost) noexcept
+    {
+        numBlocks.fetch_add (1, std::memory_order_relaxed);
+        totalTicksInPlugin.fetch_add (ticksInPlugin, std::memory_order_relaxed);
+        totalTicksInHost.fetch_add (ticksInHost, std::memory_order_relaxed);
+
+        if (ticksInPlugin > maxTicksInPlugin.load (std::memory_order_relaxed))
+            maxTicksInPlugin.store (ticksInPlugin, std::memory_order_relaxed);
+    }
+
+    ExtensionsVisitor::LV2Client::ProcessingTimes getTimes() const noexcept
+    {
+        ExtensionsVisitor::LV2Client::ProcessingTimes times;
+        times.numBlocks       = numBlocks.load (std::memory_order_relaxed);
+        times.timeInPlugin    = Time::highResolutionTicksToSeconds (totalTicksInPlugin.load (std::memory_order_relaxed));
+        times.timeInHost      = Time::highResolutionTicksToSeconds (totalTicksInHost.load (std::memory_order_relaxed));
+        times.maxTimeInPlugin = Time::highResolutionTicksToSeconds (maxTicksInPlugin.load (std::memory_order_relaxed));
+        return times;
+    }
+
+    void reset() noexcept
+    {
+        for (auto* value : { &numBlocks, &totalTicksInPlugin, &totalTicksInHost, &maxTicksInPlugin })
+            value->store (0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int64> numBlocks { 0 }, totalTicksInPlugin { 0 }, totalTicksInHost { 0 }, maxTicksInPlugin { 0 };
+};
+
 class LV2AudioPluginInstance final : public AudioPluginInstance,
                                      private TouchListener,
                                      private EditorListener,
@@ -4572,6 +4607,22 @@ public:
 
     AudioProcessorParameter* getBypassParameter() const override { return bypassParam; }
 
+    void getExtensions (ExtensionsVisitor& visitor) const override
+    {
+        struct Extensions final : public ExtensionsVisitor::LV2Client
+        {
+            explicit Extensions (const LV2AudioPluginInstance* instanceIn) : instance (instanceIn) {}
+
+            ProcessingTimes getProcessingTimes() const override { return instance->processingTimer.getTimes(); }
+            void resetProcessingTimes() const override          { instance->processingTimer.reset(); }
+
+            const LV2AudioPluginInstance* instance = nullptr;
+        };
+
+        Extensions extensions { this };
+        visitor.visitLV2Client (extensions);
+    }
+
 private:
     enum class ConcurrentWithAudioCallback { no, yes };
 
@@ -4641,12 +4692,21 @@ private:
 
     void processBlockImpl (AudioBuffer<float>& audio, MidiBuffer& midi)
     {
+        const auto startTicks = Time::getHighResolutionTicks();
+
         preparePortsForRun (audio, midi);
 
+        const auto runStartTicks = Time::getHighResolutionTicks();
+
         instance->instance.run (static_cast<uint32_t> (audio.getNumSamples()));
         instance->features.processResponses();
 
+        const auto runEndTicks = Time::getHighResolutionTicks();
+
         processPortsAfterRun (midi);
+
+        processingTimer.addBlock (runEndTicks - runStartTicks,
+                                  (runStartTicks - startTicks) + (Time::getHighResolutionTicks() - runEndTicks));
     }
 
     bool portAtIndexSupportsMidi (uint32_t index) const noexcept
@@ -4943,12 +5003,16 @@ private:
         // http://lv2plug.in/ns/ext/atom#Sequence - run() stamps are always audio frames
         jassert (sequence->body.unit == 0 || sequence->body.unit == instance->urids.mLV2_UNITS__frame);
 
+        auto* listener = uiEventListener.load();
+
         for (const auto* event : lv2_shared::SequenceIterator { lv2_shared::SequenceWithSize { sequence } })
         {
-            // At the moment, we forward all outgoing events to the UI.
-            instance->processorToUi->pushMessage ({ uiEventListener, { port.header.index, instance->urids.mLV2_ATOM__eventTransfer } },
-                                                  (uint32_t) (event->body.size + sizeof (LV2_Atom)),
-                                                  &event->body);
+            // At the moment, we forward all outgoing events to the UI, if there is one.
+            // The queue is shared by all instances, so don't fill it with messages nobody will read.
+            if (listener != nullptr)
+                instance->processorToUi->pushMessage ({ listener, { port.header.index, instance->urids.mLV2_ATOM__eventTransfer } },
+                                                      (uint32_t) (event->body.size + sizeof (LV2_Atom)),
+                                                      &event->body);
 
             if (event->body.type == instance->urids.mLV2_MIDI__MidiEvent)
                 midi.addEvent (event + 1, static_cast<int> (event->body.size), static_cast<int> (event->time.frames));
@@ -5174,6 +5238,7 @@ private:
     int lastAppliedPreset = 0;
     bool hasThreadSafeRestore = plugin.hasExtensionData (world->newUri (LV2_STATE__threadSafeRestore));
     bool active { false };
+    mutable ProcessingTimer processingTimer;
 
     JUCE_LEAK_DETECTOR (LV2AudioPluginInstance)
 };
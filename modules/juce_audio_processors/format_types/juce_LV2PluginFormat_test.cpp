@@ -273,6 +273,101 @@ public:
                                                          { "", { SinglePortInfo { 0, AudioChannelSet::leftSurround,  true } } },
                                                          { "", { SinglePortInfo { 2, AudioChannelSet::left,          true } } } });
         }
+
+        beginTest ("WorkQueue delivers messages intact when they wrap around the end of its buffer");
+        {
+            lv2_host::WorkQueue queue (32);
+            std::vector<char> received;
+            received.reserve (32);
+
+            for (int i = 0; i < 100; ++i)
+            {
+                std::vector<char> sent ((size_t) (1 + i % 11));
+                std::iota (sent.begin(), sent.end(), (char) i);
+
+                expect (queue.push ((uint32_t) sent.size(), sent.data()) == LV2_WORKER_SUCCESS);
+                expect (queue.pop (received));
+                expect (received == sent);
+            }
+
+            expect (! queue.pop (received));
+        }
+
+        beginTest ("WorkQueue rejects messages that don't fit");
+        {
+            lv2_host::WorkQueue queue (16);
+            std::vector<char> received;
+            received.reserve (16);
+
+            const std::array<char, 8> small {};
+            const std::array<char, 20> large {};
+
+            expect (queue.push ((uint32_t) large.size(), large.data()) == LV2_WORKER_ERR_NO_SPACE);
+            expect (queue.push ((uint32_t) small.size(), small.data()) == LV2_WORKER_SUCCESS);
+            expect (queue.push ((uint32_t) small.size(), small.data()) == LV2_WORKER_ERR_NO_SPACE);
+
+            expect (queue.pop (received) && received.size() == small.size());
+            expect (! queue.pop (received));
+        }
+
+        beginTest ("The shared worker thread doesn't block other instances while one is working");
+        {
+            WorkerPlugin slowPlugin, fastPlugin;
+            fastPlugin.release.signal();
+
+            lv2_host::WorkScheduler slow { slowPlugin }, fast { fastPlugin };
+            slow.startWorker();
+            expect (scheduleWork (slow) == LV2_WORKER_SUCCESS);
+            expect (slowPlugin.started.wait (5000));
+
+            WaitableEvent added, removed;
+            std::thread adder ([&] { fast.startWorker(); added.signal(); });
+            std::thread remover ([&] { slow.stopWorker(); removed.signal(); });
+
+            expect (added.wait (5000));
+
+            // Removing an instance has to wait for the work that it's in the middle of
+            expect (! removed.wait (100));
+            slowPlugin.release.signal();
+            expect (removed.wait (5000));
+
+            expect (scheduleWork (fast) == LV2_WORKER_SUCCESS);
+            expect (fastPlugin.started.wait (5000));
+            fast.stopWorker();
+
+            adder.join();
+            remover.join();
+
+            expectEquals (slowPlugin.numWorkCalls.load(), 1);
+            expectEquals (fastPlugin.numWorkCalls.load(), 1);
+        }
+    }
+
+private:
+    struct WorkerPlugin final : public lv2_host::HandleHolder
+    {
+        LV2_Handle getHandle() const override                               { return const_cast<WorkerPlugin*> (this); }
+        const LV2_Worker_Interface* getWorkerInterface() const override    { return &workerInterface; }
+
+        static LV2_Worker_Status work (LV2_Handle handle, LV2_Worker_Respond_Function, LV2_Worker_Respond_Handle, uint32_t, const void*)
+        {
+            auto& plugin = *static_cast<WorkerPlugin*> (handle);
+            plugin.started.signal();
+            plugin.release.wait();
+            ++plugin.numWorkCalls;
+            return LV2_WORKER_SUCCESS;
+        }
+
+        LV2_Worker_Interface workerInterface { work, nullptr, nullptr };
+        WaitableEvent started, release { true };
+        std::atomic<int> numWorkCalls { 0 };
+    };
+
+    static LV2_Worker_Status scheduleWork (lv2_host::WorkScheduler& scheduler)
+    {
+        const char data = 0;
+        auto& schedule = scheduler.getWorkerSchedule();
+        return schedule.schedule_work (schedule.handle, sizeof (data), &data);
     }
 };
 
@@ -1039,6 +1039,8 @@ struct DescriptionLister
 {
     static std::vector<PluginDescription> tryLoadFast (const File& file, const File& moduleinfo)
     {
+        // The moduleinfo's age isn't compared with the binary's, because code-signing rewrites
+        // the binary after the moduleinfo has been generated, so signed plugins always look stale
         if (! moduleinfo.existsAsFile())
             return {};
 
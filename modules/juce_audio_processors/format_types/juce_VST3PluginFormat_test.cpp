@@ -667,6 +667,48 @@ public:
             expect (queue.getPointCount() == 0);
             expect (storage.size() == 1);
         }
+
+        beginTest ("moduleinfo.json is still used when the binary has been modified since, e.g. by code-signing");
+        {
+            const auto bundle = File::createTempFile (".vst3");
+            const ScopeGuard deleteBundle { [&] { bundle.deleteRecursively(); } };
+
+            const auto binary = bundle.getChildFile ("Contents/x86_64-linux/Test.so");
+            const auto signature = bundle.getChildFile ("Contents/_CodeSignature/CodeResources");
+            const auto moduleinfo = bundle.getChildFile ("Contents/Resources/moduleinfo.json");
+
+            for (const auto& f : { binary, signature, moduleinfo })
+                expect (f.create().wasOk());
+
+            expect (moduleinfo.replaceWithText (R"({
+                "Name": "Test",
+                "Version": "1.0.0",
+                "Factory Info": { "Vendor": "JUCE", "URL": "", "E-Mail": "", "Flags": { "Unicode": true } },
+                "Classes": [ { "CID": "0123456789ABCDEF0123456789ABCDEF",
+                               "Category": "Audio Module Class",
+                               "Name": "Test Plugin",
+                               "Vendor": "JUCE",
+                               "Version": "1.0.0",
+                               "SDKVersion": "VST 3.7.12",
+                               "Sub Categories": [ "Fx" ],
+                               "Class Flags": 0,
+                               "Cardinality": 2147483647 } ]
+            })"));
+
+            const auto infoTime = Time::getCurrentTime() - RelativeTime::hours (1.0);
+            expect (moduleinfo.setLastModificationTime (infoTime));
+            expect (binary.setLastModificationTime (infoTime + RelativeTime::minutes (10.0)));
+            expect (signature.setLastModificationTime (infoTime + RelativeTime::minutes (10.0)));
+
+            const auto descriptions = DescriptionLister::findDescriptionsFast (bundle);
+            expect (descriptions.size() == 1);
+
+            if (! descriptions.empty())
+            {
+                expectEquals (descriptions.front().name, String ("Test Plugin"));
+                expectEquals (descriptions.front().manufacturerName, String ("JUCE"));
+            }
+        }
     }
 
 private:
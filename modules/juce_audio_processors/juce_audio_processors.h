@@ -158,6 +158,7 @@
 #include "processors/juce_GenericAudioProcessorEditor.h"
 #include "format/juce_AudioPluginFormat.h"
 #include "format/juce_AudioPluginFormatManager.h"
+#include "format/juce_OutOfProcessPluginInstance.h"
 #include "scanning/juce_KnownPluginList.h"
 #include "format_types/juce_AudioUnitPluginFormat.h"
 #include "format_types/juce_LADSPAPluginFormat.h"
@@ -167,6 +168,7 @@
 #include "format_types/juce_VSTPluginFormat.h"
 #include "format_types/juce_ARAHosting.h"
 #include "scanning/juce_PluginDirectoryScanner.h"
+#include "scanning/juce_OutOfProcessPluginScanner.h"
 #include "scanning/juce_PluginListComponent.h"
 #include "utilities/juce_AudioProcessorParameterWithID.h"
 #include "utilities/juce_RangedAudioParameter.h"
@@ -503,6 +503,211 @@ private:
     std::optional<PrepareSettings> current, next;
 };
 
+//==============================================================================
+/*  Collects the timings that GraphRenderSequence measures while profiling is enabled.
+
+    The audio thread only ever touches the atomic counters inside the preallocated Histogram
+    and NodeData objects. The map of nodes is only used on the main thread, and each sequence
+    holds its own references to the NodeData objects it writes to, so a sequence that's still
+    being rendered can't be left with dangling pointers when a node is removed.
+*/
+class GraphProfiler
+{
+public:
+    using NodeID = AudioProcessorGraph::NodeID;
+    using TimingStatistics = AudioProcessorGraph::TimingStatistics;
+
+    /*  A lock-free histogram of durations, with logarithmically-spaced buckets. */
+    class Histogram
+    {
+    public:
+        /*  Call from the audio thread only. */
+        void add (int64 ticks) noexcept
+        {
+            counts[getBucketIndex ((double) ticks * microsecondsPerTick)].fetch_add (1, std::memory_order_relaxed);
+            totalTicks.fetch_add (ticks, std::memory_order_relaxed);
+
+            for (auto previous = maxTicks.load (std::memory_order_relaxed);
+                 previous < ticks && ! maxTicks.compare_exchange_weak (previous, ticks, std::memory_order_relaxed);)
+            {}
+        }
+
+        TimingStatistics getStatistics() const
+        {
+            std::array<int64, numBuckets> snapshot;
+            int64 numBlocks = 0;
+
+            for (size_t i = 0; i < numBuckets; ++i)
+                numBlocks += (snapshot[i] = counts[i].load (std::memory_order_relaxed));
+
+            TimingStatistics result;
+
+            if (numBlocks == 0)
+                return result;
+
+            const auto millisecondsPerTick = microsecondsPerTick * 0.001;
+
+            result.numBlocks = numBlocks;
+            result.averageMs = (double) totalTicks.load (std::memory_order_relaxed) * millisecondsPerTick / (double) numBlocks;
+            result.maxMs     = (double) maxTicks.load (std::memory_order_relaxed) * millisecondsPerTick;
+            result.p50Ms     = jmin (result.maxMs, getPercentile (snapshot, numBlocks, 0.5));
+            result.p99Ms     = jmin (result.maxMs, getPercentile (snapshot, numBlocks, 0.99));
+            return result;
+        }
+
+        void reset() noexcept
+        {
+            for (auto& c : counts)
+                c.store (0, std::memory_order_relaxed);
+
+            totalTicks.store (0, std::memory_order_relaxed);
+            maxTicks.store (0, std::memory_order_relaxed);
+        }
+
+    private:
+        friend class AudioProcessorGraphTests;
+
+        // Bucket 0 holds anything under a microsecond, and the rest cover up to about a second
+        static constexpr int bucketsPerOctave = 8, numOctaves = 20;
+        static constexpr size_t numBuckets = (size_t) (bucketsPerOctave * numOctaves + 1);
+
+        static size_t getBucketIndex (double microseconds) noexcept
+        {
+            if (microseconds < 1.0)
+                return 0;
+
+            int exponent = 0;
+            const auto mantissa = std::frexp (microseconds, &exponent); // in the range [0.5, 1)
+            const auto index = 1 + (exponent - 1) * bucketsPerOctave + (int) ((mantissa - 0.5) * 2 * bucketsPerOctave);
+            return (size_t) jmin (index, (int) numBuckets - 1);
+        }
+
+        /*  Returns the centre of a bucket, in milliseconds. */
+        static double getBucketValue (size_t index) noexcept
+        {
+            if (index == 0)
+                return 0.0005;
+
+            const auto octave = (int) (index - 1) / bucketsPerOctave;
+            const auto step   = (int) (index - 1) % bucketsPerOctave;
+            return 0.001 * std::ldexp (1.0 + (step + 0.5) / bucketsPerOctave, octave);
+        }
+
+        static double getPercentile (const std::array<int64, numBuckets>& snapshot, int64 numBlocks, double proportion)
+        {
+            const auto target = jmax ((int64) 1, (int64) std::ceil (proportion * (double) numBlocks));
+            int64 count = 0;
+
+            for (size_t i = 0; i < numBuckets; ++i)
+                if ((count += snapshot[i]) >= target)
+                    return getBucketValue (i);
+
+            return getBucketValue (numBuckets - 1);
+        }
+
+        const double microsecondsPerTick = 1.0e6 / (double) Time::getHighResolutionTicksPerSecond();
+        std::array<std::atomic<int64>, numBuckets> counts{};
+        std::atomic<int64> totalTicks { 0 }, maxTicks { 0 };
+    };
+
+    struct NodeData
+    {
+        Histogram processTime;
+        std::atomic<int64> numOverruns { 0 };
+    };
+
+    void setEnabled (bool shouldBeEnabled) noexcept  { enabled.store (shouldBeEnabled, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept                  { return enabled.load (std::memory_order_relaxed); }
+
+    /*  Call from the audio thread only, once at the end of each profiled block.
+        slowestNode may be null if the block didn't contain any nodes.
+    */
+    void addBlock (int64 blockTicks, int64 nodeTicks, double deadlineTicks, NodeData* slowestNode) noexcept
+    {
+        blockTime.add (blockTicks);
+        bufferOverhead.add (jmax ((int64) 0, blockTicks - nodeTicks));
+
+        if ((double) blockTicks > deadlineTicks)
+        {
+            numOverruns.fetch_add (1, std::memory_order_relaxed);
+
+            if (slowestNode != nullptr)
+                slowestNode->numOverruns.fetch_add (1, std::memory_order_relaxed);
+        }
+    }
+
+    /*  Call from the main thread only. Returns the data for the given node, creating it if
+        necessary.
+    */
+    std::shared_ptr<NodeData> getNodeData (NodeID n)
+    {
+        auto& data = nodes[n];
+
+        if (data == nullptr)
+            data = std::make_shared<NodeData>();
+
+        return data;
+    }
+
+    /*  Call from the main thread to indicate that a node has been removed from the graph. */
+    void removeNode (NodeID n)
+    {
+        nodes.erase (n);
+    }
+
+    /*  Call from the main thread to indicate that all nodes have been removed from the graph. */
+    void clear()
+    {
+        nodes.clear();
+    }
+
+    /*  Call from the main thread only. */
+    AudioProcessorGraph::Profile getProfile (const Nodes& n) const
+    {
+        AudioProcessorGraph::Profile result;
+        result.blockTime      = blockTime.getStatistics();
+        result.bufferOverhead = bufferOverhead.getStatistics();
+        result.numOverruns    = numOverruns.load (std::memory_order_relaxed);
+
+        for (const auto& node : n.getNodes())
+        {
+            AudioProcessorGraph::NodeProfile nodeProfile;
+            nodeProfile.nodeID = node->nodeID;
+
+            const auto iter = nodes.find (node->nodeID);
+
+            if (iter != nodes.cend())
+            {
+                nodeProfile.processTime = iter->second->processTime.getStatistics();
+                nodeProfile.numOverruns = iter->second->numOverruns.load (std::memory_order_relaxed);
+            }
+
+            result.nodes.push_back (nodeProfile);
+        }
+
+        return result;
+    }
+
+    void reset()
+    {
+        blockTime.reset();
+        bufferOverhead.reset();
+        numOverruns.store (0, std::memory_order_relaxed);
+
+        for (const auto& pair : nodes)
+        {
+            pair.second->processTime.reset();
+            pair.second->numOverruns.store (0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<bool> enabled { false };
+    Histogram blockTime, bufferOverhead;
+    std::atomic<int64> numOverruns { 0 };
+    std::map<NodeID, std::shared_ptr<NodeData>> nodes;
+};
+
 //==============================================================================
 template <typename FloatType>
 struct GraphRenderSequence
@@ -551,6 +756,11 @@ struct GraphRenderSequence
             return;
         }
 
+        const auto profiling = profiler != nullptr && profiler->isEnabled();
+        const auto blockStartTicks = profiling ? Time::getHighResolutionTicks() : 0;
+        int64 nodeTicks = 0;
+        GraphProfiler::NodeData* slowestNode = nullptr;
+
         currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
         currentAudioOutputBuffer.clear();
         currentMidiOutputBuffer.clear();
@@ -563,8 +773,15 @@ struct GraphRenderSequence
                                     audioPlayHead,
                                     numSamples };
 
-            for (const auto& op : renderOps)
-                op->process (context);
+            if (profiling)
+            {
+                nodeTicks = processWithProfiling (context, slowestNode);
+            }
+            else
+            {
+                for (const auto& op : renderOps)
+                    op->process (context);
+            }
         }
 
         for (int i = 0; i < buffer.getNumChannels(); ++i)
@@ -572,6 +789,33 @@ struct GraphRenderSequence
 
         midiMessages.clear();
         midiMessages.addEvents (currentMidiOutputBuffer, 0, buffer.getNumSamples(), 0);
+
+        if (profiling)
+            profiler->addBlock (Time::getHighResolutionTicks() - blockStartTicks,
+                                nodeTicks,
+                                ticksPerSample * numSamples,
+                                slowestNode);
+    }
+
+    /*  Call on the main thread, after all the ops have been added. The sequence will keep
+        a reference to the profiler's data for each of its nodes, and will write to them
+        whenever the profiler is enabled.
+    */
+    void setProfiler (std::shared_ptr<GraphProfiler> newProfiler, double sampleRate)
+    {
+        profiler = std::move (newProfiler);
+        ticksPerSample = (double) Time::getHighResolutionTicksPerSecond() / sampleRate;
+
+        nodeProfiles.clear();
+        nodeProfiles.reserve (renderOps.size());
+
+        for (const auto& op : renderOps)
+        {
+            if (auto* nodeOp = dynamic_cast<const NodeOp*> (op.get()))
+                nodeProfiles.push_back (profiler->getNodeData (nodeOp->node->nodeID));
+            else
+                nodeProfiles.push_back (nullptr);
+        }
     }
 
     JUCE_BEGIN_IGNORE_WARNINGS_MSVC (4661)
@@ -649,6 +893,51 @@ struct GraphRenderSequence
         renderOps.push_back (std::make_unique<AddOp> (srcIndex, dstIndex));
     }
 
+    /*  Mixes several channels into one in a single op, which saves a pass over the destination
+        for each source compared to a copy followed by a series of adds.
+    */
+    void addMixChannelsOp (const Array<int>& srcIndices, int dstIndex, bool accumulate)
+    {
+        struct MixOp final : public RenderOp
+        {
+            MixOp (const Array<int>& fromIn, int toIn, bool accumulateIn)
+                : from (fromIn), to (toIn), accumulate (accumulateIn), fromBuffers ((size_t) fromIn.size(), nullptr)
+            {
+                jassert (accumulate ? from.size() > 0 : from.size() > 1);
+            }
+
+            void prepare (FloatType* const* renderBuffer, MidiBuffer*) override
+            {
+                for (size_t i = 0; i < fromBuffers.size(); ++i)
+                    fromBuffers[i] = renderBuffer[from.getUnchecked ((int) i)];
+
+                toBuffer = renderBuffer[to];
+            }
+
+            void process (const Context& c) override
+            {
+                size_t i = 0;
+
+                if (! accumulate)
+                {
+                    FloatVectorOperations::add (toBuffer, fromBuffers[0], fromBuffers[1], c.numSamples);
+                    i = 2;
+                }
+
+                for (; i < fromBuffers.size(); ++i)
+                    FloatVectorOperations::add (toBuffer, fromBuffers[i], c.numSamples);
+            }
+
+            Array<int> from;
+            int to = 0;
+            bool accumulate = false;
+            std::vector<const FloatType*> fromBuffers;
+            FloatType* toBuffer = nullptr;
+        };
+
+        renderOps.push_back (std::make_unique<MixOp> (srcIndices, dstIndex, accumulate));
+    }
+
     JUCE_END_IGNORE_WARNINGS_MSVC
 
     void addClearMidiBufferOp (int index)
@@ -826,6 +1115,10 @@ struct GraphRenderSequence
     Array<MidiBuffer> midiBuffers;
     MidiBuffer midiChunk;
 
+    std::shared_ptr<GraphProfiler> profiler;
+    std::vector<std::shared_ptr<GraphProfiler::NodeData>> nodeProfiles;
+    double ticksPerSample = 0.0;
+
 private:
     //==============================================================================
     struct RenderOp
@@ -995,6 +1288,40 @@ private:
         }
     };
 
+    /*  Only nodes are timed individually, so that the timer isn't read around every one of the
+        many small buffer ops. Whatever's left of the block's time is the buffer overhead.
+    */
+    int64 processWithProfiling (const Context& context, GraphProfiler::NodeData*& slowestNode)
+    {
+        int64 nodeTicks = 0, slowestTicks = -1;
+
+        for (size_t i = 0; i < renderOps.size(); ++i)
+        {
+            auto* data = nodeProfiles[i].get();
+
+            if (data == nullptr)
+            {
+                renderOps[i]->process (context);
+                continue;
+            }
+
+            const auto startTicks = Time::getHighResolutionTicks();
+            renderOps[i]->process (context);
+            const auto elapsedTicks = Time::getHighResolutionTicks() - startTicks;
+
+            data->processTime.add (elapsedTicks);
+            nodeTicks += elapsedTicks;
+
+            if (elapsedTicks > slowestTicks)
+            {
+                slowestTicks = elapsedTicks;
+                slowestNode = data;
+            }
+        }
+
+        return nodeTicks;
+    }
+
     std::vector<std::unique_ptr<RenderOp>> renderOps;
 };
 
@@ -1008,6 +1335,468 @@ struct SequenceAndLatency
     int latencySamples = 0;
 };
 
+//==============================================================================
+/*  A description of the ops in a render sequence, independent of the sample type.
+
+    RenderSequenceBuilder assigns buffers greedily as it walks through the nodes, which leaves
+    graphs with many parallel chains doing a lot of redundant clearing, copying and mixing, in
+    more buffers than they need. The builder's ops are recorded here so that they can be
+    optimised before they're turned into a GraphRenderSequence.
+*/
+class RenderOpList
+{
+public:
+    using Node = AudioProcessorGraph::Node;
+
+    enum class OpType
+    {
+        clearChannel,   // destination = 0
+        copyChannels,   // destination = sum of sources
+        addChannels,    // destination += sum of sources
+        delayChannel,   // destination is delayed by delaySize samples
+        clearMidi,
+        copyMidi,
+        addMidi,
+        process
+    };
+
+    struct Op
+    {
+        OpType type = OpType::clearChannel;
+        Array<int> sources;         // the buffers that are read, or the audio channels used by a process op
+        int destination = 0;        // the buffer that is written, or the MIDI buffer used by a process op
+        int delaySize = 0;
+        Node::Ptr node;
+        int totalNumChans = 0, numInputs = 0, numOutputs = 0;
+        bool usesMidi = false;
+    };
+
+    //==============================================================================
+    void addClearChannelOp (int index)                      { addOp (OpType::clearChannel, {}, index); }
+    void addCopyChannelOp (int srcIndex, int dstIndex)      { addOp (OpType::copyChannels, { srcIndex }, dstIndex); }
+    void addAddChannelOp (int srcIndex, int dstIndex)       { addOp (OpType::addChannels, { srcIndex }, dstIndex); }
+    void addClearMidiBufferOp (int index)                   { addOp (OpType::clearMidi, {}, index); }
+    void addCopyMidiBufferOp (int srcIndex, int dstIndex)   { addOp (OpType::copyMidi, { srcIndex }, dstIndex); }
+    void addAddMidiBufferOp (int srcIndex, int dstIndex)    { addOp (OpType::addMidi, { srcIndex }, dstIndex); }
+
+    void addDelayChannelOp (int chan, int delaySize)
+    {
+        addOp (OpType::delayChannel, {}, chan).delaySize = delaySize;
+    }
+
+    void addProcessOp (const Node::Ptr& node,
+                       const Array<int>& audioChannelsUsed,
+                       int totalNumChans,
+                       int midiBuffer)
+    {
+        const auto& processor = *node->getProcessor();
+
+        auto& op = addOp (OpType::process, audioChannelsUsed, midiBuffer);
+        op.node = node;
+        op.totalNumChans = totalNumChans;
+        op.numInputs = processor.getTotalNumInputChannels();
+        op.numOutputs = processor.getTotalNumOutputChannels();
+        op.usesMidi = processor.acceptsMidi() || processor.producesMidi();
+    }
+
+    //==============================================================================
+    /*  Rewrites the ops so that they do the same work in fewer steps, using fewer buffers. */
+    void optimise()
+    {
+        [[maybe_unused]] const auto numOpsBefore = ops.size();
+        [[maybe_unused]] const auto numBuffersBefore = numBuffersNeeded;
+        [[maybe_unused]] const auto numMidiBuffersBefore = numMidiBuffersNeeded;
+
+        replaceClearsFollowedByAdds();
+        fuseMixes();
+        removeDeadOps (BufferKind::audio);
+        removeDeadOps (BufferKind::midi);
+
+        numBuffersNeeded     = assignBuffers (BufferKind::audio);
+        numMidiBuffersNeeded = assignBuffers (BufferKind::midi);
+
+        DBG ("AudioProcessorGraph render sequence optimised from "
+             << (int) numOpsBefore << " to " << (int) ops.size() << " ops, "
+             << numBuffersBefore << " to " << numBuffersNeeded << " audio buffers, and "
+             << numMidiBuffersBefore << " to " << numMidiBuffersNeeded << " MIDI buffers");
+    }
+
+    /*  Adds the ops to a GraphRenderSequence. */
+    template <typename RenderSequence>
+    void createRenderOps (RenderSequence& sequence) const
+    {
+        for (const auto& op : ops)
+        {
+            switch (op.type)
+            {
+                case OpType::clearChannel:  sequence.addClearChannelOp (op.destination); break;
+                case OpType::delayChannel:  sequence.addDelayChannelOp (op.destination, op.delaySize); break;
+                case OpType::clearMidi:     sequence.addClearMidiBufferOp (op.destination); break;
+                case OpType::copyMidi:      sequence.addCopyMidiBufferOp (op.sources.getFirst(), op.destination); break;
+                case OpType::addMidi:       sequence.addAddMidiBufferOp (op.sources.getFirst(), op.destination); break;
+                case OpType::process:       sequence.addProcessOp (op.node, op.sources, op.totalNumChans, op.destination); break;
+
+                case OpType::copyChannels:
+                case OpType::addChannels:
+                {
+                    const auto accumulate = op.type == OpType::addChannels;
+
+                    if (op.sources.size() > 1)
+                        sequence.addMixChannelsOp (op.sources, op.destination, accumulate);
+                    else if (accumulate)
+                        sequence.addAddChannelOp (op.sources.getFirst(), op.destination);
+                    else
+                        sequence.addCopyChannelOp (op.sources.getFirst(), op.destination);
+
+                    break;
+                }
+            }
+        }
+
+        sequence.numBuffersNeeded = numBuffersNeeded;
+        sequence.numMidiBuffersNeeded = numMidiBuffersNeeded;
+    }
+
+    const std::vector<Op>& getOps() const noexcept  { return ops; }
+
+    int numBuffersNeeded = 0, numMidiBuffersNeeded = 0;
+
+private:
+    //==============================================================================
+    enum class BufferKind { audio, midi };
+
+    struct Access
+    {
+        int* index;
+        bool isRead, isWrite;
+    };
+
+    Op& addOp (OpType type, const Array<int>& sources, int destination)
+    {
+        auto& op = ops.emplace_back();
+        op.type = type;
+        op.sources = sources;
+        op.destination = destination;
+        return op;
+    }
+
+    /*  Finds all the buffers of a particular kind that an op reads from or writes to.
+        Buffer 0 is the read-only empty buffer, so it's never included.
+    */
+    static void getAccesses (Op& op, BufferKind kind, std::vector<Access>& result)
+    {
+        result.clear();
+
+        const auto add = [&result] (int& index, bool isRead, bool isWrite)
+        {
+            if (index != 0)
+                result.push_back ({ &index, isRead, isWrite });
+        };
+
+        const auto addSources = [&]
+        {
+            for (auto& source : op.sources)
+                add (source, true, false);
+        };
+
+        if (kind == BufferKind::audio)
+        {
+            switch (op.type)
+            {
+                case OpType::clearChannel:  add (op.destination, false, true); break;
+                case OpType::copyChannels:  addSources(); add (op.destination, false, true); break;
+                case OpType::addChannels:   addSources(); add (op.destination, true, true); break;
+                case OpType::delayChannel:  add (op.destination, true, true); break;
+
+                case OpType::process:
+                    // Channels that are outputs but not inputs may contain garbage, so the
+                    // processor has to overwrite them without reading them
+                    for (int i = 0; i < op.sources.size(); ++i)
+                        add (op.sources.getReference (i), i < op.numInputs || i >= op.numOutputs, i < op.numOutputs);
+
+                    break;
+
+                case OpType::clearMidi:
+                case OpType::copyMidi:
+                case OpType::addMidi:
+                    break;
+            }
+        }
+        else
+        {
+            switch (op.type)
+            {
+                case OpType::clearMidi:     add (op.destination, false, true); break;
+                case OpType::copyMidi:      addSources(); add (op.destination, false, true); break;
+                case OpType::addMidi:       addSources(); add (op.destination, true, true); break;
+                case OpType::process:       add (op.destination, op.usesMidi, true); break;
+
+                case OpType::clearChannel:
+                case OpType::copyChannels:
+                case OpType::addChannels:
+                case OpType::delayChannel:
+                    break;
+            }
+        }
+    }
+
+    static bool accessesBuffer (const std::vector<Access>& accesses, int index)
+    {
+        return std::any_of (accesses.begin(), accesses.end(), [index] (const auto& a) { return *a.index == index; });
+    }
+
+    void removeOps (const std::vector<bool>& shouldRemove)
+    {
+        std::vector<Op> remaining;
+        remaining.reserve (ops.size());
+
+        for (size_t i = 0; i < ops.size(); ++i)
+            if (! shouldRemove[i])
+                remaining.push_back (std::move (ops[i]));
+
+        ops = std::move (remaining);
+    }
+
+    /*  A clear followed by an add into the same buffer can just be a copy. */
+    void replaceClearsFollowedByAdds()
+    {
+        std::vector<bool> shouldRemove (ops.size(), false);
+        std::vector<Access> accesses;
+
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            if (ops[i].type != OpType::clearChannel || ops[i].destination == 0)
+                continue;
+
+            const auto buffer = ops[i].destination;
+
+            for (auto j = i + 1; j < ops.size(); ++j)
+            {
+                getAccesses (ops[j], BufferKind::audio, accesses);
+
+                if (! accessesBuffer (accesses, buffer))
+                    continue;
+
+                if (ops[j].type == OpType::addChannels
+                     && ops[j].destination == buffer
+                     && ! ops[j].sources.contains (buffer))
+                {
+                    ops[j].type = OpType::copyChannels;
+                    shouldRemove[i] = true;
+                }
+
+                break;
+            }
+        }
+
+        removeOps (shouldRemove);
+    }
+
+    /*  Merges each add into the previous copy or add that wrote to the same buffer, so that
+        all the sources are mixed in a single op. The earlier op is moved forward to where the
+        add was, so this is only possible if nothing in between uses the destination buffer or
+        overwrites any of the earlier op's sources.
+    */
+    void fuseMixes()
+    {
+        std::vector<bool> shouldRemove (ops.size(), false);
+        std::vector<Access> accesses;
+
+        for (size_t j = 0; j < ops.size(); ++j)
+        {
+            if (ops[j].type != OpType::addChannels)
+                continue;
+
+            const auto buffer = ops[j].destination;
+
+            for (auto i = j; i-- > 0;)
+            {
+                if (shouldRemove[i])
+                    continue;
+
+                getAccesses (ops[i], BufferKind::audio, accesses);
+
+                if (! accessesBuffer (accesses, buffer))
+                    continue;
+
+                const auto isMix = ops[i].type == OpType::copyChannels || ops[i].type == OpType::addChannels;
+
+                if (isMix
+                     && ops[i].destination == buffer
+                     && ! ops[i].sources.contains (buffer)
+                     && ! ops[j].sources.contains (buffer)
+                     && ! areAnyOverwrittenBetween (ops[i].sources, i, j, shouldRemove))
+                {
+                    auto sources = ops[i].sources;
+                    sources.addArray (ops[j].sources);
+
+                    ops[j].type = ops[i].type;
+                    ops[j].sources = std::move (sources);
+                    shouldRemove[i] = true;
+                }
+
+                break;
+            }
+        }
+
+        removeOps (shouldRemove);
+    }
+
+    bool areAnyOverwrittenBetween (const Array<int>& buffers, size_t begin, size_t end, const std::vector<bool>& removed)
+    {
+        std::vector<Access> accesses;
+
+        for (auto i = begin + 1; i < end; ++i)
+        {
+            if (removed[i])
+                continue;
+
+            getAccesses (ops[i], BufferKind::audio, accesses);
+
+            for (const auto& a : accesses)
+                if (a.isWrite && buffers.contains (*a.index))
+                    return true;
+        }
+
+        return false;
+    }
+
+    /*  Removes any ops that only write to buffers which are overwritten or never read before the
+        end of the block. Processing ops are always kept.
+    */
+    void removeDeadOps (BufferKind kind)
+    {
+        std::vector<bool> shouldRemove (ops.size(), false);
+        std::vector<bool> isLive ((size_t) getNumBuffers (kind), false);
+        std::vector<Access> accesses;
+
+        for (auto i = ops.size(); i-- > 0;)
+        {
+            getAccesses (ops[i], kind, accesses);
+
+            const auto writesAnything = std::any_of (accesses.begin(), accesses.end(), [] (const auto& a) { return a.isWrite; });
+            const auto writesLiveBuffer = std::any_of (accesses.begin(), accesses.end(), [&] (const auto& a)
+            {
+                return a.isWrite && isLive[(size_t) *a.index];
+            });
+
+            if (ops[i].type != OpType::process && writesAnything && ! writesLiveBuffer)
+            {
+                shouldRemove[i] = true;
+                continue;
+            }
+
+            for (const auto& a : accesses)
+                if (a.isWrite && ! a.isRead)
+                    isLive[(size_t) *a.index] = false;
+
+            for (const auto& a : accesses)
+                if (a.isRead)
+                    isLive[(size_t) *a.index] = true;
+        }
+
+        removeOps (shouldRemove);
+    }
+
+    /*  Each time a buffer is overwritten, it starts to hold a new value, which lives until the
+        last op that reads it. The ranges of ops over which these values live form an interval
+        graph, so assigning each value to the lowest-numbered buffer that's free at the start of
+        its range uses the smallest possible number of buffers.
+
+        Returns the number of buffers needed, including the read-only empty buffer.
+    */
+    int assignBuffers (BufferKind kind)
+    {
+        struct LiveRange
+        {
+            int start, end;
+        };
+
+        std::vector<LiveRange> ranges;
+        std::vector<std::pair<int*, size_t>> references;
+        std::vector<int> currentRanges ((size_t) getNumBuffers (kind), -1);
+        std::vector<Access> accesses;
+
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            getAccesses (ops[i], kind, accesses);
+
+            for (const auto& a : accesses)
+            {
+                if (! a.isRead)
+                    continue;
+
+                auto& current = currentRanges[(size_t) *a.index];
+
+                // If a buffer is read before anything is written to it, its value has to be
+                // kept from the start of the block
+                if (current < 0)
+                {
+                    current = (int) ranges.size();
+                    ranges.push_back ({ 0, (int) i });
+                }
+
+                ranges[(size_t) current].end = (int) i;
+                references.emplace_back (a.index, (size_t) current);
+            }
+
+            for (const auto& a : accesses)
+            {
+                if (a.isRead)
+                    continue;
+
+                auto& current = currentRanges[(size_t) *a.index];
+                current = (int) ranges.size();
+                ranges.push_back ({ (int) i, (int) i });
+                references.emplace_back (a.index, (size_t) current);
+            }
+        }
+
+        std::vector<size_t> order (ranges.size());
+        std::iota (order.begin(), order.end(), (size_t) 0);
+        std::stable_sort (order.begin(), order.end(), [&] (auto a, auto b) { return ranges[a].start < ranges[b].start; });
+
+        using EndAndBuffer = std::pair<int, int>;
+        std::priority_queue<EndAndBuffer, std::vector<EndAndBuffer>, std::greater<>> inUse;
+        std::set<int> freeBuffers;
+        std::vector<int> assignedBuffers (ranges.size());
+        int numBuffers = 1;
+
+        for (const auto r : order)
+        {
+            while (! inUse.empty() && inUse.top().first < ranges[r].start)
+            {
+                freeBuffers.insert (inUse.top().second);
+                inUse.pop();
+            }
+
+            if (freeBuffers.empty())
+            {
+                assignedBuffers[r] = numBuffers++;
+            }
+            else
+            {
+                assignedBuffers[r] = *freeBuffers.begin();
+                freeBuffers.erase (freeBuffers.begin());
+            }
+
+            inUse.emplace (ranges[r].end, assignedBuffers[r]);
+        }
+
+        for (const auto& [index, range] : references)
+            *index = assignedBuffers[range];
+
+        return numBuffers;
+    }
+
+    int getNumBuffers (BufferKind kind) const
+    {
+        return jmax (1, kind == BufferKind::audio ? numBuffersNeeded : numMidiBuffersNeeded);
+    }
+
+    std::vector<Op> ops;
+};
+
 //==============================================================================
 class RenderSequenceBuilder
 {
@@ -1022,8 +1811,12 @@ public:
     template <typename FloatType>
     static SequenceAndLatency build (const Nodes& n, const Connections& c)
     {
+        RenderOpList ops;
+        const RenderSequenceBuilder builder (n, c, ops);
+        ops.optimise();
+
         GraphRenderSequence<FloatType> sequence;
-        const RenderSequenceBuilder builder (n, c, sequence);
+        ops.createRenderOps (sequence);
         return { std::move (sequence), builder.totalLatency };
     }
 
@@ -1521,11 +2314,12 @@ class RenderSequence
 public:
     using AudioGraphIOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
 
-    RenderSequence (const PrepareSettings s, const Nodes& n, const Connections& c)
+    RenderSequence (const PrepareSettings s, const Nodes& n, const Connections& c, std::shared_ptr<GraphProfiler> profiler)
         : RenderSequence (s, s.precision == AudioProcessor::ProcessingPrecision::singlePrecision
                                 ? RenderSequenceBuilder::build<float>  (n, c)
                                 : RenderSequenceBuilder::build<double> (n, c))
     {
+        visitRenderSequence (*this, [&] (auto& seq) { seq.setProfiler (profiler, settings.sampleRate); });
     }
 
     template <typename FloatType>
@@ -1720,6 +2514,7 @@ public:
         nodes = Nodes{};
         connections = Connections{};
         nodeStates.clear();
+        profiler->clear();
         topologyChanged (updateKind);
     }
 
@@ -1759,6 +2554,7 @@ public:
         connections.disconnectNode (nodeID);
         auto result = nodes.removeNode (nodeID);
         nodeStates.removeNode (nodeID);
+        profiler->removeNode (nodeID);
         topologyChanged (updateKind);
         return result;
     }
@@ -1911,6 +2707,12 @@ public:
     /*  Call from the audio thread only. */
     auto* getAudioThreadState() const { return renderSequenceExchange.getAudioThreadState(); }
 
+    //==============================================================================
+    void setProfilingEnabled (bool shouldProfile) noexcept  { profiler->setEnabled (shouldProfile); }
+    bool isProfilingEnabled() const noexcept                { return profiler->isEnabled(); }
+    Profile getProfile() const                              { return profiler->getProfile (nodes); }
+    void resetProfile()                                     { profiler->reset(); }
+
 private:
     void setParentGraph (AudioProcessor* p) const
     {
@@ -1935,7 +2737,7 @@ private:
 
             if (std::exchange (lastBuiltSequence, newSignature) != newSignature)
             {
-                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections);
+                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections, profiler);
                 owner->setLatencySamples (sequence->getLatencySamples());
                 renderSequenceExchange.set (std::move (sequence));
             }
@@ -1954,6 +2756,7 @@ private:
     RenderSequenceExchange renderSequenceExchange;
     NodeID lastNodeID;
     std::optional<RenderSequenceSignature> lastBuiltSequence;
+    std::shared_ptr<GraphProfiler> profiler = std::make_shared<GraphProfiler>();
     LockingAsyncUpdater updater { [this] { handleAsyncUpdate(); } };
 };
 
@@ -1989,6 +2792,10 @@ bool AudioProcessorGraph::isConnected (NodeID a, NodeID b) const noexcept
 bool AudioProcessorGraph::isConnectionLegal (const Connection& c) const                                     { return pimpl->isConnectionLegal (c); }
 bool AudioProcessorGraph::isAnInputTo (const Node& source, const Node& destination) const noexcept          { return pimpl->isAnInputTo (source, destination); }
 bool AudioProcessorGraph::isAnInputTo (NodeID source, NodeID destination) const noexcept                    { return pimpl->isAnInputTo (source, destination); }
+void AudioProcessorGraph::setProfilingEnabled (bool shouldProfile) noexcept                                 { return pimpl->setProfilingEnabled (shouldProfile); }
+bool AudioProcessorGraph::isProfilingEnabled() const noexcept                                               { return pimpl->isProfilingEnabled(); }
+AudioProcessorGraph::Profile AudioProcessorGraph::getProfile() const                                        { return pimpl->getProfile(); }
+void AudioProcessorGraph::resetProfile()                                                                    { return pimpl->resetProfile(); }
 
 AudioProcessorGraph::Node::Ptr AudioProcessorGraph::addNode (std::unique_ptr<AudioProcessor> newProcessor,
                                                              std::optional<NodeID> nodeId,
@@ -2303,6 +3110,394 @@ public:
             // this graph, so we just want to make sure that we finish the test without timing out.
             logMessage ("render sequence built in " + String (duration) + " ms");
         }
+
+        beginTest ("profiler histogram buckets cover their own centres, in order");
+        {
+            using Histogram = GraphProfiler::Histogram;
+
+            expect (Histogram::getBucketIndex (0.0) == 0);
+            expect (Histogram::getBucketIndex (0.99) == 0);
+            expect (Histogram::getBucketIndex (1.0) == 1);
+            expect (Histogram::getBucketIndex (2.0) == 1 + Histogram::bucketsPerOctave);
+            expect (Histogram::getBucketIndex (1.0e9) == Histogram::numBuckets - 1);
+
+            for (size_t i = 0; i < Histogram::numBuckets; ++i)
+            {
+                const auto centreMicroseconds = Histogram::getBucketValue (i) * 1000.0;
+                expect (Histogram::getBucketIndex (centreMicroseconds) == i);
+
+                if (i > 0)
+                    expectGreaterThan (Histogram::getBucketValue (i), Histogram::getBucketValue (i - 1));
+            }
+        }
+
+        beginTest ("profiler histogram statistics");
+        {
+            const auto ticksPerMs = (double) Time::getHighResolutionTicksPerSecond() / 1000.0;
+            const auto toTicks = [&] (double ms) { return (int64) std::round (ms * ticksPerMs); };
+
+            // The percentiles come from the bucket centres, which are within 1/16 of an octave
+            const auto expectNear = [this] (double actual, double expected)
+            {
+                expectWithinAbsoluteError (actual, expected, expected * 0.05);
+            };
+
+            GraphProfiler::Histogram histogram;
+            expect (histogram.getStatistics().numBlocks == 0);
+            expect (exactlyEqual (histogram.getStatistics().maxMs, 0.0));
+
+            for (auto i = 0; i < 99; ++i)
+                histogram.add (toTicks (1.0));
+
+            histogram.add (toTicks (10.0));
+
+            auto stats = histogram.getStatistics();
+            expect (stats.numBlocks == 100);
+            expectNear (stats.averageMs, 1.09);
+            expectNear (stats.maxMs, 10.0);
+            expectNear (stats.p50Ms, 1.0);
+            expectNear (stats.p99Ms, 1.0);
+
+            // One more slow block pushes the 99th percentile into the slow bucket, and it's
+            // never reported as more than the maximum
+            histogram.add (toTicks (10.0));
+            stats = histogram.getStatistics();
+            expectNear (stats.p50Ms, 1.0);
+            expectNear (stats.p99Ms, 10.0);
+            expectLessOrEqual (stats.p99Ms, stats.maxMs);
+
+            histogram.add (toTicks (400.0));
+            expectNear (histogram.getStatistics().maxMs, 400.0);
+            expectNear (histogram.getStatistics().p50Ms, 1.0);
+
+            histogram.reset();
+            stats = histogram.getStatistics();
+            expect (stats.numBlocks == 0);
+            expect (exactlyEqual (stats.averageMs, 0.0));
+            expect (exactlyEqual (stats.maxMs, 0.0));
+        }
+
+        beginTest ("profiler attributes overruns to the slowest node");
+        {
+            GraphProfiler profiler;
+            const auto node = profiler.getNodeData (AudioProcessorGraph::NodeID (1));
+
+            profiler.addBlock (100, 80, 150.0, node.get());
+            profiler.addBlock (200, 150, 150.0, node.get());
+            profiler.addBlock (300, 0, 150.0, nullptr);
+
+            Nodes nodes;
+            nodes.addNode (BasicProcessor::make (BasicProcessor::getStereoProperties(), MidiIn::no, MidiOut::no),
+                           AudioProcessorGraph::NodeID (1));
+
+            auto profile = profiler.getProfile (nodes);
+            expect (profile.numOverruns == 2);
+            expect (profile.blockTime.numBlocks == 3);
+            expect (profile.bufferOverhead.numBlocks == 3);
+            expect (profile.nodes.size() == 1);
+            expect (profile.nodes[0].numOverruns == 1);
+
+            profiler.reset();
+            profile = profiler.getProfile (nodes);
+            expect (profile.numOverruns == 0);
+            expect (profile.blockTime.numBlocks == 0);
+            expect (profile.nodes[0].numOverruns == 0);
+        }
+
+        beginTest ("profiler measures each node of a graph");
+        {
+            AudioProcessorGraph graph;
+
+            auto slow = std::make_unique<BasicProcessor> (BasicProcessor::getStereoProperties(), MidiIn::no, MidiOut::no);
+            std::atomic<bool> shouldSleep { false };
+
+            slow->onProcessBlock = [&shouldSleep] (AudioBuffer<float>&)
+            {
+                if (shouldSleep.exchange (false))
+                    Thread::sleep (10);
+            };
+
+            const auto slowID = graph.addNode (std::move (slow))->nodeID;
+            const auto fastID = graph.addNode (BasicProcessor::make (BasicProcessor::getStereoProperties(), MidiIn::no, MidiOut::no))->nodeID;
+
+            expect (graph.addConnection ({ { slowID, 0 }, { fastID, 0 } }));
+            expect (graph.addConnection ({ { slowID, 1 }, { fastID, 1 } }));
+
+            graph.prepareToPlay (44100, 64);
+
+            AudioBuffer<float> audio (2, 64);
+            MidiBuffer midi;
+
+            expect (! graph.isProfilingEnabled());
+            graph.processBlock (audio, midi);
+            expect (graph.getProfile().blockTime.numBlocks == 0);
+
+            graph.setProfilingEnabled (true);
+            shouldSleep = true;
+
+            constexpr auto numBlocks = 20;
+
+            for (auto i = 0; i < numBlocks; ++i)
+                graph.processBlock (audio, midi);
+
+            const auto profile = graph.getProfile();
+
+            expect (profile.blockTime.numBlocks == numBlocks);
+            expect (profile.bufferOverhead.numBlocks == numBlocks);
+            expect (profile.nodes.size() == 2);
+            expect (profile.nodes[0].nodeID == slowID);
+            expect (profile.nodes[1].nodeID == fastID);
+            expect (profile.nodes[0].processTime.numBlocks == numBlocks);
+            expect (profile.nodes[1].processTime.numBlocks == numBlocks);
+
+            // The only timing check, and a loose one: the sleep can't finish early
+            expectGreaterOrEqual (profile.nodes[0].processTime.maxMs, 5.0);
+
+            graph.resetProfile();
+            expect (graph.getProfile().blockTime.numBlocks == 0);
+            expect (graph.getProfile().nodes[0].processTime.numBlocks == 0);
+
+            graph.removeNode (fastID);
+            expect (graph.getProfile().nodes.size() == 1);
+        }
+
+        beginTest ("render op optimisation fuses mixes, removes redundant ops and reuses buffers");
+        {
+            Nodes nodes;
+            const auto makeNode = [&nodes] (uint32 uid, const AudioProcessor::BusesProperties& layout)
+            {
+                return nodes.addNode (BasicProcessor::make (layout, MidiIn::no, MidiOut::no), AudioProcessorGraph::NodeID (uid));
+            };
+
+            const auto sourceA = makeNode (1, BasicProcessor::getOutputOnlyProperties());
+            const auto sourceB = makeNode (2, BasicProcessor::getOutputOnlyProperties());
+            const auto sourceC = makeNode (3, BasicProcessor::getOutputOnlyProperties());
+            const auto sinkA   = makeNode (4, BasicProcessor::getInputOnlyProperties());
+            const auto sinkB   = makeNode (5, BasicProcessor::getInputOnlyProperties());
+
+            RenderOpList list;
+            list.addProcessOp (sourceA, { 1, 2 }, 2, 1);
+            list.addProcessOp (sourceB, { 3, 4 }, 2, 2);
+            list.addClearChannelOp (5);
+            list.addAddChannelOp (1, 5);
+            list.addAddChannelOp (3, 5);
+            list.addCopyChannelOp (2, 6);
+            list.addAddChannelOp (4, 6);
+            list.addClearChannelOp (7);             // overwritten by sourceC before it's read
+            list.addProcessOp (sourceC, { 7, 8 }, 2, 3);
+            list.addProcessOp (sinkA, { 5, 6 }, 2, 4);
+            list.addProcessOp (sinkB, { 7, 8 }, 2, 5);
+            list.numBuffersNeeded = 9;
+            list.numMidiBuffersNeeded = 6;
+
+            list.optimise();
+
+            using OpType = RenderOpList::OpType;
+            const auto& ops = list.getOps();
+
+            expect (ops.size() == 7);
+            expect (ops[2].type == OpType::copyChannels && ops[2].sources.size() == 2);
+            expect (ops[3].type == OpType::copyChannels && ops[3].sources.size() == 2);
+            expect (ops[4].type == OpType::process && ops[4].node == sourceC);
+
+            // At most four values are in use at once, plus the read-only empty buffer
+            expect (list.numBuffersNeeded == 6);
+            expect (list.numMidiBuffersNeeded == 2);
+
+            // sourceC can reuse the buffers that were freed by the mixes
+            expect (ops[4].sources.getFirst() < 5 && ops[4].sources.getLast() < 5);
+        }
+
+        beginTest ("optimised render sequences mix parallel chains correctly");
+        {
+            AudioProcessorGraph graph;
+            graph.setPlayConfigDetails (2, 2, 44100.0, 64);
+
+            using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+            const auto input  = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::audioInputNode))->nodeID;
+            const auto output = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::audioOutputNode))->nodeID;
+
+            std::map<AudioProcessorGraph::NodeID, float> gains;
+            std::map<AudioProcessorGraph::NodeID, std::vector<AudioProcessorGraph::NodeID>> sourcesForNode;
+
+            const auto addGainNode = [&] (float gain, std::vector<AudioProcessorGraph::NodeID> sources)
+            {
+                auto processor = std::make_unique<BasicProcessor> (BasicProcessor::getStereoProperties(), MidiIn::no, MidiOut::no);
+                processor->onProcessBlock = [gain] (AudioBuffer<float>& b) { b.applyGain (gain); };
+
+                const auto id = graph.addNode (std::move (processor))->nodeID;
+
+                for (const auto& source : sources)
+                    for (auto channel = 0; channel < 2; ++channel)
+                        expect (graph.addConnection ({ { source, channel }, { id, channel } }));
+
+                gains[id] = gain;
+                sourcesForNode[id] = std::move (sources);
+                return id;
+            };
+
+            constexpr auto numChains = 6;
+            std::vector<AudioProcessorGraph::NodeID> firsts, lasts;
+
+            for (auto i = 0; i < numChains; ++i)
+                firsts.push_back (addGainNode ((float) (i + 1) * 0.1f, { input }));
+
+            for (auto i = 0; i < numChains; ++i)
+                lasts.push_back (addGainNode (0.5f, i == 1 ? std::vector { firsts[0], firsts[1] }
+                                                           : std::vector { firsts[(size_t) i] }));
+
+            // Latency compensation adds delay ops in between the mixing ops
+            graph.getNodeForId (firsts[2])->getProcessor()->setLatencySamples (10);
+
+            for (const auto& last : lasts)
+                for (auto channel = 0; channel < 2; ++channel)
+                    expect (graph.addConnection ({ { last, channel }, { output, channel } }));
+
+            graph.prepareToPlay (44100.0, 64);
+
+            std::function<float (AudioProcessorGraph::NodeID)> getExpectedLevel = [&] (AudioProcessorGraph::NodeID id)
+            {
+                if (id == input)
+                    return 1.0f;
+
+                float sum = 0.0f;
+
+                for (const auto& source : sourcesForNode[id])
+                    sum += getExpectedLevel (source);
+
+                return sum * gains[id];
+            };
+
+            float expectedOutput = 0.0f;
+
+            for (const auto& last : lasts)
+                expectedOutput += getExpectedLevel (last);
+
+            AudioBuffer<float> audio (2, 64);
+            MidiBuffer midi;
+
+            // Once the delay lines have filled up, the output should be constant
+            for (auto i = 0; i < 2; ++i)
+            {
+                for (auto channel = 0; channel < 2; ++channel)
+                    FloatVectorOperations::fill (audio.getWritePointer (channel), 1.0f, audio.getNumSamples());
+
+                graph.processBlock (audio, midi);
+            }
+
+            for (auto channel = 0; channel < 2; ++channel)
+                for (auto sample = 0; sample < audio.getNumSamples(); ++sample)
+                    expectWithinAbsoluteError (audio.getSample (channel, sample), expectedOutput, 1.0e-5f);
+        }
+
+        beginTest ("randomly connected graphs with latency produce the expected steady-state output");
+        {
+            using NodeID = AudioProcessorGraph::NodeID;
+            using NodeAndChannel = AudioProcessorGraph::NodeAndChannel;
+            using Connection = AudioProcessorGraph::Connection;
+            using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+
+            Random random (42);
+            constexpr auto blockSize = 64;
+
+            for (auto trial = 0; trial < 300; ++trial)
+            {
+                AudioProcessorGraph graph;
+                graph.setPlayConfigDetails (2, 2, 44100.0, blockSize);
+
+                const auto input  = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::audioInputNode))->nodeID;
+                const auto output = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::audioOutputNode))->nodeID;
+
+                std::vector<NodeID> nodeIDs;
+                std::map<NodeID, float> gains;
+                std::vector<Connection> connections;
+
+                const auto connect = [&] (const Connection& c)
+                {
+                    if (graph.addConnection (c))
+                        connections.push_back (c);
+                };
+
+                const auto numNodes = 1 + random.nextInt (30);
+
+                for (auto i = 0; i < numNodes; ++i)
+                {
+                    const auto gain = 0.5f + random.nextFloat();
+
+                    auto processor = std::make_unique<BasicProcessor> (BasicProcessor::getStereoProperties(), MidiIn::no, MidiOut::no);
+                    processor->onProcessBlock = [gain] (AudioBuffer<float>& b) { b.applyGain (gain); };
+                    processor->setLatencySamples (random.nextInt (5) == 0 ? random.nextInt (20) : 0);
+
+                    const auto id = graph.addNode (std::move (processor))->nodeID;
+                    gains[id] = gain;
+
+                    for (auto numConnections = random.nextInt (4); --numConnections >= 0;)
+                    {
+                        const auto source = (nodeIDs.empty() || random.nextInt (4) == 0) ? input
+                                                                                          : nodeIDs[(size_t) random.nextInt ((int) nodeIDs.size())];
+                        connect ({ { source, random.nextInt (2) }, { id, random.nextInt (2) } });
+                    }
+
+                    nodeIDs.push_back (id);
+                }
+
+                for (auto i = 0; i < 1 + numNodes / 3; ++i)
+                    connect ({ { nodeIDs[(size_t) random.nextInt ((int) nodeIDs.size())], random.nextInt (2) },
+                               { output, random.nextInt (2) } });
+
+                // With a constant input of 1, each channel settles at the sum of its sources'
+                // levels, multiplied by the node's gain
+                std::map<NodeAndChannel, double> levels;
+
+                std::function<double (NodeID, int)> getExpectedLevel = [&] (NodeID id, int channel)
+                {
+                    if (id == input)
+                        return 1.0;
+
+                    const NodeAndChannel key { id, channel };
+
+                    if (const auto iter = levels.find (key); iter != levels.end())
+                        return iter->second;
+
+                    double sum = 0.0;
+
+                    for (const auto& c : connections)
+                        if (c.destination == key)
+                            sum += getExpectedLevel (c.source.nodeID, c.source.channelIndex);
+
+                    return levels[key] = sum * (id == output ? 1.0 : (double) gains[id]);
+                };
+
+                graph.prepareToPlay (44100.0, blockSize);
+
+                AudioBuffer<float> audio (2, blockSize);
+                MidiBuffer midi;
+
+                // No path goes through more than 30 nodes, each with less than 20 samples of
+                // latency, so this is long enough for all the delay lines to fill up
+                for (auto block = 0; block < 700 / blockSize + 3; ++block)
+                {
+                    for (auto channel = 0; channel < 2; ++channel)
+                        FloatVectorOperations::fill (audio.getWritePointer (channel), 1.0f, blockSize);
+
+                    graph.processBlock (audio, midi);
+                }
+
+                for (auto channel = 0; channel < 2; ++channel)
+                {
+                    const auto expected = getExpectedLevel (output, channel);
+                    const auto tolerance = 1.0e-4 * jmax (1.0, std::abs (expected));
+                    auto numWrong = 0;
+
+                    for (auto sample = 0; sample < blockSize; ++sample)
+                        if (std::abs ((double) audio.getSample (channel, sample) - expected) > tolerance)
+                            ++numWrong;
+
+                    expect (numWrong == 0, "trial " + String (trial) + ", channel " + String (channel)
+                                             + ": expected " + String (expected) + ", got " + String (audio.getSample (channel, 0)));
+                }
+            }
+        }
     }
 
 private:
@@ -2330,7 +3525,7 @@ private:
         void setStateInformation (const void*, int) override          {}
         void prepareToPlay (double, int) override                     {}
         void releaseResources() override                              {}
-        void processBlock (AudioBuffer<float>&, MidiBuffer&) override {}
+        void processBlock (AudioBuffer<float>& b, MidiBuffer&) override { NullCheckedInvocation::invoke (onProcessBlock, b); }
         bool supportsDoublePrecisionProcessing() const override       { return true; }
         bool isMidiEffect() const override                            { return {}; }
         void reset() override                                         {}
@@ -2350,6 +3545,11 @@ private:
             return BusesProperties().withInput  ("in", AudioChannelSet::stereo());
         }
 
+        static BusesProperties getOutputOnlyProperties()
+        {
+            return BusesProperties().withOutput ("out", AudioChannelSet::stereo());
+        }
+
         static BusesProperties getStereoProperties()
         {
             return BusesProperties().withInput  ("in",  AudioChannelSet::stereo())
@@ -2362,6 +3562,8 @@ private:
                                     .withOutput ("out", AudioChannelSet::discreteChannels (numChannels));
         }
 
+        std::function<void (AudioBuffer<float>&)> onProcessBlock;
+
     private:
         MidiIn midiIn;
         MidiOut midiOut;
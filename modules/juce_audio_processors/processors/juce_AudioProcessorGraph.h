@@ -332,6 +332,95 @@ public:
     */
     void rebuild();
 
+    //==============================================================================
+    /** A summary of a set of timings gathered by the graph's profiler.
+
+        All times are in milliseconds. The percentiles are estimated from a histogram with
+        eight buckets per octave, so they're only accurate to within a few percent.
+
+        @see getProfile
+    */
+    struct TimingStatistics
+    {
+        int64 numBlocks = 0;    /**< The number of blocks that were measured. */
+        double averageMs = 0.0; /**< The mean time per block. */
+        double p50Ms = 0.0;     /**< The median time per block. */
+        double p99Ms = 0.0;     /**< The time that 99% of blocks took no longer than. */
+        double maxMs = 0.0;     /**< The longest time that any block took. */
+    };
+
+    /** The profiling results for a single node in the graph.
+        @see getProfile
+    */
+    struct NodeProfile
+    {
+        /** The node that was measured. */
+        NodeID nodeID;
+
+        /** The time spent processing this node, not including any of the mixing and
+            copying that the graph does to prepare the node's inputs.
+        */
+        TimingStatistics processTime;
+
+        /** The number of blocks that overran their deadline while this was the slowest
+            node in the graph.
+        */
+        int64 numOverruns = 0;
+    };
+
+    /** The profiling results for the whole graph.
+        @see getProfile
+    */
+    struct Profile
+    {
+        /** The time taken to render each block of the whole graph. */
+        TimingStatistics blockTime;
+
+        /** The time in each block that was spent clearing, copying, mixing and delaying
+            the graph's internal buffers, rather than inside the nodes themselves.
+        */
+        TimingStatistics bufferOverhead;
+
+        /** The number of blocks that took longer to render than their duration in
+            real time, at the graph's current sample rate.
+        */
+        int64 numOverruns = 0;
+
+        /** The results for each of the graph's nodes, in the same order as getNodes(). */
+        std::vector<NodeProfile> nodes;
+    };
+
+    /** Enables or disables the graph's profiler.
+
+        While profiling is enabled, the graph measures the time spent in each node, and in
+        the buffer operations between nodes, for every block it renders. The results are
+        kept in preallocated histograms that are updated without locking, so profiling can
+        safely be turned on while the graph is running, but it does add a couple of timer
+        reads per node to each block, so it's disabled by default.
+
+        @see getProfile, resetProfile
+    */
+    void setProfilingEnabled (bool shouldProfile) noexcept;
+
+    /** Returns true if the graph's profiler is enabled. */
+    bool isProfilingEnabled() const noexcept;
+
+    /** Returns the results that the profiler has gathered since it was last reset.
+
+        This should only be called on the message thread. Nodes that haven't been rendered
+        since they were added to the graph will have empty statistics.
+
+        @see setProfilingEnabled, resetProfile
+    */
+    Profile getProfile() const;
+
+    /** Discards all of the results that the profiler has gathered so far.
+
+        If the graph is being rendered while this is called, the results of the block that's
+        in progress may be partially discarded.
+    */
+    void resetProfile();
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
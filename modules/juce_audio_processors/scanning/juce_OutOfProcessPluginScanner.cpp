@@ -0,0 +1,505 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+OutOfProcessPluginScanner::OutOfProcessPluginScanner (const File& workerExecutable, int maxNumWorkers)
+    : executable (workerExecutable),
+      maxWorkers (jmax (1, maxNumWorkers))
+{
+}
+
+OutOfProcessPluginScanner::~OutOfProcessPluginScanner()
+{
+    // Make sure any scans that are using this object have finished before deleting it!
+    jassert ((int) idleWorkers.size() == numWorkers);
+
+    saveCache();
+}
+
+void OutOfProcessPluginScanner::setTimeout (int milliseconds) noexcept
+{
+    timeoutMs = milliseconds;
+}
+
+//==============================================================================
+bool OutOfProcessPluginScanner::findPluginTypesFor (AudioPluginFormat& format,
+                                                    OwnedArray<PluginDescription>& result,
+                                                    const String& fileOrIdentifier)
+{
+    const auto key = format.getName() + ":" + fileOrIdentifier;
+    const auto entry = createCacheEntry (fileOrIdentifier);
+
+    if (entry.has_value() && findCachedTypes (key, *entry, result))
+        return true;
+
+    auto worker = getWorker();
+
+    if (worker == nullptr)
+        return true;
+
+    const auto reply = worker->sendRequest (OutOfProcessMessageType::scanFile, timeoutMs, [&] (MemoryOutputStream& out)
+    {
+        out.writeString (format.getName());
+        out.writeString (fileOrIdentifier);
+    },
+    [this] { return shouldExit(); });
+
+    returnWorker (std::move (worker));
+
+    if (! reply.has_value())
+    {
+        updateCache (key, {}, {});
+
+        // If the scan was abandoned, the plugin shouldn't be blamed for it
+        return shouldExit();
+    }
+
+    MemoryInputStream in (*reply, false);
+    Array<PluginDescription> found;
+
+    for (int numFound = in.readInt(); --numFound >= 0 && ! in.isExhausted();)
+    {
+        PluginDescription desc;
+
+        if (const auto xml = parseXML (in.readString()))
+            if (desc.loadFromXml (*xml))
+                found.add (desc);
+    }
+
+    for (const auto& desc : found)
+        result.add (new PluginDescription (desc));
+
+    updateCache (key, entry, found);
+    return true;
+}
+
+void OutOfProcessPluginScanner::scanFinished()
+{
+    saveCache();
+
+    std::vector<std::unique_ptr<Worker>> workersToKill;
+
+    {
+        const ScopedLock sl (workerLock);
+        std::swap (workersToKill, idleWorkers);
+        numWorkers -= (int) workersToKill.size();
+    }
+}
+
+//==============================================================================
+std::unique_ptr<OutOfProcessPluginScanner::Worker> OutOfProcessPluginScanner::getWorker()
+{
+    for (;;)
+    {
+        std::unique_ptr<Worker> worker;
+        bool needsLaunching = false;
+
+        {
+            const ScopedLock sl (workerLock);
+
+            if (! idleWorkers.empty())
+            {
+                worker = std::move (idleWorkers.back());
+                idleWorkers.pop_back();
+            }
+            else if (numWorkers < maxWorkers)
+            {
+                ++numWorkers;
+                needsLaunching = true;
+            }
+        }
+
+        if (needsLaunching)
+        {
+            worker = std::make_unique<Worker>();
+
+            if (worker->launch (executable))
+                return worker;
+
+            jassertfalse; // couldn't launch the worker executable!
+
+            {
+                const ScopedLock sl (workerLock);
+                --numWorkers;
+            }
+
+            workerReturned.signal();
+            return {};
+        }
+
+        if (worker != nullptr)
+        {
+            // An idle worker might have died or been disconnected since it was last used
+            if (! worker->hasFailed())
+                return worker;
+
+            returnWorker (std::move (worker));
+            continue;
+        }
+
+        if (shouldExit())
+            return {};
+
+        workerReturned.wait (50);
+    }
+}
+
+void OutOfProcessPluginScanner::returnWorker (std::unique_ptr<Worker> worker)
+{
+    {
+        const ScopedLock sl (workerLock);
+
+        if (! worker->hasFailed())
+            idleWorkers.push_back (std::move (worker));
+        else
+            --numWorkers;
+    }
+
+    workerReturned.signal();
+}
+
+//==============================================================================
+std::optional<OutOfProcessPluginScanner::CacheEntry> OutOfProcessPluginScanner::createCacheEntry (const String& fileOrIdentifier)
+{
+    if (! File::isAbsolutePath (fileOrIdentifier))
+        return {};
+
+    const File file (fileOrIdentifier);
+    CacheEntry entry;
+
+    if (file.existsAsFile())
+    {
+        entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+        entry.size = file.getSize();
+        return entry;
+    }
+
+    if (file.isDirectory())
+    {
+        // For a bundle, a change to any of the files inside it counts
+        entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        for (const auto& child : RangedDirectoryIterator (file, true, "*", File::findFiles))
+        {
+            entry.modificationTime = jmax (entry.modificationTime, child.getModificationTime().toMilliseconds());
+            entry.size += child.getFileSize();
+        }
+
+        return entry;
+    }
+
+    return {};
+}
+
+bool OutOfProcessPluginScanner::findCachedTypes (const String& key, const CacheEntry& current,
+                                                 OwnedArray<PluginDescription>& result) const
+{
+    const ScopedLock sl (cacheLock);
+    const auto cached = cache.find (key);
+
+    if (cached == cache.end()
+         || cached->second.modificationTime != current.modificationTime
+         || cached->second.size != current.size)
+        return false;
+
+    for (const auto& desc : cached->second.types)
+        result.add (new PluginDescription (desc));
+
+    return true;
+}
+
+void OutOfProcessPluginScanner::updateCache (const String& key, std::optional<CacheEntry> entry,
+                                             const Array<PluginDescription>& found)
+{
+    const ScopedLock sl (cacheLock);
+
+    // A file that produced no plugins failed to load, so it's left out of the cache, and
+    // will be scanned again next time in case the problem was only temporary
+    if (! entry.has_value() || found.isEmpty())
+    {
+        cacheNeedsSaving = cache.erase (key) > 0 || cacheNeedsSaving;
+        return;
+    }
+
+    entry->types = found;
+    cache[key] = std::move (*entry);
+    cacheNeedsSaving = true;
+}
+
+void OutOfProcessPluginScanner::setCacheFile (const File& newCacheFile)
+{
+    const ScopedLock sl (cacheLock);
+
+    cacheFile = newCacheFile;
+    cache.clear();
+    cacheNeedsSaving = false;
+
+    if (const auto xml = parseXMLIfTagMatches (cacheFile, "PLUGINSCANCACHE"))
+    {
+        for (auto* e : xml->getChildWithTagNameIterator ("FILE"))
+        {
+            CacheEntry entry;
+            entry.modificationTime = e->getStringAttribute ("modified").getLargeIntValue();
+            entry.size = e->getStringAttribute ("size").getLargeIntValue();
+
+            for (auto* p : e->getChildWithTagNameIterator ("PLUGIN"))
+            {
+                PluginDescription desc;
+
+                if (desc.loadFromXml (*p))
+                    entry.types.add (desc);
+            }
+
+            if (! entry.types.isEmpty())
+                cache[e->getStringAttribute ("key")] = entry;
+        }
+    }
+}
+
+void OutOfProcessPluginScanner::saveCache()
+{
+    const ScopedLock sl (cacheLock);
+
+    if (! cacheNeedsSaving || cacheFile == File())
+        return;
+
+    XmlElement xml ("PLUGINSCANCACHE");
+
+    for (const auto& [key, entry] : cache)
+    {
+        auto* e = xml.createNewChildElement ("FILE");
+        e->setAttribute ("key", key);
+        e->setAttribute ("modified", String (entry.modificationTime));
+        e->setAttribute ("size", String (entry.size));
+
+        for (const auto& desc : entry.types)
+            e->addChildElement (desc.createXml().release());
+    }
+
+    if (xml.writeTo (cacheFile))
+        cacheNeedsSaving = false;
+}
+
+void OutOfProcessPluginScanner::clearCache()
+{
+    const ScopedLock sl (cacheLock);
+    cacheNeedsSaving = cacheNeedsSaving || ! cache.empty();
+    cache.clear();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct OutOfProcessPluginScannerTests final : public UnitTest
+{
+    OutOfProcessPluginScannerTests()
+        : UnitTest ("OutOfProcessPluginScanner cache", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        const auto folder = File::createTempFile ({});
+        folder.createDirectory();
+        const ScopeGuard deleteFolder { [&] { folder.deleteRecursively(); } };
+
+        const auto plugin = createFile (folder.getChildFile ("plugin.so"), "plugin");
+        const auto key = "Format:" + plugin.getFullPathName();
+
+        beginTest ("Results are reused while the file is unchanged");
+        {
+            OutOfProcessPluginScanner scanner { File() };
+            store (scanner, key, plugin, { createDescription ("A"), createDescription ("B") });
+
+            const auto types = findCachedTypes (scanner, key, plugin);
+            expect (types.has_value());
+            expectEquals (types->size(), 2);
+            expectEquals (types->getUnchecked (1)->name, String ("B"));
+
+            expect (! findCachedTypes (scanner, "Other:" + plugin.getFullPathName(), plugin).has_value());
+        }
+
+        beginTest ("Changing a file's size or modification time invalidates its results");
+        {
+            OutOfProcessPluginScanner scanner { File() };
+            store (scanner, key, plugin, { createDescription ("A") });
+
+            const auto originalTime = plugin.getLastModificationTime();
+            plugin.appendText ("more");
+            plugin.setLastModificationTime (originalTime);
+            expect (! findCachedTypes (scanner, key, plugin).has_value());
+
+            store (scanner, key, plugin, { createDescription ("A") });
+            expect (findCachedTypes (scanner, key, plugin).has_value());
+
+            plugin.setLastModificationTime (originalTime + RelativeTime::seconds (10.0));
+            expect (! findCachedTypes (scanner, key, plugin).has_value());
+        }
+
+        beginTest ("Changing any file inside a bundle invalidates its results");
+        {
+            const auto bundle = folder.getChildFile ("plugin.vst3");
+            const auto binary = createFile (bundle.getChildFile ("Contents/x86_64-linux/plugin.so"), "binary");
+            const auto info = createFile (bundle.getChildFile ("Contents/Resources/moduleinfo.json"), "{}");
+            const auto bundleKey = "Format:" + bundle.getFullPathName();
+
+            OutOfProcessPluginScanner scanner { File() };
+            store (scanner, bundleKey, bundle, { createDescription ("A") });
+            expect (findCachedTypes (scanner, bundleKey, bundle).has_value());
+
+            info.setLastModificationTime (Time::getCurrentTime() + RelativeTime::seconds (10.0));
+            expect (! findCachedTypes (scanner, bundleKey, bundle).has_value());
+
+            store (scanner, bundleKey, bundle, { createDescription ("A") });
+            const auto originalTime = binary.getLastModificationTime();
+            binary.replaceWithText ("different binary");
+            binary.setLastModificationTime (originalTime);
+            expect (! findCachedTypes (scanner, bundleKey, bundle).has_value());
+        }
+
+        beginTest ("Failed scans aren't cached, and remove any previous results");
+        {
+            OutOfProcessPluginScanner scanner { File() };
+            store (scanner, key, plugin, {});
+            expect (! findCachedTypes (scanner, key, plugin).has_value());
+
+            store (scanner, key, plugin, { createDescription ("A") });
+            expect (findCachedTypes (scanner, key, plugin).has_value());
+
+            // A crash or timeout
+            scanner.updateCache (key, {}, {});
+            expect (! findCachedTypes (scanner, key, plugin).has_value());
+
+            store (scanner, key, plugin, { createDescription ("A") });
+            store (scanner, key, plugin, {});
+            expect (! findCachedTypes (scanner, key, plugin).has_value());
+        }
+
+        beginTest ("Identifiers that aren't files aren't cached");
+        {
+            expect (! OutOfProcessPluginScanner::createCacheEntry ("com.example.plugin").has_value());
+            expect (! OutOfProcessPluginScanner::createCacheEntry (folder.getChildFile ("missing.so").getFullPathName()).has_value());
+        }
+
+        beginTest ("The cache is saved and reloaded");
+        {
+            const auto cacheFile = folder.getChildFile ("cache.xml");
+
+            {
+                OutOfProcessPluginScanner scanner { File() };
+                scanner.setCacheFile (cacheFile);
+                store (scanner, key, plugin, { createDescription ("A") });
+                scanner.saveCache();
+            }
+
+            {
+                OutOfProcessPluginScanner scanner { File() };
+                scanner.setCacheFile (cacheFile);
+
+                const auto types = findCachedTypes (scanner, key, plugin);
+                expect (types.has_value());
+                expectEquals (types->size(), 1);
+                expectEquals (types->getUnchecked (0)->name, String ("A"));
+
+                scanner.clearCache();
+                expect (! findCachedTypes (scanner, key, plugin).has_value());
+            }
+
+            {
+                OutOfProcessPluginScanner scanner { File() };
+                scanner.setCacheFile (cacheFile);
+                expect (! findCachedTypes (scanner, key, plugin).has_value());
+            }
+        }
+
+        beginTest ("Empty results in an old cache file are ignored");
+        {
+            const auto cacheFile = folder.getChildFile ("oldCache.xml");
+            const auto entry = OutOfProcessPluginScanner::createCacheEntry (plugin.getFullPathName());
+
+            XmlElement xml ("PLUGINSCANCACHE");
+            auto* e = xml.createNewChildElement ("FILE");
+            e->setAttribute ("key", key);
+            e->setAttribute ("modified", String (entry->modificationTime));
+            e->setAttribute ("size", String (entry->size));
+            expect (xml.writeTo (cacheFile));
+
+            OutOfProcessPluginScanner scanner { File() };
+            scanner.setCacheFile (cacheFile);
+            expect (! findCachedTypes (scanner, key, plugin).has_value());
+        }
+    }
+
+    static File createFile (const File& file, const String& content)
+    {
+        file.create();
+        file.replaceWithText (content);
+        return file;
+    }
+
+    static PluginDescription createDescription (const String& name)
+    {
+        PluginDescription desc;
+        desc.name = name;
+        desc.pluginFormatName = "Format";
+        desc.fileOrIdentifier = name;
+        return desc;
+    }
+
+    static void store (OutOfProcessPluginScanner& scanner, const String& key, const File& file,
+                       const Array<PluginDescription>& types)
+    {
+        scanner.updateCache (key, OutOfProcessPluginScanner::createCacheEntry (file.getFullPathName()), types);
+    }
+
+    static std::optional<OwnedArray<PluginDescription>> findCachedTypes (OutOfProcessPluginScanner& scanner,
+                                                                        const String& key, const File& file)
+    {
+        const auto entry = OutOfProcessPluginScanner::createCacheEntry (file.getFullPathName());
+        OwnedArray<PluginDescription> types;
+
+        if (entry.has_value() && scanner.findCachedTypes (key, *entry, types))
+            return types;
+
+        return {};
+    }
+};
+
+static OutOfProcessPluginScannerTests outOfProcessPluginScannerTests;
+
+#endif
+
+} // namespace juce
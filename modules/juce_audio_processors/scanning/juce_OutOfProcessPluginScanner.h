@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A KnownPluginList::CustomScanner that scans each plugin file in a separate worker
+    process, so that plugins which crash or hang while being scanned can't take the
+    host down with them.
+
+    The workers are launched from an executable that you provide, which must hand its
+    command line to an OutOfProcessPluginWorker (see that class for an example). Each
+    worker is reused for as many files as it can scan successfully. If a worker
+    crashes, or takes longer than the timeout to scan a file, it's killed, and the
+    file is reported as having crashed, so the KnownPluginList will blacklist it.
+
+    This object is thread-safe, and will run up to the given number of workers at once,
+    so to scan several files in parallel, use it with a PluginListComponent and call
+    PluginListComponent::setNumberOfThreadsForScanning(), or call
+    PluginDirectoryScanner::scanNextFile() from several threads.
+
+    If you call setCacheFile(), the results of each scan are stored along with the
+    modification time and size of the file (or of the files inside a bundle), and
+    files that haven't changed since they were last scanned are taken from the cache
+    instead of being loaded again. Files that crashed, timed out or didn't contain any
+    plugins aren't cached, so they'll be tried again by the next scan.
+
+    @code
+    auto scanner = std::make_unique<OutOfProcessPluginScanner> (File::getSpecialLocation (File::currentExecutableFile));
+    scanner->setCacheFile (appDataFolder.getChildFile ("PluginScanCache.xml"));
+    knownPluginList.setCustomScanner (std::move (scanner));
+
+    pluginListComponent.setNumberOfThreadsForScanning (SystemStats::getNumCpus());
+    @endcode
+
+    @see OutOfProcessPluginWorker, KnownPluginList::setCustomScanner, PluginDirectoryScanner
+
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginScanner   : public KnownPluginList::CustomScanner
+{
+public:
+    //==============================================================================
+    /** Creates a scanner that will launch workers from the given executable, running
+        no more than maxNumWorkers of them at a time.
+    */
+    explicit OutOfProcessPluginScanner (const File& workerExecutable,
+                                        int maxNumWorkers = SystemStats::getNumCpus());
+
+    /** Destructor. This saves the cache, if there is one, and kills any workers. */
+    ~OutOfProcessPluginScanner() override;
+
+    //==============================================================================
+    /** Sets how long a worker may spend scanning a single file before it's assumed
+        to have hung. The default is 30 seconds.
+    */
+    void setTimeout (int milliseconds) noexcept;
+
+    /** Sets a file in which to keep the results of previous scans, and loads any results
+        that are already in it. Passing File() disables the cache.
+    */
+    void setCacheFile (const File& cacheFile);
+
+    /** Writes the cache to the cache file, if anything has changed since it was last saved.
+        This is called automatically when a scan finishes.
+    */
+    void saveCache();
+
+    /** Removes all the cached results. */
+    void clearCache();
+
+    //==============================================================================
+    /** @internal */
+    bool findPluginTypesFor (AudioPluginFormat&, OwnedArray<PluginDescription>&, const String&) override;
+    /** @internal */
+    void scanFinished() override;
+
+private:
+    //==============================================================================
+    using Worker = OutOfProcessPluginInstance::Coordinator;
+    friend struct OutOfProcessPluginScannerTests;
+
+    struct CacheEntry
+    {
+        int64 modificationTime = 0, size = 0;
+        Array<PluginDescription> types;
+    };
+
+    std::unique_ptr<Worker> getWorker();
+    void returnWorker (std::unique_ptr<Worker>);
+    static std::optional<CacheEntry> createCacheEntry (const String& fileOrIdentifier);
+    bool findCachedTypes (const String& key, const CacheEntry&, OwnedArray<PluginDescription>&) const;
+    void updateCache (const String& key, std::optional<CacheEntry>, const Array<PluginDescription>&);
+
+    const File executable;
+    const int maxWorkers;
+    std::atomic<int> timeoutMs { 30000 };
+
+    CriticalSection workerLock;
+    std::vector<std::unique_ptr<Worker>> idleWorkers;
+    int numWorkers = 0;
+    WaitableEvent workerReturned;
+
+    mutable CriticalSection cacheLock;
+    File cacheFile;
+    std::map<String, CacheEntry> cache;
+    bool cacheNeedsSaving = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginScanner)
+};
+
+} // namespace juce
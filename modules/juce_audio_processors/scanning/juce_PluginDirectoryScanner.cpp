@@ -105,14 +105,20 @@ bool PluginDirectoryScanner::scanNextFile (bool dontRescanIfAlreadyInList,
             OwnedArray<PluginDescription> typesFound;
 
             // Add this plugin to the end of the dead-man's pedal list in case it crashes...
-            auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
-            crashedPlugins.removeString (file);
-            crashedPlugins.add (file);
-            setDeadMansPedalFile (crashedPlugins);
+            // The file is re-read each time, because other threads may be scanning other files
+            {
+                const ScopedLock sl (lock);
+                auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
+                crashedPlugins.removeString (file);
+                crashedPlugins.add (file);
+                setDeadMansPedalFile (crashedPlugins);
+            }
 
             list.scanAndAddFile (file, dontRescanIfAlreadyInList, typesFound, format);
 
             // Managed to load without crashing, so remove it from the dead-man's-pedal..
+            const ScopedLock sl (lock);
+            auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
             crashedPlugins.removeString (file);
             setDeadMansPedalFile (crashedPlugins);
 
@@ -133,6 +133,7 @@ private:
     AudioPluginFormat& format;
     StringArray filesOrIdentifiersToScan;
     File deadMansPedalFile;
+    CriticalSection lock;
     StringArray failedFiles;
     Atomic<int> nextIndex;
     std::atomic<float> progress { 0.0f };
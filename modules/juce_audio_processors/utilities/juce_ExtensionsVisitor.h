@@ -126,6 +126,23 @@ struct ExtensionsVisitor
         virtual void createARAFactoryAsync (std::function<void (ARAFactoryWrapper)>) const = 0;
     };
 
+    /** Can be used to retrieve information about an LV2 plugin that is wrapped by an AudioProcessor. */
+    struct LV2Client
+    {
+        /** Timings gathered while the plugin processes audio. All times are in seconds. */
+        struct ProcessingTimes
+        {
+            int64 numBlocks = 0;            /**< The number of blocks that have been processed. */
+            double timeInPlugin = 0;        /**< The total time spent in the plugin's run() and worker response functions. */
+            double timeInHost = 0;          /**< The total time spent moving audio, MIDI, parameters and messages to and from the plugin's ports. */
+            double maxTimeInPlugin = 0;     /**< The longest time spent in the plugin during a single block. */
+        };
+
+        virtual ~LV2Client() = default;
+        virtual ProcessingTimes getProcessingTimes() const = 0;
+        virtual void resetProcessingTimes() const = 0;
+    };
+
     ExtensionsVisitor() = default;
 
     ExtensionsVisitor (const ExtensionsVisitor&) = default;
@@ -150,6 +167,9 @@ struct ExtensionsVisitor
 
     /** Called with ARA-specific information. */
     virtual void visitARAClient         (const ARAClient&)       {}
+
+    /** Called with LV2-specific information. */
+    virtual void visitLV2Client         (const LV2Client&)       {}
 };
 
 } // namespace juce
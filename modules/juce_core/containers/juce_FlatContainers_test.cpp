@@ -0,0 +1,305 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class FlatContainersTests final : public UnitTest
+{
+public:
+    FlatContainersTests()
+        : UnitTest ("Flat containers", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("FlatHashMap matches std::map after random changes");
+        {
+            FlatHashMap<int, int> map;
+            std::map<int, int> groundTruth;
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                const auto key = random.nextInt (2000);
+
+                switch (random.nextInt (4))
+                {
+                    case 0:
+                        expectEquals ((int) map.remove (key), (int) groundTruth.erase (key));
+                        break;
+
+                    case 1:
+                        ++map.getReference (key);
+                        ++groundTruth[key];
+                        break;
+
+                    default:
+                        map.set (key, i);
+                        groundTruth[key] = i;
+                        break;
+                }
+            }
+
+            expectMatches (map, groundTruth);
+
+            for (int key = -10; key < 2010; ++key)
+            {
+                const auto iter = groundTruth.find (key);
+                const auto* value = map.getPointer (key);
+
+                expect ((iter == groundTruth.end()) == (value == nullptr));
+                expect (value == nullptr || *value == iter->second);
+                expectEquals (map[key], iter != groundTruth.end() ? iter->second : 0);
+            }
+        }
+
+        beginTest ("FlatHashMap can be copied, moved and cleared");
+        {
+            FlatHashMap<String, String> map;
+
+            for (int i = 0; i < 100; ++i)
+                map.set (String (i), "value " + String (i));
+
+            auto copy = map;
+            expectEquals (copy.size(), 100);
+            expectEquals (copy["42"], String ("value 42"));
+
+            copy.set ("42", "changed");
+            expectEquals (map["42"], String ("value 42"));
+
+            auto moved = std::move (copy);
+            expectEquals (moved.size(), 100);
+            expectEquals (moved["42"], String ("changed"));
+
+            moved = map;
+            expectEquals (moved["42"], String ("value 42"));
+
+            moved.clear();
+            expect (moved.isEmpty());
+            expect (! moved.contains ("42"));
+
+            moved.set ("a", "b");
+            expectEquals (moved.size(), 1);
+        }
+
+        beginTest ("FlatHashMap emplace only adds missing keys");
+        {
+            FlatHashMap<int, std::unique_ptr<int>> map;
+
+            auto [first, added] = map.emplace (1, std::make_unique<int> (10));
+            expect (added && *first == 10);
+
+            auto [second, addedAgain] = map.emplace (1, std::make_unique<int> (20));
+            expect (! addedAgain && *second == 10);
+        }
+
+        beginTest ("FlatHashMap removeIf");
+        {
+            FlatHashMap<int, int> map;
+
+            for (int i = 0; i < 1000; ++i)
+                map.set (i, i * 2);
+
+            expectEquals (map.removeIf ([] (const auto& item) { return item.first % 3 == 0; }), 334);
+            expectEquals (map.size(), 666);
+
+            for (int i = 0; i < 1000; ++i)
+                expect (map.contains (i) == (i % 3 != 0));
+
+            int numVisited = 0;
+
+            for (auto& [key, value] : map)
+            {
+                expectEquals (value, key * 2);
+                ++numVisited;
+            }
+
+            expectEquals (numVisited, map.size());
+        }
+
+        beginTest ("FlatHashSet supports heterogeneous lookup");
+        {
+            struct Hash
+            {
+                size_t operator() (const String& s) const noexcept      { return operator() (std::string_view (s.toRawUTF8())); }
+                size_t operator() (std::string_view s) const noexcept   { return std::hash<std::string_view>() (s); }
+            };
+
+            struct Equal
+            {
+                bool operator() (const String& a, const String& b) const noexcept          { return a == b; }
+                bool operator() (const String& a, std::string_view b) const noexcept       { return std::string_view (a.toRawUTF8()) == b; }
+            };
+
+            FlatHashSet<String, Hash, Equal> set { "one", "two", "three" };
+
+            expect (! set.add ("two"));
+            expect (set.add ("four"));
+            expectEquals (set.size(), 4);
+
+            expect (set.contains (std::string_view ("three")));
+            expect (! set.contains (std::string_view ("five")));
+
+            auto* found = set.find (std::string_view ("one"));
+            expect (found != nullptr && *found == "one");
+
+            expect (set.remove (std::string_view ("one")));
+            expect (! set.remove (std::string_view ("one")));
+            expectEquals (set.size(), 3);
+        }
+
+        beginTest ("FlatHashSet matches std::set after random changes");
+        {
+            FlatHashSet<int> set;
+            std::set<int> groundTruth;
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                const auto value = random.nextInt (500);
+
+                if (random.nextBool())
+                    expect (set.add (value) == groundTruth.insert (value).second);
+                else
+                    expect (set.remove (value) == (groundTruth.erase (value) != 0));
+            }
+
+            expectEquals (set.size(), (int) groundTruth.size());
+
+            for (auto value : set)
+                expect (groundTruth.count (value) == 1);
+        }
+
+        beginTest ("FlatMap matches std::map after random changes, and stays sorted");
+        {
+            FlatMap<int, int> map;
+            std::map<int, int> groundTruth;
+
+            for (int i = 0; i < 5000; ++i)
+            {
+                const auto key = random.nextInt (300);
+
+                if (random.nextInt (3) == 0)
+                {
+                    expectEquals ((int) map.remove (key), (int) groundTruth.erase (key));
+                }
+                else
+                {
+                    map.set (key, i);
+                    groundTruth[key] = i;
+                }
+            }
+
+            expectEquals (map.size(), (int) groundTruth.size());
+            expect (std::equal (map.begin(), map.end(), groundTruth.begin(), groundTruth.end(),
+                                [] (const auto& a, const auto& b) { return a.first == b.first && a.second == b.second; }));
+
+            expectEquals (map.removeIf ([] (const auto& item) { return item.first < 100; }),
+                          (int) std::count_if (groundTruth.begin(), groundTruth.end(), [] (const auto& item) { return item.first < 100; }));
+            expect (map.isEmpty() || map.begin()->first >= 100);
+        }
+
+        beginTest ("FlatMap supports heterogeneous lookup");
+        {
+            FlatMap<std::string, int> map { { "b", 2 }, { "a", 1 }, { "c", 3 } };
+
+            expect (map.begin()->first == "a");
+            expect (map.contains (std::string_view ("b")));
+            expectEquals (map["c"], 3);
+            expectEquals (map["d"], 0);
+
+            map.getReference ("d") = 4;
+            expectEquals (map.size(), 4);
+            expectEquals ((map.end() - 1)->second, 4);
+        }
+
+        beginTest ("StringPool returns the same string for matching text");
+        {
+            StringPool pool;
+
+            const String text ("pooled text");
+            const auto a = pool.getPooledString (text);
+            const auto b = pool.getPooledString ("pooled text");
+            const auto c = pool.getPooledString (StringRef ("pooled text"));
+            const auto d = pool.getPooledString (text.getCharPointer(), text.getCharPointer() + 6);
+            const auto e = pool.getPooledString (String::fromUTF8 ("pooled"));
+
+            expect (a.getCharPointer() == b.getCharPointer());
+            expect (a.getCharPointer() == c.getCharPointer());
+            expect (d.getCharPointer() == e.getCharPointer());
+            expectEquals (d, String ("pooled"));
+            expect (a.getCharPointer() != text.getCharPointer() || a == text);
+
+            const auto unicode = pool.getPooledString ((const char*) "\xc3\xa9t\xc3\xa9");
+            expect (unicode.getCharPointer() == pool.getPooledString (String::fromUTF8 ("\xc3\xa9t\xc3\xa9")).getCharPointer());
+        }
+
+        beginTest ("StringPool garbage collection only removes unreferenced strings");
+        {
+            StringPool pool;
+            Array<String> kept;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto s = pool.getPooledString ("string " + String (i));
+
+                if (i % 2 == 0)
+                    kept.add (s);
+            }
+
+            pool.garbageCollect();
+
+            for (int i = 0; i < 1000; i += 2)
+                expect (pool.getPooledString ("string " + String (i)).getCharPointer() == kept[i / 2].getCharPointer());
+        }
+    }
+
+private:
+    template <typename Map, typename GroundTruth>
+    void expectMatches (const Map& map, const GroundTruth& groundTruth)
+    {
+        expectEquals (map.size(), (int) groundTruth.size());
+
+        for (const auto& [key, value] : map)
+        {
+            const auto iter = groundTruth.find (key);
+            expect (iter != groundTruth.end() && iter->second == value);
+        }
+    }
+};
+
+static FlatContainersTests flatContainersTests;
+
+} // namespace juce
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, in a single open-addressed
+    hash table.
+
+    Unlike HashMap, which allocates a separate node for each entry, a FlatHashMap keeps
+    all of its keys and values together in one block of memory. Looking up a key only
+    needs to touch a few neighbouring bytes of metadata before going straight to the
+    matching entry, which makes it much more cache-friendly than HashMap or a search
+    through an Array of pairs, once there are more than a handful of items.
+
+    The hash and equality functions can be changed with the HashType and EqualType
+    template parameters. If these can accept types other than KeyType, then those types
+    can be used to look up keys, without having to create a KeyType first.
+
+    Adding or removing items can move the other items around in memory, so pointers and
+    iterators to the items must not be kept across calls that modify the map.
+
+    @code
+    FlatHashMap<String, int> map;
+    map.set ("one", 1);
+    map.set ("two", 2);
+
+    if (auto* value = map.getPointer ("one"))
+        DBG (*value); // prints "1"
+
+    for (auto& [key, value] : map)
+        DBG (key << " -> " << value);
+    @endcode
+
+    @see FlatHashSet, FlatMap, HashMap
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          typename HashType = std::hash<KeyType>,
+          typename EqualType = std::equal_to<>>
+class FlatHashMap
+{
+    struct KeyOf
+    {
+        static const KeyType& get (const std::pair<const KeyType, ValueType>& item) noexcept    { return item.first; }
+    };
+
+    using Table = detail::FlatHashTable<std::pair<const KeyType, ValueType>, KeyOf, HashType, EqualType>;
+
+public:
+    //==============================================================================
+    using Item          = std::pair<const KeyType, ValueType>;
+    using Iterator      = typename Table::template Iterator<Item>;
+    using ConstIterator = typename Table::template Iterator<const Item>;
+
+    /** Creates an empty map. */
+    FlatHashMap() = default;
+
+    /** Creates a map containing some key/value pairs. */
+    FlatHashMap (std::initializer_list<Item> items)
+    {
+        reserve ((int) items.size());
+
+        for (auto& item : items)
+            set (item.first, item.second);
+    }
+
+    //==============================================================================
+    /** Returns the number of items in the map. */
+    int size() const noexcept                                   { return (int) table.size(); }
+
+    /** Returns true if the map is empty. */
+    bool isEmpty() const noexcept                               { return table.size() == 0; }
+
+    /** Removes all the items, but keeps the storage allocated. */
+    void clear() noexcept                                       { table.clear(); }
+
+    /** Makes sure that there's space for at least this many items without the map
+        having to reallocate.
+    */
+    void reserve (int numItems)                                 { table.reserve ((size_t) jmax (0, numItems)); }
+
+    //==============================================================================
+    /** Returns true if the map contains an item with the given key. */
+    template <typename Key>
+    bool contains (const Key& key) const                        { return table.findIndex (key) != table.getCapacity(); }
+
+    /** Returns a pointer to the value for a key, or nullptr if the key isn't found.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename Key>
+    ValueType* getPointer (const Key& key)
+    {
+        const auto index = table.findIndex (key);
+        return index != table.getCapacity() ? &table.getElement (index).second : nullptr;
+    }
+
+    /** Returns a pointer to the value for a key, or nullptr if the key isn't found.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename Key>
+    const ValueType* getPointer (const Key& key) const
+    {
+        const auto index = table.findIndex (key);
+        return index != table.getCapacity() ? &table.getElement (index).second : nullptr;
+    }
+
+    /** Returns a copy of the value for a key, or a default-constructed value if the key
+        isn't found.
+    */
+    template <typename Key>
+    ValueType operator[] (const Key& key) const
+    {
+        if (auto* value = getPointer (key))
+            return *value;
+
+        return ValueType();
+    }
+
+    /** Returns a reference to the value for a key, adding a default-constructed value
+        first if the key isn't already in the map.
+    */
+    ValueType& getReference (const KeyType& key)
+    {
+        return table.getElement (table.findOrEmplace (key, std::piecewise_construct,
+                                                      std::forward_as_tuple (key),
+                                                      std::forward_as_tuple()).first).second;
+    }
+
+    //==============================================================================
+    /** Sets the value for a key, adding a new item or replacing the existing value. */
+    void set (const KeyType& key, ValueType value)
+    {
+        auto [index, added] = table.findOrEmplace (key, key, std::move (value));
+
+        if (! added)
+            table.getElement (index).second = std::move (value);
+    }
+
+    /** Adds a value constructed from the given arguments, if the key isn't already in the
+        map. Returns a reference to the value for the key, and true if it was added.
+    */
+    template <typename... Args>
+    std::pair<ValueType&, bool> emplace (const KeyType& key, Args&&... args)
+    {
+        auto [index, added] = table.findOrEmplace (key, std::piecewise_construct,
+                                                   std::forward_as_tuple (key),
+                                                   std::forward_as_tuple (std::forward<Args> (args)...));
+        return { table.getElement (index).second, added };
+    }
+
+    /** Removes the item with the given key, returning true if there was one. */
+    template <typename Key>
+    bool remove (const Key& key)
+    {
+        const auto index = table.findIndex (key);
+
+        if (index == table.getCapacity())
+            return false;
+
+        table.eraseAt (index);
+        return true;
+    }
+
+    /** Removes all the items for which the predicate returns true, and returns the
+        number of items removed. The predicate is passed a reference to each Item.
+    */
+    template <typename Predicate>
+    int removeIf (Predicate&& predicate)                        { return (int) table.eraseIf (std::forward<Predicate> (predicate)); }
+
+    //==============================================================================
+    /** Returns an iterator to the first item. The order of the items is unspecified. */
+    Iterator begin() noexcept                                   { return { &table, table.skipToElement (0) }; }
+    Iterator end() noexcept                                     { return { &table, table.getCapacity() }; }
+    ConstIterator begin() const noexcept                        { return { &table, table.skipToElement (0) }; }
+    ConstIterator end() const noexcept                          { return { &table, table.getCapacity() }; }
+
+private:
+    Table table;
+};
+
+} // namespace juce
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a set of unique values in a single open-addressed hash table.
+
+    This works in the same way as FlatHashMap, but stores only keys. Like SortedSet, it
+    won't hold more than one copy of any value, but adding, finding and removing values
+    all take roughly constant time, however many values it holds. The values aren't
+    kept in any particular order.
+
+    The hash and equality functions can be changed with the HashType and EqualType
+    template parameters. If these can accept types other than ValueType, then those
+    types can be used to look up values, without having to create a ValueType first.
+
+    Adding or removing values can move the other values around in memory, so pointers
+    and iterators to them must not be kept across calls that modify the set.
+
+    @see FlatHashMap, SortedSet
+
+    @tags{Core}
+*/
+template <typename ValueType,
+          typename HashType = std::hash<ValueType>,
+          typename EqualType = std::equal_to<>>
+class FlatHashSet
+{
+    struct KeyOf
+    {
+        static const ValueType& get (const ValueType& value) noexcept   { return value; }
+    };
+
+    using Table = detail::FlatHashTable<ValueType, KeyOf, HashType, EqualType>;
+
+public:
+    //==============================================================================
+    using Iterator = typename Table::template Iterator<const ValueType>;
+
+    /** Creates an empty set. */
+    FlatHashSet() = default;
+
+    /** Creates a set containing some values. */
+    FlatHashSet (std::initializer_list<ValueType> values)
+    {
+        reserve ((int) values.size());
+
+        for (auto& value : values)
+            add (value);
+    }
+
+    //==============================================================================
+    /** Returns the number of values in the set. */
+    int size() const noexcept                                   { return (int) table.size(); }
+
+    /** Returns true if the set is empty. */
+    bool isEmpty() const noexcept                               { return table.size() == 0; }
+
+    /** Removes all the values, but keeps the storage allocated. */
+    void clear() noexcept                                       { table.clear(); }
+
+    /** Makes sure that there's space for at least this many values without the set
+        having to reallocate.
+    */
+    void reserve (int numValues)                                { table.reserve ((size_t) jmax (0, numValues)); }
+
+    //==============================================================================
+    /** Returns true if the set contains a value that matches this one. */
+    template <typename Key>
+    bool contains (const Key& key) const                        { return table.findIndex (key) != table.getCapacity(); }
+
+    /** Returns a pointer to the value in the set that matches the given one, or nullptr if
+        there isn't one. The pointer is only valid until the set is next modified.
+    */
+    template <typename Key>
+    const ValueType* find (const Key& key) const
+    {
+        const auto index = table.findIndex (key);
+        return index != table.getCapacity() ? &table.getElement (index) : nullptr;
+    }
+
+    /** Adds a value to the set, if it doesn't already contain a matching one.
+        Returns true if the value was added.
+    */
+    bool add (const ValueType& value)                           { return table.findOrEmplace (value, value).second; }
+
+    /** Adds a value to the set, if it doesn't already contain a matching one.
+        Returns true if the value was added.
+    */
+    bool add (ValueType&& value)                                { return table.findOrEmplace (value, std::move (value)).second; }
+
+    /** Removes the value that matches the given one, returning true if there was one. */
+    template <typename Key>
+    bool remove (const Key& key)
+    {
+        const auto index = table.findIndex (key);
+
+        if (index == table.getCapacity())
+            return false;
+
+        table.eraseAt (index);
+        return true;
+    }
+
+    /** Removes all the values for which the predicate returns true, and returns the
+        number of values removed.
+    */
+    template <typename Predicate>
+    int removeIf (Predicate&& predicate)                        { return (int) table.eraseIf (std::forward<Predicate> (predicate)); }
+
+    //==============================================================================
+    /** Returns an iterator to the first value. The order of the values is unspecified. */
+    Iterator begin() const noexcept                             { return { &table, table.skipToElement (0) }; }
+    Iterator end() const noexcept                               { return { &table, table.getCapacity() }; }
+
+private:
+    Table table;
+};
+
+} // namespace juce
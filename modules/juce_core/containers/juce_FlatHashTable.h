@@ -0,0 +1,402 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#ifndef DOXYGEN
+namespace detail
+{
+
+/*  The open-addressing hash table used by FlatHashMap and FlatHashSet.
+
+    The elements live in a single array of slots, alongside an array holding a control
+    byte for each slot. A control byte records whether its slot is empty, or contains an
+    erased element, or else holds 7 bits of the hash of the element in the slot.
+
+    Slots are looked at in groups of 8, reading a group's control bytes as a single
+    64-bit word. A few integer operations then find every slot in the group whose hash
+    bits match the key being looked for, so the keys themselves only need comparing in
+    the rare case that these match but the keys are different.
+*/
+template <typename Element, typename KeyOf, typename Hash, typename Equal>
+class FlatHashTable
+{
+public:
+    FlatHashTable() = default;
+
+    FlatHashTable (const FlatHashTable& other)
+        : hash (other.hash), equal (other.equal)
+    {
+        if (other.capacity == 0)
+            return;
+
+        allocate (other.capacity);
+
+        for (size_t i = 0; i < capacity; ++i)
+            if (isFull (other.control[i]))
+                new (slots + i) Element (other.slots[i]);
+
+        std::copy (other.control.get(), other.control.get() + capacity, control.get());
+        numElements = other.numElements;
+        numErased = other.numErased;
+    }
+
+    FlatHashTable (FlatHashTable&& other) noexcept
+    {
+        swapWith (other);
+    }
+
+    FlatHashTable& operator= (const FlatHashTable& other)
+    {
+        if (this != &other)
+        {
+            auto copy = other;
+            swapWith (copy);
+        }
+
+        return *this;
+    }
+
+    FlatHashTable& operator= (FlatHashTable&& other) noexcept
+    {
+        FlatHashTable old;
+        swapWith (other);
+        old.swapWith (other);
+        return *this;
+    }
+
+    ~FlatHashTable()
+    {
+        destroyElements();
+    }
+
+    void swapWith (FlatHashTable& other) noexcept
+    {
+        std::swap (hash, other.hash);
+        std::swap (equal, other.equal);
+        control.swapWith (other.control);
+        slotStorage.swapWith (other.slotStorage);
+        std::swap (slots, other.slots);
+        std::swap (capacity, other.capacity);
+        std::swap (numElements, other.numElements);
+        std::swap (numErased, other.numErased);
+    }
+
+    //==============================================================================
+    size_t size() const noexcept            { return numElements; }
+
+    void clear() noexcept
+    {
+        destroyElements();
+        std::fill (control.get(), control.get() + capacity, emptyControl);
+        numElements = 0;
+        numErased = 0;
+    }
+
+    void reserve (size_t numElementsNeeded)
+    {
+        if (numElementsNeeded > getMaxLoad (capacity))
+            rehash (getCapacityNeeded (numElementsNeeded));
+    }
+
+    //==============================================================================
+    /*  Returns the index of the element matching the key, or getCapacity() if there isn't one. */
+    template <typename Key>
+    size_t findIndex (const Key& key) const
+    {
+        if (numElements == 0)
+            return capacity;
+
+        const auto h = getHash (key);
+        const auto tag = getTag (h);
+        const auto groupMask = getNumGroups() - 1;
+        auto group = getFirstGroup (h) & groupMask;
+
+        for (size_t step = 1;; ++step)
+        {
+            const auto controlBytes = loadGroup (group);
+
+            for (auto matches = matchTag (controlBytes, tag); matches != 0; matches &= matches - 1)
+            {
+                const auto index = group * groupSize + getLowestMatch (matches);
+
+                if (equal (KeyOf::get (slots[index]), key))
+                    return index;
+            }
+
+            if (matchEmpty (controlBytes) != 0)
+                return capacity;
+
+            // Stepping by 1, 2, 3... groups visits every group, as the number of groups is a power of 2
+            group = (group + step) & groupMask;
+        }
+    }
+
+    /*  Finds the element matching a key, or if there isn't one, constructs a new element
+        from the arguments. Returns the element's index and whether it was added.
+    */
+    template <typename Key, typename... Args>
+    std::pair<size_t, bool> findOrEmplace (const Key& key, Args&&... args)
+    {
+        const auto existing = findIndex (key);
+
+        if (existing != capacity)
+            return { existing, false };
+
+        if (numElements + numErased + 1 > getMaxLoad (capacity))
+        {
+            // If a lot of the table is taken up by erased elements, just clearing these out
+            // will make enough room
+            const auto newCapacity = numElements + 1 > getMaxLoad (capacity) / 2 ? getCapacityNeeded (numElements + 1)
+                                                                                 : capacity;
+            rehash (jmax (newCapacity, (size_t) groupSize));
+        }
+
+        const auto h = getHash (key);
+        const auto index = findFreeSlot (h);
+
+        new (slots + index) Element (std::forward<Args> (args)...);
+
+        if (control[index] == erasedControl)
+            --numErased;
+
+        control[index] = getTag (h);
+        ++numElements;
+        return { index, true };
+    }
+
+    void eraseAt (size_t index) noexcept
+    {
+        jassert (isFull (control[index]));
+
+        slots[index].~Element();
+        --numElements;
+
+        // A lookup stops at the first group that contains an empty slot, so if this group
+        // already has one, no other element can rely on this slot staying occupied
+        if (matchEmpty (loadGroup (index / groupSize)) != 0)
+        {
+            control[index] = emptyControl;
+        }
+        else
+        {
+            control[index] = erasedControl;
+            ++numErased;
+        }
+    }
+
+    template <typename Predicate>
+    size_t eraseIf (Predicate&& predicate)
+    {
+        const auto numBefore = numElements;
+
+        for (size_t i = 0; i < capacity; ++i)
+            if (isFull (control[i]) && predicate (slots[i]))
+                eraseAt (i);
+
+        return numBefore - numElements;
+    }
+
+    //==============================================================================
+    size_t getCapacity() const noexcept                         { return capacity; }
+    Element& getElement (size_t index) noexcept                 { return slots[index]; }
+    const Element& getElement (size_t index) const noexcept     { return slots[index]; }
+
+    /*  Returns the index of the first element at or after the given index. */
+    size_t skipToElement (size_t index) const noexcept
+    {
+        while (index < capacity && ! isFull (control[index]))
+            ++index;
+
+        return index;
+    }
+
+    template <typename ElementType>
+    struct Iterator
+    {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = std::remove_const_t<ElementType>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = ElementType*;
+        using reference         = ElementType&;
+
+        reference operator*() const noexcept                    { return table->slots[index]; }
+        pointer operator->() const noexcept                     { return table->slots + index; }
+        Iterator& operator++() noexcept                         { index = table->skipToElement (index + 1); return *this; }
+        Iterator operator++ (int) noexcept                      { auto copy = *this; ++(*this); return copy; }
+        bool operator== (const Iterator& other) const noexcept  { return index == other.index; }
+        bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+
+        const FlatHashTable* table;
+        size_t index;
+    };
+
+private:
+    //==============================================================================
+    static constexpr size_t groupSize = 8;
+    static constexpr uint8 emptyControl = 0x80, erasedControl = 0xfe;
+    static constexpr uint64 lowBits = 0x0101010101010101ull, highBits = 0x8080808080808080ull;
+
+    static bool isFull (uint8 c) noexcept                       { return (c & 0x80) == 0; }
+
+    template <typename Key>
+    uint64 getHash (const Key& key) const
+    {
+        // Many std::hash implementations return integers and pointers unchanged, so the
+        // bits need mixing up before they can be used to pick a group
+        const auto h = (uint64) hash (key) * 0x9e3779b97f4a7c15ull;
+        return h ^ (h >> 32);
+    }
+
+    static uint8 getTag (uint64 h) noexcept                     { return (uint8) (h & 0x7f); }
+    static size_t getFirstGroup (uint64 h) noexcept             { return (size_t) (h >> 7); }
+    size_t getNumGroups() const noexcept                        { return capacity / groupSize; }
+
+    uint64 loadGroup (size_t group) const noexcept
+    {
+        uint64 bytes;
+        std::memcpy (&bytes, control.get() + group * groupSize, sizeof (bytes));
+        return ByteOrder::swapIfBigEndian (bytes);
+    }
+
+    // These return a word with the top bit set in each byte that matches
+    static uint64 matchTag (uint64 group, uint8 tag) noexcept
+    {
+        // This can very occasionally report a false match, but the keys get compared anyway
+        const auto x = group ^ (lowBits * tag);
+        return (x - lowBits) & ~x & highBits;
+    }
+
+    static uint64 matchEmpty (uint64 group) noexcept            { return group & (~group << 6) & highBits; }
+    static uint64 matchEmptyOrErased (uint64 group) noexcept    { return group & highBits; }
+
+    static size_t getLowestMatch (uint64 matches) noexcept
+    {
+       #if JUCE_GCC || JUCE_CLANG
+        return (size_t) __builtin_ctzll (matches) / 8;
+       #else
+        size_t index = 0;
+
+        for (; (matches & 0x80) == 0; matches >>= 8)
+            ++index;
+
+        return index;
+       #endif
+    }
+
+    static size_t getMaxLoad (size_t numSlots) noexcept         { return numSlots - numSlots / 8; }
+
+    static size_t getCapacityNeeded (size_t numElementsNeeded) noexcept
+    {
+        size_t result = groupSize;
+
+        while (getMaxLoad (result) < numElementsNeeded)
+            result *= 2;
+
+        return result;
+    }
+
+    size_t findFreeSlot (uint64 h) const noexcept
+    {
+        const auto groupMask = getNumGroups() - 1;
+        auto group = getFirstGroup (h) & groupMask;
+
+        for (size_t step = 1;; ++step)
+        {
+            if (const auto matches = matchEmptyOrErased (loadGroup (group)))
+                return group * groupSize + getLowestMatch (matches);
+
+            group = (group + step) & groupMask;
+        }
+    }
+
+    void allocate (size_t numSlots)
+    {
+        static_assert (alignof (Element) <= alignof (std::max_align_t),
+                       "Over-aligned types aren't supported");
+
+        control.malloc (numSlots);
+        std::fill (control.get(), control.get() + numSlots, emptyControl);
+        slotStorage.malloc (numSlots * sizeof (Element));
+        slots = reinterpret_cast<Element*> (slotStorage.get());
+        capacity = numSlots;
+    }
+
+    void rehash (size_t newCapacity)
+    {
+        FlatHashTable newTable;
+        newTable.hash = hash;
+        newTable.equal = equal;
+        newTable.allocate (newCapacity);
+
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            if (isFull (control[i]))
+            {
+                const auto h = newTable.getHash (KeyOf::get (slots[i]));
+                const auto index = newTable.findFreeSlot (h);
+
+                new (newTable.slots + index) Element (std::move (slots[i]));
+                newTable.control[index] = getTag (h);
+                slots[i].~Element();
+            }
+        }
+
+        newTable.numElements = numElements;
+        numElements = 0;
+        std::fill (control.get(), control.get() + capacity, emptyControl);
+        swapWith (newTable);
+    }
+
+    void destroyElements() noexcept
+    {
+        if (numElements > 0)
+            for (size_t i = 0; i < capacity; ++i)
+                if (isFull (control[i]))
+                    slots[i].~Element();
+    }
+
+    Hash hash;
+    Equal equal;
+    HeapBlock<uint8> control;
+    HeapBlock<char> slotStorage;
+    Element* slots = nullptr;
+    size_t capacity = 0, numElements = 0, numErased = 0;
+};
+
+} // namespace detail
+#endif
+
+} // namespace juce
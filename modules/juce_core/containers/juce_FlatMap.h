@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, stored in a single array that
+    is kept sorted by key.
+
+    Finding a key is done with a binary search, and adding or removing a key has to
+    shuffle the items after it along, so this is best suited to maps that are small, or
+    that are looked up far more often than they are changed. For those, it will
+    generally beat std::map, as the items are contiguous in memory and there's no
+    allocation for each item. Iterating the map visits the items in order of their keys.
+
+    The ordering can be changed with the CompareType template parameter. If this can
+    compare KeyType with other types, then those types can be used to look up keys,
+    without having to create a KeyType first.
+
+    Adding or removing items moves the other items around in memory, so pointers and
+    iterators to the items must not be kept across calls that modify the map.
+
+    @see FlatHashMap, HashMap
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          typename CompareType = std::less<>>
+class FlatMap
+{
+public:
+    //==============================================================================
+    using Item = std::pair<KeyType, ValueType>;
+
+    /** Creates an empty map. */
+    FlatMap() = default;
+
+    /** Creates a map containing some key/value pairs. */
+    FlatMap (std::initializer_list<Item> initialItems)
+    {
+        items.ensureStorageAllocated ((int) initialItems.size());
+
+        for (auto& item : initialItems)
+            set (item.first, item.second);
+    }
+
+    //==============================================================================
+    /** Returns the number of items in the map. */
+    int size() const noexcept                                   { return items.size(); }
+
+    /** Returns true if the map is empty. */
+    bool isEmpty() const noexcept                               { return items.isEmpty(); }
+
+    /** Removes all the items, but keeps the storage allocated. */
+    void clear() noexcept                                       { items.clearQuick(); }
+
+    /** Makes sure that there's space for at least this many items without the map
+        having to reallocate.
+    */
+    void reserve (int numItems)                                 { items.ensureStorageAllocated (numItems); }
+
+    //==============================================================================
+    /** Returns true if the map contains an item with the given key. */
+    template <typename Key>
+    bool contains (const Key& key) const                        { return find (key) != end(); }
+
+    /** Returns a pointer to the value for a key, or nullptr if the key isn't found.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename Key>
+    ValueType* getPointer (const Key& key)
+    {
+        auto it = find (key);
+        return it != end() ? &it->second : nullptr;
+    }
+
+    /** Returns a pointer to the value for a key, or nullptr if the key isn't found.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename Key>
+    const ValueType* getPointer (const Key& key) const
+    {
+        auto it = find (key);
+        return it != end() ? &it->second : nullptr;
+    }
+
+    /** Returns a copy of the value for a key, or a default-constructed value if the key
+        isn't found.
+    */
+    template <typename Key>
+    ValueType operator[] (const Key& key) const
+    {
+        if (auto* value = getPointer (key))
+            return *value;
+
+        return ValueType();
+    }
+
+    /** Returns a reference to the value for a key, adding a default-constructed value
+        first if the key isn't already in the map.
+    */
+    ValueType& getReference (const KeyType& key)
+    {
+        return emplace (key).first;
+    }
+
+    /** Returns an iterator to the item with the given key, or end() if there isn't one. */
+    template <typename Key>
+    Item* find (const Key& key)
+    {
+        auto it = lowerBound (key);
+        return it != end() && ! compare (key, it->first) ? it : end();
+    }
+
+    /** Returns an iterator to the item with the given key, or end() if there isn't one. */
+    template <typename Key>
+    const Item* find (const Key& key) const
+    {
+        auto it = lowerBound (key);
+        return it != end() && ! compare (key, it->first) ? it : end();
+    }
+
+    //==============================================================================
+    /** Sets the value for a key, adding a new item or replacing the existing value. */
+    void set (const KeyType& key, ValueType value)
+    {
+        auto [existing, added] = emplace (key, std::move (value));
+
+        if (! added)
+            existing = std::move (value);
+    }
+
+    /** Adds a value constructed from the given arguments, if the key isn't already in the
+        map. Returns a reference to the value for the key, and true if it was added.
+    */
+    template <typename... Args>
+    std::pair<ValueType&, bool> emplace (const KeyType& key, Args&&... args)
+    {
+        auto it = lowerBound (key);
+
+        if (it != end() && ! compare (key, it->first))
+            return { it->second, false };
+
+        const auto index = (int) (it - begin());
+        items.insert (index, Item (std::piecewise_construct,
+                                   std::forward_as_tuple (key),
+                                   std::forward_as_tuple (std::forward<Args> (args)...)));
+        return { items.getReference (index).second, true };
+    }
+
+    /** Removes the item with the given key, returning true if there was one. */
+    template <typename Key>
+    bool remove (const Key& key)
+    {
+        auto it = find (key);
+
+        if (it == end())
+            return false;
+
+        items.remove (it);
+        return true;
+    }
+
+    /** Removes all the items for which the predicate returns true, and returns the
+        number of items removed. The predicate is passed a reference to each Item.
+    */
+    template <typename Predicate>
+    int removeIf (Predicate&& predicate)
+    {
+        return items.removeIf (std::forward<Predicate> (predicate));
+    }
+
+    //==============================================================================
+    /** Returns an iterator to the item with the lowest key. */
+    Item* begin() noexcept                                      { return items.begin(); }
+    Item* end() noexcept                                        { return items.end(); }
+    const Item* begin() const noexcept                          { return items.begin(); }
+    const Item* end() const noexcept                            { return items.end(); }
+
+private:
+    template <typename Key>
+    Item* lowerBound (const Key& key)
+    {
+        return std::lower_bound (begin(), end(), key, [this] (const Item& item, const Key& k) { return compare (item.first, k); });
+    }
+
+    template <typename Key>
+    const Item* lowerBound (const Key& key) const
+    {
+        return std::lower_bound (begin(), end(), key, [this] (const Item& item, const Key& k) { return compare (item.first, k); });
+    }
+
+    Array<Item> items;
+    CompareType compare;
+};
+
+} // namespace juce
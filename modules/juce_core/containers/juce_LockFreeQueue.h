@@ -0,0 +1,395 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#ifndef DOXYGEN
+namespace detail
+{
+
+/*  The bounded queue used by MPSCQueue and MPMCQueue.
+
+    This is based on Dmitry Vyukov's bounded MPMC queue. Each slot has a sequence number
+    that says whether it's waiting to be written or read on the current pass around the
+    buffer, so a thread only has to claim a position with a single compare-and-swap, and
+    can then construct or move the item without any other thread touching that slot.
+    When there's only one consumer, it doesn't need to use a compare-and-swap at all.
+*/
+template <typename Type, bool multipleConsumers>
+class LockFreeQueue
+{
+public:
+    explicit LockFreeQueue (int minimumCapacity)
+        : capacity (getCapacityFor (minimumCapacity)),
+          slots (new Slot[capacity])
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            slots[i].sequence.store (i, std::memory_order_relaxed);
+    }
+
+    ~LockFreeQueue()
+    {
+        // Anything left in the queue still needs destroying
+        for (auto pos = head.load(); pos != tail.load(); ++pos)
+            slots[pos & (capacity - 1)].get()->~Type();
+    }
+
+    //==============================================================================
+    int getCapacity() const noexcept                    { return (int) capacity; }
+
+    int getNumReady() const noexcept
+    {
+        const auto h = head.load (std::memory_order_acquire);
+        const auto t = tail.load (std::memory_order_acquire);
+        return (int) jlimit ((std::ptrdiff_t) 0, (std::ptrdiff_t) capacity, (std::ptrdiff_t) (t - h));
+    }
+
+    bool isEmpty() const noexcept                       { return getNumReady() == 0; }
+
+    //==============================================================================
+    template <typename... Args>
+    bool tryEmplace (Args&&... args)
+    {
+        const auto [pos, numClaimed] = claim<true> (tail, 1, 0);
+
+        if (numClaimed == 0)
+            return false;
+
+        publish (pos, std::forward<Args> (args)...);
+        return true;
+    }
+
+    bool tryPush (const Type& item)                     { return tryEmplace (item); }
+    bool tryPush (Type&& item)                          { return tryEmplace (std::move (item)); }
+
+    int tryPushBatch (const Type* items, int numItems)
+    {
+        const auto [pos, numClaimed] = claim<true> (tail, (size_t) jmax (0, numItems), 0);
+
+        for (size_t i = 0; i < numClaimed; ++i)
+            publish (pos + i, items[i]);
+
+        return (int) numClaimed;
+    }
+
+    bool tryPop (Type& result)
+    {
+        const auto [pos, numClaimed] = claim<multipleConsumers> (head, 1, 1);
+
+        if (numClaimed == 0)
+            return false;
+
+        consume (pos, result);
+        return true;
+    }
+
+    int tryPopBatch (Type* results, int maxItems)
+    {
+        const auto [pos, numClaimed] = claim<multipleConsumers> (head, (size_t) jmax (0, maxItems), 1);
+
+        for (size_t i = 0; i < numClaimed; ++i)
+            consume (pos + i, results[i]);
+
+        return (int) numClaimed;
+    }
+
+private:
+    //==============================================================================
+    struct Slot
+    {
+        Type* get() noexcept                            { return std::launder (reinterpret_cast<Type*> (storage)); }
+
+        std::atomic<size_t> sequence { 0 };
+        alignas (Type) unsigned char storage[sizeof (Type)];
+    };
+
+    static size_t getCapacityFor (int minimumCapacity) noexcept
+    {
+        size_t result = 2;
+
+        while (result < (size_t) minimumCapacity)
+            result <<= 1;
+
+        return result;
+    }
+
+    /*  Claims up to maxItems consecutive positions from the given index, whose slots all have
+        a sequence number equal to their position plus the offset, and returns the first
+        position and the number claimed. Producers use an offset of 0 to find empty slots,
+        and consumers use 1 to find slots that have been written.
+    */
+    template <bool shared>
+    std::pair<size_t, size_t> claim (std::atomic<size_t>& index, size_t maxItems, size_t offset) noexcept
+    {
+        auto pos = index.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            size_t numReady = 0;
+            std::ptrdiff_t firstDiff = 0;
+
+            for (; numReady < maxItems; ++numReady)
+            {
+                const auto expected = pos + numReady + offset;
+                const auto sequence = slots[(pos + numReady) & (capacity - 1)].sequence.load (std::memory_order_acquire);
+                const auto diff = (std::ptrdiff_t) (sequence - expected);
+
+                if (diff != 0)
+                {
+                    if (numReady == 0)
+                        firstDiff = diff;
+
+                    break;
+                }
+            }
+
+            if (numReady == 0)
+            {
+                // A negative difference means the queue is full (or empty, for a consumer), but
+                // a positive one means another thread has already claimed this position
+                if (firstDiff <= 0 || ! shared)
+                    return { pos, 0 };
+
+                pos = index.load (std::memory_order_relaxed);
+                continue;
+            }
+
+            if constexpr (shared)
+            {
+                if (! index.compare_exchange_weak (pos, pos + numReady, std::memory_order_relaxed))
+                    continue;
+            }
+            else
+            {
+                index.store (pos + numReady, std::memory_order_relaxed);
+            }
+
+            return { pos, numReady };
+        }
+    }
+
+    template <typename... Args>
+    void publish (size_t pos, Args&&... args)
+    {
+        auto& slot = slots[pos & (capacity - 1)];
+        new (slot.storage) Type (std::forward<Args> (args)...);
+        slot.sequence.store (pos + 1, std::memory_order_release);
+    }
+
+    void consume (size_t pos, Type& result)
+    {
+        auto& slot = slots[pos & (capacity - 1)];
+        auto* item = slot.get();
+        result = std::move (*item);
+        item->~Type();
+        slot.sequence.store (pos + capacity, std::memory_order_release);
+    }
+
+    //==============================================================================
+    // The indexes are kept on separate cache lines, so that producers and consumers
+    // don't slow each other down by writing to the same line
+    static constexpr size_t cacheLineSize = 64;
+
+    const size_t capacity;
+    const std::unique_ptr<Slot[]> slots;
+
+    [[maybe_unused]] char paddingBeforeTail[cacheLineSize];
+    std::atomic<size_t> tail { 0 };
+    [[maybe_unused]] char paddingBeforeHead[cacheLineSize - sizeof (std::atomic<size_t>)];
+    std::atomic<size_t> head { 0 };
+    [[maybe_unused]] char paddingAfterHead[cacheLineSize - sizeof (std::atomic<size_t>)];
+
+    JUCE_DECLARE_NON_COPYABLE (LockFreeQueue)
+};
+
+} // namespace detail
+#endif
+
+//==============================================================================
+/**
+    A bounded, lock-free queue which any number of threads can add items to, and one
+    thread can take items from.
+
+    All of the queue's storage is allocated when it's created, so adding and removing items
+    never allocates, blocks or takes a lock. This makes it suitable for passing messages from
+    several threads to the audio thread, or from the audio thread and others to a single
+    worker. If only one thread ever adds items, AbstractFifo is a little cheaper.
+
+    tryPush() and tryPop() never wait: if the queue is full or empty, they return false
+    straight away. A producer may have to retry its compare-and-swap if another producer
+    claims the same slot at the same moment, but it never waits for a thread that has
+    stalled.
+
+    The batch functions claim a run of consecutive slots with a single atomic operation,
+    which is cheaper than adding or removing the items one at a time.
+
+    @code
+    MPSCQueue<MidiMessage> incoming (256);
+
+    // on any thread..
+    if (! incoming.tryPush (message))
+        ++numDroppedMessages;
+
+    // on the audio thread..
+    MidiMessage m;
+
+    while (incoming.tryPop (m))
+        handleMessage (m);
+    @endcode
+
+    The items are moved out of the queue when they're popped, so Type must be movable and,
+    for tryPop(), move-assignable.
+
+    @see MPMCQueue, AbstractFifo
+
+    @tags{Core}
+*/
+template <typename Type>
+class MPSCQueue  : private detail::LockFreeQueue<Type, false>
+{
+    using Base = detail::LockFreeQueue<Type, false>;
+
+public:
+    /** Creates a queue that can hold at least the given number of items.
+        The capacity is rounded up to the next power of two.
+    */
+    explicit MPSCQueue (int minimumCapacity) : Base (minimumCapacity) {}
+
+    /** Returns the number of items the queue can hold. */
+    using Base::getCapacity;
+
+    /** Returns the number of items in the queue. If other threads are using the queue,
+        this may be out-of-date as soon as it returns.
+    */
+    using Base::getNumReady;
+
+    /** Returns true if the queue has no items in it. If other threads are using the queue,
+        this may be out-of-date as soon as it returns.
+    */
+    using Base::isEmpty;
+
+    /** Adds an item to the back of the queue. This can be called from any thread.
+        Returns false if the queue was full.
+    */
+    using Base::tryPush;
+
+    /** Constructs an item at the back of the queue from the given arguments. This can be
+        called from any thread. Returns false if the queue was full.
+    */
+    using Base::tryEmplace;
+
+    /** Adds as many of the given items as will fit, keeping them together and in order.
+        This can be called from any thread. Returns the number of items that were added.
+    */
+    using Base::tryPushBatch;
+
+    /** Moves the item at the front of the queue into result. This must only be called by
+        the consumer thread. Returns false if the queue was empty.
+    */
+    using Base::tryPop;
+
+    /** Moves up to maxItems items from the front of the queue into the results array. This
+        must only be called by the consumer thread. Returns the number of items that were
+        removed.
+    */
+    using Base::tryPopBatch;
+};
+
+//==============================================================================
+/**
+    A bounded, lock-free queue which any number of threads can add items to and take
+    items from.
+
+    This works like MPSCQueue, but any thread may also pop items. That means popping has
+    to use a compare-and-swap, so if there's only ever one consumer, MPSCQueue is a little
+    faster.
+
+    Items are taken out in the order their positions were claimed, but if several threads
+    are popping at the same time, there's no guarantee about which thread gets which item,
+    or which of them finishes first.
+
+    @see MPSCQueue, AbstractFifo
+
+    @tags{Core}
+*/
+template <typename Type>
+class MPMCQueue  : private detail::LockFreeQueue<Type, true>
+{
+    using Base = detail::LockFreeQueue<Type, true>;
+
+public:
+    /** Creates a queue that can hold at least the given number of items.
+        The capacity is rounded up to the next power of two.
+    */
+    explicit MPMCQueue (int minimumCapacity) : Base (minimumCapacity) {}
+
+    /** Returns the number of items the queue can hold. */
+    using Base::getCapacity;
+
+    /** Returns the number of items in the queue. If other threads are using the queue,
+        this may be out-of-date as soon as it returns.
+    */
+    using Base::getNumReady;
+
+    /** Returns true if the queue has no items in it. If other threads are using the queue,
+        this may be out-of-date as soon as it returns.
+    */
+    using Base::isEmpty;
+
+    /** Adds an item to the back of the queue. Returns false if the queue was full. */
+    using Base::tryPush;
+
+    /** Constructs an item at the back of the queue from the given arguments.
+        Returns false if the queue was full.
+    */
+    using Base::tryEmplace;
+
+    /** Adds as many of the given items as will fit, keeping them together and in order.
+        Returns the number of items that were added.
+    */
+    using Base::tryPushBatch;
+
+    /** Moves the item at the front of the queue into result.
+        Returns false if the queue was empty.
+    */
+    using Base::tryPop;
+
+    /** Moves up to maxItems items from the front of the queue into the results array.
+        Returns the number of items that were removed.
+    */
+    using Base::tryPopBatch;
+};
+
+} // namespace juce
@@ -0,0 +1,278 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class LockFreeQueueTests final : public UnitTest
+{
+public:
+    LockFreeQueueTests()
+        : UnitTest ("Lock-free queues", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Capacity is rounded up to a power of two");
+        {
+            expectEquals (MPSCQueue<int> (1).getCapacity(), 2);
+            expectEquals (MPSCQueue<int> (100).getCapacity(), 128);
+            expectEquals (MPMCQueue<int> (128).getCapacity(), 128);
+        }
+
+        beginTest ("Items come out in order, and full and empty queues are reported");
+        {
+            testSingleThreaded<MPSCQueue<int>>();
+            testSingleThreaded<MPMCQueue<int>>();
+        }
+
+        beginTest ("Batches are added and removed in order");
+        {
+            testBatches<MPSCQueue<int>>();
+            testBatches<MPMCQueue<int>>();
+        }
+
+        beginTest ("Non-trivial items are moved in and out, and destroyed with the queue");
+        {
+            auto counter = std::make_shared<int> (0);
+
+            {
+                MPMCQueue<std::shared_ptr<int>> queue (8);
+
+                for (int i = 0; i < 5; ++i)
+                    expect (queue.tryPush (counter));
+
+                expectEquals ((int) counter.use_count(), 6);
+
+                std::shared_ptr<int> popped;
+                expect (queue.tryPop (popped));
+                expect (popped == counter);
+                popped.reset();
+                expectEquals ((int) counter.use_count(), 5);
+
+                MPSCQueue<std::unique_ptr<int>> owned (4);
+                expect (owned.tryEmplace (std::make_unique<int> (3)));
+
+                std::unique_ptr<int> result;
+                expect (owned.tryPop (result) && *result == 3);
+            }
+
+            expectEquals ((int) counter.use_count(), 1);
+        }
+
+        beginTest ("MPSCQueue keeps each producer's items in order under contention");
+        {
+            MPSCQueue<uint64> queue (64);
+            constexpr int numProducers = 4, numItemsPerProducer = 50000;
+
+            std::vector<std::thread> producers;
+
+            for (int p = 0; p < numProducers; ++p)
+            {
+                producers.emplace_back ([&queue, p]
+                {
+                    for (uint32 i = 0; i < (uint32) numItemsPerProducer;)
+                    {
+                        if (i % 5 == 0)
+                        {
+                            uint64 batch[3];
+
+                            for (uint32 j = 0; j < 3; ++j)
+                                batch[j] = ((uint64) p << 32) | (i + j);
+
+                            const auto numToPush = (int) jmin ((uint32) 3, (uint32) numItemsPerProducer - i);
+                            i += (uint32) queue.tryPushBatch (batch, numToPush);
+                        }
+                        else if (queue.tryPush (((uint64) p << 32) | i))
+                        {
+                            ++i;
+                        }
+                        else
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+
+            std::vector<uint32> nextExpected (numProducers, 0);
+            bool allInOrder = true;
+            int numReceived = 0;
+            uint64 batch[7];
+
+            while (numReceived < numProducers * numItemsPerProducer)
+            {
+                const auto numPopped = queue.tryPopBatch (batch, (numReceived % 3) == 0 ? 7 : 1);
+
+                if (numPopped == 0)
+                    std::this_thread::yield();
+
+                for (int i = 0; i < numPopped; ++i)
+                {
+                    const auto producer = (size_t) (batch[i] >> 32);
+                    allInOrder = allInOrder && (uint32) batch[i] == nextExpected[producer]++;
+                }
+
+                numReceived += numPopped;
+            }
+
+            for (auto& producer : producers)
+                producer.join();
+
+            expect (allInOrder);
+            expect (queue.isEmpty());
+            expect (std::all_of (nextExpected.begin(), nextExpected.end(), [] (auto n) { return n == (uint32) numItemsPerProducer; }));
+        }
+
+        beginTest ("MPMCQueue delivers every item exactly once under contention");
+        {
+            MPMCQueue<int> queue (32);
+            constexpr int numProducers = 4, numConsumers = 4, numItemsPerProducer = 40000;
+            constexpr int numItems = numProducers * numItemsPerProducer;
+
+            std::vector<std::atomic<int>> timesSeen ((size_t) numItems);
+            std::atomic<int> numReceived { 0 };
+            std::vector<std::thread> threads;
+
+            for (int p = 0; p < numProducers; ++p)
+            {
+                threads.emplace_back ([&queue, p]
+                {
+                    for (int i = 0; i < numItemsPerProducer;)
+                    {
+                        const auto item = p * numItemsPerProducer + i;
+
+                        if (i % 7 == 0)
+                        {
+                            const int batch[] { item, item + 1 };
+                            i += queue.tryPushBatch (batch, jmin (2, numItemsPerProducer - i));
+                        }
+                        else if (queue.tryPush (item))
+                        {
+                            ++i;
+                        }
+                        else
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+            }
+
+            for (int c = 0; c < numConsumers; ++c)
+            {
+                threads.emplace_back ([&, c]
+                {
+                    int batch[4];
+
+                    while (numReceived.load() < numItems)
+                    {
+                        const auto numPopped = c % 2 == 0 ? queue.tryPopBatch (batch, 4)
+                                                          : (queue.tryPop (batch[0]) ? 1 : 0);
+
+                        if (numPopped == 0)
+                            std::this_thread::yield();
+
+                        for (int i = 0; i < numPopped; ++i)
+                            ++timesSeen[(size_t) batch[i]];
+
+                        numReceived += numPopped;
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            expectEquals (numReceived.load(), numItems);
+            expect (std::all_of (timesSeen.begin(), timesSeen.end(), [] (auto& n) { return n.load() == 1; }));
+            expect (queue.isEmpty());
+        }
+    }
+
+private:
+    template <typename Queue>
+    void testSingleThreaded()
+    {
+        Queue queue (4);
+        int result = 0;
+
+        expect (queue.isEmpty());
+        expect (! queue.tryPop (result));
+
+        for (int lap = 0; lap < 3; ++lap)
+        {
+            for (int i = 0; i < 4; ++i)
+                expect (queue.tryPush (lap * 10 + i));
+
+            expect (! queue.tryPush (99));
+            expectEquals (queue.getNumReady(), 4);
+
+            for (int i = 0; i < 4; ++i)
+            {
+                expect (queue.tryPop (result));
+                expectEquals (result, lap * 10 + i);
+            }
+
+            expect (! queue.tryPop (result));
+            expect (queue.isEmpty());
+        }
+    }
+
+    template <typename Queue>
+    void testBatches()
+    {
+        Queue queue (8);
+        const int items[] { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+
+        expectEquals (queue.tryPushBatch (items, 3), 3);
+        expectEquals (queue.tryPushBatch (items + 3, 7), 5);
+        expectEquals (queue.tryPushBatch (items, 1), 0);
+
+        int results[10] {};
+        expectEquals (queue.tryPopBatch (results, 6), 6);
+        expectEquals (queue.tryPushBatch (items + 8, 2), 2);
+        expectEquals (queue.tryPopBatch (results + 6, 10), 4);
+
+        for (int i = 0; i < 10; ++i)
+            expectEquals (results[i], items[i]);
+
+        expectEquals (queue.tryPopBatch (results, 10), 0);
+        expectEquals (queue.tryPushBatch (items, 0), 0);
+    }
+};
+
+static LockFreeQueueTests lockFreeQueueTests;
+
+} // namespace juce
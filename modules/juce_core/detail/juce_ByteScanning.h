@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::detail
+{
+
+/*  Helpers for quickly finding particular bytes in a block of text, which the JSON and XML
+    parsers use to skip over runs of ordinary characters.
+
+    These work on raw bytes, so they can be used to search UTF-8 text for ASCII characters:
+    the bytes of a multi-byte UTF-8 sequence are never in the ASCII range. Where SSE2 or Neon
+    are available, 16 bytes are checked at a time.
+*/
+struct ByteScanning
+{
+    /*  Returns the index of the first byte that matches any of the given characters, or
+        numBytes if there aren't any.
+    */
+    template <char... chars>
+    static size_t findFirstOf (const char* data, size_t numBytes) noexcept
+    {
+        static_assert (sizeof... (chars) > 0);
+        size_t i = 0;
+
+       #if JUCE_CORE_USE_SSE2
+        for (; i + blockSize <= numBytes; i += blockSize)
+        {
+            const auto block = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (data + i));
+            auto matches = _mm_setzero_si128();
+            ((matches = _mm_or_si128 (matches, _mm_cmpeq_epi8 (block, _mm_set1_epi8 (chars)))), ...);
+
+            if (const auto mask = (uint32) _mm_movemask_epi8 (matches))
+                return i + (size_t) countTrailingZeros (mask);
+        }
+       #elif JUCE_CORE_USE_NEON
+        for (; i + blockSize <= numBytes; i += blockSize)
+        {
+            const auto block = vld1q_u8 (reinterpret_cast<const uint8_t*> (data + i));
+            auto matches = vdupq_n_u8 (0);
+            ((matches = vorrq_u8 (matches, vceqq_u8 (block, vdupq_n_u8 ((uint8_t) chars)))), ...);
+
+            if (const auto mask = getMask (matches))
+                return i + (size_t) countTrailingZeros (mask) / 4;
+        }
+       #endif
+
+        for (; i < numBytes; ++i)
+            if (((data[i] == chars) || ...))
+                return i;
+
+        return numBytes;
+    }
+
+    /*  Returns the index of the first byte that isn't an ASCII whitespace character, as
+        defined by CharacterFunctions::isWhitespace (char), or numBytes if there isn't one.
+    */
+    static size_t findFirstNonWhitespace (const char* data, size_t numBytes) noexcept
+    {
+        size_t i = 0;
+
+       #if JUCE_CORE_USE_SSE2
+        for (; i + blockSize <= numBytes; i += blockSize)
+        {
+            const auto block = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (data + i));
+            const auto offset = _mm_sub_epi8 (block, _mm_set1_epi8 (9));
+            const auto isControlSpace = _mm_cmpeq_epi8 (_mm_min_epu8 (offset, _mm_set1_epi8 (4)), offset);
+            const auto isSpace = _mm_cmpeq_epi8 (block, _mm_set1_epi8 (' '));
+            const auto mask = ~(uint32) _mm_movemask_epi8 (_mm_or_si128 (isControlSpace, isSpace)) & 0xffffu;
+
+            if (mask != 0)
+                return i + (size_t) countTrailingZeros (mask);
+        }
+       #elif JUCE_CORE_USE_NEON
+        for (; i + blockSize <= numBytes; i += blockSize)
+        {
+            const auto block = vld1q_u8 (reinterpret_cast<const uint8_t*> (data + i));
+            const auto isControlSpace = vcleq_u8 (vsubq_u8 (block, vdupq_n_u8 (9)), vdupq_n_u8 (4));
+            const auto isSpace = vceqq_u8 (block, vdupq_n_u8 (' '));
+
+            if (const auto mask = getMask (vmvnq_u8 (vorrq_u8 (isControlSpace, isSpace))))
+                return i + (size_t) countTrailingZeros (mask) / 4;
+        }
+       #endif
+
+        for (; i < numBytes; ++i)
+            if (! CharacterFunctions::isWhitespace (data[i]))
+                return i;
+
+        return numBytes;
+    }
+
+    static constexpr size_t blockSize = 16;
+
+private:
+    template <typename Integer>
+    static int countTrailingZeros (Integer n) noexcept
+    {
+        jassert (n != 0);
+
+      #if JUCE_GCC || JUCE_CLANG
+        if constexpr (sizeof (Integer) == 8)
+            return __builtin_ctzll (n);
+        else
+            return __builtin_ctz (n);
+      #elif JUCE_MSVC
+        unsigned long lowest;
+
+        if constexpr (sizeof (Integer) == 8)
+            _BitScanForward64 (&lowest, n);
+        else
+            _BitScanForward (&lowest, n);
+
+        return (int) lowest;
+      #else
+        int count = 0;
+
+        for (; (n & 1) == 0; n >>= 1)
+            ++count;
+
+        return count;
+      #endif
+    }
+
+   #if JUCE_CORE_USE_NEON
+    // Packs the comparison results into 4 bits per byte
+    static uint64 getMask (uint8x16_t matches) noexcept
+    {
+        return vget_lane_u64 (vreinterpret_u64_u8 (vshrn_n_u16 (vreinterpretq_u16_u8 (matches), 4)), 0);
+    }
+   #endif
+};
+
+} // namespace juce::detail
@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::detail
+{
+
+class ByteScanningTests final : public UnitTest
+{
+public:
+    ByteScanningTests() : UnitTest ("ByteScanning", UnitTestCategories::text) {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("findFirstOf matches a simple search");
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                const auto text = createRandomText (r);
+                const auto* data = text.data();
+
+                for (size_t start = 0; start < jmin ((size_t) 20, text.size()); ++start)
+                {
+                    const auto numBytes = text.size() - start;
+                    expectEquals ((int) ByteScanning::findFirstOf<'"', '\\'> (data + start, numBytes),
+                                  (int) findFirstOfSlowly (data + start, numBytes, "\"\\"));
+                    expectEquals ((int) ByteScanning::findFirstOf<'<', '&', '\r'> (data + start, numBytes),
+                                  (int) findFirstOfSlowly (data + start, numBytes, "<&\r"));
+                    expectEquals ((int) ByteScanning::findFirstOf<'\0'> (data + start, numBytes),
+                                  (int) findFirstOfSlowly (data + start, numBytes, std::string_view ("\0", 1)));
+                }
+            }
+        }
+
+        beginTest ("findFirstNonWhitespace matches CharacterFunctions");
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                const auto text = createRandomWhitespace (r);
+                const auto expected = std::find_if (text.begin(), text.end(), [] (char c) { return ! CharacterFunctions::isWhitespace (c); });
+
+                expectEquals ((int) ByteScanning::findFirstNonWhitespace (text.data(), text.size()),
+                              (int) std::distance (text.begin(), expected));
+            }
+        }
+
+        beginTest ("Non-ASCII bytes are never matched");
+        {
+            std::string text;
+
+            for (int i = 128; i < 256; ++i)
+                text += (char) i;
+
+            expectEquals ((int) ByteScanning::findFirstOf<'"', '\\', '<', '&'> (text.data(), text.size()), (int) text.size());
+            expectEquals ((int) ByteScanning::findFirstNonWhitespace (text.data(), text.size()), 0);
+        }
+    }
+
+    static size_t findFirstOfSlowly (const char* data, size_t numBytes, std::string_view chars)
+    {
+        for (size_t i = 0; i < numBytes; ++i)
+            if (chars.find (data[i]) != std::string_view::npos)
+                return i;
+
+        return numBytes;
+    }
+
+    static std::string createRandomText (Random& r)
+    {
+        static constexpr char interesting[] = { '"', '\\', '<', '&', '\r', '\0', 'a', ' ', (char) 0xc3, (char) 0x80 };
+        std::string text ((size_t) r.nextInt (100), 'x');
+
+        for (auto& c : text)
+            if (r.nextInt (20) == 0)
+                c = interesting[r.nextInt ((int) std::size (interesting))];
+
+        return text;
+    }
+
+    static std::string createRandomWhitespace (Random& r)
+    {
+        static constexpr char whitespace[] = { ' ', '\t', '\n', '\r', '\v', '\f' };
+        static constexpr char other[] = { 'x', '\0', '\b', '\x0e', '!', (char) 0xa0 };
+        std::string text ((size_t) r.nextInt (100), ' ');
+
+        for (auto& c : text)
+            c = whitespace[r.nextInt ((int) std::size (whitespace))];
+
+        if (! text.empty() && r.nextBool())
+            text[(size_t) r.nextInt ((int) text.size())] = other[r.nextInt ((int) std::size (other))];
+
+        return text;
+    }
+};
+
+static ByteScanningTests byteScanningTests;
+
+} // namespace juce::detail
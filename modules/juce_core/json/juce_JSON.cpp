@@ -40,6 +40,8 @@ struct JSONParser
     JSONParser (String::CharPointerType text) : startLocation (text), currentLocation (text) {}
 
     String::CharPointerType startLocation, currentLocation;
+    const String::CharPointerType::CharType* endOfText = startLocation.getAddress()
+                                                           + startLocation.sizeInBytes() / sizeof (String::CharPointerType::CharType) - 1;
 
     struct ErrorException
     {
@@ -64,7 +66,23 @@ struct JSONParser
         throw e;
     }
 
-    void skipWhitespace()             { currentLocation = currentLocation.findEndOfWhitespace(); }
+    size_t getNumBytesRemaining() const noexcept
+    {
+        const auto* location = currentLocation.getAddress();
+        return location < endOfText ? (size_t) (endOfText - location) * sizeof (*location) : 0;
+    }
+
+    void skipWhitespace()
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        // Skips the ASCII whitespace quickly, leaving findEndOfWhitespace() to deal with any other kinds
+        const auto* location = currentLocation.getAddress();
+        currentLocation = String::CharPointerType (location + detail::ByteScanning::findFirstNonWhitespace (location, getNumBytesRemaining()));
+       #endif
+
+        currentLocation = currentLocation.findEndOfWhitespace();
+    }
+
     juce_wchar readChar()             { return currentLocation.getAndAdvance(); }
     juce_wchar peekChar() const       { return *currentLocation; }
     bool matchIf (char c)             { if (peekChar() == (juce_wchar) c) { ++currentLocation; return true; } return false; }
@@ -161,6 +179,18 @@ struct JSONParser
 
         for (;;)
         {
+           #if JUCE_STRING_UTF_TYPE == 8
+            {
+                // Copies any run of characters that don't need special treatment in one go
+                const auto* location = currentLocation.getAddress();
+                const auto numBytes = getNumBytesRemaining();
+                const auto runLength = quoteChar == '"' ? detail::ByteScanning::findFirstOf<'"', '\\'> (location, numBytes)
+                                                        : detail::ByteScanning::findFirstOf<'\'', '\\'> (location, numBytes);
+                buffer.write (location, runLength);
+                currentLocation = String::CharPointerType (location + runLength);
+            }
+           #endif
+
             auto c = readChar();
 
             if (c == quoteChar)
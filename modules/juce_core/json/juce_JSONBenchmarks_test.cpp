@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  Measures the throughput of the JSON parsers.
+
+    To show what the scanning in detail::ByteScanning gains, the loops JSON::parse() uses to
+    skip whitespace and copy strings are timed against the character-by-character loops it
+    used before, which are kept below for reference. By default this uses generated
+    documents, but you can set the environment variable
+    JUCE_BENCHMARK_DATA_DIR to a folder of .json files to measure some real ones.
+*/
+class JSONBenchmarks final : public UnitTest
+{
+public:
+    JSONBenchmarks() : UnitTest ("JSON benchmarks", UnitTestCategories::benchmarks) {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        for (const auto& [documentName, text] : getDocuments (r))
+        {
+            beginTest (documentName);
+
+            var parsed;
+            JSONDocument document;
+            int64 numBytesCopied = 0, previousNumBytesCopied = 0;
+
+            struct NullHandler final : public JSONStreamParser::Handler {};
+            NullHandler handler;
+
+            const auto previousTime = measure ([&] { previousNumBytesCopied = copyStringsOneCharacterAtATime (text); });
+            const auto scanTime = measure ([&] { numBytesCopied = copyStringsWithByteScanning (text); });
+
+            report ("Strings, previous loops", text, previousTime);
+            report ("Strings, ByteScanning", text, scanTime, previousTime);
+            report ("JSON::parse", text, measure ([&] { parsed = JSON::parse (text); }));
+            report ("JSONStreamParser", text, measure ([&] { JSONStreamParser::parse (text, handler); }));
+            report ("JSONDocument", text, measure ([&] { expect (document.parse (text).wasOk()); }));
+
+            expectEquals (numBytesCopied, previousNumBytesCopied);
+            expect (JSON::toString (document.getRoot().toVar()) == JSON::toString (parsed));
+        }
+    }
+
+private:
+    // How JSON::parse() used to skip whitespace and read strings, one character at a time
+    static int64 copyStringsOneCharacterAtATime (const String& text)
+    {
+        MemoryOutputStream buffer;
+
+        for (auto p = text.getCharPointer();;)
+        {
+            p = p.findEndOfWhitespace();
+            const auto c = p.getAndAdvance();
+
+            if (c == 0)
+                break;
+
+            if (c != '"')
+                continue;
+
+            for (;;)
+            {
+                auto s = p.getAndAdvance();
+
+                if (s == '"' || s == 0)
+                    break;
+
+                if (s == '\\' && (s = p.getAndAdvance()) == 0)
+                    break;
+
+                buffer.appendUTF8Char (s);
+            }
+        }
+
+        return buffer.getPosition();
+    }
+
+    // The same walk, using the scanning that JSON::parse() does now
+    static int64 copyStringsWithByteScanning (const String& text)
+    {
+        MemoryOutputStream buffer;
+        const auto* data = text.toRawUTF8();
+        const auto numBytes = text.getNumBytesAsUTF8();
+
+        for (size_t i = 0;;)
+        {
+            i += detail::ByteScanning::findFirstNonWhitespace (data + i, numBytes - i);
+
+            if (i == numBytes)
+                break;
+
+            if (data[i++] != '"')
+                continue;
+
+            for (;;)
+            {
+                const auto runLength = detail::ByteScanning::findFirstOf<'"', '\\'> (data + i, numBytes - i);
+                buffer.write (data + i, runLength);
+                i += runLength;
+
+                if (i == numBytes || data[i++] == '"' || i == numBytes)
+                    break;
+
+                buffer.writeByte (data[i++]);
+            }
+        }
+
+        return buffer.getPosition();
+    }
+
+    template <typename Fn>
+    static double measure (Fn&& fn)
+    {
+        constexpr auto numRuns = 5;
+        auto bestTime = std::numeric_limits<double>::max();
+
+        for (int i = 0; i < numRuns; ++i)
+        {
+            const auto start = Time::getMillisecondCounterHiRes();
+            fn();
+            bestTime = jmin (bestTime, Time::getMillisecondCounterHiRes() - start);
+        }
+
+        return bestTime;
+    }
+
+    void report (const String& description, const String& text, double time, double previousTime = 0.0)
+    {
+        const auto megabytes = (double) text.getNumBytesAsUTF8() / (1024.0 * 1024.0);
+        auto message = description.paddedRight (' ', 24)
+                     + String (time, 2) + " ms, "
+                     + String (megabytes * 1000.0 / jmax (0.001, time), 1) + " MB/s";
+
+        if (previousTime > 0.0)
+            message << ", " << String (previousTime / jmax (0.001, time), 2) << "x the previous speed";
+
+        logMessage (message);
+    }
+
+    static var createRecord (Random& r, int index)
+    {
+        static const StringArray words { "oscillator", "filter", "envelope", "\"quoted\"", "delay",
+                                         "reverb", "line\nbreak", "caf" + String (CharPointer_UTF8 ("\xc3\xa9")), "gain", "tab\there" };
+
+        const auto makeSentence = [&] (int numWords)
+        {
+            StringArray sentence;
+
+            for (int i = 0; i < numWords; ++i)
+                sentence.add (words[r.nextInt (words.size())]);
+
+            return sentence.joinIntoString (" ");
+        };
+
+        Array<var> tags, values;
+
+        for (int i = 0; i < 4; ++i)
+            tags.add (words[r.nextInt (words.size())]);
+
+        for (int i = 0; i < 8; ++i)
+            values.add (r.nextBool() ? var (r.nextInt (100000)) : var (r.nextDouble() * 1000.0));
+
+        return JSONUtils::makeObject ({ { "id", index },
+                                        { "name", makeSentence (3) },
+                                        { "description", makeSentence (40) },
+                                        { "enabled", r.nextBool() },
+                                        { "tags", tags },
+                                        { "values", values },
+                                        { "parent", index > 0 ? var (r.nextInt (index)) : var() } });
+    }
+
+    static std::vector<std::pair<String, String>> getDocuments (Random& r)
+    {
+        std::vector<std::pair<String, String>> result;
+        const File folder (SystemStats::getEnvironmentVariable ("JUCE_BENCHMARK_DATA_DIR", {}));
+
+        if (folder.getFullPathName().isNotEmpty() && folder.isDirectory())
+            for (const auto& file : folder.findChildFiles (File::findFiles, false, "*.json"))
+                result.emplace_back (file.getFileName(), file.loadFileAsString());
+
+        Array<var> records;
+
+        for (int i = 0; i < 20000; ++i)
+            records.add (createRecord (r, i));
+
+        const var root (records);
+        result.emplace_back ("generated, pretty-printed", JSON::toString (root));
+        result.emplace_back ("generated, compact", JSON::toString (root, true));
+        return result;
+    }
+};
+
+static JSONBenchmarks jsonBenchmarks;
+
+} // namespace juce
@@ -0,0 +1,390 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct JSONDocument::Builder
+{
+    JSONDocument& doc;
+    const char* sourceStart;
+    std::vector<uint32> openContainers;
+    size_t pendingNameOffset = 0;
+    uint32 pendingNameLength = 0;
+    bool pendingNameInArena = false;
+
+    bool startObject()      { openContainers.push_back (addNode (Type::object)); return true; }
+    bool startArray()       { openContainers.push_back (addNode (Type::array));  return true; }
+    bool endObject()        { return closeContainer(); }
+    bool endArray()         { return closeContainer(); }
+
+    bool propertyName (std::string_view name, bool isViewIntoSource)
+    {
+        pendingNameInArena = ! isViewIntoSource;
+        pendingNameOffset = storeText (name, isViewIntoSource);
+        pendingNameLength = (uint32) name.size();
+        return true;
+    }
+
+    bool stringValue (std::string_view value, bool isViewIntoSource)
+    {
+        auto& node = doc.nodes[addNode (Type::string)];
+        node.textOffset = storeText (value, isViewIntoSource);
+        node.textInArena = ! isViewIntoSource;
+        node.size = (uint32) value.size();
+        return true;
+    }
+
+    bool intValue (int64 value)     { doc.nodes[addNode (Type::integer)].intValue = value; return true; }
+    bool doubleValue (double value) { doc.nodes[addNode (Type::floatingPoint)].doubleValue = value; return true; }
+    bool boolValue (bool value)     { doc.nodes[addNode (Type::boolean)].intValue = value ? 1 : 0; return true; }
+    bool nullValue()                { addNode (Type::null); return true; }
+
+private:
+    uint32 addNode (Type type)
+    {
+        const auto index = (uint32) doc.nodes.size();
+        jassert ((size_t) index == doc.nodes.size()); // documents are limited to 2^32 values
+
+        Node node{};
+        node.type = type;
+        node.end = index + 1;
+
+        if (! openContainers.empty())
+        {
+            auto& parent = doc.nodes[openContainers.back()];
+            ++parent.size;
+
+            if (parent.type == Type::object)
+            {
+                node.nameOffset = pendingNameOffset;
+                node.nameLength = pendingNameLength;
+                node.nameInArena = pendingNameInArena;
+            }
+        }
+
+        doc.nodes.push_back (node);
+        return index;
+    }
+
+    bool closeContainer()
+    {
+        const auto index = openContainers.back();
+        openContainers.pop_back();
+
+        auto& node = doc.nodes[index];
+        node.end = (uint32) doc.nodes.size();
+
+        if (node.type == Type::object && node.size >= minSizeForPropertyIndex)
+            node.textOffset = addToPropertyIndex (index);
+
+        return true;
+    }
+
+    // The sort is stable, so where several properties have the same name, the last
+    // one in the document comes last in the index
+    size_t addToPropertyIndex (uint32 objectIndex)
+    {
+        const auto start = doc.propertyIndex.size();
+
+        for (auto child = objectIndex + 1; child < doc.nodes[objectIndex].end; child = doc.nodes[child].end)
+            doc.propertyIndex.push_back (child);
+
+        std::stable_sort (doc.propertyIndex.begin() + (std::ptrdiff_t) start, doc.propertyIndex.end(),
+                          [this] (uint32 a, uint32 b) { return doc.getName (a) < doc.getName (b); });
+
+        return start;
+    }
+
+    size_t storeText (std::string_view text, bool isViewIntoSource)
+    {
+        if (isViewIntoSource)
+            return (size_t) (text.data() - sourceStart);
+
+        const auto offset = doc.arena.size();
+        doc.arena.append (text);
+        return offset;
+    }
+};
+
+//==============================================================================
+JSONDocument::JSONDocument() = default;
+JSONDocument::~JSONDocument() = default;
+JSONDocument::JSONDocument (JSONDocument&&) noexcept = default;
+JSONDocument& JSONDocument::operator= (JSONDocument&&) noexcept = default;
+
+Result JSONDocument::parse (const String& text)
+{
+    return parse (MemoryBlock (text.toRawUTF8(), text.getNumBytesAsUTF8()));
+}
+
+Result JSONDocument::parse (InputStream& input)
+{
+    MemoryBlock data;
+    input.readIntoMemoryBlock (data);
+    return parse (std::move (data));
+}
+
+Result JSONDocument::parse (MemoryBlock utf8Data)
+{
+    clear();
+    source = std::move (utf8Data);
+
+    // A rough guess which avoids most of the reallocations for typical documents
+    nodes.reserve (source.getSize() / 16);
+
+    const auto* sourceStart = static_cast<const char*> (source.getData());
+    JSONMemorySource input (sourceStart, source.getSize());
+    Builder builder { *this, sourceStart, {} };
+    auto result = JSONEventReader<JSONMemorySource, Builder> (input, builder).parse();
+
+    if (result.failed())
+    {
+        clear();
+    }
+    else
+    {
+        nodes.shrink_to_fit();
+        propertyIndex.shrink_to_fit();
+    }
+
+    return result;
+}
+
+void JSONDocument::clear()
+{
+    source.reset();
+    arena.clear();
+    nodes.clear();
+    propertyIndex.clear();
+}
+
+JSONDocument::Value JSONDocument::getRoot() const noexcept
+{
+    if (nodes.empty())
+        return {};
+
+    return { this, 0 };
+}
+
+std::string_view JSONDocument::getText (size_t offset, size_t length, bool inArena) const noexcept
+{
+    if (length == 0)
+        return {};
+
+    return { (inArena ? arena.data() : static_cast<const char*> (source.getData())) + offset, length };
+}
+
+std::string_view JSONDocument::getName (size_t index) const noexcept
+{
+    const auto& node = getNode (index);
+    return getText (node.nameOffset, node.nameLength, node.nameInArena);
+}
+
+//==============================================================================
+JSONDocument::Type JSONDocument::Value::getType() const noexcept
+{
+    return document != nullptr ? document->getNode (index).type : Type::null;
+}
+
+bool JSONDocument::Value::getBool() const noexcept
+{
+    return isBool() && document->getNode (index).intValue != 0;
+}
+
+int64 JSONDocument::Value::getInt() const noexcept
+{
+    switch (getType())
+    {
+        case Type::integer:         return document->getNode (index).intValue;
+        case Type::floatingPoint:   return (int64) document->getNode (index).doubleValue;
+        case Type::null:
+        case Type::boolean:
+        case Type::string:
+        case Type::array:
+        case Type::object:          break;
+    }
+
+    return 0;
+}
+
+double JSONDocument::Value::getDouble() const noexcept
+{
+    switch (getType())
+    {
+        case Type::integer:         return (double) document->getNode (index).intValue;
+        case Type::floatingPoint:   return document->getNode (index).doubleValue;
+        case Type::null:
+        case Type::boolean:
+        case Type::string:
+        case Type::array:
+        case Type::object:          break;
+    }
+
+    return 0.0;
+}
+
+std::string_view JSONDocument::Value::getString() const noexcept
+{
+    if (! isString())
+        return {};
+
+    const auto& node = document->getNode (index);
+    return document->getText (node.textOffset, node.size, node.textInArena);
+}
+
+String JSONDocument::Value::toString() const
+{
+    const auto text = getString();
+    return String::fromUTF8 (text.data(), (int) text.size());
+}
+
+int JSONDocument::Value::size() const noexcept
+{
+    return isArray() || isObject() ? (int) document->getNode (index).size : 0;
+}
+
+std::string_view JSONDocument::Value::getName() const noexcept
+{
+    return document != nullptr ? document->getName (index) : std::string_view();
+}
+
+JSONDocument::Value JSONDocument::Value::operator[] (int childIndex) const noexcept
+{
+    if (childIndex < 0)
+        return {};
+
+    for (auto child : *this)
+        if (childIndex-- == 0)
+            return child;
+
+    return {};
+}
+
+JSONDocument::Value JSONDocument::Value::operator[] (std::string_view propertyName) const noexcept
+{
+    if (! isObject())
+        return {};
+
+    const auto& node = document->getNode (index);
+
+    if (node.size >= minSizeForPropertyIndex)
+    {
+        const auto first = document->propertyIndex.begin() + (std::ptrdiff_t) node.textOffset;
+        const auto last = first + (std::ptrdiff_t) node.size;
+
+        const auto next = std::upper_bound (first, last, propertyName,
+                                            [this] (std::string_view name, uint32 child) { return name < document->getName (child); });
+
+        if (next != first && document->getName (*std::prev (next)) == propertyName)
+            return { document, *std::prev (next) };
+
+        return {};
+    }
+
+    Value result;
+
+    for (auto child : *this)
+        if (child.getName() == propertyName)
+            result = child;
+
+    return result;
+}
+
+JSONDocument::Value::Iterator& JSONDocument::Value::Iterator::operator++() noexcept
+{
+    index = document->getNode (index).end;
+    return *this;
+}
+
+JSONDocument::Value::Iterator JSONDocument::Value::begin() const noexcept
+{
+    if (isArray() || isObject())
+        return { document, index + 1 };
+
+    return end();
+}
+
+JSONDocument::Value::Iterator JSONDocument::Value::end() const noexcept
+{
+    return { document, document != nullptr ? (size_t) document->getNode (index).end : index };
+}
+
+var JSONDocument::Value::toVar() const
+{
+    switch (getType())
+    {
+        case Type::null:            return {};
+        case Type::boolean:         return getBool();
+        case Type::floatingPoint:   return getDouble();
+        case Type::string:          return toString();
+
+        case Type::integer:
+        {
+            // Matches JSON::parse(), which only uses an int64 when the value won't fit in an int
+            const auto value = getInt();
+            const auto magnitude = value < 0 ? 0 - (uint64) value : (uint64) value;
+            return (magnitude >> 31) != 0 ? var (value) : var ((int) value);
+        }
+
+        case Type::array:
+        {
+            Array<var> result;
+            result.ensureStorageAllocated (size());
+
+            for (auto child : *this)
+                result.add (child.toVar());
+
+            return result;
+        }
+
+        case Type::object:
+        {
+            auto object = new DynamicObject();
+            var result (object);
+
+            for (auto child : *this)
+            {
+                const auto name = child.getName();
+                object->setProperty (Identifier (String::fromUTF8 (name.data(), (int) name.size())), child.toVar());
+            }
+
+            return result;
+        }
+    }
+
+    return {};
+}
+
+} // namespace juce
@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only, parsed JSON document.
+
+    JSON::parse() allocates a separate var, String and DynamicObject for every value in
+    a document. A JSONDocument instead keeps a copy of the source text and stores the
+    parsed values in a single flat array, with strings referring back into the source
+    wherever possible. Only strings that contain escape sequences need to be decoded,
+    and these are all stored together in one buffer.
+
+    This makes parsing much faster and uses far less memory for large documents. The
+    values can be inspected through JSONDocument::Value handles, converted to vars where
+    needed, or deserialised directly using JSONSerialisation's FromVar.
+
+    @code
+    JSONDocument doc;
+
+    if (doc.parse (file.loadFileAsString()).wasOk())
+        for (auto item : doc.getRoot()["items"])
+            DBG (item["name"].toString());
+    @endcode
+
+    @see JSON, JSONStreamParser
+
+    @tags{Core}
+*/
+class JUCE_API  JSONDocument
+{
+public:
+    //==============================================================================
+    /** The types of value that can appear in a document. */
+    enum class Type
+    {
+        null,
+        boolean,
+        integer,
+        floatingPoint,
+        string,
+        array,
+        object
+    };
+
+    //==============================================================================
+    /** Creates an empty document. */
+    JSONDocument();
+
+    /** Destructor. */
+    ~JSONDocument();
+
+    /** Move constructor. Any Values obtained from the other document must not be used afterwards. */
+    JSONDocument (JSONDocument&&) noexcept;
+
+    /** Move assignment operator. */
+    JSONDocument& operator= (JSONDocument&&) noexcept;
+
+    //==============================================================================
+    /** Parses some JSON text, replacing the current contents of the document.
+
+        The syntax accepted is the same as JSON::parse(), except that any type of value
+        may appear at the top level. If parsing fails, the document will be left empty.
+    */
+    Result parse (const String& text);
+
+    /** Reads and parses the remaining contents of a stream. */
+    Result parse (InputStream& input);
+
+    /** Parses a block of UTF-8 encoded JSON, taking ownership of the data. */
+    Result parse (MemoryBlock utf8Data);
+
+    /** Clears the document. */
+    void clear();
+
+    /** Returns the total number of values in the document. */
+    size_t getNumValues() const noexcept        { return nodes.size(); }
+
+    //==============================================================================
+    /**
+        A lightweight handle to a value inside a JSONDocument.
+
+        Values are cheap to copy, but refer to their document, so they must not be used
+        after the document has been deleted or re-parsed.
+
+        Accessing a child or property that doesn't exist returns an invalid Value, which
+        behaves as a null, so lookups can safely be chained.
+    */
+    class JUCE_API  Value
+    {
+    public:
+        /** Creates an invalid value. */
+        Value() = default;
+
+        /** Returns true if this refers to a value in a document. */
+        bool isValid() const noexcept                   { return document != nullptr; }
+
+        /** Returns the type of this value. Invalid values are reported as null. */
+        Type getType() const noexcept;
+
+        bool isNull() const noexcept                    { return getType() == Type::null; }
+        bool isBool() const noexcept                    { return getType() == Type::boolean; }
+        bool isInt() const noexcept                     { return getType() == Type::integer; }
+        bool isDouble() const noexcept                  { return getType() == Type::floatingPoint; }
+        bool isString() const noexcept                  { return getType() == Type::string; }
+        bool isArray() const noexcept                   { return getType() == Type::array; }
+        bool isObject() const noexcept                  { return getType() == Type::object; }
+
+        /** Returns the value if it's a boolean, or false otherwise. */
+        bool getBool() const noexcept;
+
+        /** Returns the value of a number, or 0 if this isn't a number. */
+        int64 getInt() const noexcept;
+
+        /** Returns the value of a number, or 0 if this isn't a number. */
+        double getDouble() const noexcept;
+
+        /** Returns the UTF-8 text of a string, or an empty view if this isn't a string.
+
+            The view remains valid for as long as the document.
+        */
+        std::string_view getString() const noexcept;
+
+        /** Returns the text of a string as a String, or an empty string if this isn't a string. */
+        String toString() const;
+
+        /** Returns the number of elements in an array or properties in an object. */
+        int size() const noexcept;
+
+        /** Returns an element of an array or an object, or an invalid value if the index is
+            out of range.
+
+            This has to walk along the container, so use begin() and end() to visit all of
+            its elements.
+        */
+        Value operator[] (int index) const noexcept;
+
+        /** Returns the value of an object's property, or an invalid value if it isn't found.
+
+            If the object contains several properties with the same name, the last one is
+            returned, to match the behaviour of JSON::parse().
+
+            Objects with more than a few properties are indexed by name when the document is
+            parsed, so this takes logarithmic time for them, rather than comparing every name.
+        */
+        Value operator[] (std::string_view propertyName) const noexcept;
+
+        /** Returns the value of an object's property. */
+        Value operator[] (const char* propertyName) const noexcept     { return operator[] (std::string_view (propertyName)); }
+
+        /** If this value is a property of an object, returns its name. */
+        std::string_view getName() const noexcept;
+
+        /** Creates a var containing a copy of this value and any values inside it. */
+        var toVar() const;
+
+        //==============================================================================
+        /** Iterates over the elements of an array or the properties of an object. */
+        struct Iterator
+        {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Value;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = Value;
+
+            Value operator*() const noexcept                        { return { document, index }; }
+            Iterator& operator++() noexcept;
+            Iterator operator++ (int) noexcept                      { auto copy = *this; ++(*this); return copy; }
+            bool operator== (const Iterator& other) const noexcept  { return index == other.index; }
+            bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+
+            const JSONDocument* document;
+            size_t index;
+        };
+
+        /** Returns an iterator to the first element of an array or object. */
+        Iterator begin() const noexcept;
+
+        /** Returns an iterator to the end of an array or object. */
+        Iterator end() const noexcept;
+
+    private:
+        friend class JSONDocument;
+        Value (const JSONDocument* d, size_t i) noexcept : document (d), index (i) {}
+
+        const JSONDocument* document = nullptr;
+        size_t index = 0;
+    };
+
+    /** Returns the top-level value, or an invalid value if the document is empty. */
+    Value getRoot() const noexcept;
+
+private:
+    //==============================================================================
+    struct Node
+    {
+        union
+        {
+            int64 intValue;
+            double doubleValue;
+            size_t textOffset;      // for a large object, the start of its entries in propertyIndex
+        };
+
+        size_t nameOffset;
+        uint32 size;            // the length of a string, or the number of elements in a container
+        uint32 nameLength;
+        uint32 end;             // one past the index of the last value nested inside this one
+        Type type;
+        bool textInArena, nameInArena;
+    };
+
+    struct Builder;
+
+    // Objects with at least this many properties get an entry in propertyIndex
+    static constexpr uint32 minSizeForPropertyIndex = 16;
+
+    const Node& getNode (size_t index) const noexcept   { return nodes[index]; }
+    std::string_view getText (size_t offset, size_t length, bool inArena) const noexcept;
+    std::string_view getName (size_t index) const noexcept;
+
+    MemoryBlock source;
+    std::string arena;
+    std::vector<Node> nodes;
+    std::vector<uint32> propertyIndex;  // the properties of each large object, sorted by name
+
+    JUCE_DECLARE_NON_COPYABLE (JSONDocument)
+};
+
+} // namespace juce
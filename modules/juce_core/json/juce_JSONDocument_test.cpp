@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class JSONStreamParserTests final : public UnitTest
+{
+public:
+    JSONStreamParserTests() : UnitTest ("JSONStreamParser", UnitTestCategories::json) {}
+
+    struct EventRecorder final : public JSONStreamParser::Handler
+    {
+        bool startObject() override                         { events.add ("{"); return true; }
+        bool propertyName (std::string_view name) override  { events.add ("name:" + toString (name)); return true; }
+        bool endObject() override                           { events.add ("}"); return true; }
+        bool startArray() override                          { events.add ("["); return true; }
+        bool endArray() override                            { events.add ("]"); return true; }
+        bool stringValue (std::string_view s) override      { events.add ("string:" + toString (s)); return true; }
+        bool intValue (int64 v) override                    { events.add ("int:" + String (v)); return true; }
+        bool doubleValue (double v) override                { events.add ("double:" + String (v)); return true; }
+        bool boolValue (bool v) override                    { events.add (v ? "true" : "false"); return true; }
+        bool nullValue() override                           { events.add ("null"); return true; }
+
+        static String toString (std::string_view s)         { return String::fromUTF8 (s.data(), (int) s.size()); }
+
+        StringArray events;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Events are reported in document order");
+        {
+            EventRecorder recorder;
+            const auto result = JSONStreamParser::parse (String (R"({ "a": [1, -2.5, "x", true, false, null], "b": {}, "c": [] })"), recorder);
+
+            expect (result.wasOk());
+            expectEquals (recorder.events.joinIntoString (" "),
+                          String ("{ name:a [ int:1 double:-2.5 string:x true false null ] name:b { } name:c [ ] }"));
+        }
+
+        beginTest ("Scalars are accepted at the top level");
+        {
+            for (const auto& [input, expected] : { std::tuple { "123", "int:123" },
+                                                   std::tuple { " \"str\" ", "string:str" },
+                                                   std::tuple { "- 4", "int:-4" },
+                                                   std::tuple { "1e3", "double:1000" },
+                                                   std::tuple { "null", "null" } })
+            {
+                EventRecorder recorder;
+                expect (JSONStreamParser::parse (String (input), recorder).wasOk());
+                expectEquals (recorder.events.joinIntoString (" "), String (expected));
+            }
+        }
+
+        beginTest ("Large integers");
+        {
+            EventRecorder recorder;
+            expect (JSONStreamParser::parse (String ("[9223372036854775807, -9223372036854775808, 18446744073709551616]"), recorder).wasOk());
+            expectEquals (recorder.events[1], "int:" + String (std::numeric_limits<int64>::max()));
+            expectEquals (recorder.events[2], "int:" + String (std::numeric_limits<int64>::min()));
+            expect (recorder.events[3].startsWith ("double:"));
+        }
+
+        beginTest ("Escape sequences are decoded");
+        {
+            EventRecorder recorder;
+            expect (JSONStreamParser::parse (String (R"(["a\nb", "\u00e9\ud83d\ude00", 'single \' quote', "\/\\\""])"), recorder).wasOk());
+            expectEquals (recorder.events[1], String ("string:a\nb"));
+            expectEquals (recorder.events[2], "string:" + String (CharPointer_UTF8 ("\xc3\xa9\xf0\x9f\x98\x80")));
+            expectEquals (recorder.events[3], String ("string:single ' quote"));
+            expectEquals (recorder.events[4], String ("string:/\\\""));
+        }
+
+        beginTest ("Errors match JSON::parse");
+        {
+            for (const auto* input : { "{ \"a\": 1", "[1, 2", "{ \"a\" 1 }", "{ a: 1 }", "[1 2]", "[\"abc",
+                                       "{ \"\": 1 }", "[1x]", "[tru]", "[\"\\ud800\"]", "[\"\\udc00\"]", "{\n  \"a\": [\n    1,\n    ?\n  ]\n}" })
+            {
+                EventRecorder recorder;
+                var parsed;
+                const auto expected = JSON::parse (input, parsed);
+                const auto result = JSONStreamParser::parse (String (input), recorder);
+
+                expect (result.failed());
+                expectEquals (result.getErrorMessage(), expected.getErrorMessage());
+            }
+        }
+
+        beginTest ("Parsing can be stopped by the handler");
+        {
+            struct StopAtSecondValue final : public JSONStreamParser::Handler
+            {
+                bool intValue (int64) override  { return ++numValues < 2; }
+                int numValues = 0;
+            };
+
+            StopAtSecondValue handler;
+            expect (JSONStreamParser::parse (String ("[1, 2, 3]"), handler).failed());
+            expectEquals (handler.numValues, 2);
+        }
+
+        beginTest ("Reading from a stream gives the same results as reading from memory");
+        {
+            Random r = getRandom();
+            const auto document = JSON::toString (createRandomVar (r, 0), true);
+
+            EventRecorder fromMemory, fromStream;
+            expect (JSONStreamParser::parse (document, fromMemory).wasOk());
+
+            MemoryInputStream stream (document.toRawUTF8(), document.getNumBytesAsUTF8(), false);
+            expect (JSONStreamParser::parse (stream, fromStream).wasOk());
+
+            expect (fromMemory.events.size() > 100);
+            expect (fromMemory.events == fromStream.events);
+        }
+    }
+
+    static var createRandomVar (Random& r, int depth)
+    {
+        if (depth < 3)
+        {
+            if (r.nextBool())
+            {
+                auto* obj = new DynamicObject();
+                var v (obj);
+
+                for (int i = 0; i < 8; ++i)
+                    obj->setProperty ("item" + String (i) + "\"\\" + String::repeatedString ("x", r.nextInt (100)),
+                                      createRandomVar (r, depth + 1));
+
+                return v;
+            }
+
+            Array<var> array;
+
+            for (int i = 0; i < 8; ++i)
+                array.add (createRandomVar (r, depth + 1));
+
+            return array;
+        }
+
+        switch (r.nextInt (5))
+        {
+            case 0:  return r.nextInt();
+            case 1:  return r.nextDouble();
+            case 2:  return r.nextBool();
+            case 3:  return String::repeatedString ("abc", r.nextInt (1000));
+            default: break;
+        }
+
+        return {};
+    }
+};
+
+static JSONStreamParserTests jsonStreamParserTests;
+
+//==============================================================================
+struct JSONDocumentTestType
+{
+    int a = 0;
+    String b;
+    std::vector<double> c;
+    std::map<std::string, bool> d;
+    std::optional<String> e;
+    var f;
+
+    static constexpr auto marshallingVersion = 3;
+
+    template <typename Archive, typename T>
+    static void serialise (Archive& archive, T& t)
+    {
+        if (archive.getVersion() != 3)
+            return;
+
+        archive (named ("a", t.a),
+                 named ("b", t.b),
+                 named ("c", t.c),
+                 named ("d", t.d),
+                 named ("e", t.e),
+                 named ("f", t.f));
+    }
+
+    auto tie() const { return std::tie (a, b, c, d, e); }
+    bool operator== (const JSONDocumentTestType& other) const { return tie() == other.tie() && JSON::toString (f) == JSON::toString (other.f); }
+};
+
+class JSONDocumentTests final : public UnitTest
+{
+public:
+    JSONDocumentTests() : UnitTest ("JSONDocument", UnitTestCategories::json) {}
+
+    void runTest() override
+    {
+        beginTest ("Empty documents");
+        {
+            JSONDocument doc;
+            expect (! doc.getRoot().isValid());
+            expect (doc.getRoot().isNull());
+            expect (! doc.getRoot()["a"][2].isValid());
+
+            expect (doc.parse (String ("[1, ")).failed());
+            expectEquals ((int) doc.getNumValues(), 0);
+        }
+
+        beginTest ("Values can be inspected");
+        {
+            JSONDocument doc;
+            expect (doc.parse (String (R"({ "name": "abc", "list": [1, 2.5, true, null, "x\ty"], "name": "def", "nested": { "a": {} } })")).wasOk());
+
+            const auto root = doc.getRoot();
+            expect (root.isObject());
+            expectEquals (root.size(), 4);
+            expect (root["name"].getString() == "def");
+            expect (root[0].getName() == "name");
+            expect (root[0].getString() == "abc");
+
+            const auto list = root["list"];
+            expect (list.isArray());
+            expectEquals (list.size(), 5);
+            expectEquals (list[0].getInt(), (int64) 1);
+            expectEquals (list[1].getDouble(), 2.5);
+            expect (list[2].getBool());
+            expect (list[3].isNull() && list[3].isValid());
+            expectEquals (list[4].toString(), String ("x\ty"));
+            expect (! list[5].isValid());
+
+            expect (root["nested"]["a"].isObject());
+            expectEquals (root["nested"]["a"].size(), 0);
+
+            StringArray names;
+
+            for (auto property : root)
+                names.add (String::fromUTF8 (property.getName().data(), (int) property.getName().size()));
+
+            expectEquals (names.joinIntoString (","), String ("name,list,name,nested"));
+        }
+
+        beginTest ("Properties of large objects can be looked up by name");
+        {
+            for (const auto numProperties : { 5, 16, 17, 300 })
+            {
+                String text ("{");
+
+                for (int i = 0; i < numProperties; ++i)
+                    text << "\"p" << (i * 7919) % numProperties << "\": " << i << ", ";
+
+                // Duplicate names resolve to the last one, and escaped names live in the arena
+                text << "\"p0\": -1, \"esc\\u0061ped\": { \"p1\": 2 } }";
+
+                JSONDocument doc;
+                expect (doc.parse (text).wasOk());
+                const auto root = doc.getRoot();
+                expectEquals (root.size(), numProperties + 2);
+
+                for (int i = 1; i < numProperties; ++i)
+                    expectEquals (root[("p" + String ((i * 7919) % numProperties)).toStdString()].getInt(), (int64) i);
+
+                expectEquals (root["p0"].getInt(), (int64) -1);
+                expectEquals (root["escaped"]["p1"].getInt(), (int64) 2);
+                expect (! root["p"].isValid());
+                expect (! root["q"].isValid());
+                expect (! root[""].isValid());
+                expect (! root["p" + std::to_string (numProperties)].isValid());
+            }
+        }
+
+        beginTest ("Strings without escapes refer to the source text");
+        {
+            const String text (R"(["plain", "escaped\n"])");
+            MemoryBlock block (text.toRawUTF8(), text.getNumBytesAsUTF8());
+
+            JSONDocument doc;
+            expect (doc.parse (std::move (block)).wasOk());
+
+            const auto plain = doc.getRoot()[0].getString();
+            const auto escaped = doc.getRoot()[1].getString();
+            expect (plain == "plain");
+            expect (escaped == "escaped\n");
+            expect (escaped.data() != plain.data() + 9);
+        }
+
+        beginTest ("toVar matches JSON::parse");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 20; ++i)
+            {
+                const auto text = JSON::toString (JSONStreamParserTests::createRandomVar (r, 1), r.nextBool());
+
+                JSONDocument doc;
+                expect (doc.parse (text).wasOk());
+                expectEquals (JSON::toString (doc.getRoot().toVar()), JSON::toString (JSON::parse (text)));
+            }
+
+            JSONDocument doc;
+            expect (doc.parse (String ("[1, 2147483648, -2147483648, -2147483647]")).wasOk());
+            const auto parsed = doc.getRoot().toVar();
+            expect (parsed[0].isInt() && parsed[1].isInt64() && parsed[2].isInt64() && parsed[3].isInt());
+        }
+
+        beginTest ("FromVar can read directly from a document");
+        {
+            JSONDocumentTestType original;
+            original.a = 42;
+            original.b = CharPointer_UTF8 ("escaped \"text\" \xc3\xa9");
+            original.c = { 1.5, -2.25 };
+            original.d = { { "yes", true }, { "no", false } };
+            original.e = "optional";
+            original.f = JSONUtils::makeObject ({ { "x", Array<var> { 1, "two" } } });
+
+            const auto text = JSON::toString (*ToVar::convert (original));
+
+            JSONDocument doc;
+            expect (doc.parse (text).wasOk());
+
+            const auto fromDocument = FromVar::convert<JSONDocumentTestType> (doc.getRoot());
+            const auto fromVar = FromVar::convert<JSONDocumentTestType> (JSON::parse (text));
+
+            expect (fromDocument.has_value());
+            expect (fromVar.has_value());
+            expect (*fromDocument == original);
+            expect (*fromDocument == *fromVar);
+
+            expect (FromVar::convert<std::vector<int>> (JSONDocument::Value{}) == std::nullopt);
+            expect (doc.parse (String ("[1, 2, 3]")).wasOk());
+            expect (FromVar::convert<std::vector<int>> (doc.getRoot()) == std::vector<int> { 1, 2, 3 });
+            expect (FromVar::convert<std::vector<String>> (doc.getRoot()) == std::nullopt);
+
+            expect (doc.parse (String (R"({ "__version__": 2, "a": 1 })")).wasOk());
+            expectEquals (FromVar::convert<JSONDocumentTestType> (doc.getRoot())->a, 0);
+        }
+    }
+};
+
+static JSONDocumentTests jsonDocumentTests;
+
+} // namespace juce
@@ -278,21 +278,43 @@ public:
     template <typename T>
     static std::optional<T> convert (const var& v)
     {
-        return Visitor::convert<T> (v);
+        return Visitor<var>::convert<T> (v);
+    }
+
+    /** Attempts to convert a value in a JSONDocument to an instance of type T.
+
+        This behaves in the same way as converting the result of JSONDocument::Value::toVar(),
+        but reads directly from the document, without creating any intermediate vars.
+    */
+    template <typename T>
+    static std::optional<T> convert (const JSONDocument::Value& v)
+    {
+        return Visitor<JSONDocument::Value>::convert<T> (v);
     }
 
 private:
+    template <typename Input>
     class Visitor
     {
+        static constexpr auto isDocument = std::is_same_v<Input, JSONDocument::Value>;
+
     public:
         template <typename T>
-        static std::optional<T> convert (const var& v)
+        static std::optional<T> convert (const Input& v)
         {
             const auto version = [&]() -> std::optional<int>
             {
-                if (auto* obj = v.getDynamicObject())
-                    if (obj->hasProperty ("__version__"))
-                        return (int) obj->getProperty ("__version__");
+                if constexpr (isDocument)
+                {
+                    if (const auto property = v["__version__"]; property.isValid())
+                        return (int) property.toVar();
+                }
+                else
+                {
+                    if (auto* obj = v.getDynamicObject())
+                        if (obj->hasProperty ("__version__"))
+                            return (int) obj->getProperty ("__version__");
+                }
 
                 return std::nullopt;
             }();
@@ -313,7 +335,7 @@ private:
         }
 
     private:
-        Visitor (std::optional<int> vn, const var& i)
+        Visitor (std::optional<int> vn, const Input& i)
             : version (vn), input (i) {}
 
         template <typename T>
@@ -351,9 +373,16 @@ private:
             if (! node.has_value())
                 return;
 
-            auto* obj = node->getDynamicObject();
+            if constexpr (isDocument)
+            {
+                failed = ! node->isObject() || ! tryGetProperty (*node, named);
+            }
+            else
+            {
+                auto* obj = node->getDynamicObject();
 
-            failed = obj == nullptr || ! tryGetProperty (*obj, named);
+                failed = obj == nullptr || ! tryGetProperty (*obj, named);
+            }
         }
 
         template <typename T>
@@ -362,15 +391,27 @@ private:
             if (failed)
                 return;
 
-            if (auto* array = input.getArray())
+            if constexpr (isDocument)
             {
-                t.size = static_cast<T> (array->size());
-                currentArrayIndex = 0;
+                if (input.isArray())
+                {
+                    t.size = static_cast<T> (input.size());
+                    currentArrayIndex = 0;
+                    arrayCursor = input.begin();
+                    return;
+                }
             }
             else
             {
-                failed = true;
+                if (auto* array = input.getArray())
+                {
+                    t.size = static_cast<T> (array->size());
+                    currentArrayIndex = 0;
+                    return;
+                }
             }
+
+            failed = true;
         }
 
         void visit (bool& t)
@@ -385,7 +426,10 @@ private:
 
         void visit (var& t)
         {
-            t = input;
+            if constexpr (isDocument)
+                t = input.toVar();
+            else
+                t = input;
         }
 
         static std::optional<double> pullTyped (std::in_place_type_t<double>, const var& source)
@@ -408,7 +452,27 @@ private:
             return source.isString() ? std::optional<String> (source.toString()) : std::nullopt;
         }
 
-        std::optional<var> getNodeToRead()
+        static std::optional<double> pullTyped (std::in_place_type_t<double>, const JSONDocument::Value& source)
+        {
+            return source.isDouble() ? std::optional<double> (source.getDouble()) : std::nullopt;
+        }
+
+        static std::optional<int64> pullTyped (std::in_place_type_t<int64>, const JSONDocument::Value& source)
+        {
+            return source.isInt() ? std::optional<int64> (source.getInt()) : std::nullopt;
+        }
+
+        static std::optional<bool> pullTyped (std::in_place_type_t<bool>, const JSONDocument::Value& source)
+        {
+            return std::optional<bool> (source.isBool() ? source.getBool() : (bool) source.toVar());
+        }
+
+        static std::optional<String> pullTyped (std::in_place_type_t<String>, const JSONDocument::Value& source)
+        {
+            return source.isString() ? std::optional<String> (source.toString()) : std::nullopt;
+        }
+
+        std::optional<Input> getNodeToRead()
         {
             if (failed)
                 return std::nullopt;
@@ -416,13 +480,27 @@ private:
             if (currentArrayIndex == std::numeric_limits<size_t>::max())
                 return input;
 
-            const auto* array = input.getArray();
+            if constexpr (isDocument)
+            {
+                if (! input.isArray())
+                    return input;
+
+                if (arrayCursor != input.end())
+                {
+                    ++currentArrayIndex;
+                    return *arrayCursor++;
+                }
+            }
+            else
+            {
+                const auto* array = input.getArray();
 
-            if (array == nullptr)
-                return input;
+                if (array == nullptr)
+                    return input;
 
-            if ((int) currentArrayIndex < array->size())
-                return array->getReference ((int) currentArrayIndex++);
+                if ((int) currentArrayIndex < array->size())
+                    return array->getReference ((int) currentArrayIndex++);
+            }
 
             failed = true;
             return std::nullopt;
@@ -461,9 +539,27 @@ private:
             return true;
         }
 
+        template <typename T>
+        static bool tryGetProperty (const JSONDocument::Value& obj, const Named<T>& n)
+        {
+            const auto property = obj[n.name];
+
+            if (! property.isValid())
+                return false;
+
+            const auto converted = convert<T> (property);
+
+            if (! converted.has_value())
+                return false;
+
+            n.value = *converted;
+            return true;
+        }
+
         std::optional<int> version;
-        var input;
+        Input input;
         size_t currentArrayIndex = std::numeric_limits<size_t>::max();
+        JSONDocument::Value::Iterator arrayCursor {};
         bool failed = false;
     };
 };
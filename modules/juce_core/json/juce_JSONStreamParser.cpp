@@ -0,0 +1,627 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  Provides the input for a JSONEventReader from a contiguous block of memory.
+    Everything in the block stays valid while parsing, so strings without escapes
+    can be handed on as views into it.
+*/
+struct JSONMemorySource
+{
+    JSONMemorySource (const void* data, size_t numBytes)
+        : start (static_cast<const char*> (data)), pos (start), end (start + numBytes) {}
+
+    static constexpr bool isPersistent = true;
+
+    const char* data() const noexcept       { return pos; }
+    size_t available() const noexcept       { return (size_t) (end - pos); }
+    void advance (size_t numBytes) noexcept { pos += numBytes; }
+    bool refill() noexcept                  { return false; }
+    uint64 getPosition() const noexcept     { return (uint64) (pos - start); }
+
+    const char* start;
+    const char* pos;
+    const char* end;
+};
+
+/*  Provides the input for a JSONEventReader by reading an InputStream in blocks. */
+struct JSONStreamSource
+{
+    explicit JSONStreamSource (InputStream& s) : stream (s), buffer (bufferSize) {}
+
+    static constexpr bool isPersistent = false;
+
+    const char* data() const noexcept       { return pos; }
+    size_t available() const noexcept       { return (size_t) (end - pos); }
+    void advance (size_t numBytes) noexcept { pos += numBytes; }
+    uint64 getPosition() const noexcept     { return bufferStartPosition + (uint64) (pos - buffer.get()); }
+
+    bool refill()
+    {
+        bufferStartPosition += (uint64) (end - buffer.get());
+        const auto numRead = stream.read (buffer.get(), bufferSize);
+        pos = buffer.get();
+        end = pos + jmax (0, numRead);
+        return numRead > 0;
+    }
+
+    static constexpr int bufferSize = 65536;
+
+    InputStream& stream;
+    HeapBlock<char> buffer;
+    const char* pos = buffer.get();
+    const char* end = buffer.get();
+    uint64 bufferStartPosition = 0;
+};
+
+//==============================================================================
+/*  The parser behind JSONStreamParser and JSONDocument.
+
+    It accepts the same syntax as JSONParser, but rather than building vars it passes
+    each value to a Sink as soon as it has been read. Nesting is tracked with an explicit
+    stack rather than by recursion, so deeply nested input can't overflow the call stack.
+
+    Strings are passed to the sink along with a flag that is true if the view points
+    directly into the source data (and will therefore remain valid after the callback),
+    or false if it points into a temporary buffer.
+*/
+template <typename Source, typename Sink>
+struct JSONEventReader
+{
+    JSONEventReader (Source& s, Sink& k) : source (s), sink (k) {}
+
+    struct ErrorException
+    {
+        String message;
+        int line = 1, column = 1;
+
+        String getDescription() const   { return String (line) + ":" + String (column) + ": error: " + message; }
+        Result getResult() const        { return Result::fail (getDescription()); }
+    };
+
+    Result parse()
+    {
+        try
+        {
+            parseDocument();
+        }
+        catch (const ErrorException& error)
+        {
+            return error.getResult();
+        }
+
+        return Result::ok();
+    }
+
+private:
+    struct Location
+    {
+        int line, column;
+    };
+
+    struct Container
+    {
+        bool isObject, hasValue;
+        Location start;
+    };
+
+    Source& source;
+    Sink& sink;
+    std::vector<Container> stack;
+    std::string stringBuffer, numberBuffer;
+    int line = 1;
+    uint64 lineStartPosition = 0;
+
+    //==============================================================================
+    [[noreturn]] void throwError (String message, Location location)
+    {
+        ErrorException e;
+        e.message = std::move (message);
+        e.line = location.line;
+        e.column = location.column;
+        throw e;
+    }
+
+    Location getLocation() const
+    {
+        return { line, (int) (source.getPosition() - lineStartPosition) + 1 };
+    }
+
+    void startNewLine()
+    {
+        ++line;
+        lineStartPosition = source.getPosition();
+    }
+
+    void check (bool handlerResult)
+    {
+        if (! handlerResult)
+            throwError ("Parsing stopped by handler", getLocation());
+    }
+
+    int peekChar()
+    {
+        if (source.available() == 0 && ! source.refill())
+            return 0;
+
+        return (uint8) *source.data();
+    }
+
+    int readChar()
+    {
+        const auto c = peekChar();
+
+        if (c != 0)
+            source.advance (1);
+
+        return c;
+    }
+
+    bool matchIf (char c)
+    {
+        if (peekChar() != c)
+            return false;
+
+        source.advance (1);
+        return true;
+    }
+
+    bool matchString (const char* t)
+    {
+        while (*t != 0)
+            if (! matchIf (*t++))
+                return false;
+
+        return true;
+    }
+
+    void skipWhitespace()
+    {
+        for (;;)
+        {
+            const auto* data = source.data();
+            const auto numAvailable = source.available();
+
+            // Values are often not preceded by any whitespace at all
+            if (numAvailable > 0 && ! CharacterFunctions::isWhitespace (*data))
+                return;
+
+            const auto end = detail::ByteScanning::findFirstNonWhitespace (data, numAvailable);
+
+            for (auto i = detail::ByteScanning::findFirstOf<'\n'> (data, end);
+                 i < end;
+                 i += 1 + detail::ByteScanning::findFirstOf<'\n'> (data + i + 1, end - i - 1))
+            {
+                ++line;
+                lineStartPosition = source.getPosition() + i + 1;
+            }
+
+            source.advance (end);
+
+            if (end < numAvailable || ! source.refill())
+                return;
+        }
+    }
+
+    //==============================================================================
+    void parseDocument()
+    {
+        skipWhitespace();
+        parseValue();
+
+        while (! stack.empty())
+        {
+            skipWhitespace();
+            const auto location = getLocation();
+            const auto c = peekChar();
+            auto& container = stack.back();
+            const auto isObject = container.isObject;
+            const auto closeChar = isObject ? '}' : ']';
+
+            if (container.hasValue)
+            {
+                if (c == ',')
+                {
+                    source.advance (1);
+                    container.hasValue = false;
+                    continue;
+                }
+
+                if (c == closeChar)
+                {
+                    source.advance (1);
+                    closeContainer();
+                    continue;
+                }
+
+                throwError (isObject ? "Expected ',' or '}'" : "Expected ',' or ']'", location);
+            }
+
+            if (c == closeChar)
+            {
+                source.advance (1);
+                closeContainer();
+                continue;
+            }
+
+            if (c == 0)
+                throwError (isObject ? "Unexpected EOF in object declaration"
+                                     : "Unexpected EOF in array declaration",
+                            container.start);
+
+            container.hasValue = true;
+
+            if (isObject)
+                parsePropertyName();
+
+            parseValue();
+        }
+    }
+
+    void closeContainer()
+    {
+        const auto isObject = stack.back().isObject;
+        stack.pop_back();
+        check (isObject ? sink.endObject() : sink.endArray());
+    }
+
+    void openContainer (bool isObject)
+    {
+        source.advance (1);
+        check (isObject ? sink.startObject() : sink.startArray());
+        stack.push_back ({ isObject, false, getLocation() });
+    }
+
+    void parsePropertyName()
+    {
+        if (! matchIf ('"'))
+            throwError ("Expected a property name in double-quotes", getLocation());
+
+        const auto nameLocation = getLocation();
+        bool isViewIntoSource = false;
+        const auto name = parseString ('"', isViewIntoSource);
+
+        if (name.empty())
+            throwError ("Invalid property name", nameLocation);
+
+        check (sink.propertyName (name, isViewIntoSource));
+
+        skipWhitespace();
+
+        if (! matchIf (':'))
+            throwError ("Expected ':'", getLocation());
+
+        skipWhitespace();
+    }
+
+    void parseValue()
+    {
+        const auto location = getLocation();
+        const auto c = peekChar();
+
+        switch (c)
+        {
+            case '{':   openContainer (true);  return;
+            case '[':   openContainer (false); return;
+
+            case '"':
+            case '\'':
+            {
+                source.advance (1);
+                bool isViewIntoSource = false;
+                const auto s = parseString ((char) c, isViewIntoSource);
+                check (sink.stringValue (s, isViewIntoSource));
+                return;
+            }
+
+            case '-':
+                source.advance (1);
+                skipWhitespace();
+
+                if (! isPositiveAndBelow (peekChar() - '0', 10))
+                    break;
+
+                parseNumber (true);
+                return;
+
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                parseNumber (false);
+                return;
+
+            case 't':
+                if (matchString ("true"))
+                {
+                    check (sink.boolValue (true));
+                    return;
+                }
+
+                break;
+
+            case 'f':
+                if (matchString ("false"))
+                {
+                    check (sink.boolValue (false));
+                    return;
+                }
+
+                break;
+
+            case 'n':
+                if (matchString ("null"))
+                {
+                    check (sink.nullValue());
+                    return;
+                }
+
+                break;
+
+            default:
+                break;
+        }
+
+        throwError ("Syntax error", location);
+    }
+
+    //==============================================================================
+    void parseNumber (bool isNegative)
+    {
+        numberBuffer.clear();
+        uint64 magnitude = 0;
+        bool overflowed = false;
+
+        for (;;)
+        {
+            const auto c = peekChar();
+            const auto digit = c - '0';
+
+            if (! isPositiveAndBelow (digit, 10))
+                break;
+
+            overflowed = overflowed || magnitude > (std::numeric_limits<uint64>::max() - (uint64) digit) / 10;
+            magnitude = magnitude * 10 + (uint64) digit;
+            numberBuffer += (char) c;
+            source.advance (1);
+        }
+
+        auto c = peekChar();
+
+        if (c == '.' || c == 'e' || c == 'E')
+        {
+            while (isPositiveAndBelow (c - '0', 10) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-')
+            {
+                numberBuffer += (char) c;
+                source.advance (1);
+                c = peekChar();
+            }
+
+            check (sink.doubleValue (readDouble (isNegative)));
+            return;
+        }
+
+        if (! (c == 0 || c == ',' || c == '}' || c == ']' || CharacterFunctions::isWhitespace ((char) c)))
+            throwError ("Syntax error in number", getLocation());
+
+        const auto limit = (uint64) std::numeric_limits<int64>::max() + (isNegative ? 1 : 0);
+
+        if (overflowed || magnitude > limit)
+        {
+            check (sink.doubleValue (readDouble (isNegative)));
+            return;
+        }
+
+        check (sink.intValue (isNegative ? (int64) (0 - magnitude) : (int64) magnitude));
+    }
+
+    double readDouble (bool isNegative) const
+    {
+        CharPointer_ASCII text (numberBuffer.c_str());
+        const auto value = CharacterFunctions::readDoubleValue (text);
+        return isNegative ? -value : value;
+    }
+
+    //==============================================================================
+    std::string_view parseString (char quoteChar, bool& isViewIntoSource)
+    {
+        stringBuffer.clear();
+        bool hasCopiedText = false;
+
+        for (;;)
+        {
+            const auto* data = source.data();
+            const auto numAvailable = source.available();
+            const auto i = quoteChar == '"' ? detail::ByteScanning::findFirstOf<'"',  '\\', '\n', 0> (data, numAvailable)
+                                            : detail::ByteScanning::findFirstOf<'\'', '\\', '\n', 0> (data, numAvailable);
+
+            if (i < numAvailable && data[i] == quoteChar && ! hasCopiedText)
+            {
+                source.advance (i + 1);
+                isViewIntoSource = Source::isPersistent;
+                return { data, i };
+            }
+
+            stringBuffer.append (data, i);
+            hasCopiedText = true;
+            source.advance (i);
+
+            if (i == numAvailable)
+            {
+                if (! source.refill())
+                    throwError ("Unexpected EOF in string constant", getLocation());
+
+                continue;
+            }
+
+            const auto c = data[i];
+
+            if (c == quoteChar)
+            {
+                source.advance (1);
+                isViewIntoSource = false;
+                return stringBuffer;
+            }
+
+            if (c == 0)
+                throwError ("Unexpected EOF in string constant", getLocation());
+
+            source.advance (1);
+
+            if (c == '\n')
+            {
+                startNewLine();
+                stringBuffer += '\n';
+                continue;
+            }
+
+            parseEscapeSequence();
+        }
+    }
+
+    void parseEscapeSequence()
+    {
+        auto errorLocation = getLocation();
+        --errorLocation.column; // points at the backslash
+        const auto c = readChar();
+
+        switch (c)
+        {
+            case 'a': stringBuffer += '\a'; return;
+            case 'b': stringBuffer += '\b'; return;
+            case 'f': stringBuffer += '\f'; return;
+            case 'n': stringBuffer += '\n'; return;
+            case 'r': stringBuffer += '\r'; return;
+            case 't': stringBuffer += '\t'; return;
+            case 'u': appendUTF8 (parseUnicodeEscape (errorLocation)); return;
+
+            case 0:
+                throwError ("Unexpected EOF in string constant", getLocation());
+
+            default:
+                // Any other escaped character is kept as it is, including the quotes,
+                // slashes and backslashes.
+                stringBuffer += (char) c;
+                return;
+        }
+    }
+
+    int parseHexDigit()
+    {
+        const auto location = getLocation();
+        const auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) readChar());
+
+        if (digitValue < 0)
+            throwError ("Invalid hex character", location);
+
+        return digitValue;
+    }
+
+    uint32 parseCodeUnit()
+    {
+        return (uint32) (   parseHexDigit() << 12
+                         | (parseHexDigit() << 8)
+                         | (parseHexDigit() << 4)
+                         | (parseHexDigit()));
+    }
+
+    juce_wchar parseUnicodeEscape (Location errorLocation)
+    {
+        const auto firstCodeUnit = parseCodeUnit();
+
+        if (CharacterFunctions::isNonSurrogateCodePoint ((juce_wchar) firstCodeUnit))
+            return (juce_wchar) firstCodeUnit;
+
+        if (! CharacterFunctions::isHighSurrogate ((juce_wchar) firstCodeUnit))
+            throwError ("Invalid UTF-16 escape sequence", errorLocation);
+
+        const auto lowSurrogateLocation = getLocation();
+
+        if (readChar() != '\\' || readChar() != 'u')
+            throwError ("Expected UTF-16 low surrogate", lowSurrogateLocation);
+
+        const auto secondCodeUnit = parseCodeUnit();
+
+        if (! CharacterFunctions::isLowSurrogate ((juce_wchar) secondCodeUnit))
+            throwError ("Expected UTF-16 low surrogate", lowSurrogateLocation);
+
+        return (juce_wchar) (0x10000 + (((firstCodeUnit - 0xd800) << 10) | (secondCodeUnit - 0xdc00)));
+    }
+
+    void appendUTF8 (juce_wchar c)
+    {
+        char bytes[4] = {};
+        CharPointer_UTF8 dest (bytes);
+        dest.write (c);
+        stringBuffer.append (bytes, CharPointer_UTF8::getBytesRequiredFor (c));
+    }
+};
+
+//==============================================================================
+struct JSONHandlerSink
+{
+    JSONStreamParser::Handler& handler;
+
+    bool startObject()                                  { return handler.startObject(); }
+    bool endObject()                                    { return handler.endObject(); }
+    bool startArray()                                   { return handler.startArray(); }
+    bool endArray()                                     { return handler.endArray(); }
+    bool propertyName (std::string_view name, bool)     { return handler.propertyName (name); }
+    bool stringValue (std::string_view value, bool)     { return handler.stringValue (value); }
+    bool intValue (int64 value)                         { return handler.intValue (value); }
+    bool doubleValue (double value)                     { return handler.doubleValue (value); }
+    bool boolValue (bool value)                         { return handler.boolValue (value); }
+    bool nullValue()                                    { return handler.nullValue(); }
+};
+
+Result JSONStreamParser::parse (InputStream& input, Handler& handler)
+{
+    JSONStreamSource source (input);
+    JSONHandlerSink sink { handler };
+    return JSONEventReader<JSONStreamSource, JSONHandlerSink> (source, sink).parse();
+}
+
+Result JSONStreamParser::parse (const String& text, Handler& handler)
+{
+    return parse (text.toRawUTF8(), text.getNumBytesAsUTF8(), handler);
+}
+
+Result JSONStreamParser::parse (const void* utf8Data, size_t numBytes, Handler& handler)
+{
+    JSONMemorySource source (utf8Data, numBytes);
+    JSONHandlerSink sink { handler };
+    return JSONEventReader<JSONMemorySource, JSONHandlerSink> (source, sink).parse();
+}
+
+} // namespace juce
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads JSON and reports its contents through a series of callbacks, instead of
+    building a var tree.
+
+    The parser only keeps a small stack describing how deeply nested the current value
+    is, so it can work through documents of any size with roughly constant memory use.
+    This makes it suitable for large files that would be too costly to hold in memory
+    as a var, or for extracting a few fields from a document without building the rest.
+
+    The syntax accepted is the same as JSON::parse(), except that any type of value may
+    appear at the top level. Parsing stops after the first complete top-level value.
+
+    @code
+    struct NameCollector final : public JSONStreamParser::Handler
+    {
+        bool propertyName (std::string_view name) override
+        {
+            isName = name == "name";
+            return true;
+        }
+
+        bool stringValue (std::string_view value) override
+        {
+            if (isName)
+                names.add (String::fromUTF8 (value.data(), (int) value.size()));
+
+            return true;
+        }
+
+        StringArray names;
+        bool isName = false;
+    };
+
+    NameCollector collector;
+    auto result = JSONStreamParser::parse (fileStream, collector);
+    @endcode
+
+    @see JSON, JSONDocument
+
+    @tags{Core}
+*/
+class JUCE_API  JSONStreamParser
+{
+public:
+    /** No constructor. */
+    JSONStreamParser() = delete;
+
+    //==============================================================================
+    /**
+        Receives the contents of a JSON document from a JSONStreamParser.
+
+        Strings and property names are passed as UTF-8 views with any escape sequences
+        already decoded. These views are only valid until the callback returns, so copy
+        the text if you need to keep it.
+
+        Each callback can return false to stop parsing, in which case the parser will
+        return a failed Result.
+    */
+    struct JUCE_API  Handler
+    {
+        /** Destructor. */
+        virtual ~Handler() = default;
+
+        /** Called at the start of an object. */
+        virtual bool startObject()                      { return true; }
+
+        /** Called with the name of each property of an object, before its value. */
+        virtual bool propertyName (std::string_view)    { return true; }
+
+        /** Called at the end of an object. */
+        virtual bool endObject()                        { return true; }
+
+        /** Called at the start of an array. */
+        virtual bool startArray()                       { return true; }
+
+        /** Called at the end of an array. */
+        virtual bool endArray()                         { return true; }
+
+        /** Called for a string value. */
+        virtual bool stringValue (std::string_view)     { return true; }
+
+        /** Called for a number without a fractional part or exponent. */
+        virtual bool intValue (int64)                   { return true; }
+
+        /** Called for a number with a fractional part or exponent, or one too large to
+            fit in an int64.
+        */
+        virtual bool doubleValue (double)               { return true; }
+
+        /** Called for the values true and false. */
+        virtual bool boolValue (bool)                   { return true; }
+
+        /** Called for the value null. */
+        virtual bool nullValue()                        { return true; }
+    };
+
+    //==============================================================================
+    /** Parses JSON read from a stream, passing its contents to the handler.
+
+        The stream is read in blocks, so it never needs to be held in memory all at once.
+    */
+    static Result parse (InputStream& input, Handler& handler);
+
+    /** Parses some JSON text, passing its contents to the handler. */
+    static Result parse (const String& text, Handler& handler);
+
+    /** Parses a block of UTF-8 encoded JSON, passing its contents to the handler.
+
+        Strings that don't contain any escape sequences are passed to the handler as views
+        directly into this data, without being copied.
+    */
+    static Result parse (const void* utf8Data, size_t numBytes, Handler& handler);
+};
+
+} // namespace juce
@@ -125,6 +125,16 @@
 
 #undef check
 
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || defined (_M_AMD64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define JUCE_CORE_USE_SSE2 1
+ #include <emmintrin.h>
+#elif JUCE_ARM && (defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (_M_ARM64))
+ #define JUCE_CORE_USE_NEON 1
+ #include <arm_neon.h>
+#endif
+
+#include "detail/juce_ByteScanning.h"
+
 //==============================================================================
 #include "containers/juce_AbstractFifo.cpp"
 #include "containers/juce_ArrayBase.cpp"
@@ -147,6 +157,8 @@
 #include "maths/juce_Random.cpp"
 #include "memory/juce_MemoryBlock.cpp"
 #include "memory/juce_AllocationHooks.cpp"
+#include "memory/juce_MonotonicArena.cpp"
+#include "memory/juce_FixedBlockPool.cpp"
 #include "misc/juce_RuntimePermissions.cpp"
 #include "misc/juce_Result.cpp"
 #include "misc/juce_Uuid.cpp"
@@ -184,6 +196,7 @@
 #include "threads/juce_ReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
+#include "threads/juce_TaskScheduler.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 #include "time/juce_PerformanceCounter.cpp"
 #include "time/juce_RelativeTime.cpp"
@@ -192,9 +205,12 @@
 #include "containers/juce_Variant.cpp"
 #include "json/juce_JSON.cpp"
 #include "json/juce_JSONUtils.cpp"
+#include "json/juce_JSONStreamParser.cpp"
+#include "json/juce_JSONDocument.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlStreamReader.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
@@ -287,6 +303,8 @@
 //==============================================================================
 #if JUCE_UNIT_TESTS
  #include "containers/juce_HashMap_test.cpp"
+ #include "containers/juce_FlatContainers_test.cpp"
+ #include "containers/juce_LockFreeQueue_test.cpp"
  #include "containers/juce_Optional_test.cpp"
  #include "containers/juce_Enumerate_test.cpp"
  #include "containers/juce_ListenerList_test.cpp"
@@ -294,10 +312,18 @@
  #include "misc/juce_EnumHelpers_test.cpp"
  #include "containers/juce_FixedSizeFunction_test.cpp"
  #include "json/juce_JSONSerialisation_test.cpp"
+ #include "json/juce_JSONDocument_test.cpp"
+ #include "detail/juce_ByteScanning_test.cpp"
  #include "memory/juce_SharedResourcePointer_test.cpp"
+ #include "memory/juce_RealtimeAllocators_test.cpp"
+ #include "threads/juce_TaskScheduler_test.cpp"
  #include "text/juce_CharPointer_UTF8_test.cpp"
  #include "text/juce_CharPointer_UTF16_test.cpp"
  #include "text/juce_CharPointer_UTF32_test.cpp"
+ #if JUCE_UNIT_TEST_BENCHMARKS
+  #include "json/juce_JSONBenchmarks_test.cpp"
+  #include "xml/juce_XmlBenchmarks_test.cpp"
+ #endif
  #if JUCE_MAC || JUCE_IOS
   #include "native/juce_ObjCHelpers_mac_test.mm"
  #endif
@@ -197,6 +197,15 @@
  #define JUCE_ENABLE_ALLOCATION_HOOKS 0
 #endif
 
+/** Config: JUCE_UNIT_TEST_BENCHMARKS
+    If enabled along with JUCE_UNIT_TESTS, this adds some performance benchmarks in the
+    UnitTestCategories::benchmarks category. These take a while to run, so they're
+    disabled by default.
+*/
+#ifndef JUCE_UNIT_TEST_BENCHMARKS
+ #define JUCE_UNIT_TEST_BENCHMARKS 0
+#endif
+
 #ifndef JUCE_STRING_UTF_TYPE
  #define JUCE_STRING_UTF_TYPE 8
 #endif
@@ -285,6 +294,11 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "containers/juce_SparseSet.h"
 #include "containers/juce_AbstractFifo.h"
 #include "containers/juce_SingleThreadedAbstractFifo.h"
+#include "containers/juce_LockFreeQueue.h"
+#include "containers/juce_FlatHashTable.h"
+#include "containers/juce_FlatHashMap.h"
+#include "containers/juce_FlatHashSet.h"
+#include "containers/juce_FlatMap.h"
 #include "text/juce_NewLine.h"
 #include "text/juce_StringPool.h"
 #include "text/juce_Identifier.h"
@@ -328,6 +342,8 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "json/juce_JSONUtils.h"
+#include "json/juce_JSONStreamParser.h"
+#include "json/juce_JSONDocument.h"
 #include "serialisation/juce_Serialisation.h"
 #include "json/juce_JSONSerialisation.h"
 #include "maths/juce_BigInteger.h"
@@ -345,6 +361,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "threads/juce_HighResolutionTimer.h"
 #include "threads/juce_ThreadLocalValue.h"
 #include "threads/juce_ThreadPool.h"
+#include "threads/juce_TaskScheduler.h"
 #include "threads/juce_TimeSliceThread.h"
 #include "threads/juce_ReadWriteLock.h"
 #include "threads/juce_ScopedReadLock.h"
@@ -360,6 +377,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlStreamReader.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
@@ -367,6 +385,8 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "memory/juce_SharedResourcePointer.h"
 #include "memory/juce_AllocationHooks.h"
 #include "memory/juce_Reservoir.h"
+#include "memory/juce_MonotonicArena.h"
+#include "memory/juce_FixedBlockPool.h"
 #include "files/juce_AndroidDocument.h"
 #include "streams/juce_AndroidDocumentInputSource.h"
 #include "misc/juce_OptionsHelpers.h"
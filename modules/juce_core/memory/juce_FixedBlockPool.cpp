@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+FixedBlockPool::FixedBlockPool (size_t blockSizeInBytes, int numBlocksToAllocate)
+    : blockSize (jmax ((size_t) 1, (blockSizeInBytes + alignof (std::max_align_t) - 1) / alignof (std::max_align_t)) * alignof (std::max_align_t)),
+      numBlocks (jmax (0, numBlocksToAllocate)),
+      storage ((size_t) numBlocks * blockSize),
+      nextFreeBlock (new std::atomic<uint32>[(size_t) numBlocks])
+{
+    for (int i = 0; i < numBlocks; ++i)
+        nextFreeBlock[(size_t) i] = (uint32) i + 1;
+
+    // An index of numBlocks marks the end of the list
+    head = 0;
+    numFreeBlocks = numBlocks;
+}
+
+FixedBlockPool::~FixedBlockPool()
+{
+    // Some blocks haven't been returned to the pool! Anything still using them
+    // is about to be left with a dangling pointer.
+    jassert (numFreeBlocks == numBlocks);
+}
+
+bool FixedBlockPool::owns (const void* block) const noexcept
+{
+    const auto address = reinterpret_cast<uintptr_t> (block);
+    const auto start = reinterpret_cast<uintptr_t> (storage.get());
+
+    return address >= start
+        && address < start + (size_t) numBlocks * blockSize
+        && (address - start) % blockSize == 0;
+}
+
+void* FixedBlockPool::allocate() noexcept
+{
+    auto oldHead = head.load (std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto index = (uint32) oldHead;
+
+        if (index >= (uint32) numBlocks)
+            return nullptr;
+
+        // If another thread takes this block first, the value read here may be stale, but
+        // then the exchange below will fail because the head's counter will have changed
+        const auto next = nextFreeBlock[index].load (std::memory_order_relaxed);
+
+        if (head.compare_exchange_weak (oldHead, makeHead (oldHead, next),
+                                        std::memory_order_acquire, std::memory_order_acquire))
+        {
+            --numFreeBlocks;
+            return storage + (size_t) index * blockSize;
+        }
+    }
+}
+
+void FixedBlockPool::deallocate (void* block) noexcept
+{
+    if (block == nullptr)
+        return;
+
+    jassert (owns (block)); // this block didn't come from this pool!
+
+    const auto index = (uint32) ((size_t) (static_cast<char*> (block) - storage.get()) / blockSize);
+    auto oldHead = head.load (std::memory_order_relaxed);
+
+    for (;;)
+    {
+        nextFreeBlock[index].store ((uint32) oldHead, std::memory_order_relaxed);
+
+        if (head.compare_exchange_weak (oldHead, makeHead (oldHead, index),
+                                        std::memory_order_release, std::memory_order_relaxed))
+            break;
+    }
+
+    ++numFreeBlocks;
+}
+
+#if JUCE_HAS_MEMORY_RESOURCE
+void* FixedBlockPool::Resource::do_allocate (size_t numBytes, size_t alignment)
+{
+    if (numBytes <= pool.getBlockSize() && alignment <= alignof (std::max_align_t))
+        if (auto* block = pool.allocate())
+            return block;
+
+   #if JUCE_EXCEPTIONS_DISABLED
+    return nullptr;
+   #else
+    throw std::bad_alloc();
+   #endif
+}
+#endif
+
+} // namespace juce
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A fixed number of equally-sized blocks of memory, which can be allocated and freed
+    from any thread without locking.
+
+    All of the pool's memory is allocated by its constructor. After that, allocate()
+    and deallocate() only update a lock-free list of the free blocks, so they're safe to
+    call on the audio thread, and a block can be freed on a different thread from the one
+    that allocated it. This makes the pool handy for objects that are passed between the
+    audio thread and other threads, such as messages or voices.
+
+    @code
+    FixedBlockPool pool (sizeof (NoteEvent), 256);
+
+    // on the audio thread..
+    if (auto* event = pool.create<NoteEvent> (note, velocity))
+        fifo.push (event);
+
+    // on the message thread..
+    pool.destroy (event);
+    @endcode
+
+    @see MonotonicArena
+
+    @tags{Core}
+*/
+class JUCE_API  FixedBlockPool
+{
+public:
+    //==============================================================================
+    /** Creates a pool of blocks.
+
+        Each block will be at least blockSizeInBytes long, and aligned to
+        alignof (std::max_align_t).
+    */
+    FixedBlockPool (size_t blockSizeInBytes, int numBlocks);
+
+    /** Destructor.
+        All of the blocks should have been deallocated before the pool is deleted.
+    */
+    ~FixedBlockPool();
+
+    //==============================================================================
+    /** Returns the size of each block, which may have been rounded up from the size
+        that was requested.
+    */
+    size_t getBlockSize() const noexcept                { return blockSize; }
+
+    /** Returns the total number of blocks in the pool. */
+    int getNumBlocks() const noexcept                   { return numBlocks; }
+
+    /** Returns the number of blocks that are currently free.
+        If other threads are using the pool, this may be out-of-date as soon as it returns.
+    */
+    int getNumFreeBlocks() const noexcept               { return numFreeBlocks.load (std::memory_order_relaxed); }
+
+    /** Returns true if the pointer is to the start of one of this pool's blocks. */
+    bool owns (const void* block) const noexcept;
+
+    //==============================================================================
+    /** Takes a block from the pool, or returns nullptr if there are none left. */
+    void* allocate() noexcept;
+
+    /** Returns a block to the pool. Passing nullptr does nothing. */
+    void deallocate (void* block) noexcept;
+
+    /** Creates an object in a block from the pool, or returns nullptr if the pool is empty. */
+    template <typename Type, typename... Args>
+    Type* create (Args&&... args)
+    {
+        static_assert (alignof (Type) <= alignof (std::max_align_t), "Over-aligned types aren't supported");
+        jassert (sizeof (Type) <= blockSize); // the pool's blocks are too small for this type!
+
+        if (auto* block = allocate())
+            return new (block) Type (std::forward<Args> (args)...);
+
+        return nullptr;
+    }
+
+    /** Deletes an object that was created with create(), and returns its block to the pool. */
+    template <typename Type>
+    void destroy (Type* object) noexcept
+    {
+        if (object != nullptr)
+        {
+            object->~Type();
+            deallocate (object);
+        }
+    }
+
+   #if JUCE_HAS_MEMORY_RESOURCE || DOXYGEN
+    /** Returns a std::pmr::memory_resource that allocates from this pool.
+
+        This can be used with node-based std::pmr containers, such as std::pmr::list, whose
+        nodes fit into the pool's blocks. Requests that are too big for a block, or that
+        arrive when the pool is empty, throw std::bad_alloc.
+    */
+    std::pmr::memory_resource& getMemoryResource() noexcept     { return resource; }
+   #endif
+
+private:
+    //==============================================================================
+    // The head of the free list is stored as a block index in the low 32 bits, and a
+    // counter in the high 32 bits, which changes with every update so that a thread can't
+    // mistake a list that has been popped and pushed for one that hasn't changed
+    static uint64 makeHead (uint64 previousHead, uint32 index) noexcept   { return ((previousHead >> 32) + 1) << 32 | index; }
+
+    size_t blockSize;
+    int numBlocks;
+    HeapBlock<char> storage;
+    std::unique_ptr<std::atomic<uint32>[]> nextFreeBlock;
+    std::atomic<uint64> head { 0 };
+    std::atomic<int> numFreeBlocks { 0 };
+
+   #if JUCE_HAS_MEMORY_RESOURCE
+    struct Resource final : public std::pmr::memory_resource
+    {
+        explicit Resource (FixedBlockPool& p) noexcept  : pool (p) {}
+
+        void* do_allocate (size_t, size_t) override;
+        void do_deallocate (void* block, size_t, size_t) override  { pool.deallocate (block); }
+        bool do_is_equal (const memory_resource& other) const noexcept override   { return this == &other; }
+
+        FixedBlockPool& pool;
+    };
+
+    Resource resource { *this };
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (FixedBlockPool)
+    JUCE_DECLARE_NON_MOVEABLE (FixedBlockPool)
+};
+
+} // namespace juce
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+MonotonicArena::MonotonicArena (size_t capacityInBytes)
+{
+    setCapacity (capacityInBytes);
+}
+
+MonotonicArena::~MonotonicArena() = default;
+
+void MonotonicArena::setCapacity (size_t newCapacityInBytes)
+{
+    storage.free();
+    storage.malloc (newCapacityInBytes);
+    capacity = storage != nullptr ? newCapacityInBytes : 0;
+    numBytesUsed = 0;
+    peakNumBytesUsed = 0;
+}
+
+void* MonotonicArena::allocate (size_t numBytes, size_t alignment) noexcept
+{
+    // The alignment has to be a power of two!
+    jassert (alignment != 0 && isPowerOfTwo (alignment));
+
+    const auto base = reinterpret_cast<uintptr_t> (storage.get());
+    const auto start = (base + numBytesUsed + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    const auto end = start + numBytes;
+
+    if (storage == nullptr || end > base + capacity)
+    {
+        // Remember how much space this would have needed, so that the peak shows how big the arena should be
+        peakNumBytesUsed = jmax (peakNumBytesUsed, (size_t) (end - base));
+        return nullptr;
+    }
+
+    numBytesUsed = (size_t) (end - base);
+    peakNumBytesUsed = jmax (peakNumBytesUsed, numBytesUsed);
+    return reinterpret_cast<void*> (start);
+}
+
+#if JUCE_HAS_MEMORY_RESOURCE
+void* MonotonicArena::Resource::do_allocate (size_t numBytes, size_t alignment)
+{
+    if (auto* result = arena.allocate (numBytes, alignment))
+        return result;
+
+   #if JUCE_EXCEPTIONS_DISABLED
+    return nullptr;
+   #else
+    throw std::bad_alloc();
+   #endif
+}
+#endif
+
+} // namespace juce
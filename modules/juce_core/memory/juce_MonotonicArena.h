@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A block of memory that hands out space by simply moving a pointer along it.
+
+    The arena's memory is allocated up-front, by the constructor or setCapacity(), and
+    after that, allocating from it never calls malloc or takes a lock. Individual
+    allocations can't be freed; instead, reset() makes all of the arena's space available
+    again in one go. This makes it suitable for building temporary structures on the audio
+    thread: call reset() at the start of each processBlock(), then allocate whatever that
+    block needs.
+
+    @code
+    void prepareToPlay (double, int maxBlockSize) override
+    {
+        arena.setCapacity (AudioBuffer<float>::getArenaSizeNeeded (2, maxBlockSize)
+                            + MonotonicArena::getSizeNeededFor<float> ((size_t) maxBlockSize));
+    }
+
+    void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+    {
+        arena.reset();
+        AudioBuffer<float> scratch (arena, 2, buffer.getNumSamples());
+        auto* gains = arena.allocateArray<float> ((size_t) buffer.getNumSamples());
+        ...
+    }
+    @endcode
+
+    Objects created in the arena never have their destructors called, so only trivially
+    destructible types can be created with create() or allocateArray(). For containers,
+    the arena can be used through an Allocator, or as a std::pmr::memory_resource where
+    the standard library provides one.
+
+    An arena isn't thread-safe: each thread that needs one should have its own.
+
+    @see FixedBlockPool
+
+    @tags{Core}
+*/
+class JUCE_API  MonotonicArena
+{
+public:
+    //==============================================================================
+    /** Creates an arena with no space. Call setCapacity() before using it. */
+    MonotonicArena() = default;
+
+    /** Creates an arena and allocates the given number of bytes for it. */
+    explicit MonotonicArena (size_t capacityInBytes);
+
+    /** Destructor. */
+    ~MonotonicArena();
+
+    /** Reallocates the arena's memory with a new capacity, which also resets it.
+        This calls malloc, so don't use it on the audio thread!
+    */
+    void setCapacity (size_t newCapacityInBytes);
+
+    /** Returns the number of bytes that the arena can hold. */
+    size_t getCapacity() const noexcept                 { return capacity; }
+
+    /** Returns the number of bytes currently in use, including any padding for alignment. */
+    size_t getNumBytesUsed() const noexcept             { return numBytesUsed; }
+
+    /** Returns the largest number of bytes that have been in use at once since the arena
+        was created, or since resetPeakUsage() was called. This can help to pick a capacity.
+
+        Allocations that failed are included, so if this is more than getCapacity(), it's
+        the capacity that the arena would have needed for them to succeed.
+    */
+    size_t getPeakNumBytesUsed() const noexcept         { return peakNumBytesUsed; }
+
+    /** Resets the value returned by getPeakNumBytesUsed(). */
+    void resetPeakUsage() noexcept                      { peakNumBytesUsed = numBytesUsed; }
+
+    /** Returns a capacity that's enough to hold the given number of arrays of a type,
+        allowing for the padding that aligns each one.
+
+        The alignment should match the one that the arrays will be allocated with. The
+        default is the alignment that allocateArray() uses.
+    */
+    template <typename Type>
+    static constexpr size_t getSizeNeededFor (size_t numElements,
+                                              size_t numArrays = 1,
+                                              size_t alignment = jmax (alignof (Type), defaultAlignment)) noexcept
+    {
+        return numArrays * (numElements * sizeof (Type) + alignment);
+    }
+
+    //==============================================================================
+    /** Allocates some space from the arena.
+
+        The alignment must be a power of two. If there isn't enough space left, this
+        returns nullptr - use getPeakNumBytesUsed() to find out how big the arena needs to be.
+    */
+    void* allocate (size_t numBytes, size_t alignment = defaultAlignment) noexcept;
+
+    /** Allocates space for an array of trivially destructible objects, and
+        value-initialises them. Returns nullptr if there isn't enough space.
+    */
+    template <typename Type>
+    Type* allocateArray (size_t numElements) noexcept
+    {
+        static_assert (std::is_trivially_destructible_v<Type>,
+                       "The arena never calls destructors, so it can only hold trivially destructible types");
+
+        auto* result = static_cast<Type*> (allocate (numElements * sizeof (Type), jmax (alignof (Type), defaultAlignment)));
+
+        if (result != nullptr)
+            std::uninitialized_value_construct_n (result, numElements);
+
+        return result;
+    }
+
+    /** Creates a trivially destructible object in the arena, or returns nullptr if there
+        isn't enough space.
+    */
+    template <typename Type, typename... Args>
+    Type* create (Args&&... args)
+    {
+        static_assert (std::is_trivially_destructible_v<Type>,
+                       "The arena never calls destructors, so it can only hold trivially destructible types");
+
+        if (auto* space = allocate (sizeof (Type), alignof (Type)))
+            return new (space) Type (std::forward<Args> (args)...);
+
+        return nullptr;
+    }
+
+    /** Makes all of the arena's space available again.
+        Anything that was allocated from the arena must not be used after this.
+    */
+    void reset() noexcept                               { numBytesUsed = 0; }
+
+    //==============================================================================
+    /** Records how much of the arena is in use, so that it can be rewound to that point. */
+    struct Marker
+    {
+        size_t position;
+    };
+
+    /** Returns a marker for the arena's current position. */
+    Marker getMarker() const noexcept                   { return { numBytesUsed }; }
+
+    /** Frees everything that was allocated after the marker was taken. */
+    void rewindTo (Marker marker) noexcept
+    {
+        jassert (marker.position <= numBytesUsed);
+        numBytesUsed = marker.position;
+    }
+
+    /** Rewinds an arena to its current position when this object goes out of scope, to
+        free any temporary allocations made in that scope.
+    */
+    class ScopedRewind
+    {
+    public:
+        explicit ScopedRewind (MonotonicArena& arenaToUse) noexcept
+            : arena (arenaToUse), marker (arena.getMarker()) {}
+
+        ~ScopedRewind() noexcept                        { arena.rewindTo (marker); }
+
+    private:
+        MonotonicArena& arena;
+        const Marker marker;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRewind)
+    };
+
+    //==============================================================================
+    /** An allocator that can be used with standard library containers, to make them
+        allocate from an arena.
+
+        Deallocating does nothing, so a container that grows will leave its old storage
+        in the arena until it's reset. Reserving enough space up-front avoids this.
+
+        @code
+        std::vector<int, MonotonicArena::Allocator<int>> notes (arena);
+        notes.reserve (128);
+        @endcode
+    */
+    template <typename Type>
+    class Allocator
+    {
+    public:
+        using value_type = Type;
+
+        Allocator (MonotonicArena& arenaToUse) noexcept  : arena (&arenaToUse) {}
+
+        template <typename Other>
+        Allocator (const Allocator<Other>& other) noexcept  : arena (other.arena) {}
+
+        Type* allocate (size_t numElements)
+        {
+            if (auto* result = arena->allocate (numElements * sizeof (Type), jmax (alignof (Type), defaultAlignment)))
+                return static_cast<Type*> (result);
+
+           #if JUCE_EXCEPTIONS_DISABLED
+            return nullptr;
+           #else
+            throw std::bad_alloc();
+           #endif
+        }
+
+        void deallocate (Type*, size_t) noexcept {}
+
+        template <typename Other>
+        bool operator== (const Allocator<Other>& other) const noexcept  { return arena == other.arena; }
+
+        template <typename Other>
+        bool operator!= (const Allocator<Other>& other) const noexcept  { return arena != other.arena; }
+
+    private:
+        template <typename>
+        friend class Allocator;
+
+        MonotonicArena* arena;
+    };
+
+   #if JUCE_HAS_MEMORY_RESOURCE || DOXYGEN
+    /** Returns a std::pmr::memory_resource that allocates from this arena.
+
+        This can be used with std::pmr containers. If the arena runs out of space, the
+        resource will throw std::bad_alloc rather than falling back to the heap.
+    */
+    std::pmr::memory_resource& getMemoryResource() noexcept     { return resource; }
+   #endif
+
+    /** The alignment used for allocations that don't specify one. */
+    static constexpr size_t defaultAlignment = alignof (std::max_align_t);
+
+private:
+    //==============================================================================
+    HeapBlock<char> storage;
+    size_t capacity = 0, numBytesUsed = 0, peakNumBytesUsed = 0;
+
+   #if JUCE_HAS_MEMORY_RESOURCE
+    struct Resource final : public std::pmr::memory_resource
+    {
+        explicit Resource (MonotonicArena& a) noexcept  : arena (a) {}
+
+        void* do_allocate (size_t, size_t) override;
+        void do_deallocate (void*, size_t, size_t) override {}
+        bool do_is_equal (const memory_resource& other) const noexcept override   { return this == &other; }
+
+        MonotonicArena& arena;
+    };
+
+    Resource resource { *this };
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (MonotonicArena)
+    JUCE_DECLARE_NON_MOVEABLE (MonotonicArena)
+};
+
+} // namespace juce
@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class RealtimeAllocatorsTests final : public UnitTest
+{
+public:
+    RealtimeAllocatorsTests()
+        : UnitTest ("Realtime allocators", UnitTestCategories::memory)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("MonotonicArena hands out aligned, non-overlapping space");
+        {
+            MonotonicArena arena (4096);
+            expectEquals (arena.getCapacity(), (size_t) 4096);
+
+            auto* a = static_cast<char*> (arena.allocate (3, 1));
+            auto* b = static_cast<char*> (arena.allocate (100, 64));
+            auto* c = arena.allocateArray<double> (10);
+
+            expect (a != nullptr && b != nullptr && c != nullptr);
+            expect (reinterpret_cast<uintptr_t> (b) % 64 == 0);
+            expect (reinterpret_cast<uintptr_t> (c) % alignof (double) == 0);
+            expect (b >= a + 3);
+            expect (reinterpret_cast<char*> (c) >= b + 100);
+            expect (std::all_of (c, c + 10, [] (double d) { return exactlyEqual (d, 0.0); }));
+
+            const auto used = arena.getNumBytesUsed();
+            expect (used >= 3 + 100 + 10 * sizeof (double));
+
+            arena.reset();
+            expectEquals (arena.getNumBytesUsed(), (size_t) 0);
+            expectEquals (arena.getPeakNumBytesUsed(), used);
+            expect (arena.allocate (3, 1) == a);
+        }
+
+        beginTest ("MonotonicArena can be rewound to a marker");
+        {
+            MonotonicArena arena (1024);
+            arena.allocate (10);
+            const auto before = arena.getNumBytesUsed();
+
+            {
+                const MonotonicArena::ScopedRewind rewind (arena);
+                arena.allocate (500);
+                expect (arena.getNumBytesUsed() > before);
+            }
+
+            expectEquals (arena.getNumBytesUsed(), before);
+
+            const auto marker = arena.getMarker();
+            auto* range = arena.create<Range<int>> (3, 4);
+            expect (range != nullptr && range->getStart() == 3 && range->getEnd() == 4);
+
+            arena.rewindTo (marker);
+            expectEquals (arena.getNumBytesUsed(), before);
+        }
+
+        beginTest ("MonotonicArena returns nullptr when it's full");
+        {
+            MonotonicArena arena (256);
+            expect (arena.allocate (200) != nullptr);
+
+            expect (arena.allocate (100) == nullptr);
+
+            expect (arena.allocate (16) != nullptr);
+        }
+
+        beginTest ("MonotonicArena's peak usage includes allocations that didn't fit");
+        {
+            MonotonicArena arena (256);
+
+            const auto allocateBlocks = [&]
+            {
+                arena.reset();
+                return arena.allocate (200) != nullptr && arena.allocate (100) != nullptr;
+            };
+
+            expect (! allocateBlocks());
+            expectGreaterThan (arena.getPeakNumBytesUsed(), arena.getCapacity());
+
+            arena.setCapacity (arena.getPeakNumBytesUsed());
+            expect (allocateBlocks());
+            expectEquals (arena.getNumBytesUsed(), arena.getCapacity());
+        }
+
+        beginTest ("MonotonicArena works as an allocator for standard containers");
+        {
+            MonotonicArena arena (MonotonicArena::getSizeNeededFor<int> (100, 4));
+
+            std::vector<int, MonotonicArena::Allocator<int>> values (arena);
+            values.reserve (100);
+
+            for (int i = 0; i < 100; ++i)
+                values.push_back (i);
+
+            expectEquals (std::accumulate (values.begin(), values.end(), 0), 4950);
+            expect (arena.getNumBytesUsed() >= 100 * sizeof (int));
+
+           #if JUCE_HAS_MEMORY_RESOURCE
+            const auto usedBefore = arena.getNumBytesUsed();
+            std::pmr::vector<int> pmrValues (&arena.getMemoryResource());
+            pmrValues.reserve (50);
+            pmrValues.assign (50, 7);
+            expect (arena.getNumBytesUsed() >= usedBefore + 50 * sizeof (int));
+           #endif
+        }
+
+        beginTest ("FixedBlockPool hands out every block once");
+        {
+            FixedBlockPool pool (20, 64);
+            expectEquals (pool.getBlockSize() % alignof (std::max_align_t), (size_t) 0);
+            expect (pool.getBlockSize() >= 20);
+            expectEquals (pool.getNumFreeBlocks(), 64);
+
+            std::set<void*> blocks;
+
+            for (int i = 0; i < 64; ++i)
+            {
+                auto* block = pool.allocate();
+                expect (block != nullptr && pool.owns (block));
+                blocks.insert (block);
+            }
+
+            expectEquals ((int) blocks.size(), 64);
+            expect (pool.allocate() == nullptr);
+            expectEquals (pool.getNumFreeBlocks(), 0);
+
+            int dummy = 0;
+            expect (! pool.owns (&dummy));
+            expect (! pool.owns (static_cast<char*> (*blocks.begin()) + 1));
+
+            for (auto* block : blocks)
+                pool.deallocate (block);
+
+            expectEquals (pool.getNumFreeBlocks(), 64);
+        }
+
+        beginTest ("FixedBlockPool creates and destroys objects");
+        {
+            struct Counted
+            {
+                explicit Counted (int& c) : count (c)   { ++count; }
+                ~Counted()                              { --count; }
+                int& count;
+            };
+
+            int count = 0;
+            FixedBlockPool pool (sizeof (Counted), 4);
+
+            auto* a = pool.create<Counted> (count);
+            auto* b = pool.create<Counted> (count);
+            expectEquals (count, 2);
+
+            pool.destroy (a);
+            pool.destroy (b);
+            pool.destroy<Counted> (nullptr);
+            expectEquals (count, 0);
+            expectEquals (pool.getNumFreeBlocks(), 4);
+        }
+
+       #if JUCE_HAS_MEMORY_RESOURCE
+        beginTest ("FixedBlockPool works as a memory resource for node-based containers");
+        {
+            FixedBlockPool pool (64, 32);
+
+            {
+                std::pmr::list<int> list (&pool.getMemoryResource());
+
+                for (int i = 0; i < 10; ++i)
+                    list.push_back (i);
+
+                expectEquals (pool.getNumFreeBlocks(), 22);
+            }
+
+            expectEquals (pool.getNumFreeBlocks(), 32);
+        }
+       #endif
+
+        beginTest ("FixedBlockPool can be used from several threads at once");
+        {
+            constexpr int numThreads = 4, numBlocks = 64, numIterations = 20000;
+            FixedBlockPool pool (sizeof (int64), numBlocks);
+            std::atomic<bool> blockWasShared { false };
+
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([&, t]
+                {
+                    std::vector<int64*> held;
+
+                    for (int i = 0; i < numIterations; ++i)
+                    {
+                        if (held.size() < 8)
+                        {
+                            if (auto* block = pool.create<int64> (t))
+                                held.push_back (block);
+                        }
+
+                        if (! held.empty() && (i % 3 == 0 || held.size() == 8))
+                        {
+                            auto* block = held.back();
+                            held.pop_back();
+
+                            // If two threads had been given the same block, one of them would
+                            // have overwritten the value
+                            if (*block != t)
+                                blockWasShared = true;
+
+                            pool.destroy (block);
+                        }
+                    }
+
+                    for (auto* block : held)
+                        pool.destroy (block);
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            expect (! blockWasShared.load());
+            expectEquals (pool.getNumFreeBlocks(), numBlocks);
+        }
+    }
+};
+
+static RealtimeAllocatorsTests realtimeAllocatorsTests;
+
+} // namespace juce
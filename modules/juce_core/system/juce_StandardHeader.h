@@ -89,6 +89,17 @@
 #include <variant>
 #include <vector>
 
+#if __has_include (<memory_resource>)
+ #include <memory_resource>
+#endif
+
+// Some standard libraries only provide std::pmr when targeting newer OS versions
+#if defined (__cpp_lib_memory_resource)
+ #define JUCE_HAS_MEMORY_RESOURCE 1
+#else
+ #define JUCE_HAS_MEMORY_RESOURCE 0
+#endif
+
 //==============================================================================
 #include "juce_CompilerSupport.h"
 #include "juce_CompilerWarnings.h"
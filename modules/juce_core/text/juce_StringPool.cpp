@@ -41,72 +41,25 @@ static const uint32 garbageCollectionInterval = 30000;
 
 StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0) {}
 
-struct StartEndString
+template <typename StringSet>
+static String addPooledString (StringSet& strings, std::string_view newString)
 {
-    StartEndString (String::CharPointerType s, String::CharPointerType e) noexcept : start (s), end (e) {}
-    operator String() const   { return String (start, end); }
+    if (auto* existing = strings.find (newString))
+        return *existing;
 
-    String::CharPointerType start, end;
-};
-
-static int compareStrings (const String& s1, const String& s2) noexcept     { return s1.compare (s2); }
-static int compareStrings (CharPointer_UTF8 s1, const String& s2) noexcept  { return s1.compare (s2.getCharPointer()); }
-
-static int compareStrings (const StartEndString& string1, const String& string2) noexcept
-{
-    String::CharPointerType s1 (string1.start), s2 (string2.getCharPointer());
-
-    for (;;)
-    {
-        const int c1 = s1 < string1.end ? (int) s1.getAndAdvance() : 0;
-        const int c2 = (int) s2.getAndAdvance();
-        const int diff = c1 - c2;
-
-        if (diff != 0)  return diff < 0 ? -1 : 1;
-        if (c1 == 0)    break;
-    }
-
-    return 0;
+    auto s = String::fromUTF8 (newString.data(), (int) newString.size());
+    strings.add (s);
+    return s;
 }
 
-template <typename NewStringType>
-static String addPooledString (Array<String>& strings, const NewStringType& newString)
+template <typename StringSet>
+static String addPooledString (StringSet& strings, const String& newString)
 {
-    int start = 0;
-    int end = strings.size();
-
-    while (start < end)
-    {
-        const String& startString = strings.getReference (start);
-        const int startComp = compareStrings (newString, startString);
-
-        if (startComp == 0)
-            return startString;
-
-        const int halfway = (start + end) / 2;
+    if (auto* existing = strings.find (newString))
+        return *existing;
 
-        if (halfway == start)
-        {
-            if (startComp > 0)
-                ++start;
-
-            break;
-        }
-
-        const String& halfwayString = strings.getReference (halfway);
-        const int halfwayComp = compareStrings (newString, halfwayString);
-
-        if (halfwayComp == 0)
-            return halfwayString;
-
-        if (halfwayComp > 0)
-            start = halfway;
-        else
-            end = halfway;
-    }
-
-    strings.insert (start, newString);
-    return strings.getReference (start);
+    strings.add (newString);
+    return newString;
 }
 
 String StringPool::getPooledString (const char* const newString)
@@ -116,7 +69,11 @@ String StringPool::getPooledString (const char* const newString)
 
     const ScopedLock sl (lock);
     garbageCollectIfNeeded();
-    return addPooledString (strings, CharPointer_UTF8 (newString));
+
+    if constexpr (isKeyedOnUTF8)
+        return addPooledString (strings, std::string_view (newString));
+    else
+        return addPooledString (strings, String (CharPointer_UTF8 (newString)));
 }
 
 String StringPool::getPooledString (String::CharPointerType start, String::CharPointerType end)
@@ -126,7 +83,12 @@ String StringPool::getPooledString (String::CharPointerType start, String::CharP
 
     const ScopedLock sl (lock);
     garbageCollectIfNeeded();
-    return addPooledString (strings, StartEndString (start, end));
+
+    if constexpr (isKeyedOnUTF8)
+        return addPooledString (strings, std::string_view (reinterpret_cast<const char*> (start.getAddress()),
+                                                           (size_t) (end.getAddress() - start.getAddress())));
+    else
+        return addPooledString (strings, String (start, end));
 }
 
 String StringPool::getPooledString (StringRef newString)
@@ -136,7 +98,11 @@ String StringPool::getPooledString (StringRef newString)
 
     const ScopedLock sl (lock);
     garbageCollectIfNeeded();
-    return addPooledString (strings, newString.text);
+
+    if constexpr (isKeyedOnUTF8)
+        return addPooledString (strings, std::string_view (reinterpret_cast<const char*> (newString.text.getAddress())));
+    else
+        return addPooledString (strings, String (newString.text));
 }
 
 String StringPool::getPooledString (const String& newString)
@@ -160,9 +126,7 @@ void StringPool::garbageCollect()
 {
     const ScopedLock sl (lock);
 
-    for (int i = strings.size(); --i >= 0;)
-        if (strings.getReference (i).getReferenceCount() == 1)
-            strings.remove (i);
+    strings.removeIf ([] (const String& s) { return s.getReferenceCount() == 1; });
 
     lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
 }
@@ -87,7 +87,37 @@ public:
     static StringPool& getGlobalPool() noexcept;
 
 private:
-    Array<String> strings;
+    // When Strings hold UTF-8, they're looked up by their bytes, so that finding a pooled
+    // string never needs a temporary String to be created. With the other encodings, the
+    // incoming text is converted to a String first.
+    static constexpr bool isKeyedOnUTF8 = std::is_same_v<String::CharPointerType, CharPointer_UTF8>;
+
+    struct StringHash
+    {
+        static std::string_view toView (const String& s) noexcept
+        {
+            jassert (isKeyedOnUTF8);
+            return { reinterpret_cast<const char*> (s.getCharPointer().getAddress()), s.getNumBytesAsUTF8() };
+        }
+
+        size_t operator() (std::string_view s) const noexcept       { return std::hash<std::string_view>() (s); }
+
+        size_t operator() (const String& s) const noexcept
+        {
+            if constexpr (isKeyedOnUTF8)
+                return operator() (toView (s));
+            else
+                return s.hash();
+        }
+    };
+
+    struct StringEqual
+    {
+        bool operator() (const String& a, std::string_view b) const noexcept  { return StringHash::toView (a) == b; }
+        bool operator() (const String& a, const String& b) const noexcept     { return a == b; }
+    };
+
+    FlatHashSet<String, StringHash, StringEqual> strings;
     CriticalSection lock;
     uint32 lastGarbageCollectionTime;
 
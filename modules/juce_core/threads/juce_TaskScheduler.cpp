@@ -0,0 +1,520 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/*  A fixed-size work-stealing deque, as described by Chase and Lev, using the memory
+    orderings given by Lê et al. in "Correct and Efficient Work-Stealing for Weak Memory
+    Models".
+
+    Only the thread that owns the queue may call push() and pop(), which work at the
+    bottom end. Any thread may call steal(), which takes from the top end.
+*/
+struct TaskScheduler::WorkQueue
+{
+    enum class StealResult { success, empty, contended };
+
+    bool push (Task* task) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        const auto t = top.load (std::memory_order_acquire);
+
+        if (b - t >= (int64) capacity)
+            return false;
+
+        tasks[(size_t) b & mask].store (task, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        bottom.store (b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Task* pop() noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto* task = tasks[(size_t) b & mask].load (std::memory_order_relaxed);
+
+        if (t == b)
+        {
+            // This was the last task, so a thief might be trying to take it too
+            if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = nullptr;
+
+            bottom.store (b + 1, std::memory_order_relaxed);
+        }
+
+        return task;
+    }
+
+    StealResult steal (Task*& result) noexcept
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return StealResult::empty;
+
+        auto* task = tasks[(size_t) t & mask].load (std::memory_order_relaxed);
+
+        if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return StealResult::contended;
+
+        result = task;
+        return StealResult::success;
+    }
+
+    static constexpr size_t capacity = 1024, mask = capacity - 1;
+
+    std::atomic<int64> top { 0 }, bottom { 0 };
+    std::atomic<Task*> tasks[capacity] {};
+};
+
+//==============================================================================
+class TaskScheduler::WorkerThread final : public Thread
+{
+public:
+    WorkerThread (TaskScheduler& s, const String& name, size_t stackSize)
+        : Thread (name, stackSize), owner (s)
+    {}
+
+    void run() override
+    {
+        owner.workerLoop (*this);
+    }
+
+    TaskScheduler& owner;
+    WorkQueue queue;
+    Random random;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkerThread)
+};
+
+TaskScheduler::WorkerThread*& TaskScheduler::getCurrentWorkerThread() noexcept
+{
+    static thread_local WorkerThread* currentWorkerThread = nullptr;
+    return currentWorkerThread;
+}
+
+//==============================================================================
+TaskScheduler::TaskScheduler (const ThreadPoolOptions& options)
+{
+    jassert (options.numberOfThreads > 0); // not much point having a scheduler without any threads!
+
+    for (int i = jmax (1, options.numberOfThreads); --i >= 0;)
+        workers.add (new WorkerThread (*this, options.threadName, options.threadStackSizeBytes));
+
+    for (auto* worker : workers)
+        worker->startThread (options.desiredThreadPriority);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    waitUntil ([this] { return numUnfinishedTasks.load() == 0; });
+
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    {
+        const std::scoped_lock sl (sleepMutex);
+        shouldStop = true;
+    }
+
+    workAvailable.notify_all();
+
+    for (auto* worker : workers)
+        worker->waitForThreadToExit (-1);
+
+    workers.clear();
+    detachRemainingHandles();
+}
+
+void TaskScheduler::detachRemainingHandles() noexcept
+{
+    // Every task has finished by now, so any task that's still referenced must belong to a
+    // TaskHandle. Rather than leave that handle pointing at deleted memory, the block that
+    // holds its task is leaked, and the task forgets about this scheduler.
+    for (auto& block : taskBlocks)
+    {
+        bool isReferenced = false;
+
+        for (size_t i = 0; i < numTasksPerBlock; ++i)
+        {
+            if (block[i].numReferences.load() > 0)
+            {
+                block[i].owner = nullptr;
+                isReferenced = true;
+            }
+        }
+
+        if (isReferenced)
+        {
+            // A TaskHandle mustn't outlive the scheduler that created it!
+            jassertfalse;
+            ignoreUnused (block.release());
+        }
+    }
+}
+
+int TaskScheduler::getNumThreads() const noexcept
+{
+    return workers.size();
+}
+
+//==============================================================================
+TaskScheduler::Task* TaskScheduler::allocateTask()
+{
+    Task* task = nullptr;
+
+    {
+        const SpinLock::ScopedLockType sl (taskPoolLock);
+
+        if (freeTasks == nullptr)
+        {
+            auto& block = taskBlocks.emplace_back (new Task[numTasksPerBlock]);
+
+            for (size_t i = 0; i < numTasksPerBlock; ++i)
+            {
+                block[i].owner = this;
+                block[i].next = i + 1 < numTasksPerBlock ? block.get() + i + 1 : nullptr;
+            }
+
+            freeTasks = block.get();
+        }
+
+        task = freeTasks;
+        freeTasks = task->next;
+    }
+
+    task->next = nullptr;
+    task->group = nullptr;
+    task->finished = false;
+    task->numReferences = 1;    // released once the task has run
+    task->numDependencies = 1;  // released once the task has been submitted
+    return task;
+}
+
+void TaskScheduler::releaseTask (Task* task) noexcept
+{
+    if (task->numReferences.fetch_sub (1, std::memory_order_acq_rel) != 1)
+        return;
+
+    const SpinLock::ScopedLockType sl (taskPoolLock);
+    task->next = freeTasks;
+    freeTasks = task;
+}
+
+TaskScheduler::TaskHandle TaskScheduler::submit (Task* task, const TaskHandle* dependencies, size_t numDependencies)
+{
+    ++numUnfinishedTasks;
+
+    for (size_t i = 0; i < numDependencies; ++i)
+    {
+        auto* dependency = dependencies[i].task;
+
+        if (dependency == nullptr)
+            continue;
+
+        jassert (dependency->owner == this); // tasks can only depend on tasks from the same scheduler
+
+        const SpinLock::ScopedLockType sl (dependency->continuationLock);
+
+        if (! dependency->finished)
+        {
+            ++task->numDependencies;
+            dependency->continuations.push_back (task);
+        }
+    }
+
+    // The group doesn't hold on to its tasks, so there's no need to make a handle for one
+    // that's only going to be thrown away
+    TaskHandle handle (task->group == nullptr ? task : nullptr);
+    releaseDependency (task);
+    return handle;
+}
+
+void TaskScheduler::releaseDependency (Task* task)
+{
+    if (--task->numDependencies == 0)
+        enqueue (task);
+}
+
+void TaskScheduler::enqueue (Task* task)
+{
+    auto* worker = getCurrentWorkerThread();
+
+    if (worker == nullptr || &worker->owner != this || ! worker->queue.push (task))
+    {
+        const ScopedLock sl (injectedTasksLock);
+
+        if (lastInjectedTask != nullptr)
+            lastInjectedTask->next = task;
+        else
+            firstInjectedTask = task;
+
+        lastInjectedTask = task;
+    }
+
+    wakeThreads();
+}
+
+TaskScheduler::Task* TaskScheduler::findTask (WorkerThread* worker)
+{
+    if (worker != nullptr && &worker->owner == this)
+        if (auto* task = worker->queue.pop())
+            return task;
+
+    {
+        const ScopedLock sl (injectedTasksLock);
+
+        if (auto* task = firstInjectedTask)
+        {
+            firstInjectedTask = task->next;
+
+            if (firstInjectedTask == nullptr)
+                lastInjectedTask = nullptr;
+
+            task->next = nullptr;
+            return task;
+        }
+    }
+
+    const auto numWorkers = workers.size();
+    const auto firstVictim = worker != nullptr ? worker->random.nextInt (numWorkers) : 0;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* victim = workers.getUnchecked ((firstVictim + i) % numWorkers);
+
+        if (victim == worker)
+            continue;
+
+        for (;;)
+        {
+            Task* task = nullptr;
+            const auto result = victim->queue.steal (task);
+
+            if (result == WorkQueue::StealResult::success)
+                return task;
+
+            if (result == WorkQueue::StealResult::empty)
+                break;
+        }
+    }
+
+    return nullptr;
+}
+
+void TaskScheduler::runTask (Task* task)
+{
+    task->function();
+    task->function = nullptr;
+
+    {
+        const SpinLock::ScopedLockType sl (task->continuationLock);
+        task->finished = true;
+    }
+
+    // Nothing else can add continuations now that the task is marked as finished
+    for (auto* continuation : task->continuations)
+        releaseDependency (continuation);
+
+    task->continuations.clear();
+
+    // Waiting threads only need waking when a task that isn't part of a group finishes,
+    // or when the last task in a group does
+    const auto group = task->group;
+    const auto mayBeWaitedFor = group == nullptr || --group->numPending == 0;
+
+    releaseTask (task);
+    --numUnfinishedTasks;
+
+    if (mayBeWaitedFor)
+        notifyWaiters();
+}
+
+//==============================================================================
+void TaskScheduler::waitUntil (const std::function<bool()>& isDone)
+{
+    auto* worker = getCurrentWorkerThread();
+
+    while (! isDone())
+    {
+        const auto wakeCountBefore = wakeCount.load();
+
+        if (auto* task = findTask (worker))
+        {
+            runTask (task);
+            continue;
+        }
+
+        ++numWaiters;
+
+        {
+            std::unique_lock lock (sleepMutex);
+            taskFinished.wait (lock, [&] { return isDone() || wakeCount.load() != wakeCountBefore; });
+        }
+
+        --numWaiters;
+    }
+}
+
+void TaskScheduler::wakeThreads()
+{
+    ++wakeCount;
+
+    const auto anyWorkersSleeping = numSleepingWorkers.load() > 0;
+    const auto anyWaiters = numWaiters.load() > 0;
+
+    if (anyWorkersSleeping || anyWaiters)
+    {
+        // Taking the lock here makes sure that a thread that's about to sleep has either
+        // seen the new wake count, or is already waiting and will get the notification
+        { const std::scoped_lock sl (sleepMutex); }
+
+        if (anyWorkersSleeping)
+            workAvailable.notify_one();
+
+        if (anyWaiters)
+            taskFinished.notify_all();
+    }
+}
+
+void TaskScheduler::notifyWaiters()
+{
+    if (numWaiters.load() > 0)
+    {
+        { const std::scoped_lock sl (sleepMutex); }
+        taskFinished.notify_all();
+    }
+}
+
+void TaskScheduler::workerLoop (WorkerThread& worker)
+{
+    getCurrentWorkerThread() = &worker;
+
+    while (! shouldStop)
+    {
+        const auto wakeCountBefore = wakeCount.load();
+
+        if (auto* task = findTask (&worker))
+        {
+            runTask (task);
+            continue;
+        }
+
+        ++numSleepingWorkers;
+
+        {
+            std::unique_lock lock (sleepMutex);
+            workAvailable.wait (lock, [&] { return shouldStop || wakeCount.load() != wakeCountBefore; });
+        }
+
+        --numSleepingWorkers;
+    }
+
+    getCurrentWorkerThread() = nullptr;
+}
+
+//==============================================================================
+TaskScheduler::TaskHandle::TaskHandle (Task* t) noexcept  : task (t)
+{
+    if (task != nullptr)
+        ++task->numReferences;
+}
+
+TaskScheduler::TaskHandle::TaskHandle (const TaskHandle& other) noexcept  : TaskHandle (other.task) {}
+
+TaskScheduler::TaskHandle::TaskHandle (TaskHandle&& other) noexcept  : task (std::exchange (other.task, nullptr)) {}
+
+TaskScheduler::TaskHandle& TaskScheduler::TaskHandle::operator= (const TaskHandle& other) noexcept
+{
+    TaskHandle copy (other);
+    std::swap (task, copy.task);
+    return *this;
+}
+
+TaskScheduler::TaskHandle& TaskScheduler::TaskHandle::operator= (TaskHandle&& other) noexcept
+{
+    TaskHandle moved (std::move (other));
+    std::swap (task, moved.task);
+    return *this;
+}
+
+TaskScheduler::TaskHandle::~TaskHandle()
+{
+    if (task == nullptr)
+        return;
+
+    if (task->owner != nullptr)
+        task->owner->releaseTask (task);
+    else
+        --task->numReferences;
+}
+
+bool TaskScheduler::TaskHandle::isFinished() const noexcept
+{
+    return task == nullptr || task->finished.load (std::memory_order_acquire);
+}
+
+void TaskScheduler::TaskHandle::wait() const
+{
+    if (! isFinished())
+        task->owner->waitUntil ([this] { return isFinished(); });
+}
+
+TaskScheduler& TaskScheduler::TaskHandle::getScheduler() const noexcept
+{
+    // The scheduler that created this handle has been deleted!
+    jassert (task->owner != nullptr);
+    return *task->owner;
+}
+
+void TaskScheduler::TaskGroup::wait()
+{
+    scheduler.waitUntil ([this] { return isFinished(); });
+}
+
+} // namespace juce
@@ -0,0 +1,361 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A set of threads that run small tasks, using work-stealing to share them out.
+
+    ThreadPool is designed for a modest number of long-running jobs, which can be
+    interrupted or removed. A TaskScheduler is designed for large numbers of short tasks,
+    where the overhead of handing out each task matters. Each thread keeps its own queue of
+    tasks, and a thread that runs out of work takes tasks from the other threads' queues,
+    so threads mostly don't have to contend for a shared lock. Tasks are recycled from an
+    internal pool, and small lambdas are stored without any allocation.
+
+    Tasks can be given dependencies, so that they won't start until some other tasks have
+    finished, and groups of tasks can be waited for with a TaskGroup. A thread that waits
+    for a task or group will run other tasks while it's waiting, so it's safe to wait from
+    inside a task. The parallelFor() and parallelReduce() helpers use this to split up a
+    loop between all the threads.
+
+    @code
+    TaskScheduler scheduler;
+
+    auto load = scheduler.schedule ([&] { loadFile(); });
+    auto done = load.then ([&] { updateDisplay(); });
+
+    scheduler.parallelFor (0, numThumbnails, [&] (int i) { thumbnails[i].render(); });
+
+    done.wait();
+    @endcode
+
+    Tasks must not throw exceptions, and they can't be cancelled once they've been
+    scheduled. For jobs that need to be interrupted, use a ThreadPool.
+
+    @see ThreadPool
+
+    @tags{Core}
+*/
+class JUCE_API  TaskScheduler
+{
+    struct Task;
+
+public:
+    //==============================================================================
+    /** Creates a scheduler and starts its threads.
+        The name, number of threads, stack size and priority are taken from the options.
+    */
+    explicit TaskScheduler (const ThreadPoolOptions& options);
+
+    /** Creates a scheduler using the default ThreadPoolOptions. */
+    TaskScheduler() : TaskScheduler (ThreadPoolOptions{}) {}
+
+    /** Destructor.
+        This will wait for any tasks that are still scheduled to finish before
+        stopping the threads.
+    */
+    ~TaskScheduler();
+
+    /** Returns the number of threads that the scheduler is running. */
+    int getNumThreads() const noexcept;
+
+    //==============================================================================
+    /**
+        A reference to a task that has been given to a TaskScheduler.
+
+        This can be used to check whether the task has finished, to wait for it, or to
+        schedule other tasks that depend on it. Handles can be freely copied, and a task
+        is recycled when it has finished and there are no handles left that refer to it.
+
+        Handles should be deleted before the scheduler that created them. If one is
+        still around when the scheduler is deleted, it'll assert, and the handle will
+        only report that its task has finished - it can't be used to schedule more tasks.
+    */
+    class JUCE_API  TaskHandle
+    {
+    public:
+        /** Creates a handle that doesn't refer to any task. */
+        TaskHandle() = default;
+
+        TaskHandle (const TaskHandle&) noexcept;
+        TaskHandle (TaskHandle&&) noexcept;
+        TaskHandle& operator= (const TaskHandle&) noexcept;
+        TaskHandle& operator= (TaskHandle&&) noexcept;
+        ~TaskHandle();
+
+        /** Returns true if this refers to a task. */
+        bool isValid() const noexcept               { return task != nullptr; }
+
+        /** Returns true if the task has finished running, or if this handle is invalid. */
+        bool isFinished() const noexcept;
+
+        /** Waits for the task to finish, running other tasks while it waits. */
+        void wait() const;
+
+        /** Schedules a function to be run after this task has finished, and returns a
+            handle to the new task.
+        */
+        template <typename Fn>
+        TaskHandle then (Fn&& fn) const
+        {
+            jassert (isValid());
+            return getScheduler().scheduleAfter ({ *this }, std::forward<Fn> (fn));
+        }
+
+    private:
+        friend class TaskScheduler;
+        explicit TaskHandle (Task*) noexcept;
+        TaskScheduler& getScheduler() const noexcept;
+
+        Task* task = nullptr;
+    };
+
+    //==============================================================================
+    /**
+        Runs a set of tasks and waits for all of them to finish.
+
+        Any number of tasks can be added to a group with run(), and these can add more tasks
+        to the same group while they're running. The wait() method, or the destructor, will
+        return once all of them have finished.
+    */
+    class JUCE_API  TaskGroup
+    {
+    public:
+        /** Creates an empty group that will run its tasks on the given scheduler. */
+        explicit TaskGroup (TaskScheduler& schedulerToUse) noexcept  : scheduler (schedulerToUse) {}
+
+        /** Destructor. This waits for any tasks in the group that haven't finished yet. */
+        ~TaskGroup()                                { wait(); }
+
+        /** Schedules a function to be run as part of this group. */
+        template <typename Fn>
+        void run (Fn&& fn)
+        {
+            ++numPending;
+            scheduler.submit (scheduler.createTask (std::forward<Fn> (fn), this), nullptr, 0);
+        }
+
+        /** Waits for all the tasks in the group to finish, running other tasks while it waits. */
+        void wait();
+
+        /** Returns true if all the group's tasks have finished. */
+        bool isFinished() const noexcept            { return numPending.load() == 0; }
+
+    private:
+        friend class TaskScheduler;
+        TaskScheduler& scheduler;
+        std::atomic<int> numPending { 0 };
+
+        JUCE_DECLARE_NON_COPYABLE (TaskGroup)
+    };
+
+    //==============================================================================
+    /** Schedules a function to be run, and returns a handle to the new task. */
+    template <typename Fn>
+    TaskHandle schedule (Fn&& fn)
+    {
+        return submit (createTask (std::forward<Fn> (fn), nullptr), nullptr, 0);
+    }
+
+    /** Schedules a function to be run once all of the tasks it depends on have finished,
+        and returns a handle to the new task.
+    */
+    template <typename Fn>
+    TaskHandle scheduleAfter (std::initializer_list<TaskHandle> dependencies, Fn&& fn)
+    {
+        return submit (createTask (std::forward<Fn> (fn), nullptr), dependencies.begin(), dependencies.size());
+    }
+
+    /** Schedules a function to be run once all of the tasks it depends on have finished,
+        and returns a handle to the new task.
+    */
+    template <typename Fn>
+    TaskHandle scheduleAfter (const Array<TaskHandle>& dependencies, Fn&& fn)
+    {
+        return submit (createTask (std::forward<Fn> (fn), nullptr), dependencies.begin(), (size_t) dependencies.size());
+    }
+
+    //==============================================================================
+    /** Calls a function for each index from start up to (but not including) end, sharing
+        the calls between the scheduler's threads, and returns when they've all finished.
+
+        The range is split in half repeatedly until the pieces contain no more than
+        grainSize indexes. Choose a grain size that makes each piece take at least a few
+        microseconds to run, so that the cost of scheduling is small in comparison.
+
+        The calling thread also runs some of the calls, so this can be used from inside
+        another task.
+    */
+    template <typename Fn>
+    void parallelFor (int start, int end, Fn&& fn, int grainSize = 1)
+    {
+        TaskGroup group (*this);
+        runRange (group, start, end, jmax (1, grainSize), fn);
+        group.wait();
+    }
+
+    /** Combines a value for each index from start up to (but not including) end, sharing
+        the work between the scheduler's threads.
+
+        The range is divided into chunks, each of which starts with a copy of identity and
+        combines it with map (index) for each of its indexes, in order. The chunks' results
+        are then combined in order, starting with identity. So the combine function must be
+        associative, and identity must leave a value unchanged when combined with it, but
+        the combine function doesn't need to be commutative.
+
+        @code
+        auto total = scheduler.parallelReduce (0, numSamples, 0.0,
+                                               [&] (int i) { return (double) samples[i] * samples[i]; },
+                                               std::plus<>());
+        @endcode
+    */
+    template <typename ValueType, typename MapFn, typename CombineFn>
+    ValueType parallelReduce (int start, int end, ValueType identity, MapFn&& map, CombineFn&& combine, int grainSize = 1)
+    {
+        const auto numItems = jmax (0, end - start);
+
+        if (numItems == 0)
+            return identity;
+
+        grainSize = jmax (1, grainSize);
+        const auto numChunks = jlimit (1, getNumThreads() * 4, (numItems + grainSize - 1) / grainSize);
+
+        std::vector<ValueType> results ((size_t) numChunks, identity);
+
+        parallelFor (0, numChunks, [&] (int chunk)
+        {
+            const auto chunkStart = start + (int) ((int64) numItems * chunk / numChunks);
+            const auto chunkEnd   = start + (int) ((int64) numItems * (chunk + 1) / numChunks);
+            auto& result = results[(size_t) chunk];
+
+            for (auto i = chunkStart; i < chunkEnd; ++i)
+                result = combine (std::move (result), map (i));
+        });
+
+        for (auto& result : results)
+            identity = combine (std::move (identity), std::move (result));
+
+        return identity;
+    }
+
+private:
+    //==============================================================================
+    class WorkerThread;
+    struct WorkQueue;
+
+    // Lambdas up to this size are stored inside the task, which covers the ones that
+    // parallelFor creates; bigger ones are moved to the heap
+    static constexpr size_t maxInlineFunctionSize = 64;
+    static constexpr size_t numTasksPerBlock = 64;
+
+    struct Task
+    {
+        FixedSizeFunction<maxInlineFunctionSize, void()> function;
+        TaskScheduler* owner = nullptr;     // (cleared if a handle outlives the scheduler)
+        TaskGroup* group = nullptr;
+        std::atomic<int> numReferences { 0 }, numDependencies { 0 };
+        std::atomic<bool> finished { false };
+        SpinLock continuationLock;
+        std::vector<Task*> continuations;
+        Task* next = nullptr;     // used by the free list and the queue of injected tasks
+    };
+
+    template <typename Fn>
+    Task* createTask (Fn&& fn, TaskGroup* group)
+    {
+        using Function = std::decay_t<Fn>;
+        auto* task = allocateTask();
+
+        if constexpr (sizeof (Function) <= maxInlineFunctionSize && alignof (Function) <= alignof (std::max_align_t))
+            task->function = std::forward<Fn> (fn);
+        else
+            task->function = [f = std::make_shared<Function> (std::forward<Fn> (fn))] { (*f)(); };
+
+        task->group = group;
+        return task;
+    }
+
+    template <typename Fn>
+    void runRange (TaskGroup& group, int start, int end, int grainSize, Fn& fn)
+    {
+        // Keep handing out the top half of the range to be picked up by another thread,
+        // until the part that's left is small enough to just run here
+        while (end - start > grainSize)
+        {
+            const auto mid = start + (end - start) / 2;
+            group.run ([this, &group, mid, end, grainSize, &fn] { runRange (group, mid, end, grainSize, fn); });
+            end = mid;
+        }
+
+        for (auto i = start; i < end; ++i)
+            fn (i);
+    }
+
+    Task* allocateTask();
+    void releaseTask (Task*) noexcept;
+    TaskHandle submit (Task*, const TaskHandle* dependencies, size_t numDependencies);
+    void releaseDependency (Task*);
+    void enqueue (Task*);
+    Task* findTask (WorkerThread*);
+    void runTask (Task*);
+    void waitUntil (const std::function<bool()>& isDone);
+    void wakeThreads();
+    void notifyWaiters();
+    void workerLoop (WorkerThread&);
+    void detachRemainingHandles() noexcept;
+    static WorkerThread*& getCurrentWorkerThread() noexcept;
+
+    OwnedArray<WorkerThread> workers;
+
+    CriticalSection injectedTasksLock;
+    Task* firstInjectedTask = nullptr;
+    Task* lastInjectedTask = nullptr;
+
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable, taskFinished;
+    std::atomic<uint32> wakeCount { 0 };
+    std::atomic<int> numSleepingWorkers { 0 }, numWaiters { 0 }, numUnfinishedTasks { 0 };
+    std::atomic<bool> shouldStop { false };
+
+    SpinLock taskPoolLock;
+    std::vector<std::unique_ptr<Task[]>> taskBlocks;
+    Task* freeTasks = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TaskScheduler)
+};
+
+} // namespace juce
@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class TaskSchedulerTests final : public UnitTest
+{
+public:
+    TaskSchedulerTests()
+        : UnitTest ("TaskScheduler", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        TaskScheduler scheduler (ThreadPoolOptions{}.withNumberOfThreads (4));
+
+        beginTest ("All scheduled tasks are run");
+        {
+            std::atomic<int> count { 0 };
+            std::vector<TaskScheduler::TaskHandle> handles;
+
+            for (int i = 0; i < 10000; ++i)
+                handles.push_back (scheduler.schedule ([&] { ++count; }));
+
+            for (auto& handle : handles)
+                handle.wait();
+
+            expectEquals (count.load(), 10000);
+
+            for (auto& handle : handles)
+                expect (handle.isFinished());
+        }
+
+        beginTest ("Tasks don't start until their dependencies have finished");
+        {
+            for (int repeat = 0; repeat < 100; ++repeat)
+            {
+                std::atomic<int> numFinished { 0 };
+                std::atomic<bool> orderWasCorrect { true };
+
+                auto first  = scheduler.schedule ([&] { Thread::yield(); ++numFinished; });
+                auto second = scheduler.schedule ([&] { ++numFinished; });
+
+                auto joined = scheduler.scheduleAfter ({ first, second }, [&]
+                {
+                    if (numFinished.load() != 2)
+                        orderWasCorrect = false;
+
+                    ++numFinished;
+                });
+
+                auto last = joined.then ([&]
+                {
+                    if (numFinished.load() != 3)
+                        orderWasCorrect = false;
+                });
+
+                last.wait();
+                expect (orderWasCorrect.load());
+                expect (first.isFinished() && second.isFinished() && joined.isFinished());
+            }
+        }
+
+        beginTest ("A continuation of a finished task runs straight away");
+        {
+            auto task = scheduler.schedule ([] {});
+            task.wait();
+
+            std::atomic<bool> ran { false };
+            task.then ([&] { ran = true; }).wait();
+            expect (ran.load());
+        }
+
+        beginTest ("Invalid handles count as finished");
+        {
+            TaskScheduler::TaskHandle handle;
+            expect (! handle.isValid());
+            expect (handle.isFinished());
+            handle.wait();
+
+            std::atomic<bool> ran { false };
+            scheduler.scheduleAfter ({ handle }, [&] { ran = true; }).wait();
+            expect (ran.load());
+        }
+
+        beginTest ("Large and move-only functions can be scheduled");
+        {
+            std::array<int, 64> values;
+            std::iota (values.begin(), values.end(), 0);
+
+            std::atomic<int> sum { 0 };
+            scheduler.schedule ([values, &sum] { sum = std::accumulate (values.begin(), values.end(), 0); }).wait();
+            expectEquals (sum.load(), 63 * 64 / 2);
+
+            auto owned = std::make_unique<int> (42);
+            std::atomic<int> result { 0 };
+            scheduler.schedule ([o = std::move (owned), &result] { result = *o; }).wait();
+            expectEquals (result.load(), 42);
+        }
+
+        beginTest ("TaskGroup waits for tasks that its tasks add");
+        {
+            std::atomic<int> count { 0 };
+
+            {
+                TaskScheduler::TaskGroup group (scheduler);
+
+                for (int i = 0; i < 50; ++i)
+                {
+                    group.run ([&]
+                    {
+                        for (int j = 0; j < 20; ++j)
+                            group.run ([&] { ++count; });
+                    });
+                }
+            }
+
+            expectEquals (count.load(), 1000);
+        }
+
+        beginTest ("parallelFor visits every index exactly once");
+        {
+            for (auto grainSize : { 1, 7, 100, 100000 })
+            {
+                std::vector<std::atomic<int>> visits (10000);
+                scheduler.parallelFor (0, (int) visits.size(), [&] (int i) { ++visits[(size_t) i]; }, grainSize);
+
+                expect (std::all_of (visits.begin(), visits.end(), [] (auto& v) { return v.load() == 1; }));
+            }
+
+            std::atomic<int> numCalls { 0 };
+            scheduler.parallelFor (10, 10, [&] (int) { ++numCalls; });
+            scheduler.parallelFor (10, 5, [&] (int) { ++numCalls; });
+            expectEquals (numCalls.load(), 0);
+        }
+
+        beginTest ("parallelReduce combines values in order");
+        {
+            const auto sum = scheduler.parallelReduce (0, 100000, (int64) 0, [] (int i) { return (int64) i; }, std::plus<>(), 64);
+            expectEquals (sum, (int64) 99999 * 100000 / 2);
+
+            // String concatenation isn't commutative, so this checks the order is preserved
+            const auto text = scheduler.parallelReduce (0, 500, String(), [] (int i) { return String (i % 10); },
+                                                        [] (String a, const String& b) { return a + b; });
+            String expected;
+
+            for (int i = 0; i < 500; ++i)
+                expected << (i % 10);
+
+            expectEquals (text, expected);
+            expectEquals (scheduler.parallelReduce (0, 0, 7, [] (int) { return 1; }, std::plus<>()), 7);
+        }
+
+        beginTest ("Tasks can wait for other tasks, even with only one thread");
+        {
+            TaskScheduler singleThreaded (ThreadPoolOptions{}.withNumberOfThreads (1));
+            std::atomic<int> count { 0 };
+
+            singleThreaded.parallelFor (0, 8, [&] (int)
+            {
+                singleThreaded.parallelFor (0, 100, [&] (int) { ++count; });
+            });
+
+            expectEquals (count.load(), 800);
+            expectEquals (fibonacci (singleThreaded, 18), 2584);
+            expectEquals (fibonacci (scheduler, 20), 6765);
+        }
+
+        beginTest ("The destructor waits for tasks that haven't finished");
+        {
+            std::atomic<int> count { 0 };
+
+            {
+                TaskScheduler temporary (ThreadPoolOptions{}.withNumberOfThreads (2));
+
+                for (int i = 0; i < 100; ++i)
+                    temporary.schedule ([&] { Thread::sleep (1); ++count; });
+            }
+
+            expectEquals (count.load(), 100);
+        }
+    }
+
+private:
+    static int fibonacci (TaskScheduler& scheduler, int n)
+    {
+        if (n < 2)
+            return n;
+
+        int a = 0;
+        auto task = scheduler.schedule ([&] { a = fibonacci (scheduler, n - 1); });
+        const auto b = fibonacci (scheduler, n - 2);
+        task.wait();
+        return a + b;
+    }
+};
+
+static TaskSchedulerTests taskSchedulerTests;
+
+#if JUCE_UNIT_TEST_BENCHMARKS
+
+//==============================================================================
+/*
+    Compares ThreadPool and TaskScheduler on some mixes of small jobs.
+*/
+class TaskSchedulerBenchmarks final : public UnitTest
+{
+public:
+    TaskSchedulerBenchmarks()
+        : UnitTest ("TaskScheduler benchmarks", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        const auto options = ThreadPoolOptions{}.withThreadName ("Benchmark");
+        ThreadPool pool (options);
+        TaskScheduler scheduler (options);
+
+        // Lots of short, equal jobs, like finding the levels for each pixel of a thumbnail
+        beginTest ("Thumbnail-style jobs");
+        {
+            std::vector<float> samples (1 << 22);
+            auto r = getRandom();
+
+            for (auto& s : samples)
+                s = r.nextFloat() * 2.0f - 1.0f;
+
+            constexpr size_t samplesPerJob = 1024;
+            const auto numJobs = (int) (samples.size() / samplesPerJob);
+            std::vector<Range<float>> levels ((size_t) numJobs);
+
+            auto findLevels = [&] (int job)
+            {
+                const auto* start = samples.data() + (size_t) job * samplesPerJob;
+                const auto [low, high] = std::minmax_element (start, start + samplesPerJob);
+                levels[(size_t) job] = { *low, *high };
+            };
+
+            report ("ThreadPool, one job each",   [&] { runOnPool (pool, numJobs, findLevels); });
+            report ("TaskScheduler, one task each", [&] { runOnScheduler (scheduler, numJobs, findLevels); });
+            report ("TaskScheduler::parallelFor", [&] { scheduler.parallelFor (0, numJobs, findLevels); });
+        }
+
+        // Fewer jobs that take very different amounts of time, like scanning plugins
+        beginTest ("Scan-style jobs");
+        {
+            auto r = getRandom();
+            std::vector<int> workPerJob (500);
+
+            for (auto& w : workPerJob)
+                w = r.nextInt (r.nextInt (10) == 0 ? 200000 : 5000);
+
+            std::atomic<uint32> checksum { 0 };
+
+            auto scan = [&] (int job)
+            {
+                uint32 hash = (uint32) job;
+
+                for (int i = 0; i < workPerJob[(size_t) job]; ++i)
+                    hash = hash * 31u + (uint32) i;
+
+                checksum += hash;
+            };
+
+            const auto numJobs = (int) workPerJob.size();
+
+            report ("ThreadPool, one job each",   [&] { runOnPool (pool, numJobs, scan); });
+            report ("TaskScheduler, one task each", [&] { runOnScheduler (scheduler, numJobs, scan); });
+            report ("TaskScheduler::parallelFor", [&] { scheduler.parallelFor (0, numJobs, scan); });
+        }
+    }
+
+private:
+    template <typename Fn>
+    static void runOnPool (ThreadPool& pool, int numJobs, Fn& fn)
+    {
+        std::atomic<int> numRemaining { numJobs };
+        WaitableEvent finished;
+
+        for (int i = 0; i < numJobs; ++i)
+        {
+            pool.addJob ([&, i]
+            {
+                fn (i);
+
+                if (--numRemaining == 0)
+                    finished.signal();
+            });
+        }
+
+        finished.wait();
+    }
+
+    template <typename Fn>
+    static void runOnScheduler (TaskScheduler& scheduler, int numJobs, Fn& fn)
+    {
+        TaskScheduler::TaskGroup group (scheduler);
+
+        for (int i = 0; i < numJobs; ++i)
+            group.run ([&fn, i] { fn (i); });
+
+        group.wait();
+    }
+
+    template <typename Fn>
+    void report (const String& description, Fn&& fn)
+    {
+        constexpr auto numRuns = 5;
+        auto bestTime = std::numeric_limits<double>::max();
+
+        for (int i = 0; i < numRuns; ++i)
+        {
+            const auto start = Time::getMillisecondCounterHiRes();
+            fn();
+            bestTime = jmin (bestTime, Time::getMillisecondCounterHiRes() - start);
+        }
+
+        logMessage (description.paddedRight (' ', 32) + String (bestTime, 3) + " ms");
+    }
+};
+
+static TaskSchedulerBenchmarks taskSchedulerBenchmarks;
+
+#endif
+
+} // namespace juce
@@ -39,11 +39,13 @@ namespace juce::UnitTestCategories
     static const String audio                      { "Audio" };
     static const String audioProcessorParameters   { "AudioProcessorParameters" };
     static const String audioProcessors            { "AudioProcessors" };
+    static const String benchmarks                 { "Benchmarks" };
     static const String blocks                     { "Blocks" };
     static const String compression                { "Compression" };
     static const String containers                 { "Containers" };
     static const String cryptography               { "Cryptography" };
     static const String dsp                        { "DSP" };
+    static const String events                     { "Events" };
     static const String files                      { "Files" };
     static const String graphics                   { "Graphics" };
     static const String gui                        { "GUI" };
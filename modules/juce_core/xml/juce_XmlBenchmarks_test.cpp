@@ -0,0 +1,243 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  Measures the throughput of the XML parsers.
+
+    To show what the scanning in detail::ByteScanning gains, the loops XmlDocument uses to
+    copy text and attribute values are timed against the character-by-character loops it
+    used before, which are kept below for reference. By default this uses a generated
+    document, but you can set the environment variable
+    JUCE_BENCHMARK_DATA_DIR to a folder of .xml files to measure some real ones.
+*/
+class XmlBenchmarks final : public UnitTest
+{
+public:
+    XmlBenchmarks() : UnitTest ("XML benchmarks", UnitTestCategories::benchmarks) {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        for (const auto& [documentName, text] : getDocuments (r))
+        {
+            beginTest (documentName);
+
+            std::unique_ptr<XmlElement> parsed;
+            int numElements = 0;
+            int64 numBytesCopied = 0, previousNumBytesCopied = 0;
+
+            const auto previousTime = measure ([&] { previousNumBytesCopied = copyContentOneCharacterAtATime (text); });
+            const auto scanTime = measure ([&] { numBytesCopied = copyContentWithByteScanning (text); });
+            const auto parseTime = measure ([&] { parsed = parseXML (text); });
+
+            const auto streamTime = measure ([&]
+            {
+                MemoryInputStream stream (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+                XmlStreamReader reader (stream);
+                numElements = 0;
+
+                for (auto event = reader.next(); event != XmlStreamReader::Event::endOfDocument && event != XmlStreamReader::Event::error; event = reader.next())
+                    if (event == XmlStreamReader::Event::startElement)
+                        ++numElements;
+            });
+
+            report ("Content, previous loops", text, previousTime);
+            report ("Content, ByteScanning", text, scanTime, previousTime);
+            report ("XmlDocument", text, parseTime);
+            report ("XmlStreamReader", text, streamTime);
+
+            expectEquals (numBytesCopied, previousNumBytesCopied);
+            expect (parsed != nullptr);
+            expect (numElements > 0);
+        }
+    }
+
+private:
+    // How XmlDocument used to read text and attribute values, one character at a time
+    static int64 copyContentOneCharacterAtATime (const String& text)
+    {
+        MemoryOutputStream buffer;
+        auto inTag = false, inValue = false;
+
+        for (auto p = text.getCharPointer(); ! p.isEmpty();)
+        {
+            const auto c = p.getAndAdvance();
+
+            if (inValue)
+            {
+                if (c == '"')
+                    inValue = false;
+                else
+                    buffer.appendUTF8Char (c);
+            }
+            else if (inTag)
+            {
+                if (c == '"')
+                    inValue = true;
+                else if (c == '>')
+                    inTag = false;
+            }
+            else if (c == '<')
+            {
+                inTag = true;
+            }
+            else
+            {
+                buffer.appendUTF8Char (c);
+            }
+        }
+
+        return buffer.getPosition();
+    }
+
+    // The same walk, using the scanning that XmlDocument does now
+    static int64 copyContentWithByteScanning (const String& text)
+    {
+        MemoryOutputStream buffer;
+        const auto* data = text.toRawUTF8();
+        const auto numBytes = text.getNumBytesAsUTF8();
+        auto inTag = false;
+
+        for (size_t i = 0; i < numBytes;)
+        {
+            if (inTag)
+            {
+                i += detail::ByteScanning::findFirstOf<'"', '>'> (data + i, numBytes - i);
+
+                if (i == numBytes)
+                    break;
+
+                if (data[i++] == '>')
+                {
+                    inTag = false;
+                    continue;
+                }
+
+                const auto valueLength = detail::ByteScanning::findFirstOf<'"'> (data + i, numBytes - i);
+                buffer.write (data + i, valueLength);
+                i += valueLength + 1;
+            }
+            else
+            {
+                const auto textLength = detail::ByteScanning::findFirstOf<'<'> (data + i, numBytes - i);
+                buffer.write (data + i, textLength);
+                i += textLength + 1;
+                inTag = true;
+            }
+        }
+
+        return buffer.getPosition();
+    }
+
+    template <typename Fn>
+    static double measure (Fn&& fn)
+    {
+        constexpr auto numRuns = 5;
+        auto bestTime = std::numeric_limits<double>::max();
+
+        for (int i = 0; i < numRuns; ++i)
+        {
+            const auto start = Time::getMillisecondCounterHiRes();
+            fn();
+            bestTime = jmin (bestTime, Time::getMillisecondCounterHiRes() - start);
+        }
+
+        return bestTime;
+    }
+
+    void report (const String& description, const String& text, double time, double previousTime = 0.0)
+    {
+        const auto megabytes = (double) text.getNumBytesAsUTF8() / (1024.0 * 1024.0);
+        auto message = description.paddedRight (' ', 24)
+                     + String (time, 2) + " ms, "
+                     + String (megabytes * 1000.0 / jmax (0.001, time), 1) + " MB/s";
+
+        if (previousTime > 0.0)
+            message << ", " << String (previousTime / jmax (0.001, time), 2) << "x the previous speed";
+
+        logMessage (message);
+    }
+
+    static std::vector<std::pair<String, String>> getDocuments (Random& r)
+    {
+        std::vector<std::pair<String, String>> result;
+        const File folder (SystemStats::getEnvironmentVariable ("JUCE_BENCHMARK_DATA_DIR", {}));
+
+        if (folder.getFullPathName().isNotEmpty() && folder.isDirectory())
+            for (const auto& file : folder.findChildFiles (File::findFiles, false, "*.xml"))
+                result.emplace_back (file.getFileName(), file.loadFileAsString());
+
+        static const StringArray words { "oscillator", "filter", "envelope", "\"quoted\"", "delay", "<tag>",
+                                         "reverb", "line\nbreak", "caf" + String (CharPointer_UTF8 ("\xc3\xa9")), "gain & level" };
+
+        const auto makeSentence = [&] (int numWords)
+        {
+            StringArray sentence;
+
+            for (int i = 0; i < numWords; ++i)
+                sentence.add (words[r.nextInt (words.size())]);
+
+            return sentence.joinIntoString (" ");
+        };
+
+        XmlElement root ("RECORDS");
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            auto* record = root.createNewChildElement ("RECORD");
+            record->setAttribute ("id", i);
+            record->setAttribute ("name", makeSentence (3));
+            record->setAttribute ("enabled", r.nextBool() ? "true" : "false");
+            record->setAttribute ("gain", r.nextDouble() * 1000.0);
+
+            if (i > 0)
+                record->setAttribute ("parent", r.nextInt (i));
+
+            record->createNewChildElement ("DESCRIPTION")->addTextElement (makeSentence (40));
+
+            for (int j = 0; j < 4; ++j)
+                record->createNewChildElement ("TAG")->setAttribute ("value", words[r.nextInt (words.size())]);
+        }
+
+        result.emplace_back ("generated", root.toString());
+        return result;
+    }
+};
+
+static XmlBenchmarks xmlBenchmarks;
+
+} // namespace juce
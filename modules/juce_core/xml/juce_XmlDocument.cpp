@@ -119,6 +119,58 @@ namespace XmlIdentifierChars
     }
 }
 
+namespace XmlTextScanning
+{
+    /*  When the text is UTF-8, these skip over runs of characters a block at a time
+        without decoding them. Otherwise, they leave the parser's own loops to do the work.
+    */
+    template <char... chars>
+    static void skipToFirstOf (String::CharPointerType& p, size_t numBytesAvailable) noexcept
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        p = String::CharPointerType (p.getAddress() + detail::ByteScanning::findFirstOf<chars...> (p.getAddress(), numBytesAvailable));
+       #else
+        ignoreUnused (p, numBytesAvailable);
+       #endif
+    }
+
+    static void skipWhitespace (String::CharPointerType& p, size_t numBytesAvailable) noexcept
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        p = String::CharPointerType (p.getAddress() + detail::ByteScanning::findFirstNonWhitespace (p.getAddress(), numBytesAvailable));
+       #else
+        ignoreUnused (p, numBytesAvailable);
+       #endif
+    }
+
+    static void copyTextRun (String::CharPointerType& p, size_t numBytesAvailable,
+                             MemoryOutputStream& out, bool& containsNonWhitespace)
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        const auto* start = p.getAddress();
+        const auto length = detail::ByteScanning::findFirstOf<'<', '&', '\r'> (start, numBytesAvailable);
+
+        if (length == 0)
+            return;
+
+        out.write (start, length);
+        p = String::CharPointerType (start + length);
+
+        if (! containsNonWhitespace)
+        {
+            const auto firstNonWhitespace = detail::ByteScanning::findFirstNonWhitespace (start, length);
+
+            // Non-ASCII characters need decoding to find out whether they're whitespace
+            containsNonWhitespace = firstNonWhitespace < length
+                                      && ((uint8) start[firstNonWhitespace] < 0x80
+                                           || String::CharPointerType (start + firstNonWhitespace).findEndOfWhitespace().getAddress() < start + length);
+        }
+       #else
+        ignoreUnused (p, numBytesAvailable, out, containsNonWhitespace);
+       #endif
+    }
+}
+
 std::unique_ptr<XmlElement> XmlDocument::getDocumentElement (const bool onlyReadOuterDocumentElement)
 {
     if (originalText.isEmpty() && inputSource != nullptr)
@@ -209,6 +261,9 @@ std::unique_ptr<XmlElement> XmlDocument::parseDocumentElement (String::CharPoint
                                                                bool onlyReadOuterDocumentElement)
 {
     input = textToParse;
+    documentStart = textToParse;
+    documentEnd = String::CharPointerType (textToParse.getAddress()
+                                          + textToParse.sizeInBytes() / sizeof (String::CharPointerType::CharType) - 1);
     errorOccurred = false;
     outOfData = false;
     needToLoadDTD = true;
@@ -299,10 +354,22 @@ bool XmlDocument::parseDTD()
     return true;
 }
 
+size_t XmlDocument::getNumBytesAvailable() const noexcept
+{
+    // While expanding an entity, the input may be pointing at some other text
+    const auto* location = input.getAddress();
+
+    if (std::less<>() (location, documentStart.getAddress()) || ! std::less<>() (location, documentEnd.getAddress()))
+        return 0;
+
+    return (size_t) (documentEnd.getAddress() - location) * sizeof (*location);
+}
+
 void XmlDocument::skipNextWhiteSpace()
 {
     for (;;)
     {
+        XmlTextScanning::skipWhitespace (input, getNumBytesAvailable());
         input.incrementToEndOfWhitespace();
 
         if (input.isEmpty())
@@ -373,6 +440,11 @@ void XmlDocument::readQuotedString (String& result)
 
             for (;;)
             {
+                if (quote == '"')
+                    XmlTextScanning::skipToFirstOf<'"', '&'> (input, getNumBytesAvailable());
+                else
+                    XmlTextScanning::skipToFirstOf<'\'', '&'> (input, getNumBytesAvailable());
+
                 auto character = *input;
 
                 if (character == quote)
@@ -537,6 +609,7 @@ void XmlDocument::readChildElements (XmlElement& parent)
 
                 for (;;)
                 {
+                    XmlTextScanning::skipToFirstOf<']'> (input, getNumBytesAvailable());
                     auto c0 = *input;
 
                     if (c0 == 0)
@@ -632,6 +705,7 @@ void XmlDocument::readChildElements (XmlElement& parent)
                 {
                     for (;; ++input)
                     {
+                        XmlTextScanning::copyTextRun (input, getNumBytesAvailable(), textElementContent, contentShouldBeUsed);
                         auto nextChar = *input;
 
                         if (nextChar == '\r')
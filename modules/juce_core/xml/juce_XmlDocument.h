@@ -160,7 +160,7 @@ public:
     //==============================================================================
 private:
     String originalText;
-    String::CharPointerType input { nullptr };
+    String::CharPointerType input { nullptr }, documentStart { nullptr }, documentEnd { nullptr };
     bool outOfData = false, errorOccurred = false;
     String lastError, dtdText;
     StringArray tokenisedDTD;
@@ -172,6 +172,7 @@ private:
     bool parseHeader();
     bool parseDTD();
     void skipNextWhiteSpace();
+    size_t getNumBytesAvailable() const noexcept;
     juce_wchar readNextChar() noexcept;
     XmlElement* readNextElement (bool alsoParseSubElements);
     void readChildElements (XmlElement&);
@@ -0,0 +1,920 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace XmlStreamReaderHelpers
+{
+    static constexpr auto notFound = std::numeric_limits<size_t>::max();
+
+    static bool isIdentifierByte (char c) noexcept
+    {
+        // Bytes outside the ASCII range are part of a multi-byte UTF-8 character
+        return (uint8) c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) c);
+    }
+
+    static bool isWhitespaceByte (char c) noexcept
+    {
+        return CharacterFunctions::isWhitespace (c);
+    }
+
+    static bool matchesIgnoreCase (std::string_view text, size_t pos, std::string_view entity) noexcept
+    {
+        if (text.size() - pos < entity.size())
+            return false;
+
+        for (size_t i = 0; i < entity.size(); ++i)
+            if (CharacterFunctions::toLowerCase ((juce_wchar) text[pos + i]) != (juce_wchar) entity[i])
+                return false;
+
+        return true;
+    }
+
+    static void appendUTF8 (std::string& dest, juce_wchar c)
+    {
+        char bytes[4] = {};
+        CharPointer_UTF8 (bytes).write (c);
+        dest.append (bytes, CharPointer_UTF8::getBytesRequiredFor (c));
+    }
+
+    /*  Decodes the character entities in some text, returning the number of bytes consumed
+        from the input. Unknown entities are left as they are.
+    */
+    static size_t decodeEntity (std::string_view text, size_t pos, std::string& dest)
+    {
+        static constexpr std::pair<std::string_view, char> namedEntities[]
+        {
+            { "&amp;", '&' }, { "&quot;", '"' }, { "&apos;", '\'' }, { "&lt;", '<' }, { "&gt;", '>' }
+        };
+
+        for (const auto& [entity, character] : namedEntities)
+        {
+            if (matchesIgnoreCase (text, pos, entity))
+            {
+                dest += character;
+                return entity.size();
+            }
+        }
+
+        if (pos + 2 < text.size() && text[pos + 1] == '#')
+        {
+            const auto isHex = text[pos + 2] == 'x' || text[pos + 2] == 'X';
+            auto i = pos + (isHex ? 3 : 2);
+            uint32 charCode = 0;
+            int numDigits = 0;
+
+            for (; i < text.size() && numDigits < 8; ++i, ++numDigits)
+            {
+                const auto digit = isHex ? CharacterFunctions::getHexDigitValue ((juce_wchar) text[i])
+                                         : (isPositiveAndBelow (text[i] - '0', 10) ? text[i] - '0' : -1);
+
+                if (digit < 0)
+                    break;
+
+                charCode = charCode * (isHex ? 16u : 10u) + (uint32) digit;
+            }
+
+            if (numDigits > 0 && i < text.size() && text[i] == ';')
+            {
+                appendUTF8 (dest, (juce_wchar) charCode);
+                return i + 1 - pos;
+            }
+        }
+
+        dest += '&';
+        return 1;
+    }
+
+    /*  Appends some text to a string, decoding any entities. For text content, line
+        endings are also converted to '\n', in the same way as XmlDocument.
+    */
+    static void appendDecoded (std::string& dest, std::string_view text, bool isTextContent)
+    {
+        for (size_t i = 0; i < text.size();)
+        {
+            const auto run = isTextContent ? detail::ByteScanning::findFirstOf<'&', '\r'> (text.data() + i, text.size() - i)
+                                           : detail::ByteScanning::findFirstOf<'&'> (text.data() + i, text.size() - i);
+            dest.append (text.data() + i, run);
+            i += run;
+
+            if (i >= text.size())
+                break;
+
+            if (text[i] == '&')
+            {
+                i += decodeEntity (text, i, dest);
+            }
+            else
+            {
+                dest += '\n';
+                i += (i + 1 < text.size() && text[i + 1] == '\n') ? (size_t) 2 : (size_t) 1;
+            }
+        }
+    }
+}
+
+//==============================================================================
+XmlStreamReader::XmlStreamReader (InputStream& source) : input (source) {}
+XmlStreamReader::~XmlStreamReader() = default;
+
+XmlStreamReader::Event XmlStreamReader::setError (const String& message)
+{
+    lastError = message;
+    currentEvent = Event::error;
+    return currentEvent;
+}
+
+bool XmlStreamReader::readMore()
+{
+    if (inputExhausted)
+        return false;
+
+    // Discard everything that has already been consumed, and grow the buffer if it's full
+    if (bufferStart > 0)
+    {
+        std::memmove (buffer, buffer + bufferStart, bufferEnd - bufferStart);
+        bufferEnd -= bufferStart;
+        bufferStart = 0;
+    }
+
+    if (bufferEnd == bufferCapacity)
+    {
+        bufferCapacity = jmax ((size_t) 65536, bufferCapacity * 2);
+        buffer.realloc (bufferCapacity);
+    }
+
+    const auto numRead = input.read (buffer + bufferEnd, (int) jmin (bufferCapacity - bufferEnd, (size_t) std::numeric_limits<int>::max()));
+
+    if (numRead <= 0)
+    {
+        inputExhausted = true;
+        return false;
+    }
+
+    bufferEnd += (size_t) numRead;
+    return true;
+}
+
+bool XmlStreamReader::ensureAvailable (size_t numBytes)
+{
+    while (getNumBytesAvailable() < numBytes)
+        if (! readMore())
+            return false;
+
+    return true;
+}
+
+bool XmlStreamReader::startsWith (std::string_view text)
+{
+    return ensureAvailable (text.size())
+            && std::memcmp (getData(), text.data(), text.size()) == 0;
+}
+
+template <char... chars>
+size_t XmlStreamReader::find (size_t startOffset)
+{
+    for (;;)
+    {
+        const auto numAvailable = getNumBytesAvailable();
+
+        if (startOffset < numAvailable)
+        {
+            const auto index = startOffset + detail::ByteScanning::findFirstOf<chars...> (getData() + startOffset,
+                                                                                         numAvailable - startOffset);
+
+            if (index < numAvailable)
+                return index;
+
+            startOffset = numAvailable;
+        }
+
+        if (! readMore())
+            return XmlStreamReaderHelpers::notFound;
+    }
+}
+
+size_t XmlStreamReader::findSequence (std::string_view sequence, size_t startOffset)
+{
+    for (;;)
+    {
+        size_t index = XmlStreamReaderHelpers::notFound;
+
+        switch (sequence[0])
+        {
+            case '-':   index = find<'-'> (startOffset); break;
+            case '?':   index = find<'?'> (startOffset); break;
+            case ']':   index = find<']'> (startOffset); break;
+            default:    jassertfalse; break;
+        }
+
+        if (index == XmlStreamReaderHelpers::notFound || ! ensureAvailable (index + sequence.size()))
+            return XmlStreamReaderHelpers::notFound;
+
+        if (std::memcmp (getData() + index, sequence.data(), sequence.size()) == 0)
+            return index;
+
+        startOffset = index + 1;
+    }
+}
+
+size_t XmlStreamReader::findEndOfTag()
+{
+    // Finds the closing '>', ignoring any that appear inside quoted attribute values
+    for (size_t index = 1;;)
+    {
+        index = find<'>', '"', '\''> (index);
+
+        if (index == XmlStreamReaderHelpers::notFound)
+            return index;
+
+        const auto c = getData()[index];
+
+        if (c == '>')
+            return index;
+
+        index = c == '"' ? find<'"'> (index + 1) : find<'\''> (index + 1);
+
+        if (index == XmlStreamReaderHelpers::notFound)
+            return index;
+
+        ++index;
+    }
+}
+
+bool XmlStreamReader::skipPast (std::string_view terminator, size_t startOffset)
+{
+    const auto index = findSequence (terminator, startOffset);
+
+    if (index == XmlStreamReaderHelpers::notFound)
+        return false;
+
+    bufferStart += index + terminator.size();
+    return true;
+}
+
+bool XmlStreamReader::skipDeclaration()
+{
+    // Skips something like a DOCTYPE, which may contain nested declarations
+    size_t index = 1;
+
+    for (int nesting = 1; nesting > 0; ++index)
+    {
+        index = find<'<', '>'> (index);
+
+        if (index == XmlStreamReaderHelpers::notFound)
+            return false;
+
+        nesting += getData()[index] == '<' ? 1 : -1;
+    }
+
+    bufferStart += index;
+    return true;
+}
+
+//==============================================================================
+XmlStreamReader::Event XmlStreamReader::next()
+{
+    using namespace XmlStreamReaderHelpers;
+
+    if (currentEvent == Event::endOfDocument || currentEvent == Event::error)
+        return currentEvent;
+
+    depth = depthAfterCurrentEvent;
+    currentTextIsCDATA = false;
+
+    if (hasPendingEndElement)
+    {
+        // The end of an empty element, whose name is still in the buffer
+        hasPendingEndElement = false;
+        currentEvent = Event::endElement;
+        depthAfterCurrentEvent = depth - 1;
+        return currentEvent;
+    }
+
+    if (hasStarted && depth == 0)
+        return currentEvent = Event::endOfDocument;
+
+    if (! hasCheckedByteOrderMark)
+    {
+        hasCheckedByteOrderMark = true;
+
+        if (startsWith ("\xef\xbb\xbf"))
+            bufferStart += 3;
+        else if (startsWith ("\xfe\xff") || startsWith ("\xff\xfe"))
+            return setError ("UTF-16 documents aren't supported");
+    }
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+            return setError (hasStarted ? "unmatched tags" : "not enough input");
+
+        if (getData()[0] == '<')
+        {
+            if (startsWith ("<!--"))
+            {
+                if (! skipPast ("-->", 4))
+                    return setError ("unterminated comment");
+
+                continue;
+            }
+
+            if (startsWith ("<?"))
+            {
+                if (! skipPast ("?>", 2))
+                    return setError ("unterminated processing instruction");
+
+                continue;
+            }
+
+            if (startsWith ("<![CDATA["))
+            {
+                if (depth == 0)
+                    return setError ("CDATA section found outside the document element");
+
+                return readCDATA();
+            }
+
+            if (startsWith ("<!"))
+            {
+                if (! skipDeclaration())
+                    return setError ("malformed DTD");
+
+                continue;
+            }
+
+            if (startsWith ("</"))
+            {
+                if (depth == 0)
+                    return setError ("unmatched tags");
+
+                return readEndTag();
+            }
+
+            const auto endOfTag = findEndOfTag();
+
+            if (endOfTag == notFound)
+                return setError ("unterminated tag");
+
+            return readStartTag (endOfTag + 1);
+        }
+
+        if (depth == 0)
+        {
+            // Outside the document element, only whitespace is allowed
+            const auto numWhitespace = detail::ByteScanning::findFirstNonWhitespace (getData(), getNumBytesAvailable());
+
+            if (numWhitespace == 0)
+                return setError ("illegal character found outside the document element");
+
+            bufferStart += numWhitespace;
+            continue;
+        }
+
+        if (auto event = readText())
+            return *event;
+    }
+}
+
+XmlStreamReader::Event XmlStreamReader::readStartTag (size_t tagLength)
+{
+    using namespace XmlStreamReaderHelpers;
+
+    const std::string_view tag (getData(), tagLength);
+    const auto tagOffset = bufferStart;
+    const auto end = tagLength - 1;
+    size_t i = 1;
+
+    const auto skipWhitespace = [&] { while (i < end && isWhitespaceByte (tag[i])) ++i; };
+    const auto readIdentifier = [&] { const auto start = i; while (i < end && isIdentifierByte (tag[i])) ++i; return i - start; };
+
+    skipWhitespace();
+    nameStart = tagOffset + i;
+    nameLength = readIdentifier();
+
+    if (nameLength == 0)
+        return setError ("tag name missing");
+
+    attributes.clear();
+    decoded.clear();
+    bool isEmptyElement = false;
+
+    for (;;)
+    {
+        skipWhitespace();
+
+        if (i >= end)
+            break;
+
+        if (tag[i] == '/' && i + 1 == end)
+        {
+            isEmptyElement = true;
+            break;
+        }
+
+        const auto attributeNameStart = i;
+        const auto attributeNameLength = readIdentifier();
+
+        if (attributeNameLength == 0)
+            return setError ("illegal character found in " + String::fromUTF8 (tag.data() + nameStart - tagOffset, (int) nameLength)
+                               + ": '" + String::charToString ((juce_wchar) (uint8) tag[i]) + "'");
+
+        skipWhitespace();
+
+        if (i >= end || tag[i] != '=')
+            return setError ("expected '=' after attribute '"
+                               + String::fromUTF8 (tag.data() + attributeNameStart, (int) attributeNameLength) + "'");
+
+        ++i;
+        skipWhitespace();
+
+        const auto quote = i < end ? tag[i] : '\0';
+        const auto closingQuote = quote == '"' || quote == '\'' ? tag.find (quote, i + 1) : std::string_view::npos;
+
+        if (closingQuote == std::string_view::npos || closingQuote >= end)
+            return setError ("unmatched quotes");
+
+        const auto value = tag.substr (i + 1, closingQuote - i - 1);
+        Attribute attribute { tagOffset + attributeNameStart, attributeNameLength, tagOffset + i + 1, value.size(), false };
+
+        if (value.find ('&') != std::string_view::npos)
+        {
+            attribute.valueStart = decoded.size();
+            appendDecoded (decoded, value, false);
+            attribute.valueLength = decoded.size() - attribute.valueStart;
+            attribute.valueIsDecoded = true;
+        }
+
+        attributes.push_back (attribute);
+        i = closingQuote + 1;
+    }
+
+    bufferStart += tagLength;
+    hasStarted = true;
+    hasPendingEndElement = isEmptyElement;
+    depthAfterCurrentEvent = ++depth;
+    currentEvent = Event::startElement;
+    return currentEvent;
+}
+
+XmlStreamReader::Event XmlStreamReader::readEndTag()
+{
+    using namespace XmlStreamReaderHelpers;
+
+    const auto endOfTag = find<'>'> (2);
+
+    if (endOfTag == notFound)
+        return setError ("unterminated tag");
+
+    const auto* data = getData();
+    size_t i = 2;
+
+    while (i < endOfTag && isWhitespaceByte (data[i]))
+        ++i;
+
+    nameStart = bufferStart + i;
+
+    while (i < endOfTag && isIdentifierByte (data[i]))
+        ++i;
+
+    nameLength = bufferStart + i - nameStart;
+    attributes.clear();
+    bufferStart += endOfTag + 1;
+    depthAfterCurrentEvent = depth - 1;
+    currentEvent = Event::endElement;
+    return currentEvent;
+}
+
+XmlStreamReader::Event XmlStreamReader::readCDATA()
+{
+    static constexpr std::string_view start { "<![CDATA[" };
+    const auto end = findSequence ("]]>", start.size());
+
+    if (end == XmlStreamReaderHelpers::notFound)
+        return setError ("unterminated CDATA section");
+
+    textStart = bufferStart + start.size();
+    textLength = end - start.size();
+    currentTextIsDecoded = false;
+    currentTextIsCDATA = true;
+    bufferStart += end + 3;
+    currentEvent = Event::text;
+    return currentEvent;
+}
+
+std::optional<XmlStreamReader::Event> XmlStreamReader::readText()
+{
+    using namespace XmlStreamReaderHelpers;
+
+    decoded.clear();
+    currentTextIsDecoded = false;
+
+    for (;;)
+    {
+        const auto length = find<'<'> (0);
+
+        if (length == notFound)
+            return setError ("unmatched tags");
+
+        // XmlDocument joins up any text on either side of a comment, so check for one
+        // before taking a view of the text, as reading more data may move the buffer
+        const auto isFollowedByComment = ensureAvailable (length + 4)
+                                          && std::memcmp (getData() + length, "<!--", 4) == 0;
+
+        const std::string_view text (getData(), length);
+
+        if (currentTextIsDecoded || isFollowedByComment || text.find_first_of ("&\r") != std::string_view::npos)
+        {
+            appendDecoded (decoded, text, true);
+            currentTextIsDecoded = true;
+        }
+        else
+        {
+            textStart = bufferStart;
+            textLength = length;
+        }
+
+        bufferStart += length;
+
+        if (! isFollowedByComment)
+            break;
+
+        if (! skipPast ("-->", 4))
+            return setError ("unterminated comment");
+    }
+
+    if (currentTextIsDecoded)
+    {
+        textStart = 0;
+        textLength = decoded.size();
+    }
+
+    if (ignoreEmptyTextElements)
+    {
+        const auto text = getView (textStart, textLength, currentTextIsDecoded);
+
+        if (detail::ByteScanning::findFirstNonWhitespace (text.data(), text.size()) == text.size())
+            return std::nullopt;
+    }
+
+    currentEvent = Event::text;
+    return currentEvent;
+}
+
+//==============================================================================
+std::string_view XmlStreamReader::getView (size_t start, size_t length, bool isDecoded) const noexcept
+{
+    return { (isDecoded ? decoded.data() : buffer.get()) + start, length };
+}
+
+std::string_view XmlStreamReader::getName() const noexcept
+{
+    if (currentEvent != Event::startElement && currentEvent != Event::endElement)
+        return {};
+
+    return getView (nameStart, nameLength, false);
+}
+
+std::string_view XmlStreamReader::getAttributeName (int index) const noexcept
+{
+    if (currentEvent != Event::startElement || ! isPositiveAndBelow (index, getNumAttributes()))
+        return {};
+
+    const auto& attribute = attributes[(size_t) index];
+    return getView (attribute.nameStart, attribute.nameLength, false);
+}
+
+std::string_view XmlStreamReader::getAttributeValue (int index) const noexcept
+{
+    if (currentEvent != Event::startElement || ! isPositiveAndBelow (index, getNumAttributes()))
+        return {};
+
+    const auto& attribute = attributes[(size_t) index];
+    return getView (attribute.valueStart, attribute.valueLength, attribute.valueIsDecoded);
+}
+
+std::optional<std::string_view> XmlStreamReader::getAttributeValue (std::string_view attributeName) const noexcept
+{
+    for (int i = 0; i < getNumAttributes(); ++i)
+        if (getAttributeName (i) == attributeName)
+            return getAttributeValue (i);
+
+    return std::nullopt;
+}
+
+std::string_view XmlStreamReader::getText() const noexcept
+{
+    if (currentEvent != Event::text)
+        return {};
+
+    return getView (textStart, textLength, currentTextIsDecoded);
+}
+
+//==============================================================================
+bool XmlStreamReader::skipElement()
+{
+    if (currentEvent != Event::startElement)
+        return false;
+
+    const auto elementDepth = depth;
+
+    for (;;)
+    {
+        switch (next())
+        {
+            case Event::endElement:
+                if (depth == elementDepth)
+                    return true;
+
+                break;
+
+            case Event::startElement:
+            case Event::text:
+                break;
+
+            case Event::endOfDocument:
+            case Event::error:
+                return false;
+        }
+    }
+}
+
+XmlElement* XmlStreamReader::createElement() const
+{
+    const auto tagName = getName();
+
+   #if JUCE_STRING_UTF_TYPE == 8
+    const auto toCharPointer = [] (const char* p) { return String::CharPointerType (p); };
+    auto* element = new XmlElement (toCharPointer (tagName.data()), toCharPointer (tagName.data() + tagName.size()));
+   #else
+    auto* element = new XmlElement (String::fromUTF8 (tagName.data(), (int) tagName.size()));
+   #endif
+
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (element->attributes);
+
+    for (int i = 0; i < getNumAttributes(); ++i)
+    {
+        const auto name = getAttributeName (i);
+        const auto value = getAttributeValue (i);
+
+       #if JUCE_STRING_UTF_TYPE == 8
+        auto* attribute = new XmlElement::XmlAttributeNode (toCharPointer (name.data()), toCharPointer (name.data() + name.size()));
+       #else
+        auto* attribute = new XmlElement::XmlAttributeNode (Identifier (String::fromUTF8 (name.data(), (int) name.size())), {});
+       #endif
+
+        attribute->value = String::fromUTF8 (value.data(), (int) value.size());
+        attributeAppender.append (attribute);
+    }
+
+    return element;
+}
+
+std::unique_ptr<XmlElement> XmlStreamReader::readElement()
+{
+    if (currentEvent != Event::startElement)
+        return {};
+
+    std::unique_ptr<XmlElement> root (createElement());
+    const auto rootDepth = depth;
+
+    // For each open element, this points to where its next child should go
+    std::vector<LinkedListPointer<XmlElement>*> nextChild { &root->firstChildElement };
+
+    for (;;)
+    {
+        switch (next())
+        {
+            case Event::startElement:
+            {
+                auto* element = createElement();
+                *nextChild.back() = element;
+                nextChild.back() = &element->nextListItem;
+                nextChild.push_back (&element->firstChildElement);
+                break;
+            }
+
+            case Event::text:
+            {
+                const auto text = getText();
+                auto* element = XmlElement::createTextElement (String::fromUTF8 (text.data(), (int) text.size()));
+                *nextChild.back() = element;
+                nextChild.back() = &element->nextListItem;
+                break;
+            }
+
+            case Event::endElement:
+                if (depth == rootDepth)
+                    return root;
+
+                nextChild.pop_back();
+                break;
+
+            case Event::endOfDocument:
+            case Event::error:
+                return {};
+        }
+    }
+}
+
+std::unique_ptr<XmlElement> XmlStreamReader::parse (InputStream& source)
+{
+    XmlStreamReader reader (source);
+
+    if (reader.next() == Event::startElement)
+        return reader.readElement();
+
+    return {};
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlStreamReaderTests final : public UnitTest
+{
+public:
+    XmlStreamReaderTests()
+        : UnitTest ("XmlStreamReader", UnitTestCategories::xml)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Events");
+        {
+            const char* text = "<?xml version=\"1.0\"?>\n<!-- comment -->\n"
+                               "<ROOT a=\"1 &amp; 2\" b='x'>\n"
+                               "  <EMPTY c=\"&#65;&#x42;\"/>\n"
+                               "  text &lt;here&gt;<!-- inner -->joined\r\n"
+                               "  <![CDATA[<raw & data>]]>\n"
+                               "</ROOT>\n";
+            MemoryInputStream stream (text, strlen (text), false);
+            XmlStreamReader reader (stream);
+
+            expect (reader.next() == XmlStreamReader::Event::startElement);
+            expect (reader.getName() == "ROOT");
+            expectEquals (reader.getDepth(), 1);
+            expectEquals (reader.getNumAttributes(), 2);
+            expect (reader.getAttributeName (0) == "a");
+            expect (reader.getAttributeValue (0) == "1 & 2");
+            expect (reader.getAttributeValue ("b") == std::optional<std::string_view> ("x"));
+            expect (! reader.getAttributeValue ("c").has_value());
+
+            expect (reader.next() == XmlStreamReader::Event::startElement);
+            expect (reader.getName() == "EMPTY");
+            expectEquals (reader.getDepth(), 2);
+            expect (reader.getAttributeValue ("c") == std::optional<std::string_view> ("AB"));
+
+            expect (reader.next() == XmlStreamReader::Event::endElement);
+            expect (reader.getName() == "EMPTY");
+            expectEquals (reader.getDepth(), 2);
+
+            expect (reader.next() == XmlStreamReader::Event::text);
+            expect (reader.getText() == "\n  text <here>joined\n  ");
+            expect (! reader.isCDATA());
+
+            expect (reader.next() == XmlStreamReader::Event::text);
+            expect (reader.getText() == "<raw & data>");
+            expect (reader.isCDATA());
+
+            expect (reader.next() == XmlStreamReader::Event::endElement);
+            expect (reader.getName() == "ROOT");
+            expectEquals (reader.getDepth(), 1);
+
+            expect (reader.next() == XmlStreamReader::Event::endOfDocument);
+            expect (reader.next() == XmlStreamReader::Event::endOfDocument);
+        }
+
+        beginTest ("Errors");
+        {
+            for (const auto* text : { "", "<ROOT>", "<ROOT><A></ROOT>", "<ROOT a=\"1></ROOT>", "<ROOT a></ROOT>", "<ROOT>&#x1;<!-- </ROOT>" })
+            {
+                MemoryInputStream stream (text, strlen (text), false);
+                XmlStreamReader reader (stream);
+
+                while (reader.next() != XmlStreamReader::Event::error)
+                    expect (reader.getCurrentEvent() != XmlStreamReader::Event::endOfDocument);
+
+                expect (reader.getLastError().isNotEmpty());
+            }
+        }
+
+        beginTest ("Sections of a document can be read as XmlElements");
+        {
+            const auto document = createTestDocument (getRandom());
+            MemoryInputStream stream (document.toRawUTF8(), document.getNumBytesAsUTF8(), false);
+            XmlStreamReader reader (stream);
+            int numItems = 0, numSkipped = 0;
+
+            while (reader.next() != XmlStreamReader::Event::endOfDocument)
+            {
+                if (reader.getCurrentEvent() == XmlStreamReader::Event::startElement && reader.getDepth() == 2)
+                {
+                    if (reader.getName() == "ITEM")
+                    {
+                        auto item = reader.readElement();
+                        expect (item != nullptr && item->hasTagName ("ITEM"));
+                        expectEquals (item->getIntAttribute ("index"), numItems++);
+                    }
+                    else
+                    {
+                        expect (reader.skipElement());
+                        ++numSkipped;
+                    }
+                }
+
+                expect (reader.getCurrentEvent() != XmlStreamReader::Event::error);
+            }
+
+            expectEquals (numItems + numSkipped, 100);
+        }
+
+        beginTest ("Results match XmlDocument for any buffer boundaries");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 20; ++i)
+            {
+                const auto document = createTestDocument (r);
+                const auto expected = parseXML (document);
+
+                TrickleStream stream (document, r);
+                const auto result = XmlStreamReader::parse (stream);
+
+                expect (expected != nullptr && result != nullptr && result->isEquivalentTo (expected.get(), false));
+            }
+        }
+    }
+
+    // Returns a few bytes at a time, to move the boundaries between reads around
+    struct TrickleStream final : public MemoryInputStream
+    {
+        TrickleStream (const String& text, Random& rng)
+            : MemoryInputStream (text.toRawUTF8(), text.getNumBytesAsUTF8(), true), random (rng) {}
+
+        int read (void* dest, int numBytes) override
+        {
+            return MemoryInputStream::read (dest, jmin (numBytes, 1 + random.nextInt (7)));
+        }
+
+        Random& random;
+    };
+
+    static String createTestDocument (Random r)
+    {
+        XmlElement root ("ROOT");
+        int numItems = 0;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            auto* item = root.createNewChildElement (r.nextBool() ? "ITEM" : "OTHER_ITEM");
+
+            if (item->hasTagName ("ITEM"))
+                item->setAttribute ("index", numItems++);
+
+            item->setAttribute ("name", "item \"" + String (i) + "\" <&> " + String (CharPointer_UTF8 ("\xc3\xa9")));
+            item->createNewChildElement ("CHILD")->addTextElement ("some text & more\nover two lines");
+            item->createNewChildElement ("EMPTY");
+        }
+
+        return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!-- generated -->\n" + root.toString (XmlElement::TextFormat().withoutHeader());
+    }
+};
+
+static XmlStreamReaderTests xmlStreamReaderTests;
+
+#endif
+
+} // namespace juce
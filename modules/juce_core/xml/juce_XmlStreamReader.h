@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads an XML document from a stream one piece at a time.
+
+    XmlDocument builds a complete tree of XmlElement objects before returning anything,
+    which needs a lot of memory for large files. An XmlStreamReader instead lets you step
+    through the document by calling next(), which moves on to the next start tag, end tag
+    or block of text. Only the current item is held in memory, and its names and values
+    are returned as views into the reader's buffer rather than as new Strings.
+
+    You can also use readElement() to create an XmlElement for just the part of the
+    document you're currently looking at, so code that works with XmlElements can be
+    used to process a large document one section at a time.
+
+    @code
+    FileInputStream stream (sessionFile);
+    XmlStreamReader reader (stream);
+
+    while (reader.next() == XmlStreamReader::Event::startElement)
+    {
+        if (reader.getName() == "TRACK" && reader.getDepth() == 2)
+            if (auto track = reader.readElement())
+                loadTrack (*track);
+    }
+
+    if (reader.getCurrentEvent() == XmlStreamReader::Event::error)
+        DBG (reader.getLastError());
+    @endcode
+
+    The reader expects UTF-8 text. It handles the standard character entities, but
+    doesn't load DTDs, so any entities that they define are passed through unchanged.
+    Comments, processing instructions and DOCTYPE declarations are skipped.
+
+    @see XmlDocument, XmlElement
+
+    @tags{Core}
+*/
+class JUCE_API  XmlStreamReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for a stream. The stream must remain valid while the reader
+        is using it.
+    */
+    explicit XmlStreamReader (InputStream& source);
+
+    /** Destructor. */
+    ~XmlStreamReader();
+
+    //==============================================================================
+    /** The kinds of item that the reader can be positioned at. */
+    enum class Event
+    {
+        startElement,   /**< An opening tag. Empty tags like <a/> produce a startElement followed by an endElement. */
+        endElement,     /**< A closing tag. */
+        text,           /**< A block of text or a CDATA section. */
+        endOfDocument,  /**< The document element has been closed. */
+        error           /**< The document was malformed. Use getLastError() to find out why. */
+    };
+
+    /** Moves on to the next item in the document and returns its type.
+
+        Once the end of the document or an error has been reached, this will keep
+        returning the same event.
+
+        Any views returned by the reader for the previous item become invalid when
+        this is called.
+    */
+    Event next();
+
+    /** Returns the type of the item that the reader is positioned at. */
+    Event getCurrentEvent() const noexcept                      { return currentEvent; }
+
+    /** Returns the number of elements that are open at the current position.
+
+        For a startElement or endElement, this includes the element itself, so the
+        document element has a depth of 1.
+    */
+    int getDepth() const noexcept                               { return depth; }
+
+    /** For a startElement or endElement, returns the tag name. */
+    std::string_view getName() const noexcept;
+
+    /** For a startElement, returns the number of attributes. */
+    int getNumAttributes() const noexcept                       { return (int) attributes.size(); }
+
+    /** For a startElement, returns the name of one of its attributes. */
+    std::string_view getAttributeName (int index) const noexcept;
+
+    /** For a startElement, returns the value of one of its attributes, with any
+        entities decoded.
+    */
+    std::string_view getAttributeValue (int index) const noexcept;
+
+    /** For a startElement, returns the value of the attribute with the given name,
+        or nullopt if there isn't one.
+    */
+    std::optional<std::string_view> getAttributeValue (std::string_view attributeName) const noexcept;
+
+    /** For a text event, returns the text with any entities decoded. */
+    std::string_view getText() const noexcept;
+
+    /** For a text event, returns true if the text came from a CDATA section. */
+    bool isCDATA() const noexcept                               { return currentTextIsCDATA; }
+
+    /** Returns a description of the problem if next() returned Event::error. */
+    const String& getLastError() const noexcept                 { return lastError; }
+
+    /** Sets whether text that's entirely whitespace should be skipped.
+
+        This is true by default, to match XmlDocument::setEmptyTextElementsIgnored().
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept   { ignoreEmptyTextElements = shouldBeIgnored; }
+
+    //==============================================================================
+    /** When positioned at a startElement, skips over everything inside the element,
+        leaving the reader positioned at its endElement.
+
+        Returns false if the document ends or an error occurs before the element is closed.
+    */
+    bool skipElement();
+
+    /** When positioned at a startElement, reads the whole element and everything
+        inside it into a new XmlElement, leaving the reader positioned at its endElement.
+
+        Returns nullptr if the reader isn't at a startElement, or if the document ends
+        or an error occurs before the element is closed.
+    */
+    std::unique_ptr<XmlElement> readElement();
+
+    /** Reads the document element of some XML from a stream.
+
+        This produces the same result as XmlDocument for most documents, without
+        needing to load the whole stream into memory first.
+    */
+    static std::unique_ptr<XmlElement> parse (InputStream& source);
+
+private:
+    //==============================================================================
+    struct Attribute
+    {
+        size_t nameStart, nameLength, valueStart, valueLength;
+        bool valueIsDecoded;
+    };
+
+    InputStream& input;
+    HeapBlock<char> buffer;
+    size_t bufferCapacity = 0, bufferStart = 0, bufferEnd = 0;
+    bool inputExhausted = false;
+
+    Event currentEvent = Event::text;
+    std::vector<Attribute> attributes;
+    std::string decoded;
+    size_t nameStart = 0, nameLength = 0, textStart = 0, textLength = 0;
+    bool currentTextIsDecoded = false, currentTextIsCDATA = false;
+    bool hasPendingEndElement = false, hasStarted = false, hasCheckedByteOrderMark = false;
+    int depth = 0, depthAfterCurrentEvent = 0;
+    bool ignoreEmptyTextElements = true;
+    String lastError;
+
+    Event setError (const String&);
+    bool readMore();
+    size_t getNumBytesAvailable() const noexcept                { return bufferEnd - bufferStart; }
+    const char* getData() const noexcept                        { return buffer + bufferStart; }
+    bool ensureAvailable (size_t numBytes);
+    bool startsWith (std::string_view);
+    template <char... chars> size_t find (size_t startOffset);
+    size_t findSequence (std::string_view, size_t startOffset);
+    size_t findEndOfTag();
+    bool skipPast (std::string_view terminator, size_t startOffset);
+    bool skipDeclaration();
+    Event readStartTag (size_t tagLength);
+    Event readEndTag();
+    Event readCDATA();
+    std::optional<Event> readText();
+    std::string_view getView (size_t start, size_t length, bool isDecoded) const noexcept;
+    XmlElement* createElement() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlStreamReader)
+};
+
+} // namespace juce
@@ -45,6 +45,7 @@
 
 #include "values/juce_Value.cpp"
 #include "values/juce_ValueTree.cpp"
+#include "values/juce_CompactValueTree.cpp"
 #include "values/juce_ValueTreeSynchroniser.cpp"
 #include "values/juce_CachedValue.cpp"
 #include "undomanager/juce_UndoManager.cpp"
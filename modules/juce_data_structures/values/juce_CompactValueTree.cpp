@@ -0,0 +1,1160 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  The layout of the data is:
+
+    header      4 magic bytes, then the format version as 4 little-endian bytes
+    identifiers varint count, then for each: varint length and UTF-8 bytes
+    nodes       each node's children are written before the node itself
+    trailer     the offset of the root node, as 8 little-endian bytes (0 for an invalid tree)
+
+    and each node contains:
+
+    varint type index
+    varint number of children
+    if there are children, a byte holding the width (1, 2, 4 or 8) of the child offsets,
+    followed by each child's distance back from the start of this node, little-endian
+    varint number of properties, then for each: varint name index and a tagged value
+*/
+namespace CompactValueTreeHelpers
+{
+    // The leading zero means that ValueTree::readFromStream() sees an empty type name,
+    // and returns an invalid tree rather than misreading the data
+    static constexpr uint8 magic[] { 0, 'V', 'T', 'C' };
+    static constexpr size_t headerSize = 8, trailerSize = 8;
+
+    enum ValueTag : uint8
+    {
+        voidTag, undefinedTag, falseTag, trueTag, intTag, int64Tag, doubleTag, stringTag, binaryTag, arrayTag
+    };
+
+    static uint64 zigzagEncode (int64 value) noexcept   { return ((uint64) value << 1) ^ (uint64) (value >> 63); }
+    static int64 zigzagDecode (uint64 value) noexcept   { return (int64) (value >> 1) ^ -(int64) (value & 1); }
+
+    static void writeVarint (MemoryOutputStream& out, uint64 value)
+    {
+        uint8 buffer[10];
+        size_t numBytes = 0;
+
+        for (; value >= 0x80; value >>= 7)
+            buffer[numBytes++] = (uint8) (value | 0x80);
+
+        buffer[numBytes++] = (uint8) value;
+        out.write (buffer, numBytes);
+    }
+
+    static void writeFixed (MemoryOutputStream& out, uint64 value, int numBytes)
+    {
+        for (int i = 0; i < numBytes; ++i)
+            out.writeByte ((char) (value >> (8 * i)));
+    }
+
+    static uint64 readFixed (const uint8* data, int numBytes) noexcept
+    {
+        uint64 result = 0;
+
+        for (int i = 0; i < numBytes; ++i)
+            result |= (uint64) data[i] << (8 * i);
+
+        return result;
+    }
+
+    static int getWidthNeeded (uint64 maxValue) noexcept
+    {
+        return maxValue <= 0xff ? 1 : (maxValue <= 0xffff ? 2 : (maxValue <= 0xffffffff ? 4 : 8));
+    }
+
+    static void writeValue (MemoryOutputStream& out, const var& value, int depth)
+    {
+        if (value.isVoid())
+        {
+            out.writeByte ((char) voidTag);
+        }
+        else if (value.isUndefined())
+        {
+            out.writeByte ((char) undefinedTag);
+        }
+        else if (value.isBool())
+        {
+            out.writeByte ((char) (static_cast<bool> (value) ? trueTag : falseTag));
+        }
+        else if (value.isInt())
+        {
+            out.writeByte ((char) intTag);
+            writeVarint (out, zigzagEncode (static_cast<int> (value)));
+        }
+        else if (value.isInt64())
+        {
+            out.writeByte ((char) int64Tag);
+            writeVarint (out, zigzagEncode (static_cast<int64> (value)));
+        }
+        else if (value.isDouble())
+        {
+            const auto d = static_cast<double> (value);
+            uint64 bits;
+            std::memcpy (&bits, &d, sizeof (bits));
+
+            out.writeByte ((char) doubleTag);
+            writeFixed (out, bits, 8);
+        }
+        else if (value.isString())
+        {
+            const auto text = value.toString();
+            const auto numBytes = text.getNumBytesAsUTF8();
+
+            out.writeByte ((char) stringTag);
+            writeVarint (out, numBytes);
+            out.write (text.toRawUTF8(), numBytes);
+        }
+        else if (auto* block = value.getBinaryData())
+        {
+            out.writeByte ((char) binaryTag);
+            writeVarint (out, block->getSize());
+            out << *block;
+        }
+        else if (auto* array = value.getArray(); array != nullptr && depth < CompactValueTree::maxNestingDepth)
+        {
+            out.writeByte ((char) arrayTag);
+            writeVarint (out, (uint64) array->size());
+
+            for (const auto& element : *array)
+                writeValue (out, element, depth + 1);
+        }
+        else
+        {
+            // Objects and methods can't be stored, just as with var::writeToStream(),
+            // and neither can arrays that are nested more deeply than maxNestingDepth
+            jassertfalse;
+            out.writeByte ((char) voidTag);
+        }
+    }
+}
+
+//==============================================================================
+struct CompactValueTree::Reader
+{
+    Reader (const uint8* start, const uint8* end) noexcept  : position (start), endOfData (end) {}
+
+    size_t getNumBytesRemaining() const noexcept    { return (size_t) (endOfData - position); }
+
+    uint64 readVarint() noexcept
+    {
+        uint64 result = 0;
+
+        for (int shift = 0; shift < 64 && position < endOfData; shift += 7)
+        {
+            const auto byte = *position++;
+            result |= (uint64) (byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+                return result;
+        }
+
+        failed = true;
+        return 0;
+    }
+
+    // Every item in a list takes at least one byte, which gives a limit to check counts against
+    int readCount() noexcept
+    {
+        const auto count = readVarint();
+
+        if (count > getNumBytesRemaining() || count > (uint64) std::numeric_limits<int>::max())
+        {
+            failed = true;
+            return 0;
+        }
+
+        return (int) count;
+    }
+
+    const uint8* readBytes (size_t numBytes) noexcept
+    {
+        if (numBytes > getNumBytesRemaining())
+        {
+            failed = true;
+            return nullptr;
+        }
+
+        const auto* start = position;
+        position += numBytes;
+        return start;
+    }
+
+    // Corrupt data can contain anything, so the text is checked before being turned into a String
+    String readString() noexcept
+    {
+        const auto numBytes = readCount();
+        const auto* text = reinterpret_cast<const char*> (readBytes ((size_t) numBytes));
+
+        if (failed || ! CharPointer_UTF8::isValidString (text, numBytes))
+        {
+            failed = true;
+            return {};
+        }
+
+        return String::fromUTF8 (text, numBytes);
+    }
+
+    var readValue()
+    {
+        using namespace CompactValueTreeHelpers;
+
+        if (position >= endOfData)
+        {
+            failed = true;
+            return {};
+        }
+
+        switch (*position++)
+        {
+            case voidTag:       return {};
+            case undefinedTag:  return var::undefined();
+            case falseTag:      return false;
+            case trueTag:       return true;
+            case intTag:        return (int) zigzagDecode (readVarint());
+            case int64Tag:      return (int64) zigzagDecode (readVarint());
+
+            case doubleTag:
+            {
+                if (const auto* bytes = readBytes (8))
+                {
+                    const auto bits = readFixed (bytes, 8);
+                    double d;
+                    std::memcpy (&d, &bits, sizeof (d));
+                    return d;
+                }
+
+                return {};
+            }
+
+            case stringTag:     return readString();
+
+            case binaryTag:
+            {
+                const auto numBytes = readVarint();
+
+                if (const auto* bytes = readBytes ((size_t) numBytes))
+                    return MemoryBlock (bytes, (size_t) numBytes);
+
+                return {};
+            }
+
+            case arrayTag:
+            {
+                if (! enterArray())
+                    return {};
+
+                Array<var> array;
+                const auto size = readCount();
+                array.ensureStorageAllocated (size);
+
+                for (int i = 0; i < size && ! failed; ++i)
+                    array.add (readValue());
+
+                --depth;
+                return array;
+            }
+
+            default:
+                failed = true;
+                return {};
+        }
+    }
+
+    void skipValue() noexcept
+    {
+        using namespace CompactValueTreeHelpers;
+
+        if (position >= endOfData)
+        {
+            failed = true;
+            return;
+        }
+
+        switch (*position++)
+        {
+            case voidTag:
+            case undefinedTag:
+            case falseTag:
+            case trueTag:       break;
+            case intTag:
+            case int64Tag:      readVarint(); break;
+            case doubleTag:     readBytes (8); break;
+
+            case stringTag:
+            case binaryTag:     readBytes ((size_t) readVarint()); break;
+
+            case arrayTag:
+            {
+                if (! enterArray())
+                    break;
+
+                for (auto i = readCount(); --i >= 0 && ! failed;)
+                    skipValue();
+
+                --depth;
+                break;
+            }
+
+            default:            failed = true; break;
+        }
+    }
+
+    bool enterArray() noexcept
+    {
+        if (depth >= CompactValueTree::maxNestingDepth)
+        {
+            failed = true;
+            return false;
+        }
+
+        ++depth;
+        return true;
+    }
+
+    const uint8* position;
+    const uint8* endOfData;
+    int depth = 0;
+    bool failed = false;
+};
+
+struct CompactValueTree::NodeInfo
+{
+    size_t typeIndex = 0;
+    int numChildren = 0, childOffsetWidth = 0;
+    const uint8* childOffsets = nullptr;
+    int numProperties = 0;
+    const uint8* properties = nullptr;
+};
+
+//==============================================================================
+struct CompactValueTree::Writer
+{
+    bool write (const ValueTree& tree, OutputStream& output)
+    {
+        using namespace CompactValueTreeHelpers;
+
+        if (tree.isValid() && ! addIdentifiers (*tree.object, 0))
+        {
+            // This tree is too deeply nested to be read back safely
+            jassertfalse;
+            return false;
+        }
+
+        out.write (magic, sizeof (magic));
+        writeFixed (out, (uint64) formatVersion, 4);
+
+        writeVarint (out, identifiers.size());
+
+        for (const auto& identifier : identifiers)
+        {
+            const auto name = identifier.toString();
+            const auto numBytes = name.getNumBytesAsUTF8();
+            writeVarint (out, numBytes);
+            out.write (name.toRawUTF8(), numBytes);
+        }
+
+        const auto rootOffset = tree.isValid() ? writeNode (*tree.object) : 0;
+        writeFixed (out, rootOffset, (int) trailerSize);
+
+        return output.write (out.getData(), out.getDataSize());
+    }
+
+private:
+    void addIdentifier (const Identifier& identifier)
+    {
+        // Identifiers are pooled, so each distinct name has a unique address
+        if (indices.emplace (identifier.getCharPointer().getAddress(), (uint64) identifiers.size()).second)
+            identifiers.push_back (identifier);
+    }
+
+    bool addIdentifiers (const ValueTree::SharedObject& object, int depth)
+    {
+        if (depth >= CompactValueTree::maxNestingDepth)
+            return false;
+
+        addIdentifier (object.type);
+
+        for (int i = 0; i < object.properties.size(); ++i)
+            addIdentifier (object.properties.getName (i));
+
+        for (const auto* child : object.children)
+            if (! addIdentifiers (*child, depth + 1))
+                return false;
+
+        return true;
+    }
+
+    uint64 getIndex (const Identifier& identifier) const
+    {
+        return indices.find (identifier.getCharPointer().getAddress())->second;
+    }
+
+    uint64 writeNode (const ValueTree::SharedObject& object)
+    {
+        using namespace CompactValueTreeHelpers;
+
+        std::vector<uint64> childOffsets;
+        childOffsets.reserve ((size_t) object.children.size());
+
+        for (const auto* child : object.children)
+            childOffsets.push_back (writeNode (*child));
+
+        const auto offset = (uint64) out.getPosition();
+
+        writeVarint (out, getIndex (object.type));
+        writeVarint (out, childOffsets.size());
+
+        if (! childOffsets.empty())
+        {
+            // The first child is the furthest away
+            const auto width = getWidthNeeded (offset - childOffsets.front());
+            out.writeByte ((char) width);
+
+            for (auto childOffset : childOffsets)
+                writeFixed (out, offset - childOffset, width);
+        }
+
+        writeVarint (out, (uint64) object.properties.size());
+
+        for (int i = 0; i < object.properties.size(); ++i)
+        {
+            writeVarint (out, getIndex (object.properties.getName (i)));
+            writeValue (out, object.properties.getValueAt (i), 0);
+        }
+
+        return offset;
+    }
+
+    MemoryOutputStream out;
+    std::vector<Identifier> identifiers;
+    std::unordered_map<const void*, uint64> indices;
+};
+
+bool CompactValueTree::write (const ValueTree& tree, OutputStream& output)
+{
+    return Writer().write (tree, output);
+}
+
+bool CompactValueTree::isCompactFormat (const void* sourceData, size_t numBytes) noexcept
+{
+    using namespace CompactValueTreeHelpers;
+    return numBytes >= sizeof (magic) && std::memcmp (sourceData, magic, sizeof (magic)) == 0;
+}
+
+//==============================================================================
+CompactValueTree::CompactValueTree() = default;
+CompactValueTree::~CompactValueTree() = default;
+
+CompactValueTree::CompactValueTree (CompactValueTree&& other) noexcept
+{
+    *this = std::move (other);
+}
+
+CompactValueTree& CompactValueTree::operator= (CompactValueTree&& other) noexcept
+{
+    mappedFile  = std::move (other.mappedFile);
+    ownedData   = std::move (other.ownedData);
+    identifiers = std::move (other.identifiers);
+    data        = std::exchange (other.data, nullptr);
+    dataSize    = std::exchange (other.dataSize, 0);
+    nodesStart  = std::exchange (other.nodesStart, 0);
+    rootOffset  = std::exchange (other.rootOffset, 0);
+    return *this;
+}
+
+Result CompactValueTree::open (const File& file)
+{
+    close();
+
+    auto mapped = std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly);
+
+    if (mapped->getData() == nullptr)
+        return Result::fail ("Couldn't open " + file.getFullPathName());
+
+    data = static_cast<const uint8*> (mapped->getData());
+    dataSize = mapped->getSize();
+    mappedFile = std::move (mapped);
+    return openData();
+}
+
+Result CompactValueTree::open (MemoryBlock block)
+{
+    close();
+    ownedData = std::move (block);
+    data = static_cast<const uint8*> (ownedData.getData());
+    dataSize = ownedData.getSize();
+    return openData();
+}
+
+Result CompactValueTree::open (const void* sourceData, size_t numBytes)
+{
+    close();
+    data = static_cast<const uint8*> (sourceData);
+    dataSize = numBytes;
+    return openData();
+}
+
+void CompactValueTree::close()
+{
+    mappedFile.reset();
+    ownedData.reset();
+    identifiers.clear();
+    data = nullptr;
+    dataSize = nodesStart = rootOffset = 0;
+}
+
+Result CompactValueTree::openData()
+{
+    using namespace CompactValueTreeHelpers;
+
+    const auto result = [this]
+    {
+        if (dataSize < headerSize + trailerSize || ! isCompactFormat (data, dataSize))
+            return Result::fail ("Not a compact ValueTree");
+
+        if (readFixed (data + sizeof (magic), 4) > (uint64) formatVersion)
+            return Result::fail ("The data was written by a newer version of the format");
+
+        Reader reader (data + headerSize, data + dataSize - trailerSize);
+        const auto numIdentifiers = reader.readCount();
+        identifiers.reserve ((size_t) numIdentifiers);
+
+        for (int i = 0; i < numIdentifiers; ++i)
+        {
+            const auto name = reader.readString();
+
+            if (name.isEmpty())
+                return Result::fail ("Corrupt identifier table");
+
+            identifiers.emplace_back (name);
+        }
+
+        if (reader.failed)
+            return Result::fail ("Corrupt identifier table");
+
+        nodesStart = (size_t) (reader.position - data);
+        const auto root = readFixed (data + dataSize - trailerSize, (int) trailerSize);
+
+        if (root != 0 && (root < nodesStart || root >= dataSize - trailerSize))
+            return Result::fail ("Corrupt root node offset");
+
+        rootOffset = (size_t) root;
+        return Result::ok();
+    }();
+
+    if (result.failed())
+        close();
+
+    return result;
+}
+
+bool CompactValueTree::readNodeInfo (size_t offset, NodeInfo& info) const noexcept
+{
+    using namespace CompactValueTreeHelpers;
+
+    if (offset < nodesStart || offset >= dataSize - trailerSize)
+        return false;
+
+    Reader reader (data + offset, data + dataSize - trailerSize);
+    info.typeIndex = (size_t) reader.readVarint();
+    info.numChildren = reader.readCount();
+
+    if (info.numChildren > 0)
+    {
+        if (const auto* width = reader.readBytes (1))
+            info.childOffsetWidth = *width;
+
+        if (info.childOffsetWidth != 1 && info.childOffsetWidth != 2 && info.childOffsetWidth != 4 && info.childOffsetWidth != 8)
+            return false;
+
+        info.childOffsets = reader.readBytes ((size_t) info.numChildren * (size_t) info.childOffsetWidth);
+    }
+
+    info.numProperties = reader.readCount();
+    info.properties = reader.position;
+
+    return ! reader.failed && info.typeIndex < identifiers.size();
+}
+
+size_t CompactValueTree::getChildOffset (size_t offset, const NodeInfo& info, int index) const noexcept
+{
+    if (! isPositiveAndBelow (index, info.numChildren))
+        return 0;
+
+    const auto distance = CompactValueTreeHelpers::readFixed (info.childOffsets + (size_t) index * (size_t) info.childOffsetWidth,
+                                                              info.childOffsetWidth);
+
+    // Children always come before their parent, so a bad offset can't lead to a loop
+    if (distance == 0 || distance > offset - nodesStart)
+        return 0;
+
+    return offset - (size_t) distance;
+}
+
+CompactValueTree::Reader CompactValueTree::getPropertyReader (const NodeInfo& info) const noexcept
+{
+    return { info.properties, data + dataSize - CompactValueTreeHelpers::trailerSize };
+}
+
+CompactValueTree::Node CompactValueTree::getRoot() const noexcept
+{
+    if (rootOffset == 0)
+        return {};
+
+    return { this, rootOffset };
+}
+
+//==============================================================================
+Identifier CompactValueTree::Node::getType() const noexcept
+{
+    NodeInfo info;
+
+    if (document == nullptr || ! document->readNodeInfo (offset, info))
+        return {};
+
+    return document->identifiers[info.typeIndex];
+}
+
+int CompactValueTree::Node::getNumProperties() const noexcept
+{
+    NodeInfo info;
+
+    if (document == nullptr || ! document->readNodeInfo (offset, info))
+        return 0;
+
+    return info.numProperties;
+}
+
+Identifier CompactValueTree::Node::getPropertyName (int index) const noexcept
+{
+    NodeInfo info;
+
+    if (document == nullptr || ! document->readNodeInfo (offset, info) || ! isPositiveAndBelow (index, info.numProperties))
+        return {};
+
+    auto reader = document->getPropertyReader (info);
+
+    for (int i = 0; i < index; ++i)
+    {
+        reader.readVarint();
+        reader.skipValue();
+    }
+
+    const auto nameIndex = (size_t) reader.readVarint();
+
+    if (reader.failed || nameIndex >= document->identifiers.size())
+        return {};
+
+    return document->identifiers[nameIndex];
+}
+
+var CompactValueTree::Node::getProperty (const Identifier& name, const var& defaultReturnValue) const
+{
+    NodeInfo info;
+
+    if (document == nullptr || ! document->readNodeInfo (offset, info))
+        return defaultReturnValue;
+
+    auto reader = document->getPropertyReader (info);
+
+    for (int i = 0; i < info.numProperties && ! reader.failed; ++i)
+    {
+        const auto nameIndex = (size_t) reader.readVarint();
+
+        if (nameIndex < document->identifiers.size() && document->identifiers[nameIndex] == name)
+        {
+            auto value = reader.readValue();
+            return reader.failed ? defaultReturnValue : value;
+        }
+
+        reader.skipValue();
+    }
+
+    return defaultReturnValue;
+}
+
+bool CompactValueTree::Node::hasProperty (const Identifier& name) const noexcept
+{
+    NodeInfo info;
+
+    if (document == nullptr || ! document->readNodeInfo (offset, info))
+        return false;
+
+    auto reader = document->getPropertyReader (info);
+
+    for (int i = 0; i < info.numProperties && ! reader.failed; ++i)
+    {
+        const auto nameIndex = (size_t) reader.readVarint();
+
+        if (! reader.failed && nameIndex < document->identifiers.size() && document->identifiers[nameIndex] == name)
+            return true;
+
+        reader.skipValue();
+    }
+
+    return false;
+}
+
+int CompactValueTree::Node::getNumChildren() const noexcept
+{
+    NodeInfo info;
+
+    if (document == nullptr || ! document->readNodeInfo (offset, info))
+        return 0;
+
+    return info.numChildren;
+}
+
+CompactValueTree::Node CompactValueTree::Node::getChild (int index) const noexcept
+{
+    NodeInfo info;
+
+    if (document == nullptr || ! document->readNodeInfo (offset, info))
+        return {};
+
+    if (const auto childOffset = document->getChildOffset (offset, info, index))
+        return { document, childOffset };
+
+    return {};
+}
+
+CompactValueTree::Node CompactValueTree::Node::getChildWithName (const Identifier& type) const noexcept
+{
+    for (int i = 0; i < getNumChildren(); ++i)
+    {
+        const auto child = getChild (i);
+
+        if (child.hasType (type))
+            return child;
+    }
+
+    return {};
+}
+
+ValueTree CompactValueTree::Node::createValueTree() const
+{
+    if (document == nullptr)
+        return {};
+
+    return document->decodeNode (offset, 0);
+}
+
+ValueTree CompactValueTree::decodeNode (size_t offset, int depth) const
+{
+    NodeInfo info;
+
+    if (depth >= maxNestingDepth || ! readNodeInfo (offset, info))
+        return {};
+
+    ValueTree tree (identifiers[info.typeIndex]);
+    auto& object = *tree.object;
+    auto reader = getPropertyReader (info);
+
+    for (int i = 0; i < info.numProperties; ++i)
+    {
+        const auto nameIndex = (size_t) reader.readVarint();
+        auto value = reader.readValue();
+
+        if (reader.failed || nameIndex >= identifiers.size())
+            return {};
+
+        object.properties.set (identifiers[nameIndex], std::move (value));
+    }
+
+    object.children.ensureStorageAllocated (info.numChildren);
+
+    for (int i = 0; i < info.numChildren; ++i)
+    {
+        const auto childOffset = getChildOffset (offset, info, i);
+        auto child = childOffset != 0 ? decodeNode (childOffset, depth + 1) : ValueTree();
+
+        if (! child.isValid())
+            return {};
+
+        object.children.add (child.object);
+        child.object->parent = &object;
+    }
+
+    return tree;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CompactValueTreeTests final : public UnitTest
+{
+public:
+    CompactValueTreeTests()
+        : UnitTest ("CompactValueTree", UnitTestCategories::values)
+    {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Trees survive a round trip");
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                const auto tree = createRandomTree (r, 0);
+                const auto data = writeToBlock (tree);
+
+                CompactValueTree document;
+                expect (document.open (data).wasOk());
+                expect (document.createValueTree().isEquivalentTo (tree));
+                expect (ValueTree::readFromData (data.getData(), data.getSize()).isEquivalentTo (tree));
+
+                expectNodeMatches (document.getRoot(), tree);
+            }
+        }
+
+        beginTest ("Invalid trees");
+        {
+            const auto data = writeToBlock ({});
+
+            CompactValueTree document;
+            expect (document.open (data).wasOk());
+            expect (! document.getRoot().isValid());
+            expect (! document.createValueTree().isValid());
+
+            MemoryInputStream in (data, false);
+            expect (! ValueTree::readFromStream (in).isValid());
+        }
+
+        beginTest ("Identifiers are only stored once");
+        {
+            ValueTree tree ("ROOT");
+
+            for (int i = 0; i < 1000; ++i)
+                tree.appendChild (ValueTree { "CHILD_NODE", { { "someProperty", i }, { "anotherProperty", "x" } } }, nullptr);
+
+            MemoryOutputStream original;
+            tree.writeToStream (original);
+
+            expectLessThan (writeToBlock (tree).getSize() * 3, original.getDataSize());
+        }
+
+        beginTest ("Files can be opened lazily");
+        {
+            const auto tree = createRandomTree (r, 0);
+            TemporaryFile temp;
+
+            {
+                FileOutputStream out (temp.getFile());
+                expect (CompactValueTree::write (tree, out));
+            }
+
+            CompactValueTree document;
+            expect (document.open (temp.getFile()).wasOk());
+            expectNodeMatches (document.getRoot(), tree);
+
+            auto moved = std::move (document);
+            expect (moved.createValueTree().isEquivalentTo (tree));
+            expect (! document.getRoot().isValid());
+        }
+
+        beginTest ("Corrupt data is handled safely");
+        {
+            expect (CompactValueTree().open (MemoryBlock()).failed());
+            expect (CompactValueTree().open (MemoryBlock ("not a tree", 10)).failed());
+
+            auto newerVersion = writeToBlock (createRandomTree (r, 0));
+            newerVersion[4] = (char) (CompactValueTree::formatVersion + 1);
+            expect (CompactValueTree().open (newerVersion).failed());
+
+            auto versionInUpperBytes = writeToBlock (createRandomTree (r, 0));
+            versionInUpperBytes[6] = 1;
+            expect (CompactValueTree().open (versionInUpperBytes).failed());
+
+            const auto tree = createRandomTree (r, 0);
+            const auto data = writeToBlock (tree);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto corrupted = data;
+
+                if (r.nextBool())
+                    corrupted.setSize ((size_t) r.nextInt ((int) data.getSize()));
+                else
+                    for (int j = 1 + r.nextInt (4); --j >= 0;)
+                        corrupted[r.nextInt ((int) data.getSize())] = (char) r.nextInt (256);
+
+                CompactValueTree document;
+
+                if (document.open (corrupted).wasOk())
+                {
+                    visitAll (document.getRoot());
+                    document.createValueTree();
+                }
+            }
+
+            const auto corruptText = [this] (const MemoryBlock& block, const char* text)
+            {
+                auto corrupted = block;
+                const auto* begin = static_cast<char*> (corrupted.getData());
+                const auto* end = begin + corrupted.getSize();
+                const auto found = std::search (begin, end, text, text + std::strlen (text));
+                expect (found != end);
+                corrupted[(int) (found - begin)] = (char) 0xff;
+                return corrupted;
+            };
+
+            ValueTree named ("named");
+            named.setProperty ("text", "qwerty", nullptr);
+            const auto namedData = writeToBlock (named);
+
+            expect (CompactValueTree().open (corruptText (namedData, "named")).failed());
+
+            CompactValueTree document;
+            expect (document.open (corruptText (namedData, "qwerty")).wasOk());
+            expect (document.getRoot().getProperty ("text", 123) == var (123));
+        }
+
+        beginTest ("Deeply nested data fails cleanly");
+        {
+            const auto createChain = [] (int depth)
+            {
+                ValueTree tree ("node");
+
+                for (int i = 1; i < depth; ++i)
+                {
+                    ValueTree parent ("node");
+                    parent.appendChild (tree, nullptr);
+                    tree = parent;
+                }
+
+                return tree;
+            };
+
+            const auto deepestAllowed = createChain (CompactValueTree::maxNestingDepth);
+            expect (writeToBlock (deepestAllowed).getSize() > 0);
+
+            CompactValueTree document;
+            expect (document.open (writeToBlock (deepestAllowed)).wasOk());
+            expect (document.createValueTree().isEquivalentTo (deepestAllowed));
+
+            // Data that's too deep has to be built by hand, because write() refuses to produce it
+            for (auto depth : { CompactValueTree::maxNestingDepth + 1, 100000 })
+            {
+                expect (document.open (createNestedNodes (depth)).wasOk());
+                expect (! document.createValueTree().isValid());
+
+                expect (document.open (createNestedArrayProperty (depth)).wasOk());
+                expect (document.getRoot().hasProperty ("node"));
+                expect (document.getRoot().getProperty ("node", 123) == var (123));
+                expect (! document.createValueTree().isValid());
+            }
+        }
+    }
+
+    // A chain of nodes, each holding only the next one
+    static MemoryBlock createNestedNodes (int depth)
+    {
+        using namespace CompactValueTreeHelpers;
+
+        MemoryOutputStream out;
+        writeNestedDataHeader (out);
+
+        uint64 offset = 0, previousOffset = 0;
+
+        for (int i = 0; i < depth; ++i)
+        {
+            offset = (uint64) out.getPosition();
+            writeVarint (out, 0);
+
+            if (i == 0)
+            {
+                writeVarint (out, 0);
+            }
+            else
+            {
+                writeVarint (out, 1);
+                out.writeByte (1);
+                out.writeByte ((char) (offset - previousOffset));
+            }
+
+            writeVarint (out, 0);
+            previousOffset = offset;
+        }
+
+        writeFixed (out, offset, (int) trailerSize);
+        return out.getMemoryBlock();
+    }
+
+    // A single node with a property holding arrays nested inside each other
+    static MemoryBlock createNestedArrayProperty (int depth)
+    {
+        using namespace CompactValueTreeHelpers;
+
+        MemoryOutputStream out;
+        writeNestedDataHeader (out);
+
+        const auto offset = (uint64) out.getPosition();
+        writeVarint (out, 0);
+        writeVarint (out, 0);
+        writeVarint (out, 1);
+        writeVarint (out, 0);
+
+        for (int i = 0; i < depth; ++i)
+        {
+            out.writeByte ((char) arrayTag);
+            writeVarint (out, 1);
+        }
+
+        out.writeByte ((char) voidTag);
+
+        writeFixed (out, offset, (int) trailerSize);
+        return out.getMemoryBlock();
+    }
+
+    static void writeNestedDataHeader (MemoryOutputStream& out)
+    {
+        using namespace CompactValueTreeHelpers;
+
+        out.write (magic, sizeof (magic));
+        writeFixed (out, (uint64) CompactValueTree::formatVersion, 4);
+        writeVarint (out, 1);
+        writeVarint (out, 4);
+        out.write ("node", 4);
+    }
+
+    static MemoryBlock writeToBlock (const ValueTree& tree)
+    {
+        MemoryOutputStream out;
+        CompactValueTree::write (tree, out);
+        return out.getMemoryBlock();
+    }
+
+    static var createRandomValue (Random& r, int depth)
+    {
+        switch (r.nextInt (depth < 2 ? 10 : 9))
+        {
+            case 0:  return {};
+            case 1:  return var::undefined();
+            case 2:  return r.nextBool();
+            case 3:  return r.nextInt() >> r.nextInt (32);
+            case 4:  return r.nextInt64();
+            case 5:  return r.nextDouble() * std::pow (10.0, r.nextInt (40) - 20);
+            case 6:  return String (CharPointer_UTF8 ("caf\xc3\xa9 ")) + String::repeatedString ("x", r.nextInt (300));
+
+            case 7:
+            {
+                MemoryBlock block ((size_t) r.nextInt (100));
+                r.fillBitsRandomly (block.getData(), block.getSize());
+                return block;
+            }
+
+            case 8:  return String (r.nextInt());
+
+            case 9:
+            {
+                Array<var> array;
+
+                for (int i = r.nextInt (5); --i >= 0;)
+                    array.add (createRandomValue (r, depth + 1));
+
+                return array;
+            }
+
+            default: return {};
+        }
+    }
+
+    static ValueTree createRandomTree (Random& r, int depth)
+    {
+        static const Identifier names[] { "alpha", "beta", "gamma", "delta", "epsilon", "zeta" };
+
+        ValueTree tree (names[r.nextInt (numElementsInArray (names))]);
+
+        for (int i = r.nextInt (6); --i >= 0;)
+            tree.setProperty (names[r.nextInt (numElementsInArray (names))].toString() + String (r.nextInt (10)),
+                              createRandomValue (r, 0), nullptr);
+
+        if (depth < 4)
+            for (int i = r.nextInt (depth == 0 ? 100 : 8); --i >= 0;)
+                tree.appendChild (createRandomTree (r, depth + 1), nullptr);
+
+        return tree;
+    }
+
+    void expectNodeMatches (const CompactValueTree::Node& node, const ValueTree& tree)
+    {
+        expect (node.hasType (tree.getType()));
+        expectEquals (node.getNumProperties(), tree.getNumProperties());
+        expectEquals (node.getNumChildren(), tree.getNumChildren());
+
+        for (int i = 0; i < tree.getNumProperties(); ++i)
+        {
+            const auto propertyName = tree.getPropertyName (i);
+            expect (node.getPropertyName (i) == propertyName);
+            expect (node.hasProperty (propertyName));
+            expect (node.getProperty (propertyName).equalsWithSameType (tree[propertyName]));
+        }
+
+        expect (! node.hasProperty ("missing"));
+        expect (node.getProperty ("missing", 123) == var (123));
+
+        for (int i = 0; i < tree.getNumChildren(); ++i)
+            expectNodeMatches (node.getChild (i), tree.getChild (i));
+
+        expect (! node.getChild (tree.getNumChildren()).isValid());
+
+        if (tree.getNumChildren() > 0)
+        {
+            const auto type = tree.getChild (tree.getNumChildren() - 1).getType();
+            expect (node.getChildWithName (type).createValueTree().isEquivalentTo (tree.getChildWithName (type)));
+        }
+    }
+
+    static void visitAll (const CompactValueTree::Node& node)
+    {
+        for (int i = 0; i < node.getNumProperties(); ++i)
+            node.getProperty (node.getPropertyName (i));
+
+        for (int i = 0; i < node.getNumChildren(); ++i)
+            visitAll (node.getChild (i));
+    }
+};
+
+static CompactValueTreeTests compactValueTreeTests;
+
+#endif
+
+} // namespace juce
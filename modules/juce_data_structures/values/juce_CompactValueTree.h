@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads and writes ValueTrees in a compact, indexed binary format.
+
+    ValueTree::writeToStream() stores the full name of every type and property each
+    time it appears, and ValueTree::readFromStream() has to decode a whole tree before
+    any of it can be used. The format used by this class avoids both problems:
+
+    - every distinct Identifier is written once, in a table at the start of the data,
+      and nodes refer to them by index
+    - integers and lengths are stored as variable-length integers, and each value is
+      tagged with its type
+    - each node has an index holding the positions of its children, so any part of
+      the tree can be reached without decoding the nodes in front of it
+
+    A CompactValueTree can open this data directly from a memory-mapped file, which
+    takes almost no time, even for very large documents. The tree can then be browsed
+    through CompactValueTree::Node handles, which decode things only as they are
+    accessed, and any subtree can be turned into a real ValueTree when it's needed.
+
+    @code
+    CompactValueTree::write (project, fileStream);
+    ...
+    CompactValueTree doc;
+
+    if (doc.open (file).wasOk())
+        if (auto settings = doc.getRoot().getChildWithName ("SETTINGS"); settings.isValid())
+            applySettings (settings.createValueTree());
+    @endcode
+
+    ValueTree::readFromData() also recognises this format, so it can be used to load
+    data written by either method.
+
+    @see ValueTree::writeToStream
+
+    @tags{DataStructures}
+*/
+class JUCE_API  CompactValueTree
+{
+public:
+    //==============================================================================
+    /** The version of the format that write() produces. Data written with a newer
+        version than this can't be opened.
+    */
+    static constexpr int formatVersion = 1;
+
+    /** The maximum depth of the trees, and of any arrays inside their property values,
+        that can be written and read. This stops malformed data from exhausting the stack
+        while it's being decoded.
+    */
+    static constexpr int maxNestingDepth = 512;
+
+    /** Writes a tree and all its children to a stream in the compact format.
+
+        The data is built up in memory and written to the stream in one go.
+        Returns false if the stream couldn't be written to, or if the tree is nested
+        more deeply than maxNestingDepth.
+    */
+    static bool write (const ValueTree& tree, OutputStream& output);
+
+    /** Returns true if a block of data starts with the header that write() produces. */
+    static bool isCompactFormat (const void* data, size_t numBytes) noexcept;
+
+    //==============================================================================
+    /** Creates an empty document. */
+    CompactValueTree();
+
+    /** Destructor. */
+    ~CompactValueTree();
+
+    /** Move constructor. Any Nodes obtained from the other document must not be used afterwards. */
+    CompactValueTree (CompactValueTree&&) noexcept;
+
+    /** Move assignment operator. */
+    CompactValueTree& operator= (CompactValueTree&&) noexcept;
+
+    //==============================================================================
+    /** Memory-maps a file that was written by write(), replacing the current contents
+        of the document.
+
+        Only the header and identifier table are read when the file is opened; the
+        rest is read from the file as the tree is accessed.
+    */
+    Result open (const File& file);
+
+    /** Opens a block of data that was written by write(), taking ownership of it. */
+    Result open (MemoryBlock data);
+
+    /** Opens a block of data that was written by write().
+
+        The data isn't copied, so it must remain valid for as long as the document
+        is open.
+    */
+    Result open (const void* data, size_t numBytes);
+
+    /** Closes the document, releasing any data or file that it was using. */
+    void close();
+
+    //==============================================================================
+    /**
+        A lightweight handle to a node inside a CompactValueTree.
+
+        Nodes are cheap to copy, but refer to their document, so they must not be used
+        after the document has been deleted or re-opened.
+
+        Accessing a child that doesn't exist returns an invalid Node, so lookups can
+        safely be chained.
+    */
+    class JUCE_API  Node
+    {
+    public:
+        /** Creates an invalid node. */
+        Node() = default;
+
+        /** Returns true if this refers to a node in a document. */
+        bool isValid() const noexcept                           { return document != nullptr; }
+
+        /** Returns the type of this node. */
+        Identifier getType() const noexcept;
+
+        /** Returns true if the node has this type. */
+        bool hasType (const Identifier& typeName) const noexcept    { return getType() == typeName; }
+
+        /** Returns the number of properties that the node has. */
+        int getNumProperties() const noexcept;
+
+        /** Returns the name of one of the node's properties. */
+        Identifier getPropertyName (int index) const noexcept;
+
+        /** Returns the value of a property, or the default value if it isn't found. */
+        var getProperty (const Identifier& name, const var& defaultReturnValue = {}) const;
+
+        /** Returns true if the node has a property with this name. */
+        bool hasProperty (const Identifier& name) const noexcept;
+
+        /** Returns the number of child nodes. */
+        int getNumChildren() const noexcept;
+
+        /** Returns one of the node's children, or an invalid node if the index is out
+            of range. This doesn't need to look at any of the other children.
+        */
+        Node getChild (int index) const noexcept;
+
+        /** Returns the first child with the given type, or an invalid node if there
+            isn't one.
+        */
+        Node getChildWithName (const Identifier& type) const noexcept;
+
+        /** Decodes this node and all of its children into a new ValueTree.
+            If this node is invalid, or the data is corrupt or nested more deeply than
+            maxNestingDepth, the tree returned will be invalid.
+        */
+        ValueTree createValueTree() const;
+
+    private:
+        friend class CompactValueTree;
+        Node (const CompactValueTree* d, size_t o) noexcept : document (d), offset (o) {}
+
+        const CompactValueTree* document = nullptr;
+        size_t offset = 0;
+    };
+
+    /** Returns the root node, or an invalid node if the document is empty or holds an
+        invalid tree.
+    */
+    Node getRoot() const noexcept;
+
+    /** Decodes the whole document into a ValueTree. */
+    ValueTree createValueTree() const                           { return getRoot().createValueTree(); }
+
+private:
+    //==============================================================================
+    struct NodeInfo;
+    struct Reader;
+    struct Writer;
+
+    bool readNodeInfo (size_t offset, NodeInfo&) const noexcept;
+    size_t getChildOffset (size_t offset, const NodeInfo&, int index) const noexcept;
+    Reader getPropertyReader (const NodeInfo&) const noexcept;
+    ValueTree decodeNode (size_t offset, int depth) const;
+    Result openData();
+
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    MemoryBlock ownedData;
+    const uint8* data = nullptr;
+    size_t dataSize = 0, nodesStart = 0, rootOffset = 0;
+    std::vector<Identifier> identifiers;
+
+    JUCE_DECLARE_NON_COPYABLE (CompactValueTree)
+};
+
+} // namespace juce
@@ -1156,6 +1156,12 @@ ValueTree ValueTree::readFromStream (InputStream& input)
 
 ValueTree ValueTree::readFromData (const void* data, size_t numBytes)
 {
+    if (CompactValueTree::isCompactFormat (data, numBytes))
+    {
+        CompactValueTree document;
+        return document.open (data, numBytes).wasOk() ? document.createValueTree() : ValueTree();
+    }
+
     MemoryInputStream in (data, numBytes, false);
     return readFromStream (in);
 }
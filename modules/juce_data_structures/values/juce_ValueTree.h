@@ -480,7 +480,9 @@ public:
     /** Reloads a tree from a stream that was written with writeToStream(). */
     static ValueTree readFromStream (InputStream& input);
 
-    /** Reloads a tree from a data block that was written with writeToStream(). */
+    /** Reloads a tree from a data block that was written with writeToStream(), or with
+        CompactValueTree::write().
+    */
     static ValueTree readFromData (const void* data, size_t numBytes);
 
     /** Reloads a tree from a data block that was written with writeToStream() and
@@ -634,6 +636,7 @@ public:
 private:
     //==============================================================================
     friend class SharedObject;
+    friend class CompactValueTree;
 
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
@@ -44,9 +44,19 @@ namespace ValueTreeSynchroniserHelpers
         childAdded       = 3,
         childRemoved     = 4,
         childMoved       = 5,
-        propertyRemoved  = 6
+        propertyRemoved  = 6,
+        batch            = 7
     };
 
+    enum BatchFlags
+    {
+        batchIsCompressed = 1
+    };
+
+    // Compressed batches that expand to more than this are rejected, so that a small corrupt
+    // or malicious message can't make the receiver allocate an unlimited amount of memory
+    static constexpr size_t maxDecompressedBatchSize = 64 * 1024 * 1024;
+
     static void getValueTreePath (ValueTree v, const ValueTree& topLevelTree, Array<int>& path)
     {
         while (v != topLevelTree)
@@ -80,7 +90,14 @@ namespace ValueTreeSynchroniserHelpers
             stream.writeCompressedInt (path.getUnchecked (i));
     }
 
-    static ValueTree readSubTreeLocation (MemoryInputStream& input, ValueTree v)
+    static std::vector<int> getPathFromRoot (const ValueTree& v, const ValueTree& topLevelTree)
+    {
+        Array<int> path;
+        getValueTreePath (v, topLevelTree, path);
+        return { std::make_reverse_iterator (path.end()), std::make_reverse_iterator (path.begin()) };
+    }
+
+    static ValueTree readSubTreeLocation (InputStream& input, ValueTree v)
     {
         const int numLevels = input.readCompressedInt();
 
@@ -99,8 +116,304 @@ namespace ValueTreeSynchroniserHelpers
 
         return v;
     }
+
+    template <typename ReadIdentifier>
+    static bool applyChangeToSubTree (ValueTree& v, ChangeType type, InputStream& input,
+                                      ReadIdentifier&& readIdentifier, UndoManager* undoManager)
+    {
+        switch (type)
+        {
+            case propertyChanged:
+            {
+                Identifier property (readIdentifier());
+
+                if (property.isNull())
+                    return false;
+
+                v.setProperty (property, var::readFromStream (input), undoManager);
+                return true;
+            }
+
+            case propertyRemoved:
+            {
+                Identifier property (readIdentifier());
+
+                if (property.isNull())
+                    return false;
+
+                v.removeProperty (property, undoManager);
+                return true;
+            }
+
+            case childAdded:
+            {
+                const int index = input.readCompressedInt();
+                v.addChild (ValueTree::readFromStream (input), index, undoManager);
+                return true;
+            }
+
+            case childRemoved:
+            {
+                const int index = input.readCompressedInt();
+
+                if (isPositiveAndBelow (index, v.getNumChildren()))
+                {
+                    v.removeChild (index, undoManager);
+                    return true;
+                }
+
+                jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+                break;
+            }
+
+            case childMoved:
+            {
+                const int oldIndex = input.readCompressedInt();
+                const int newIndex = input.readCompressedInt();
+
+                if (isPositiveAndBelow (oldIndex, v.getNumChildren())
+                     && isPositiveAndBelow (newIndex, v.getNumChildren()))
+                {
+                    v.moveChild (oldIndex, newIndex, undoManager);
+                    return true;
+                }
+
+                jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+                break;
+            }
+
+            case fullSync:
+            case batch:
+                break;
+
+            default:
+                jassertfalse; // Seem to have received some corrupt data?
+                break;
+        }
+
+        return false;
+    }
+
+    static bool applyBatch (ValueTree& root, InputStream& input, UndoManager* undoManager)
+    {
+        const int numIdentifiers = input.readCompressedInt();
+
+        if (! isPositiveAndBelow (numIdentifiers, 65536)) // sanity-check
+            return false;
+
+        std::vector<Identifier> identifiers;
+        identifiers.reserve ((size_t) numIdentifiers);
+
+        for (int i = 0; i < numIdentifiers; ++i)
+        {
+            auto name = input.readString();
+
+            if (name.isEmpty())
+                return false;
+
+            identifiers.emplace_back (name);
+        }
+
+        const auto readIdentifier = [&]
+        {
+            const int index = input.readCompressedInt();
+            return isPositiveAndBelow (index, (int) identifiers.size()) ? identifiers[(size_t) index] : Identifier();
+        };
+
+        const int numChanges = input.readCompressedInt();
+
+        if (numChanges < 0)
+            return false;
+
+        // Each path is stored as the number of levels it shares with the previous one,
+        // followed by the indices of the levels that are different
+        Array<int> path;
+
+        for (int i = 0; i < numChanges; ++i)
+        {
+            const auto type = (ChangeType) input.readByte();
+            const int numSharedLevels = input.readCompressedInt();
+            const int numNewLevels = input.readCompressedInt();
+
+            if (numSharedLevels < 0 || numSharedLevels > path.size() || ! isPositiveAndBelow (numNewLevels, 65536))
+                return false;
+
+            path.resize (numSharedLevels);
+
+            for (int j = 0; j < numNewLevels; ++j)
+                path.add (input.readCompressedInt());
+
+            auto v = root;
+
+            for (auto index : path)
+            {
+                if (! isPositiveAndBelow (index, v.getNumChildren()))
+                    return false;
+
+                v = v.getChild (index);
+            }
+
+            if (! applyChangeToSubTree (v, type, input, readIdentifier, undoManager))
+                return false;
+        }
+
+        return true;
+    }
 }
 
+//==============================================================================
+struct ValueTreeSynchroniser::Batch
+{
+    using ChangeType = ValueTreeSynchroniserHelpers::ChangeType;
+
+    struct Change
+    {
+        ChangeType type;
+        std::vector<int> path;
+        Identifier property;
+        var value;
+        int index = 0, newIndex = 0;
+        MemoryBlock subTree;
+    };
+
+    void addPropertyChange (std::vector<int> path, const Identifier& property, const var* value)
+    {
+        const auto type = value != nullptr ? ValueTreeSynchroniserHelpers::propertyChanged
+                                           : ValueTreeSynchroniserHelpers::propertyRemoved;
+
+        // Identifiers are pooled, so the address of the name is enough to tell them apart
+        auto key = std::make_pair (path, static_cast<const void*> (property.getCharPointer().getAddress()));
+        const auto existing = latestPropertyChanges.find (key);
+
+        if (existing != latestPropertyChanges.end())
+        {
+            // Nothing structural has happened since the last change to this property,
+            // so the new value can just replace the old one
+            auto& change = changes[existing->second];
+            change.type = type;
+            change.value = value != nullptr ? *value : var();
+            return;
+        }
+
+        latestPropertyChanges.emplace (std::move (key), changes.size());
+        changes.push_back ({ type, std::move (path), property, value != nullptr ? *value : var(), 0, 0, {} });
+    }
+
+    void addStructuralChange (Change change)
+    {
+        // The paths of the earlier changes may no longer be valid after this
+        latestPropertyChanges.clear();
+        changes.push_back (std::move (change));
+    }
+
+    bool isEmpty() const noexcept   { return changes.empty(); }
+
+    void clear()
+    {
+        changes.clear();
+        latestPropertyChanges.clear();
+    }
+
+    MemoryBlock encode (size_t compressionThreshold) const
+    {
+        using namespace ValueTreeSynchroniserHelpers;
+
+        std::vector<Identifier> identifiers;
+        std::map<const void*, int> identifierIndices;
+
+        for (auto& change : changes)
+        {
+            if (change.type == propertyChanged || change.type == propertyRemoved)
+                if (identifierIndices.emplace (change.property.getCharPointer().getAddress(), (int) identifiers.size()).second)
+                    identifiers.push_back (change.property);
+        }
+
+        MemoryOutputStream payload;
+        payload.writeCompressedInt ((int) identifiers.size());
+
+        for (auto& identifier : identifiers)
+            payload.writeString (identifier.toString());
+
+        payload.writeCompressedInt ((int) changes.size());
+
+        const std::vector<int>* previousPath = nullptr;
+
+        for (auto& change : changes)
+        {
+            payload.writeByte ((char) change.type);
+
+            size_t numSharedLevels = 0;
+
+            if (previousPath != nullptr)
+                while (numSharedLevels < jmin (previousPath->size(), change.path.size())
+                        && (*previousPath)[numSharedLevels] == change.path[numSharedLevels])
+                    ++numSharedLevels;
+
+            payload.writeCompressedInt ((int) numSharedLevels);
+            payload.writeCompressedInt ((int) (change.path.size() - numSharedLevels));
+
+            for (auto i = numSharedLevels; i < change.path.size(); ++i)
+                payload.writeCompressedInt (change.path[i]);
+
+            previousPath = &change.path;
+
+            switch (change.type)
+            {
+                case propertyChanged:
+                    payload.writeCompressedInt (identifierIndices[change.property.getCharPointer().getAddress()]);
+                    change.value.writeToStream (payload);
+                    break;
+
+                case propertyRemoved:
+                    payload.writeCompressedInt (identifierIndices[change.property.getCharPointer().getAddress()]);
+                    break;
+
+                case childAdded:
+                    payload.writeCompressedInt (change.index);
+                    payload << change.subTree;
+                    break;
+
+                case childRemoved:
+                    payload.writeCompressedInt (change.index);
+                    break;
+
+                case childMoved:
+                    payload.writeCompressedInt (change.index);
+                    payload.writeCompressedInt (change.newIndex);
+                    break;
+
+                case fullSync:
+                case ValueTreeSynchroniserHelpers::batch:
+                default:
+                    jassertfalse;
+                    break;
+            }
+        }
+
+        MemoryOutputStream message;
+        writeHeader (message, ValueTreeSynchroniserHelpers::batch);
+
+        if (compressionThreshold > 0 && payload.getDataSize() > compressionThreshold)
+        {
+            message.writeByte ((char) batchIsCompressed);
+            GZIPCompressorOutputStream zipper (message);
+            zipper.write (payload.getData(), payload.getDataSize());
+        }
+        else
+        {
+            message.writeByte (0);
+            message << payload.getMemoryBlock();
+        }
+
+        return message.getMemoryBlock();
+    }
+
+    std::vector<Change> changes;
+
+    // The positions of the changes to each property since the last structural change
+    std::map<std::pair<std::vector<int>, const void*>, size_t> latestPropertyChanges;
+};
+
 ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)  : valueTree (tree)
 {
     valueTree.addListener (this);
@@ -108,19 +421,79 @@ ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)  : valueTre
 
 ValueTreeSynchroniser::~ValueTreeSynchroniser()
 {
+    // stateChanged() can't be called from here, because the subclass that implements it has
+    // already been destroyed, so any changes that haven't been sent are dropped
+    stopTimer();
     valueTree.removeListener (this);
 }
 
+void ValueTreeSynchroniser::setBatchInterval (int milliseconds)
+{
+    if (milliseconds <= 0)
+    {
+        flushPendingChanges();
+        batch.reset();
+        batchInterval = 0;
+        return;
+    }
+
+    if (batch == nullptr)
+        batch = std::make_unique<Batch>();
+
+    if (isTimerRunning())
+        startTimer (milliseconds);
+
+    batchInterval = milliseconds;
+}
+
+void ValueTreeSynchroniser::flushPendingChanges()
+{
+    stopTimer();
+
+    if (batch == nullptr || batch->isEmpty())
+        return;
+
+    const auto message = batch->encode (compressionThreshold);
+    batch->clear();
+    stateChanged (message.getData(), message.getSize());
+}
+
+void ValueTreeSynchroniser::timerCallback()
+{
+    flushPendingChanges();
+}
+
 void ValueTreeSynchroniser::sendFullSyncCallback()
 {
+    // The full state includes anything that hasn't been sent yet
+    if (batch != nullptr)
+    {
+        stopTimer();
+        batch->clear();
+    }
+
     MemoryOutputStream m;
     writeHeader (m, ValueTreeSynchroniserHelpers::fullSync);
     valueTree.writeToStream (m);
     stateChanged (m.getData(), m.getDataSize());
 }
 
+void ValueTreeSynchroniser::startBatchTimer()
+{
+    if (! isTimerRunning())
+        startTimer (batchInterval);
+}
+
 void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Identifier& property)
 {
+    if (batch != nullptr)
+    {
+        batch->addPropertyChange (ValueTreeSynchroniserHelpers::getPathFromRoot (vt, valueTree),
+                                  property, vt.getPropertyPointer (property));
+        startBatchTimer();
+        return;
+    }
+
     MemoryOutputStream m;
 
     if (auto* value = vt.getPropertyPointer (property))
@@ -143,6 +516,18 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
     const int index = parentTree.indexOf (childTree);
     jassert (index >= 0);
 
+    if (batch != nullptr)
+    {
+        MemoryOutputStream subTree;
+        childTree.writeToStream (subTree);
+
+        batch->addStructuralChange ({ ValueTreeSynchroniserHelpers::childAdded,
+                                      ValueTreeSynchroniserHelpers::getPathFromRoot (parentTree, valueTree),
+                                      {}, {}, index, 0, subTree.getMemoryBlock() });
+        startBatchTimer();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childAdded, parentTree);
     m.writeCompressedInt (index);
@@ -152,6 +537,15 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
 
 void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueTree&, int oldIndex)
 {
+    if (batch != nullptr)
+    {
+        batch->addStructuralChange ({ ValueTreeSynchroniserHelpers::childRemoved,
+                                      ValueTreeSynchroniserHelpers::getPathFromRoot (parentTree, valueTree),
+                                      {}, {}, oldIndex, 0, {} });
+        startBatchTimer();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childRemoved, parentTree);
     m.writeCompressedInt (oldIndex);
@@ -160,6 +554,15 @@ void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueT
 
 void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex)
 {
+    if (batch != nullptr)
+    {
+        batch->addStructuralChange ({ ValueTreeSynchroniserHelpers::childMoved,
+                                      ValueTreeSynchroniserHelpers::getPathFromRoot (parent, valueTree),
+                                      {}, {}, oldIndex, newIndex, {} });
+        startBatchTimer();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childMoved, parent);
     m.writeCompressedInt (oldIndex);
@@ -179,73 +582,282 @@ bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size
         return true;
     }
 
+    if (type == ValueTreeSynchroniserHelpers::batch)
+    {
+        if ((input.readByte() & ValueTreeSynchroniserHelpers::batchIsCompressed) != 0)
+        {
+            GZIPDecompressorInputStream unzipper (input);
+            MemoryBlock payload;
+
+            if (unzipper.readIntoMemoryBlock (payload, (ssize_t) ValueTreeSynchroniserHelpers::maxDecompressedBatchSize + 1)
+                  > ValueTreeSynchroniserHelpers::maxDecompressedBatchSize)
+                return false;
+
+            MemoryInputStream payloadStream (payload, false);
+            return ValueTreeSynchroniserHelpers::applyBatch (root, payloadStream, undoManager);
+        }
+
+        return ValueTreeSynchroniserHelpers::applyBatch (root, input, undoManager);
+    }
+
     ValueTree v (ValueTreeSynchroniserHelpers::readSubTreeLocation (input, root));
 
     if (! v.isValid())
         return false;
 
-    switch (type)
+    return ValueTreeSynchroniserHelpers::applyChangeToSubTree (v, type, input,
+                                                               [&] { return Identifier (input.readString()); },
+                                                               undoManager);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeSynchroniserTests final : public UnitTest
+{
+public:
+    ValueTreeSynchroniserTests()
+        : UnitTest ("ValueTreeSynchroniser", UnitTestCategories::values)
+    {}
+
+    struct TestSynchroniser final : public ValueTreeSynchroniser
     {
-        case ValueTreeSynchroniserHelpers::propertyChanged:
+        using ValueTreeSynchroniser::ValueTreeSynchroniser;
+
+        void stateChanged (const void* data, size_t size) override
         {
-            Identifier property (input.readString());
-            v.setProperty (property, var::readFromStream (input), undoManager);
-            return true;
+            messages.emplace_back (data, size);
         }
 
-        case ValueTreeSynchroniserHelpers::propertyRemoved:
+        bool applyTo (ValueTree& target)
         {
-            Identifier property (input.readString());
-            v.removeProperty (property, undoManager);
+            for (auto& message : messages)
+                if (! applyChange (target, message.getData(), message.getSize(), nullptr))
+                    return false;
+
+            messages.clear();
             return true;
         }
 
-        case ValueTreeSynchroniserHelpers::childAdded:
+        std::vector<MemoryBlock> messages;
+    };
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Individual changes");
         {
-            const int index = input.readCompressedInt();
-            v.addChild (ValueTree::readFromStream (input), index, undoManager);
-            return true;
+            ValueTree source ("ROOT"), target;
+            TestSynchroniser sync (source);
+            sync.sendFullSyncCallback();
+
+            for (int i = 0; i < 500; ++i)
+                makeRandomChange (source, r);
+
+            expect (sync.applyTo (target));
+            expect (target.isEquivalentTo (source));
         }
 
-        case ValueTreeSynchroniserHelpers::childRemoved:
+        beginTest ("Batched changes");
         {
-            const int index = input.readCompressedInt();
+            for (int i = 0; i < 20; ++i)
+            {
+                ValueTree source ("ROOT"), target;
+                TestSynchroniser sync (source);
+                sync.sendFullSyncCallback();
+                sync.setBatchInterval (1000);
+                sync.setCompressionThreshold (r.nextBool() ? 100 : 0);
+
+                for (int j = 0; j < 200; ++j)
+                    makeRandomChange (source, r);
+
+                expectEquals ((int) sync.messages.size(), 1);
+                sync.flushPendingChanges();
+                expectEquals ((int) sync.messages.size(), 2);
+
+                sync.flushPendingChanges();
+                expectEquals ((int) sync.messages.size(), 2);
+
+                expect (sync.applyTo (target));
+                expect (target.isEquivalentTo (source));
+            }
+        }
+
+        beginTest ("Superseded property changes are dropped");
+        {
+            ValueTree source ("ROOT", {}, { ValueTree ("CHILD") }), target;
+            TestSynchroniser sync (source);
+            sync.sendFullSyncCallback();
+            expect (sync.applyTo (target));
+
+            sync.setBatchInterval (1000);
 
-            if (isPositiveAndBelow (index, v.getNumChildren()))
+            for (int i = 0; i < 1000; ++i)
             {
-                v.removeChild (index, undoManager);
-                return true;
+                source.setProperty ("value", i, nullptr);
+                source.getChild (0).setProperty ("value", String (i), nullptr);
             }
 
-            jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
-            break;
+            source.getChild (0).removeProperty ("value", nullptr);
+            sync.flushPendingChanges();
+
+            expectEquals ((int) sync.messages.size(), 1);
+            expectLessThan ((int) sync.messages.front().getSize(), 50);
+            expect (sync.applyTo (target));
+            expect (target.isEquivalentTo (source));
         }
 
-        case ValueTreeSynchroniserHelpers::childMoved:
+        beginTest ("Large batches are compressed");
         {
-            const int oldIndex = input.readCompressedInt();
-            const int newIndex = input.readCompressedInt();
+            ValueTree source ("ROOT"), target;
+            TestSynchroniser sync (source);
+            sync.sendFullSyncCallback();
+            expect (sync.applyTo (target));
+
+            sync.setBatchInterval (1000);
+            sync.setCompressionThreshold (1024);
+
+            ValueTree bigChild ("BIG");
 
-            if (isPositiveAndBelow (oldIndex, v.getNumChildren())
-                 && isPositiveAndBelow (newIndex, v.getNumChildren()))
+            for (int i = 0; i < 1000; ++i)
+                bigChild.appendChild (ValueTree { "ITEM", { { "name", "item" }, { "index", i } } }, nullptr);
+
+            source.appendChild (bigChild, nullptr);
+            sync.flushPendingChanges();
+
+            MemoryOutputStream uncompressed;
+            bigChild.writeToStream (uncompressed);
+
+            expectEquals ((int) sync.messages.size(), 1);
+            expectLessThan (sync.messages.front().getSize() * 10, uncompressed.getDataSize());
+            expect (sync.applyTo (target));
+            expect (target.isEquivalentTo (source));
+        }
+
+        beginTest ("Pending changes are dropped when the synchroniser is deleted, unless the subclass flushes them");
+        {
+            struct DeletedSynchroniser final : public ValueTreeSynchroniser
             {
-                v.moveChild (oldIndex, newIndex, undoManager);
-                return true;
+                DeletedSynchroniser (const ValueTree& tree, std::vector<MemoryBlock>& m, bool flush)
+                    : ValueTreeSynchroniser (tree), messages (m), shouldFlush (flush)
+                {
+                    setBatchInterval (1000);
+                }
+
+                ~DeletedSynchroniser() override
+                {
+                    if (shouldFlush)
+                        flushPendingChanges();
+                }
+
+                void stateChanged (const void* data, size_t size) override   { messages.emplace_back (data, size); }
+
+                std::vector<MemoryBlock>& messages;
+                const bool shouldFlush;
+            };
+
+            for (auto shouldFlush : { false, true })
+            {
+                ValueTree source ("ROOT");
+                std::vector<MemoryBlock> messages;
+
+                {
+                    DeletedSynchroniser sync (source, messages, shouldFlush);
+                    source.setProperty ("a", 1, nullptr);
+                    expect (messages.empty());
+                }
+
+                expectEquals ((int) messages.size(), shouldFlush ? 1 : 0);
             }
+        }
 
-            jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
-            break;
+        beginTest ("Compressed batches that expand too much are rejected");
+        {
+            const auto makeBatch = [] (size_t payloadSize)
+            {
+                MemoryOutputStream message;
+                message.writeByte ((char) ValueTreeSynchroniserHelpers::batch);
+                message.writeByte ((char) ValueTreeSynchroniserHelpers::batchIsCompressed);
+
+                {
+                    GZIPCompressorOutputStream zipper (message);
+                    MemoryBlock payload (payloadSize, true);
+                    zipper.write (payload.getData(), payload.getSize());
+                }
+
+                return message.getMemoryBlock();
+            };
+
+            ValueTree target ("ROOT");
+
+            // An empty batch: no identifiers and no changes, followed by padding
+            const auto small = makeBatch (1024);
+            expect (ValueTreeSynchroniser::applyChange (target, small.getData(), small.getSize(), nullptr));
+
+            const auto huge = makeBatch (ValueTreeSynchroniserHelpers::maxDecompressedBatchSize + 1);
+            expectLessThan (huge.getSize(), (size_t) 1024 * 1024);
+            expect (! ValueTreeSynchroniser::applyChange (target, huge.getData(), huge.getSize(), nullptr));
         }
 
-        case ValueTreeSynchroniserHelpers::fullSync:
-            break;
+        beginTest ("Turning batching off sends pending changes");
+        {
+            ValueTree source ("ROOT");
+            TestSynchroniser sync (source);
 
-        default:
-            jassertfalse; // Seem to have received some corrupt data?
-            break;
+            sync.setBatchInterval (1000);
+            source.setProperty ("a", 1, nullptr);
+            expect (sync.messages.empty());
+
+            sync.setBatchInterval (0);
+            expectEquals ((int) sync.messages.size(), 1);
+
+            source.setProperty ("a", 2, nullptr);
+            expectEquals ((int) sync.messages.size(), 2);
+        }
     }
 
-    return false;
-}
+    static void makeRandomChange (ValueTree& root, Random& r)
+    {
+        static const Identifier names[] { "a", "b", "c", "d" };
+
+        // Pick a random node, favouring ones near the top
+        auto v = root;
+
+        while (v.getNumChildren() > 0 && r.nextInt (3) != 0)
+            v = v.getChild (r.nextInt (v.getNumChildren()));
+
+        const auto& type = names[r.nextInt (numElementsInArray (names))];
+
+        switch (r.nextInt (7))
+        {
+            case 0:
+            case 1:
+            case 2:  v.setProperty (type, r.nextInt (100), nullptr); break;
+            case 3:  v.removeProperty (type, nullptr); break;
+            case 4:  v.addChild (ValueTree (type, { { type, r.nextDouble() } }), r.nextInt (v.getNumChildren() + 1), nullptr); break;
+
+            case 5:
+                if (v.getNumChildren() > 0)
+                    v.removeChild (r.nextInt (v.getNumChildren()), nullptr);
+
+                break;
+
+            case 6:
+                if (v.getNumChildren() > 1)
+                    v.moveChild (r.nextInt (v.getNumChildren()), r.nextInt (v.getNumChildren()), nullptr);
+
+                break;
+
+            default:
+                break;
+        }
+    }
+};
+
+static ValueTreeSynchroniserTests valueTreeSynchroniserTests;
+
+#endif
 
 } // namespace juce
@@ -49,9 +49,14 @@ namespace juce
     via a network or other means) to a remote destination, where it can be
     applied to a target tree.
 
+    By default, every change is sent as soon as it happens. If the tree changes
+    rapidly, e.g. while a user is dragging a control, setBatchInterval() can be used
+    to collect the changes and send them together in a single, compact message.
+
     @tags{DataStructures}
 */
-class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener
+class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener,
+                                         private Timer
 {
 public:
     /** Creates a ValueTreeSynchroniser that watches the given tree.
@@ -62,7 +67,12 @@ public:
     */
     ValueTreeSynchroniser (const ValueTree& tree);
 
-    /** Destructor. */
+    /** Destructor.
+
+        If batching is enabled, any changes that haven't been sent yet are dropped, because
+        stateChanged() can't be called once your subclass has been destroyed. To send them,
+        call flushPendingChanges() from your subclass's destructor.
+    */
     ~ValueTreeSynchroniser() override;
 
     /** This callback happens when the ValueTree changes and the given state-change message
@@ -84,6 +94,9 @@ public:
         When you implement a receiver for changes that were sent by the stateChanged()
         message, this is the function that you'll need to call to apply them to the
         target tree that you want to be synced.
+
+        Returns false if the data couldn't be applied, which includes compressed batches
+        that would expand to more than 64MB.
     */
     static bool applyChange (ValueTree& target,
                              const void* encodedChangeData, size_t encodedChangeDataSize,
@@ -92,8 +105,45 @@ public:
     /** Returns the root ValueTree that is being observed. */
     const ValueTree& getRoot() noexcept       { return valueTree; }
 
+    //==============================================================================
+    /** Makes the synchroniser collect changes and send them together in one message,
+        at most once every given number of milliseconds.
+
+        While changes are being collected, a new value for a property replaces any
+        earlier value that hasn't been sent yet, so only the latest one is transmitted.
+        The collected changes are sent when the interval has elapsed, or when
+        flushPendingChanges() is called.
+
+        Batches use a newer encoding than individual changes, so the receiver must be
+        using a version of applyChange() that understands them.
+
+        Passing 0 sends any pending changes and turns batching off again, so that every
+        change is sent immediately in a message of its own, which is the default.
+    */
+    void setBatchInterval (int milliseconds);
+
+    /** Sets a size in bytes above which batches will be compressed using a
+        GZIPCompressorOutputStream before they're sent.
+
+        This is worthwhile when large subtrees are being added or replaced. A value of 0
+        disables compression, which is the default.
+    */
+    void setCompressionThreshold (size_t numBytes) noexcept     { compressionThreshold = numBytes; }
+
+    /** If batching is enabled, sends any changes that have been collected so far. */
+    void flushPendingChanges();
+
 private:
+    struct Batch;
+
     ValueTree valueTree;
+    std::unique_ptr<Batch> batch;
+    size_t compressionThreshold = 0;
+    int batchInterval = 0;
+
+    void startBatchTimer();
+
+    void timerCallback() override;
 
     void valueTreePropertyChanged (ValueTree&, const Identifier&) override;
     void valueTreeChildAdded (ValueTree&, ValueTree&) override;
@@ -35,12 +35,12 @@
 namespace juce
 {
 
-class AsyncUpdater::AsyncUpdaterMessage final : public CallbackMessage
+class AsyncUpdater::AsyncUpdaterMessage final : public ReferenceCountedObject
 {
 public:
-    AsyncUpdaterMessage (AsyncUpdater& au)  : owner (au) {}
+    AsyncUpdaterMessage (AsyncUpdater& au, UpdatePriority p)  : owner (au), priority (p) {}
 
-    void messageCallback() override
+    void deliver()
     {
         if (shouldDeliver.compareAndSetBool (0, 1))
             owner.handleAsyncUpdate();
@@ -48,14 +48,233 @@ public:
 
     AsyncUpdater& owner;
     Atomic<int> shouldDeliver;
+    std::atomic<UpdatePriority> priority;
+
+    // Links the message into one of the Dispatcher's lists while isInBatch is set
+    std::atomic<bool> isInBatch { false };
+    AsyncUpdaterMessage* nextInBatch = nullptr;
+    uint64 batchNumber = 0;
 
     JUCE_DECLARE_NON_COPYABLE (AsyncUpdaterMessage)
 };
 
+//==============================================================================
+/*  Collects the AsyncUpdaters that have been triggered and calls them back in batches, from a
+    single message, rather than posting a separate message for each one.
+
+    A triggered updater joins the batch message that's waiting in the queue, as long as nothing
+    else has been posted since that batch was. Otherwise, it posts a new batch, so updaters are
+    never called back before messages that were posted before they were triggered. Each batch
+    calls its updaters in the order they were triggered, highest priority first. Once the time
+    budget for a batch has run out, any normal or low priority updaters that are left are carried
+    over to another message, so that the message thread can handle its other events in between.
+*/
+class AsyncUpdater::Dispatcher
+{
+public:
+    static Dispatcher& getInstance()
+    {
+        static Dispatcher dispatcher;
+        return dispatcher;
+    }
+
+    ~Dispatcher()
+    {
+        for (auto* lists : { &triggered, &pending })
+            for (auto& list : *lists)
+                while (auto* message = unlinkFirst (list))
+                    message->decReferenceCount();
+    }
+
+    bool add (AsyncUpdaterMessage& message)
+    {
+        const ScopedLock sl (lock);
+
+        // Already waiting in an earlier batch, which is delivered before anything posted after it
+        if (message.isInBatch.load (std::memory_order_acquire))
+            return true;
+
+        const auto canJoinLatestBatch = latestBatch.isWaiting
+                                         && MessageManager::getNumMessagesPosted() == latestBatch.numMessagesPostedBefore + 1;
+
+        if (! canJoinLatestBatch && ! postBatch())
+            return false;
+
+        message.isInBatch.store (true, std::memory_order_release);
+        message.batchNumber = latestBatch.number;
+        message.incReferenceCount();
+        append (triggered[(size_t) message.priority.load (std::memory_order_relaxed)], message);
+        return true;
+    }
+
+    void setTimeBudget (int milliseconds) noexcept
+    {
+        timeBudgetMs = jmax (0, milliseconds);
+    }
+
+    /*  Drops all the updaters that are waiting to be delivered. This has to happen when the
+        MessageManager is deleted, because any batch message still in its queue gets thrown away
+        without being delivered, and otherwise those updaters could never be triggered again.
+    */
+    void cancelAll()
+    {
+        const ScopedLock sl (lock);
+
+        for (size_t i = 0; i < numPriorities; ++i)
+        {
+            while (auto message = takeFirst (triggered[i]))
+                message->shouldDeliver.set (0);
+
+            while (auto message = takeFirst (pending[i]))
+                message->shouldDeliver.set (0);
+        }
+
+        latestBatch.isWaiting = false;
+        carryOverPosted = false;
+    }
+
+private:
+    static constexpr size_t numPriorities = 3;
+
+    // Carry-over messages only deliver the updaters that an earlier batch ran out of time for
+    static constexpr uint64 carryOverBatchNumber = 0;
+
+    struct List
+    {
+        AsyncUpdaterMessage* first = nullptr;
+        AsyncUpdaterMessage* last = nullptr;
+    };
+
+    struct BatchMessage final : public CallbackMessage
+    {
+        explicit BatchMessage (uint64 n)  : number (n) {}
+        void messageCallback() override  { Dispatcher::getInstance().deliverBatch (number); }
+
+        const uint64 number;
+    };
+
+    struct LatestBatch
+    {
+        uint64 number = carryOverBatchNumber;
+        uint64 numMessagesPostedBefore = 0;
+        bool isWaiting = false;
+    };
+
+    CriticalSection lock;
+    std::array<List, numPriorities> triggered;  // guarded by the lock
+    LatestBatch latestBatch;                    // guarded by the lock
+    std::array<List, numPriorities> pending;    // only touched by the message thread
+    bool carryOverPosted = false;               // only touched by the message thread
+    std::atomic<int> timeBudgetMs { 8 };
+
+    Dispatcher() = default;
+
+    bool postBatch()
+    {
+        const auto numMessagesPostedBefore = MessageManager::getNumMessagesPosted();
+        const auto number = latestBatch.number + 1;
+
+        if (! (new BatchMessage (number))->post())
+            return false;
+
+        latestBatch = { number, numMessagesPostedBefore, true };
+        return true;
+    }
+
+    void deliverBatch (uint64 batchNumber)
+    {
+        {
+            const ScopedLock sl (lock);
+
+            // Anything triggered after this point will post another batch
+            if (batchNumber == latestBatch.number)
+                latestBatch.isWaiting = false;
+
+            // This also picks up the updaters from any earlier batches that were never delivered
+            for (size_t i = 0; i < numPriorities; ++i)
+                while (triggered[i].first != nullptr && triggered[i].first->batchNumber <= batchNumber)
+                    append (pending[i], *unlinkFirst (triggered[i]));
+        }
+
+        if (batchNumber == carryOverBatchNumber)
+            carryOverPosted = false;
+
+        const auto deadline = Time::getMillisecondCounterHiRes() + timeBudgetMs.load (std::memory_order_relaxed);
+
+        for (size_t i = 0; i < numPriorities; ++i)
+        {
+            // Updaters are taken off the list one at a time, so that this is safe to re-enter
+            // if a callback runs a modal loop
+            while (auto message = takeFirst (pending[i]))
+            {
+                message->deliver();
+
+                if (i != (size_t) UpdatePriority::high && Time::getMillisecondCounterHiRes() >= deadline)
+                {
+                    if (hasPending() && ! std::exchange (carryOverPosted, true))
+                        carryOverPosted = (new BatchMessage (carryOverBatchNumber))->post();
+
+                    return;
+                }
+            }
+        }
+    }
+
+    static void append (List& list, AsyncUpdaterMessage& message)
+    {
+        message.nextInBatch = nullptr;
+        (list.last != nullptr ? list.last->nextInBatch : list.first) = &message;
+        list.last = &message;
+    }
+
+    // Removes the first updater from a list, leaving the caller with the list's reference to it
+    static AsyncUpdaterMessage* unlinkFirst (List& list)
+    {
+        auto* message = list.first;
+
+        if (message == nullptr)
+            return nullptr;
+
+        list.first = std::exchange (message->nextInBatch, nullptr);
+
+        if (list.first == nullptr)
+            list.last = nullptr;
+
+        return message;
+    }
+
+    static ReferenceCountedObjectPtr<AsyncUpdaterMessage> takeFirst (List& list)
+    {
+        auto* message = unlinkFirst (list);
+
+        if (message == nullptr)
+            return nullptr;
+
+        // From here on, the updater can be triggered again
+        message->isInBatch.store (false, std::memory_order_release);
+
+        ReferenceCountedObjectPtr<AsyncUpdaterMessage> result (message);
+        message->decReferenceCount();
+        return result;
+    }
+
+    bool hasPending() const noexcept
+    {
+        return std::any_of (pending.begin(), pending.end(), [] (const List& l) { return l.first != nullptr; });
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Dispatcher)
+};
+
 //==============================================================================
 AsyncUpdater::AsyncUpdater()
+    : AsyncUpdater (UpdatePriority::normal)
+{
+}
+
+AsyncUpdater::AsyncUpdater (UpdatePriority priority)
 {
-    activeMessage = *new AsyncUpdaterMessage (*this);
+    activeMessage = *new AsyncUpdaterMessage (*this, priority);
 }
 
 AsyncUpdater::~AsyncUpdater()
@@ -78,7 +297,7 @@ void AsyncUpdater::triggerAsyncUpdate()
     JUCE_ASSERT_MESSAGE_MANAGER_EXISTS
 
     if (activeMessage->shouldDeliver.compareAndSetBool (1, 0))
-        if (! activeMessage->post())
+        if (! Dispatcher::getInstance().add (*activeMessage))
             cancelPendingUpdate(); // if the message queue fails, this avoids getting
                                    // trapped waiting for the message to arrive
 }
@@ -102,4 +321,202 @@ bool AsyncUpdater::isUpdatePending() const noexcept
     return activeMessage->shouldDeliver.value != 0;
 }
 
+void AsyncUpdater::setAsyncUpdatePriority (UpdatePriority newPriority) noexcept
+{
+    activeMessage->priority = newPriority;
+}
+
+AsyncUpdater::UpdatePriority AsyncUpdater::getAsyncUpdatePriority() const noexcept
+{
+    return activeMessage->priority;
+}
+
+void JUCE_CALLTYPE AsyncUpdater::setBatchTimeBudget (int milliseconds) noexcept
+{
+    Dispatcher::getInstance().setTimeBudget (milliseconds);
+}
+
+void AsyncUpdater::cancelAllPendingUpdates()
+{
+    Dispatcher::getInstance().cancelAll();
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS && ! (JUCE_MAC || JUCE_IOS || JUCE_ANDROID)
+
+class AsyncUpdaterTests final : public UnitTest
+{
+public:
+    AsyncUpdaterTests()
+        : UnitTest ("AsyncUpdater", UnitTestCategories::events)
+    {}
+
+    void runTest() override
+    {
+        using Priority = AsyncUpdater::UpdatePriority;
+
+        beginTest ("Triggered updaters are called back in batches, highest priority first, in order with other messages");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+
+            std::vector<String> calls;
+            const auto record = [&] (const String& label) { return [&calls, label] { calls.push_back (label); }; };
+
+            TestUpdater low1 (record ("low1"), Priority::low), normal1 (record ("normal1")), high1 (record ("high1"), Priority::high),
+                        normal2 (record ("normal2")), low2 (record ("low2"), Priority::low), high2 (record ("high2"), Priority::high);
+
+            MessageManager::callAsync (record ("before"));
+
+            for (auto* u : { &low1, &normal1, &high1 })
+                u->triggerAsyncUpdate();
+
+            // Updaters triggered after this message has been posted go into a new batch, but the
+            // ones that are already waiting stay in the first batch
+            MessageManager::callAsync (record ("between"));
+
+            for (auto* u : { &normal2, &low2, &high2, &normal1, &high1 })
+                u->triggerAsyncUpdate();
+
+            MessageManager::callAsync (record ("after"));
+            dispatchPendingMessages();
+
+            expect (calls == std::vector<String> { "before", "high1", "normal1", "low1", "between",
+                                                   "high2", "normal2", "low2", "after" });
+
+            // Once an updater has been called, triggering it again puts it in a new batch
+            calls.clear();
+            normal1.triggerAsyncUpdate();
+            normal2.triggerAsyncUpdate();
+            dispatchPendingMessages();
+            normal1.triggerAsyncUpdate();
+            MessageManager::callAsync (record ("after"));
+            normal2.triggerAsyncUpdate();
+            dispatchPendingMessages();
+
+            expect (calls == std::vector<String> { "normal1", "normal2", "normal1", "after", "normal2" });
+        }
+
+        beginTest ("Updaters that a batch runs out of time for are carried over to a later message");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+
+            std::vector<String> calls;
+            const auto record = [&] (const String& label) { return [&calls, label] { calls.push_back (label); }; };
+
+            TestUpdater high1 (record ("high1"), Priority::high), high2 (record ("high2"), Priority::high),
+                        normal1 (record ("normal1")), normal2 (record ("normal2"));
+
+            AsyncUpdater::setBatchTimeBudget (0);
+
+            for (auto* u : { &normal1, &normal2, &high1, &high2 })
+                u->triggerAsyncUpdate();
+
+            MessageManager::callAsync (record ("after"));
+            dispatchPendingMessages();
+            dispatchPendingMessages();
+
+            AsyncUpdater::setBatchTimeBudget (8);
+
+            expect (calls == std::vector<String> { "high1", "high2", "normal1", "after", "normal2" });
+        }
+
+        beginTest ("Updaters can be cancelled or flushed while they're waiting in a batch");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+
+            int numA = 0, numB = 0;
+            TestUpdater a ([&] { ++numA; }), b ([&] { ++numB; });
+
+            a.triggerAsyncUpdate();
+            b.triggerAsyncUpdate();
+            a.cancelPendingUpdate();
+            expect (! a.isUpdatePending());
+            dispatchPendingMessages();
+
+            expectEquals (numA, 0);
+            expectEquals (numB, 1);
+
+            // Triggering again after a cancel puts the updater back in the same batch, only once
+            a.triggerAsyncUpdate();
+            a.cancelPendingUpdate();
+            a.triggerAsyncUpdate();
+            dispatchPendingMessages();
+
+            expectEquals (numA, 1);
+
+            a.triggerAsyncUpdate();
+            a.handleUpdateNowIfNeeded();
+            expectEquals (numA, 2);
+            expect (! a.isUpdatePending());
+            dispatchPendingMessages();
+
+            expectEquals (numA, 2);
+
+            // An updater that's deleted while it's in a batch is just skipped
+            auto c = std::make_unique<TestUpdater> ([&] { expect (false, "A deleted updater was called"); });
+            c->triggerAsyncUpdate();
+            b.triggerAsyncUpdate();
+            c.reset();
+            dispatchPendingMessages();
+
+            expectEquals (numB, 2);
+        }
+
+        beginTest ("Updates left waiting when the MessageManager is deleted don't stop later updates");
+        {
+            int numCallbacks = 0;
+            std::optional<TestUpdater> updater;
+
+            {
+                const ScopedJuceInitialiser_GUI libraryInitialiser;
+                updater.emplace ([&] { ++numCallbacks; });
+                updater->triggerAsyncUpdate();
+            }
+
+            if (MessageManager::getInstanceWithoutCreating() == nullptr)
+                expect (! updater->isUpdatePending());
+
+            {
+                const ScopedJuceInitialiser_GUI libraryInitialiser;
+
+                // If the updater or the batch were still marked as queued, this would never be delivered
+                updater->cancelPendingUpdate();
+                updater->triggerAsyncUpdate();
+                dispatchPendingMessages();
+
+                expectEquals (numCallbacks, 1);
+                updater.reset();
+            }
+        }
+    }
+
+private:
+    struct TestUpdater final : public AsyncUpdater
+    {
+        explicit TestUpdater (std::function<void()> fn, UpdatePriority p = UpdatePriority::normal)
+            : AsyncUpdater (p), callback (std::move (fn))
+        {}
+
+        ~TestUpdater() override     { cancelPendingUpdate(); }
+        void handleAsyncUpdate() override   { callback(); }
+
+        std::function<void()> callback;
+    };
+
+    // Delivers everything that's in the message queue so far
+    static void dispatchPendingMessages()
+    {
+        bool reachedEnd = false;
+        MessageManager::callAsync ([&reachedEnd] { reachedEnd = true; });
+
+        while (! reachedEnd)
+            detail::dispatchNextMessageOnSystemQueue (true);
+    }
+};
+
+static AsyncUpdaterTests asyncUpdaterTests;
+
+#endif
+
 } // namespace juce
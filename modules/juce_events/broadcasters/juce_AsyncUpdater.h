@@ -45,15 +45,39 @@ namespace juce
     Basically, one or more calls to the triggerAsyncUpdate() will result in the
     message thread calling handleAsyncUpdate() as soon as it can.
 
+    Rather than each AsyncUpdater posting its own message, the updaters that have been
+    triggered are collected together and called back in batches from a single message.
+    An updater only joins a batch if no other messages have been posted since the batch
+    was, so it's never called back before a message that was posted before it was
+    triggered. Within a batch, updaters are called in the order in which they were triggered, with
+    higher priority updaters first (see setAsyncUpdatePriority()). If a batch runs for
+    longer than its time budget (see setBatchTimeBudget()), the remaining updaters are
+    left for a later message so that the message thread can deal with other events.
+    Any updates that are still waiting when the MessageManager is deleted are cancelled.
+
     @tags{Events}
 */
 class JUCE_API  AsyncUpdater
 {
 public:
     //==============================================================================
+    /** The priority classes used when delivering a batch of async updates.
+
+        @see setAsyncUpdatePriority
+    */
+    enum class UpdatePriority
+    {
+        high,     /**< Called before any other updaters, and always in the next batch, however long it takes. */
+        normal,   /**< The default priority. */
+        low       /**< Called after the high and normal priority updaters in a batch. */
+    };
+
     /** Creates an AsyncUpdater object. */
     AsyncUpdater();
 
+    /** Creates an AsyncUpdater object with the given priority. */
+    explicit AsyncUpdater (UpdatePriority priority);
+
     /** Destructor.
         If there are any pending callbacks when the object is deleted, these are lost.
     */
@@ -70,7 +94,7 @@ public:
         this method will have no effect.
 
         It's thread-safe to call this method from any thread, BUT beware of calling
-        it from a real-time (e.g. audio) thread, because it involves posting a message
+        it from a real-time (e.g. audio) thread, because it may involve posting a message
         to the system queue, which means it may block (and in general will do on
         most OSes).
     */
@@ -102,6 +126,24 @@ public:
     /** Returns true if there's an update callback in the pipeline. */
     bool isUpdatePending() const noexcept;
 
+    //==============================================================================
+    /** Changes the priority with which this updater's callbacks are delivered.
+
+        If an update is already pending, the change will take effect from the next
+        time the update is triggered.
+    */
+    void setAsyncUpdatePriority (UpdatePriority newPriority) noexcept;
+
+    /** Returns the priority with which this updater's callbacks are delivered. */
+    UpdatePriority getAsyncUpdatePriority() const noexcept;
+
+    /** Sets how long the message thread may spend delivering a batch of updates before
+        any normal or low priority updaters that are left get deferred to a later message.
+
+        High priority updaters are always delivered in full. The default is 8 milliseconds.
+    */
+    static void JUCE_CALLTYPE setBatchTimeBudget (int milliseconds) noexcept;
+
     //==============================================================================
     /** Called back to do whatever your class needs to do.
 
@@ -113,7 +155,13 @@ public:
 private:
     //==============================================================================
     class AsyncUpdaterMessage;
+    class Dispatcher;
     friend class ReferenceCountedObjectPtr<AsyncUpdaterMessage>;
+    friend class MessageManager;
+
+    // Called when the MessageManager is deleted, taking with it any batch that was waiting to be delivered
+    static void cancelAllPendingUpdates();
+
     ReferenceCountedObjectPtr<AsyncUpdaterMessage> activeMessage;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncUpdater)
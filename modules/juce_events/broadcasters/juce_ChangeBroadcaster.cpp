@@ -94,6 +94,11 @@ void ChangeBroadcaster::dispatchPendingMessages()
     broadcastCallback.handleUpdateNowIfNeeded();
 }
 
+void ChangeBroadcaster::setChangeMessagePriority (AsyncUpdater::UpdatePriority newPriority) noexcept
+{
+    broadcastCallback.setAsyncUpdatePriority (newPriority);
+}
+
 void ChangeBroadcaster::callListeners()
 {
     changeListeners.call ([this] (ChangeListener& l) { l.changeListenerCallback (this); });
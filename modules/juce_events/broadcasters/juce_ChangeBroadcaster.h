@@ -92,6 +92,13 @@ public:
     */
     void dispatchPendingMessages();
 
+    /** Sets the priority with which asynchronous change messages are delivered,
+        relative to other change messages and AsyncUpdater callbacks.
+
+        @see AsyncUpdater::setAsyncUpdatePriority
+    */
+    void setChangeMessagePriority (AsyncUpdater::UpdatePriority newPriority) noexcept;
+
 private:
     //==============================================================================
     class ChangeBroadcasterCallback  : public AsyncUpdater
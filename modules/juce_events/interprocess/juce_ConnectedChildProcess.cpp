@@ -47,6 +47,14 @@ static bool isMessageType (const MemoryBlock& mb, const char* messageType) noexc
     return mb.matches (messageType, (size_t) specialMessageSize);
 }
 
+static bool isMessageType (const void* data, size_t numBytes, const char* messageType) noexcept
+{
+    return numBytes == (size_t) specialMessageSize && memcmp (data, messageType, (size_t) specialMessageSize) == 0;
+}
+
+// Connection names that start with this character refer to a shared memory region rather than a pipe
+static constexpr juce_wchar sharedMemoryNamePrefix = 's';
+
 static String getCommandLinePrefix (const String& commandLineUniqueID)
 {
     return "--" + commandLineUniqueID + ":";
@@ -101,12 +109,11 @@ private:
 struct ChildProcessCoordinator::Connection final : public InterprocessConnection,
                                                    private ChildProcessPingThread
 {
-    Connection (ChildProcessCoordinator& m, const String& pipeName, int timeout)
+    Connection (ChildProcessCoordinator& m, int timeout)
         : InterprocessConnection (false, Thread::Priority::normal, magicCoordWorkerConnectionHeader),
           ChildProcessPingThread (timeout),
           owner (m)
     {
-        createPipe (pipeName, timeoutMs);
     }
 
     ~Connection() override
@@ -117,6 +124,14 @@ struct ChildProcessCoordinator::Connection final : public InterprocessConnection
 
     using ChildProcessPingThread::startPinging;
 
+    void create (const String& pipeName, int sharedMemoryBufferSize)
+    {
+        if (pipeName.startsWithChar (sharedMemoryNamePrefix))
+            createSharedMemory (pipeName, sharedMemoryBufferSize, timeoutMs, true);
+        else
+            createPipe (pipeName, timeoutMs);
+    }
+
 private:
     void connectionMade() override  {}
     void connectionLost() override  { owner.handleConnectionLost(); }
@@ -132,6 +147,14 @@ private:
             owner.handleMessageFromWorker (m);
     }
 
+    void sharedMemoryMessageReceived (const void* data, size_t numBytes) override
+    {
+        pingReceived();
+
+        if (! isMessageType (data, numBytes, pingMessage))
+            owner.handleSharedMemoryMessageFromWorker (data, numBytes);
+    }
+
     ChildProcessCoordinator& owner;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Connection)
@@ -154,6 +177,11 @@ void ChildProcessCoordinator::handleMessageFromWorker (const MemoryBlock& mb)
     JUCE_END_IGNORE_DEPRECATION_WARNINGS
 }
 
+void ChildProcessCoordinator::handleSharedMemoryMessageFromWorker (const void* data, size_t numBytes)
+{
+    handleMessageFromWorker (MemoryBlock (data, numBytes));
+}
+
 bool ChildProcessCoordinator::sendMessageToWorker (const MemoryBlock& mb)
 {
     if (connection != nullptr)
@@ -168,7 +196,9 @@ bool ChildProcessCoordinator::launchWorkerProcess (const File& executable, const
 {
     killWorkerProcess();
 
-    auto pipeName = "p" + String::toHexString (Random().nextInt64());
+    const auto useSharedMemory = sharedMemoryBufferSize > 0 && InterprocessConnection::isSharedMemoryAvailable();
+    auto pipeName = String::charToString (useSharedMemory ? sharedMemoryNamePrefix : 'p')
+                      + String::toHexString (Random().nextInt64());
 
     StringArray args;
     args.add (executable.getFullPathName());
@@ -189,7 +219,10 @@ bool ChildProcessCoordinator::launchWorkerProcess (const File& executable, const
 
     if (childProcess != nullptr)
     {
-        connection.reset (new Connection (*this, pipeName, timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs));
+        // The connection must be in place before it's opened, because messages may arrive
+        // (and handlers may reply to them) as soon as it is
+        connection.reset (new Connection (*this, timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs));
+        connection->create (pipeName, sharedMemoryBufferSize);
 
         if (connection->isConnected())
         {
@@ -220,12 +253,11 @@ void ChildProcessCoordinator::killWorkerProcess()
 struct ChildProcessWorker::Connection final : public InterprocessConnection,
                                               private ChildProcessPingThread
 {
-    Connection (ChildProcessWorker& p, const String& pipeName, int timeout)
+    Connection (ChildProcessWorker& p, int timeout)
         : InterprocessConnection (false, Thread::Priority::normal, magicCoordWorkerConnectionHeader),
           ChildProcessPingThread (timeout),
           owner (p)
     {
-        connectToPipe (pipeName, timeoutMs);
     }
 
     ~Connection() override
@@ -237,6 +269,14 @@ struct ChildProcessWorker::Connection final : public InterprocessConnection,
 
     using ChildProcessPingThread::startPinging;
 
+    void connect (const String& pipeName)
+    {
+        if (pipeName.startsWithChar (sharedMemoryNamePrefix))
+            connectToSharedMemory (pipeName, timeoutMs);
+        else
+            connectToPipe (pipeName, timeoutMs);
+    }
+
 private:
     ChildProcessWorker& owner;
 
@@ -262,6 +302,22 @@ private:
         owner.handleMessageFromCoordinator (m);
     }
 
+    void sharedMemoryMessageReceived (const void* data, size_t numBytes) override
+    {
+        pingReceived();
+
+        if (isMessageType (data, numBytes, pingMessage))
+            return;
+
+        if (isMessageType (data, numBytes, killMessage))
+            return triggerConnectionLostMessage();
+
+        if (isMessageType (data, numBytes, startMessage))
+            return owner.handleConnectionMade();
+
+        owner.handleSharedMemoryMessageFromCoordinator (data, numBytes);
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Connection)
 };
 
@@ -279,6 +335,11 @@ void ChildProcessWorker::handleMessageFromCoordinator (const MemoryBlock& mb)
     JUCE_END_IGNORE_DEPRECATION_WARNINGS
 }
 
+void ChildProcessWorker::handleSharedMemoryMessageFromCoordinator (const void* data, size_t numBytes)
+{
+    handleMessageFromCoordinator (MemoryBlock (data, numBytes));
+}
+
 bool ChildProcessWorker::sendMessageToCoordinator (const MemoryBlock& mb)
 {
     if (connection != nullptr)
@@ -301,7 +362,10 @@ bool ChildProcessWorker::initialiseFromCommandLine (const String& commandLine,
 
         if (pipeName.isNotEmpty())
         {
-            connection.reset (new Connection (*this, pipeName, timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs));
+            // Messages from the coordinator may already be waiting in a shared memory buffer,
+            // so the connection must be in place before it starts delivering them
+            connection.reset (new Connection (*this, timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs));
+            connection->connect (pipeName);
 
             if (connection->isConnected())
                 connection->startPinging();
@@ -98,6 +98,16 @@ public:
     [[deprecated ("Replaced by handleMessageFromCoordinator.")]]
     virtual void handleMessageFromMaster (const MemoryBlock&) {}
 
+    /** If the coordinator launched this worker with a shared memory connection, this is called
+        instead of handleMessageFromCoordinator(), with a pointer to the message in the shared region.
+
+        The data is only valid until this method returns. The default implementation copies
+        it into a MemoryBlock and calls handleMessageFromCoordinator().
+
+        @see ChildProcessCoordinator::setSharedMemoryBufferSize
+    */
+    virtual void handleSharedMemoryMessageFromCoordinator (const void* data, size_t numBytes);
+
     /** This will be called when the coordinator process finishes connecting to this worker.
         The call will probably be made on a background thread, so be careful with your thread-safety!
     */
@@ -195,6 +205,17 @@ public:
         return launchWorkerProcess (executableToLaunch, commandLineUniqueID, timeoutMs, streamFlags);
     }
 
+    /** Makes subsequent calls to launchWorkerProcess() connect to the worker through
+        shared memory rather than a named pipe.
+
+        If numBytes is greater than zero and InterprocessConnection::isSharedMemoryAvailable()
+        returns true, the connection will use a ring buffer of this size in each direction (see
+        InterprocessConnection::createSharedMemory()). The worker will find out about this
+        from its command line, so it doesn't need to be told separately. Passing 0 goes back
+        to using a named pipe.
+    */
+    void setSharedMemoryBufferSize (int numBytes) noexcept      { sharedMemoryBufferSize = numBytes; }
+
     /** Sends a kill message to the worker, and disconnects from it.
         Note that this won't wait for it to terminate.
     */
@@ -211,6 +232,16 @@ public:
     [[deprecated ("Replaced by handleMessageFromWorker")]]
     virtual void handleMessageFromSlave (const MemoryBlock&) {}
 
+    /** If the worker was launched with a shared memory connection, this is called instead
+        of handleMessageFromWorker(), with a pointer to the message in the shared region.
+
+        The data is only valid until this method returns. The default implementation copies
+        it into a MemoryBlock and calls handleMessageFromWorker().
+
+        @see setSharedMemoryBufferSize
+    */
+    virtual void handleSharedMemoryMessageFromWorker (const void* data, size_t numBytes);
+
     /** This will be called when the worker process dies or is somehow disconnected.
         The call will probably be made on a background thread, so be careful with your thread-safety!
     */
@@ -228,6 +259,7 @@ public:
 
 private:
     std::shared_ptr<ChildProcess> childProcess;
+    int sharedMemoryBufferSize = 0;
 
     struct Connection;
     std::unique_ptr<Connection> connection;
@@ -82,6 +82,27 @@ class InterprocessConnection::SafeAction final : public SafeActionImpl
     using SafeActionImpl::SafeActionImpl;
 };
 
+#if ! JUCE_LINUX
+// Shared memory connections aren't implemented on this platform yet, so this just fails to open.
+class InterprocessConnection::SharedMemoryChannel
+{
+public:
+    static std::unique_ptr<SharedMemoryChannel> create (const String&, int, uint32, bool)    { return {}; }
+    static std::unique_ptr<SharedMemoryChannel> open (const String&, uint32, int)            { return {}; }
+
+    void close() {}
+    bool isOpen() const noexcept                                    { return false; }
+    size_t getMaxInPlaceMessageSize() const noexcept                { return 0; }
+    bool write (const void*, size_t, int)                           { return false; }
+
+    template <typename WriteFn>
+    bool writeInPlace (size_t, int, WriteFn&&)                      { return false; }
+
+    template <typename DeliverFn>
+    int read (int, DeliverFn&&)                                     { return -1; }
+};
+#endif
+
 //==============================================================================
 InterprocessConnection::InterprocessConnection (bool callbacksOnMessageThread, Thread::Priority threadPrio, uint32 magicMessageHeaderNumber)
     : useMessageThread (callbacksOnMessageThread),
@@ -158,6 +179,45 @@ bool InterprocessConnection::createPipe (const String& pipeName, int timeoutMs,
     return false;
 }
 
+bool InterprocessConnection::createSharedMemory (const String& name, int bufferSizeBytes, int timeoutMs, bool mustNotExist)
+{
+    disconnect();
+
+    if (auto channel = SharedMemoryChannel::create (name, bufferSizeBytes, magicMessageHeader, mustNotExist))
+    {
+        const ScopedWriteLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = timeoutMs;
+        initialiseWithSharedMemory (std::move (channel));
+        return true;
+    }
+
+    return false;
+}
+
+bool InterprocessConnection::connectToSharedMemory (const String& name, int timeoutMs)
+{
+    disconnect();
+
+    if (auto channel = SharedMemoryChannel::open (name, magicMessageHeader, timeoutMs))
+    {
+        const ScopedWriteLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = timeoutMs;
+        initialiseWithSharedMemory (std::move (channel));
+        return true;
+    }
+
+    return false;
+}
+
+bool InterprocessConnection::isSharedMemoryAvailable() noexcept
+{
+   #if JUCE_LINUX
+    return true;
+   #else
+    return false;
+   #endif
+}
+
 void InterprocessConnection::disconnect (int timeoutMs, Notify notify)
 {
     thread->signalThreadShouldExit();
@@ -166,6 +226,7 @@ void InterprocessConnection::disconnect (int timeoutMs, Notify notify)
         const ScopedReadLock sl (pipeAndSocketLock);
         if (socket != nullptr)  socket->close();
         if (pipe != nullptr)    pipe->close();
+        if (sharedMemory != nullptr)  sharedMemory->close();
     }
 
     thread->stopThread (timeoutMs);
@@ -183,6 +244,7 @@ void InterprocessConnection::deletePipeAndSocket()
     const ScopedWriteLock sl (pipeAndSocketLock);
     socket.reset();
     pipe.reset();
+    sharedMemory.reset();
 }
 
 bool InterprocessConnection::isConnected() const
@@ -190,7 +252,8 @@ bool InterprocessConnection::isConnected() const
     const ScopedReadLock sl (pipeAndSocketLock);
 
     return ((socket != nullptr && socket->isConnected())
-              || (pipe != nullptr && pipe->isOpen()))
+              || (pipe != nullptr && pipe->isOpen())
+              || (sharedMemory != nullptr && sharedMemory->isOpen()))
             && threadIsRunning;
 }
 
@@ -199,7 +262,7 @@ String InterprocessConnection::getConnectedHostName() const
     {
         const ScopedReadLock sl (pipeAndSocketLock);
 
-        if (pipe == nullptr && socket == nullptr)
+        if (pipe == nullptr && socket == nullptr && sharedMemory == nullptr)
             return {};
 
         if (socket != nullptr && ! socket->isLocal())
@@ -212,6 +275,13 @@ String InterprocessConnection::getConnectedHostName() const
 //==============================================================================
 bool InterprocessConnection::sendMessage (const MemoryBlock& message)
 {
+    {
+        const ScopedReadLock sl (pipeAndSocketLock);
+
+        if (sharedMemory != nullptr)
+            return sharedMemory->write (message.getData(), message.getSize(), pipeReceiveMessageTimeout);
+    }
+
     uint32 messageHeader[2] = { ByteOrder::swapIfBigEndian (magicMessageHeader),
                                 ByteOrder::swapIfBigEndian ((uint32) message.getSize()) };
 
@@ -222,6 +292,21 @@ bool InterprocessConnection::sendMessage (const MemoryBlock& message)
     return writeData (messageData.getData(), (int) messageData.getSize()) == (int) messageData.getSize();
 }
 
+bool InterprocessConnection::sendMessageInPlaceInt (size_t numBytes, void (*writeMessage) (void*, void*), void* context)
+{
+    {
+        const ScopedReadLock sl (pipeAndSocketLock);
+
+        if (sharedMemory != nullptr && numBytes <= sharedMemory->getMaxInPlaceMessageSize())
+            return sharedMemory->writeInPlace (numBytes, pipeReceiveMessageTimeout,
+                                               [=] (void* dest) { writeMessage (context, dest); });
+    }
+
+    MemoryBlock message (numBytes);
+    writeMessage (context, message.getData());
+    return sendMessage (message);
+}
+
 int InterprocessConnection::writeData (void* data, int dataSize)
 {
     const ScopedReadLock sl (pipeAndSocketLock);
@@ -246,18 +331,25 @@ void InterprocessConnection::initialise()
 
 void InterprocessConnection::initialiseWithSocket (std::unique_ptr<StreamingSocket> newSocket)
 {
-    jassert (socket == nullptr && pipe == nullptr);
+    jassert (socket == nullptr && pipe == nullptr && sharedMemory == nullptr);
     socket = std::move (newSocket);
     initialise();
 }
 
 void InterprocessConnection::initialiseWithPipe (std::unique_ptr<NamedPipe> newPipe)
 {
-    jassert (socket == nullptr && pipe == nullptr);
+    jassert (socket == nullptr && pipe == nullptr && sharedMemory == nullptr);
     pipe = std::move (newPipe);
     initialise();
 }
 
+void InterprocessConnection::initialiseWithSharedMemory (std::unique_ptr<SharedMemoryChannel> newChannel)
+{
+    jassert (socket == nullptr && pipe == nullptr && sharedMemory == nullptr);
+    sharedMemory = std::move (newChannel);
+    initialise();
+}
+
 //==============================================================================
 struct ConnectionStateMessage final : public MessageManager::MessageBase
 {
@@ -310,20 +402,24 @@ void InterprocessConnection::connectionLostInt()
 
 struct DataDeliveryMessage final : public Message
 {
-    DataDeliveryMessage (std::shared_ptr<SafeActionImpl> ipc, const MemoryBlock& d)
-        : safeAction (ipc), data (d)
+    DataDeliveryMessage (std::shared_ptr<SafeActionImpl> ipc, const MemoryBlock& d, bool fromSharedMemory = false)
+        : safeAction (ipc), data (d), isFromSharedMemory (fromSharedMemory)
     {}
 
     void messageCallback() override
     {
         safeAction->ifSafe ([this] (InterprocessConnection& owner)
         {
-            owner.messageReceived (data);
+            if (isFromSharedMemory)
+                owner.sharedMemoryMessageReceived (data.getData(), data.getSize());
+            else
+                owner.messageReceived (data);
         });
     }
 
     std::shared_ptr<SafeActionImpl> safeAction;
     MemoryBlock data;
+    bool isFromSharedMemory;
 };
 
 void InterprocessConnection::deliverDataInt (const MemoryBlock& data)
@@ -336,6 +432,21 @@ void InterprocessConnection::deliverDataInt (const MemoryBlock& data)
         messageReceived (data);
 }
 
+void InterprocessConnection::deliverSharedMemoryDataInt (const void* data, size_t numBytes)
+{
+    jassert (callbackConnectionState);
+
+    if (useMessageThread)
+        (new DataDeliveryMessage (safeAction, MemoryBlock (data, numBytes), true))->post();
+    else
+        sharedMemoryMessageReceived (data, numBytes);
+}
+
+void InterprocessConnection::sharedMemoryMessageReceived (const void* data, size_t numBytes)
+{
+    messageReceived (MemoryBlock (data, numBytes));
+}
+
 //==============================================================================
 int InterprocessConnection::readData (void* data, int num)
 {
@@ -399,6 +510,28 @@ bool InterprocessConnection::readNextMessage()
     return false;
 }
 
+bool InterprocessConnection::readNextSharedMemoryMessage()
+{
+    // No lock is needed here, because the channel is only deleted by this thread
+    // or by disconnect(), after it has stopped this thread.
+    const auto result = sharedMemory->read (100, [this] (const void* data, size_t numBytes)
+    {
+        deliverSharedMemoryDataInt (data, numBytes);
+    });
+
+    if (result < 0)
+    {
+        if (thread->threadShouldExit())
+            return false;
+
+        deletePipeAndSocket();
+        connectionLostInt();
+        return false;
+    }
+
+    return true;
+}
+
 void InterprocessConnection::runThread()
 {
     while (! thread->threadShouldExit())
@@ -429,6 +562,13 @@ void InterprocessConnection::runThread()
                 break;
             }
         }
+        else if (sharedMemory != nullptr)
+        {
+            if (thread->threadShouldExit() || ! readNextSharedMemoryMessage())
+                break;
+
+            continue;
+        }
         else
         {
             break;
@@ -441,4 +581,185 @@ void InterprocessConnection::runThread()
     threadIsRunning = false;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_LINUX
+
+class SharedMemoryConnectionTests final : public UnitTest
+{
+public:
+    SharedMemoryConnectionTests()
+        : UnitTest ("InterprocessConnection shared memory", UnitTestCategories::networking)
+    {}
+
+    void runTest() override
+    {
+        Random random = getRandom();
+
+        beginTest ("Messages arrive intact and in order in both directions");
+        {
+            TestConnectionPair pair (*this);
+
+            for (auto [from, to] : { std::pair { &pair.creator, &pair.connector },
+                                     std::pair { &pair.connector, &pair.creator } })
+            {
+                std::vector<MemoryBlock> sent;
+
+                for (int i = 0; i < 200; ++i)
+                    sent.push_back (createRandomBlock (random, 1 + random.nextInt (100)));
+
+                for (auto& block : sent)
+                    expect (from->sendMessage (block));
+
+                expect (to->waitForMessages (sent.size()));
+                expect (to->takeMessages() == sent);
+            }
+        }
+
+        beginTest ("Messages wrap around the end of the ring");
+        {
+            TestConnectionPair pair (*this);
+            std::vector<MemoryBlock> sent;
+
+            // These don't fit exactly into the ring, so the writer has to pad the end of it
+            for (int i = 0; i < 50; ++i)
+                sent.push_back (createRandomBlock (random, 1000 + (i % 7) * 13));
+
+            for (auto& block : sent)
+            {
+                if (block.getSize() % 2 == 0)
+                    expect (pair.creator.sendMessage (block));
+                else
+                    expect (pair.creator.sendMessageInPlace (block.getSize(), [&block] (void* dest)
+                    {
+                        block.copyTo (dest, 0, block.getSize());
+                    }));
+            }
+
+            expect (pair.connector.waitForMessages (sent.size()));
+            expect (pair.connector.takeMessages() == sent);
+        }
+
+        beginTest ("Messages larger than the ring are split up and put back together");
+        {
+            TestConnectionPair pair (*this);
+            std::vector<MemoryBlock> sent;
+
+            for (auto size : { 2040, 2041, 4096, 10000, 3, 100000, 5000 })
+                sent.push_back (createRandomBlock (random, size));
+
+            for (auto& block : sent)
+                expect (pair.creator.sendMessage (block));
+
+            expect (pair.connector.waitForMessages (sent.size()));
+            expect (pair.connector.takeMessages() == sent);
+        }
+
+        beginTest ("Messages delivered on the message thread go to sharedMemoryMessageReceived");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+            TestConnectionPair pair (*this, true);
+
+            const auto block = createRandomBlock (random, 500);
+            expect (pair.creator.sendMessage (block));
+
+            const auto endTime = Time::getMillisecondCounter() + 5000;
+
+            while (pair.connector.getNumMessages() == 0 && Time::getMillisecondCounter() < endTime)
+                if (! detail::dispatchNextMessageOnSystemQueue (true))
+                    Thread::sleep (1);
+
+            expect (pair.connector.takeMessages() == std::vector<MemoryBlock> { block });
+            expectEquals (pair.connector.numMessageReceivedCalls.load(), 0);
+        }
+
+        beginTest ("Closing one end is noticed by the other");
+        {
+            TestConnectionPair pair (*this);
+            expect (pair.connector.isConnected());
+
+            pair.creator.disconnect();
+
+            expect (pair.connector.lost.wait (5000));
+            expect (! pair.connector.isConnected());
+            expect (! pair.connector.sendMessage (createRandomBlock (random, 10)));
+        }
+    }
+
+private:
+    struct TestConnection final : public InterprocessConnection
+    {
+        explicit TestConnection (bool callbacksOnMessageThread)
+            : InterprocessConnection (callbacksOnMessageThread)
+        {}
+
+        ~TestConnection() override
+        {
+            disconnect();
+        }
+
+        void connectionMade() override {}
+        void connectionLost() override                          { lost.signal(); }
+        void messageReceived (const MemoryBlock&) override      { ++numMessageReceivedCalls; }
+
+        void sharedMemoryMessageReceived (const void* data, size_t numBytes) override
+        {
+            const ScopedLock sl (lock);
+            messages.emplace_back (data, numBytes);
+        }
+
+        size_t getNumMessages() const
+        {
+            const ScopedLock sl (lock);
+            return messages.size();
+        }
+
+        bool waitForMessages (size_t num)
+        {
+            for (int i = 0; i < 1000 && getNumMessages() < num; ++i)
+                Thread::sleep (5);
+
+            return getNumMessages() == num;
+        }
+
+        std::vector<MemoryBlock> takeMessages()
+        {
+            const ScopedLock sl (lock);
+            return std::exchange (messages, {});
+        }
+
+        CriticalSection lock;
+        std::vector<MemoryBlock> messages;
+        std::atomic<int> numMessageReceivedCalls { 0 };
+        WaitableEvent lost;
+    };
+
+    struct TestConnectionPair
+    {
+        TestConnectionPair (UnitTest& test, bool callbacksOnMessageThread = false)
+            : creator (callbacksOnMessageThread), connector (callbacksOnMessageThread)
+        {
+            const auto name = "SharedMemoryTest" + String ((int) getpid()) + "_" + String (++counter);
+
+            test.expect (creator.createSharedMemory (name, 4096, 5000, true));
+            test.expect (connector.connectToSharedMemory (name, 5000));
+            test.expect (creator.isUsingSharedMemory() && connector.isUsingSharedMemory());
+        }
+
+        TestConnection creator, connector;
+        static inline int counter = 0;
+    };
+
+    static MemoryBlock createRandomBlock (Random& random, int size)
+    {
+        MemoryBlock block ((size_t) size);
+        random.fillBitsRandomly (block.getData(), block.getSize());
+        return block;
+    }
+};
+
+static SharedMemoryConnectionTests sharedMemoryConnectionTests;
+
+#endif
+
 } // namespace juce
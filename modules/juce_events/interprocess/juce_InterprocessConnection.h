@@ -41,8 +41,8 @@ class MemoryBlock;
 
 //==============================================================================
 /**
-    Manages a simple two-way messaging connection to another process, using either
-    a socket or a named pipe as the transport medium.
+    Manages a simple two-way messaging connection to another process, using a
+    socket, a named pipe or a block of shared memory as the transport medium.
 
     To connect to a waiting socket or an open pipe, use the connectToSocket() or
     connectToPipe() methods. If this succeeds, messages can be sent to the other end,
@@ -52,6 +52,11 @@ class MemoryBlock;
     To open a pipe and wait for another client to connect to it, use the createPipe()
     method.
 
+    For high-throughput connections between processes on the same machine, createSharedMemory()
+    and connectToSharedMemory() can be used instead of pipes. Messages are then passed through
+    ring buffers in a shared memory region, and can be read and written in place using
+    sharedMemoryMessageReceived() and sendMessageInPlace().
+
     To act as a socket server and create connections for one or more client, see the
     InterprocessConnectionServer class.
 
@@ -133,6 +138,43 @@ public:
     */
     bool createPipe (const String& pipeName, int pipeReceiveMessageTimeoutMs, bool mustNotExist = false);
 
+    /** Tries to create a shared memory region for another process to connect to.
+
+        This creates a region with the given name, containing a ring buffer of the given size
+        for each direction, so that another process on the same computer can use
+        connectToSharedMemory() to connect to it. Messages sent before the other end has
+        connected are kept in the buffer until it does.
+
+        This is currently only available on Linux, and will return false on other platforms
+        (see isSharedMemoryAvailable()).
+
+        @param name             the name to use for the region - this should be unique to your app
+        @param bufferSizeBytes  the size of each ring buffer. This will be rounded up to a power of two.
+                                Messages larger than half this size can still be sent, but they'll be
+                                split up and must be copied back together at the other end
+        @param timeoutMs        how long sendMessage() may wait for space in a full buffer, or -1 to
+                                wait until there is space
+        @param mustNotExist     if set to true, the method will fail if a region with this name already exists
+        @returns true if the region was created
+    */
+    bool createSharedMemory (const String& name, int bufferSizeBytes, int timeoutMs, bool mustNotExist = false);
+
+    /** Tries to connect to a shared memory region created by another process with createSharedMemory().
+
+        If the region doesn't exist yet, this will keep trying until the timeout expires. Once
+        it has connected, the region's name is removed, so no other process can connect to it.
+
+        @param name         the name that was passed to createSharedMemory()
+        @param timeoutMs    how long to wait for the region to appear, which is also used as the
+                            time that sendMessage() may wait for space in a full buffer
+        @returns true if it connects successfully
+        @see createSharedMemory
+    */
+    bool connectToSharedMemory (const String& name, int timeoutMs);
+
+    /** Returns true if createSharedMemory() and connectToSharedMemory() are available on this platform. */
+    static bool isSharedMemoryAvailable() noexcept;
+
     /** Whether the disconnect call should trigger callbacks. */
     enum class Notify { no, yes };
 
@@ -146,7 +188,7 @@ public:
     */
     void disconnect (int timeoutMs = -1, Notify notify = Notify::yes);
 
-    /** True if a socket or pipe is currently active. */
+    /** True if a socket, pipe or shared memory region is currently active. */
     bool isConnected() const;
 
     /** Returns the socket that this connection is using (or nullptr if it uses a pipe). */
@@ -155,6 +197,9 @@ public:
     /** Returns the pipe that this connection is using (or nullptr if it uses a socket). */
     NamedPipe* getPipe() const noexcept                         { return pipe.get(); }
 
+    /** Returns true if this connection is using a shared memory region. */
+    bool isUsingSharedMemory() const noexcept                   { return sharedMemory != nullptr; }
+
     /** Returns the name of the machine at the other end of this connection.
         This may return an empty string if the name is unknown.
     */
@@ -171,6 +216,26 @@ public:
     */
     bool sendMessage (const MemoryBlock& message);
 
+    /** Sends a message by letting the caller write it directly into the connection's buffer.
+
+        The writeMessage function is called with a void* pointing to numBytes of space,
+        which it must fill with the message. When the connection is using shared memory and
+        the message fits in one piece, this space is inside the shared region, so the data
+        doesn't need to be assembled anywhere else first. Otherwise, it's written into a
+        temporary block which is then sent with sendMessage().
+
+        @see sendMessage, sharedMemoryMessageReceived
+    */
+    template <typename WriteFn>
+    bool sendMessageInPlace (size_t numBytes, WriteFn&& writeMessage)
+    {
+        return sendMessageInPlaceInt (numBytes, [] (void* context, void* dest)
+                                      {
+                                          (*static_cast<std::remove_reference_t<WriteFn>*> (context)) (dest);
+                                      },
+                                      std::addressof (writeMessage));
+    }
+
     //==============================================================================
     /** Called when the connection is first connected.
 
@@ -201,12 +266,28 @@ public:
     */
     virtual void messageReceived (const MemoryBlock& message) = 0;
 
+    /** Called instead of messageReceived() when a message arrives over a shared memory connection.
+
+        If the connection was created with the callbacksOnMessageThread flag set to false,
+        the data pointer refers directly to the message in the shared region, and is only
+        valid until this method returns - the other end can't reuse that space until then,
+        so don't hold on to it for long. When callbacks are made on the message thread, the
+        message has to be copied so that it can be posted, and this will get a pointer to
+        the copy instead.
+
+        The default implementation copies the data into a MemoryBlock and calls messageReceived().
+
+        @see messageReceived, sendMessageInPlace
+    */
+    virtual void sharedMemoryMessageReceived (const void* data, size_t numBytes);
 
 private:
     //==============================================================================
     ReadWriteLock pipeAndSocketLock;
     std::unique_ptr<StreamingSocket> socket;
     std::unique_ptr<NamedPipe> pipe;
+    class SharedMemoryChannel;
+    std::unique_ptr<SharedMemoryChannel> sharedMemory;
     bool callbackConnectionState = false;
     const bool useMessageThread;
     const uint32 magicMessageHeader;
@@ -216,11 +297,15 @@ private:
     void initialise();
     void initialiseWithSocket (std::unique_ptr<StreamingSocket>);
     void initialiseWithPipe (std::unique_ptr<NamedPipe>);
+    void initialiseWithSharedMemory (std::unique_ptr<SharedMemoryChannel>);
     void deletePipeAndSocket();
     void connectionMadeInt();
     void connectionLostInt();
     void deliverDataInt (const MemoryBlock&);
+    void deliverSharedMemoryDataInt (const void*, size_t);
     bool readNextMessage();
+    bool readNextSharedMemoryMessage();
+    bool sendMessageInPlaceInt (size_t, void (*) (void*, void*), void*);
     int readData (void*, int);
 
     struct ConnectionThread;
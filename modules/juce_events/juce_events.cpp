@@ -63,6 +63,11 @@
 
 #elif JUCE_LINUX || JUCE_BSD
  #include <unistd.h>
+
+ #if JUCE_LINUX
+  #include <sys/epoll.h>
+  #include <linux/futex.h>
+ #endif
 #endif
 
 //==============================================================================
@@ -76,6 +81,11 @@
 #include "broadcasters/juce_ChangeBroadcaster.cpp"
 #include "timers/juce_MultiTimer.cpp"
 #include "timers/juce_Timer.cpp"
+
+#if JUCE_LINUX
+ #include "native/juce_SharedMemoryChannel_linux.h"
+#endif
+
 #include "interprocess/juce_ChildProcessManager.cpp"
 #include "interprocess/juce_InterprocessConnection.cpp"
 #include "interprocess/juce_InterprocessConnectionServer.cpp"
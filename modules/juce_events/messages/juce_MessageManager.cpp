@@ -49,12 +49,14 @@ MessageManager::~MessageManager() noexcept
     broadcaster.reset();
 
     doPlatformSpecificShutdown();
+    AsyncUpdater::cancelAllPendingUpdates();
 
     jassert (instance == this);
     instance = nullptr;  // do this last in case this instance is still needed by doPlatformSpecificShutdown()
 }
 
 MessageManager* MessageManager::instance = nullptr;
+std::atomic<uint64> MessageManager::numMessagesPosted { 0 };
 
 MessageManager* MessageManager::getInstance()
 {
@@ -88,6 +90,8 @@ bool MessageManager::MessageBase::post()
         return false;
     }
 
+    // (counted once it is in the queue, so that AsyncUpdater can tell whether anything was posted after its own message)
+    numMessagesPosted.fetch_add (1, std::memory_order_acq_rel);
     return true;
 }
 
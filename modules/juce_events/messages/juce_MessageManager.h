@@ -201,6 +201,16 @@ public:
 
         using Ptr = ReferenceCountedObjectPtr<MessageBase>;
 
+    private:
+       #if JUCE_LINUX || JUCE_BSD
+        friend class InternalMessageQueue;
+
+        // Used by the Linux message queue, which links pending messages together without allocating
+        std::atomic<MessageBase*> nextQueuedMessage { nullptr };
+        std::atomic<bool> isQueued { false };
+        int64 timePosted = 0;
+       #endif
+
         JUCE_DECLARE_NON_COPYABLE (MessageBase)
     };
 
@@ -333,6 +343,9 @@ public:
     // Internal methods - do not use!
     void deliverBroadcastMessage (const String&);
     ~MessageManager() noexcept;
+
+    // The number of messages that have been successfully posted so far
+    static uint64 getNumMessagesPosted() noexcept   { return numMessagesPosted.load (std::memory_order_acquire); }
    #endif
 
 private:
@@ -340,6 +353,7 @@ private:
     MessageManager() noexcept;
 
     static MessageManager* instance;
+    static std::atomic<uint64> numMessagesPosted;
 
     friend class MessageBase;
     class QuitMessage;
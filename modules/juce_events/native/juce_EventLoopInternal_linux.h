@@ -62,6 +62,14 @@ struct LinuxEventLoopInternal
     static void invokeEventLoopCallbackForFd (int);
     /** @internal */
     static std::vector<int> getRegisteredFds();
+
+    /** @internal
+
+        Like LinuxEventLoop::registerFdCallback(), but on Linux the fd is watched in edge-triggered
+        mode, so the callback will only be called again once new data has arrived. The callback
+        must therefore consume everything that is available each time it is called.
+    */
+    static void registerEdgeTriggeredFdCallback (int fd, std::function<void (int)> readCallback);
 };
 
 } // namespace juce
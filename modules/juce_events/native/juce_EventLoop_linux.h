@@ -56,4 +56,47 @@ namespace juce::LinuxEventLoop
     */
     void unregisterFdCallback (int fd);
 
+    //==============================================================================
+    /** Counters describing the traffic through the message thread's queue.
+
+        These are gathered by MessageManager::postMessageToSystemQueue() and the
+        message thread's dispatch loop, and are intended to help find code that
+        floods the message thread with callAsync() or triggerAsyncUpdate() calls.
+
+        @see getMessageQueueStatistics, resetMessageQueueStatistics
+    */
+    struct MessageQueueStatistics
+    {
+        /** The number of messages that were posted to the queue. */
+        int64 numMessagesPosted = 0;
+
+        /** The number of messages that were taken from the queue and delivered. */
+        int64 numMessagesDispatched = 0;
+
+        /** The number of times a posting thread had to wake the message thread.
+            Messages posted while a wakeup is already pending don't cause another one,
+            so this will normally be much smaller than numMessagesPosted under load.
+        */
+        int64 numWakeups = 0;
+
+        /** The largest number of messages that were waiting in the queue at once. */
+        int maxQueueLength = 0;
+
+        /** The mean time between a message being posted and its callback starting. */
+        double averageLatencySeconds = 0.0;
+
+        /** The longest time between a message being posted and its callback starting. */
+        double maxLatencySeconds = 0.0;
+    };
+
+    /** Returns the counters gathered since the message queue was created, or since
+        the last call to resetMessageQueueStatistics().
+
+        This may be called from any thread.
+    */
+    MessageQueueStatistics getMessageQueueStatistics();
+
+    /** Clears the counters returned by getMessageQueueStatistics(). */
+    void resetMessageQueueStatistics();
+
 } // namespace juce::LinuxEventLoop
@@ -36,93 +36,381 @@ namespace juce
 {
 
 //==============================================================================
+/*
+    Holds the messages that other threads post to the message thread.
+
+    Messages are linked together through MessageBase::nextQueuedMessage, using Dmitry Vyukov's
+    intrusive MPSC queue: posting is a single atomic exchange, so producers never contend on a
+    lock, and only the message thread ever pops.
+
+    The message thread is woken through an eventfd (or a socketpair where eventfd isn't
+    available). Only the first message posted after the message thread has started draining
+    the queue writes to it, so a burst of messages costs a single syscall on each side.
+*/
 class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
     {
-        [[maybe_unused]] auto err = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, msgpipe);
+       #if JUCE_LINUX
+        wakeupFds[0] = wakeupFds[1] = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+        jassert (wakeupFds[0] >= 0);
+       #else
+        [[maybe_unused]] auto err = ::socketpair (AF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0, wakeupFds);
         jassert (err == 0);
+       #endif
 
-        LinuxEventLoop::registerFdCallback (getReadHandle(),
-                                            [this] (int fd)
-                                            {
-                                                while (auto msg = popNextMessage (fd))
-                                                {
-                                                    JUCE_TRY
-                                                    {
-                                                        msg->messageCallback();
-                                                    }
-                                                    JUCE_CATCH_EXCEPTION
-                                                }
-                                            });
+        LinuxEventLoopInternal::registerEdgeTriggeredFdCallback (getReadHandle(), [this] (int) { dispatchPendingMessages(); });
     }
 
     ~InternalMessageQueue()
     {
         LinuxEventLoop::unregisterFdCallback (getReadHandle());
 
+        while (popNextMessage() != nullptr) {}
+
         close (getReadHandle());
-        close (getWriteHandle());
+
+        if (getWriteHandle() != getReadHandle())
+            close (getWriteHandle());
 
         clearSingletonInstance();
     }
 
     //==============================================================================
-    void postMessage (MessageManager::MessageBase* const msg) noexcept
+    void postMessage (MessageManager::MessageBase* msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
-
-        if (bytesInSocket < maxBytesInSocketQueue)
+        // A message can only be linked into the queue once, so if it's posted again before it
+        // has been delivered, we queue a separate message that forwards the callback to it
+        if (msg->isQueued.exchange (true, std::memory_order_acq_rel))
         {
-            bytesInSocket++;
+            msg = new ForwardingMessage (*msg);
+            msg->isQueued.store (true, std::memory_order_relaxed);
+        }
 
-            ScopedUnlock ul (lock);
-            unsigned char x = 0xff;
-            [[maybe_unused]] auto numBytes = write (getWriteHandle(), &x, 1);
+        msg->incReferenceCount();
+        msg->timePosted = Time::getHighResolutionTicks();
+        msg->nextQueuedMessage.store (nullptr, std::memory_order_relaxed);
+
+        // Once this exchange has happened the message is visible to the consumer, as soon as
+        // the previous head has been linked to it
+        auto* previous = head.exchange (msg, std::memory_order_acq_rel);
+        previous->nextQueuedMessage.store (msg, std::memory_order_release);
+
+        const auto queueLength = numQueued.fetch_add (1, std::memory_order_relaxed) + 1;
+        numPosted.fetch_add (1, std::memory_order_relaxed);
+
+        for (auto longest = maxQueueLength.load (std::memory_order_relaxed);
+             queueLength > longest && ! maxQueueLength.compare_exchange_weak (longest, queueLength, std::memory_order_relaxed);)
+        {}
+
+        if (! wakeupPending.exchange (true, std::memory_order_acq_rel))
+        {
+            numWakeups.fetch_add (1, std::memory_order_relaxed);
+            signalWakeup();
         }
     }
 
+    LinuxEventLoop::MessageQueueStatistics getStatistics() const noexcept
+    {
+        LinuxEventLoop::MessageQueueStatistics stats;
+        stats.numMessagesPosted     = numPosted.load (std::memory_order_relaxed);
+        stats.numMessagesDispatched = numDispatched.load (std::memory_order_relaxed);
+        stats.numWakeups            = numWakeups.load (std::memory_order_relaxed);
+        stats.maxQueueLength        = maxQueueLength.load (std::memory_order_relaxed);
+        stats.maxLatencySeconds     = Time::highResolutionTicksToSeconds (maxLatencyTicks.load (std::memory_order_relaxed));
+
+        if (stats.numMessagesDispatched > 0)
+            stats.averageLatencySeconds = Time::highResolutionTicksToSeconds (totalLatencyTicks.load (std::memory_order_relaxed))
+                                            / (double) stats.numMessagesDispatched;
+
+        return stats;
+    }
+
+    void resetStatistics() noexcept
+    {
+        numPosted = 0;
+        numDispatched = 0;
+        numWakeups = 0;
+        maxQueueLength = 0;
+        totalLatencyTicks = 0;
+        maxLatencyTicks = 0;
+    }
+
     //==============================================================================
     JUCE_DECLARE_SINGLETON_INLINE (InternalMessageQueue, false)
 
 private:
-    CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
+    struct StubMessage final : public MessageManager::MessageBase
+    {
+        void messageCallback() override {}
+    };
+
+    struct ForwardingMessage final : public MessageManager::MessageBase
+    {
+        explicit ForwardingMessage (MessageManager::MessageBase& m)  : target (&m) {}
+
+        void messageCallback() override  { target->messageCallback(); }
+
+        MessageManager::MessageBase::Ptr target;
+    };
+
+    StubMessage stub;
+    std::atomic<MessageManager::MessageBase*> head { &stub };
+    MessageManager::MessageBase* tail = &stub;  // only touched by the message thread
 
-    int msgpipe[2];
-    int bytesInSocket = 0;
-    static constexpr int maxBytesInSocketQueue = 128;
+    std::atomic<bool> wakeupPending { false };
+    int wakeupFds[2] = { -1, -1 };
 
-    int getWriteHandle() const noexcept  { return msgpipe[0]; }
-    int getReadHandle() const noexcept   { return msgpipe[1]; }
+    std::atomic<int64> numPosted { 0 }, numDispatched { 0 }, numWakeups { 0 },
+                       totalLatencyTicks { 0 }, maxLatencyTicks { 0 };
+    std::atomic<int> numQueued { 0 }, maxQueueLength { 0 };
 
-    MessageManager::MessageBase::Ptr popNextMessage (int fd) noexcept
+    int getWriteHandle() const noexcept  { return wakeupFds[0]; }
+    int getReadHandle() const noexcept   { return wakeupFds[1]; }
+
+    void signalWakeup() noexcept
     {
-        const ScopedLock sl (lock);
+       #if JUCE_LINUX
+        const uint64_t value = 1;
+       #else
+        const unsigned char value = 0xff;
+       #endif
 
-        if (bytesInSocket > 0)
+        [[maybe_unused]] auto numBytes = write (getWriteHandle(), &value, sizeof (value));
+    }
+
+    void clearWakeup() noexcept
+    {
+       #if JUCE_LINUX
+        uint64_t value;
+        [[maybe_unused]] auto numBytes = read (getReadHandle(), &value, sizeof (value));
+       #else
+        unsigned char buffer[64];
+
+        while (read (getReadHandle(), buffer, sizeof (buffer)) == (ssize_t) sizeof (buffer)) {}
+       #endif
+    }
+
+    void dispatchPendingMessages()
+    {
+        clearWakeup();
+
+        // Clearing the flag before draining means that anything posted from here on will
+        // signal the fd again, including a message whose producer we catch half-way through
+        // linking it in below
+        wakeupPending.exchange (false, std::memory_order_acq_rel);
+
+        // Only handle the messages that are already here, so that a message which keeps posting
+        // itself again can't stop the event loop from servicing its other fds. Anything posted
+        // after this point has signalled the fd, so it'll be handled on the next pass.
+        for (auto numToHandle = numQueued.load (std::memory_order_acquire); numToHandle > 0; --numToHandle)
+        {
+            auto msg = popNextMessage();
+
+            if (msg == nullptr)
+                break;
+
+            const auto latency = Time::getHighResolutionTicks() - msg->timePosted;
+            totalLatencyTicks.fetch_add (latency, std::memory_order_relaxed);
+            numDispatched.fetch_add (1, std::memory_order_relaxed);
+
+            if (latency > maxLatencyTicks.load (std::memory_order_relaxed))
+                maxLatencyTicks.store (latency, std::memory_order_relaxed);
+
+            JUCE_TRY
+            {
+                msg->messageCallback();
+            }
+            JUCE_CATCH_EXCEPTION
+        }
+    }
+
+    MessageManager::MessageBase::Ptr popNextMessage() noexcept
+    {
+        auto* first = tail;
+        auto* next = first->nextQueuedMessage.load (std::memory_order_acquire);
+
+        if (first == &stub)
+        {
+            if (next == nullptr)
+                return nullptr;
+
+            tail = first = next;
+            next = next->nextQueuedMessage.load (std::memory_order_acquire);
+        }
+
+        if (next == nullptr)
         {
-            --bytesInSocket;
+            // A producer has swapped itself in as the head but hasn't linked it to the
+            // previous one yet. It'll signal the fd when it has, so we can stop here.
+            if (first != head.load (std::memory_order_acquire))
+                return nullptr;
+
+            // Push the stub so that the last real message can be removed
+            stub.nextQueuedMessage.store (nullptr, std::memory_order_relaxed);
+            auto* previous = head.exchange (&stub, std::memory_order_acq_rel);
+            previous->nextQueuedMessage.store (&stub, std::memory_order_release);
 
-            ScopedUnlock ul (lock);
-            unsigned char x;
-            [[maybe_unused]] auto numBytes = read (fd, &x, 1);
+            next = first->nextQueuedMessage.load (std::memory_order_acquire);
+
+            if (next == nullptr)
+                return nullptr;
         }
 
-        return queue.removeAndReturn (0);
+        tail = next;
+        numQueued.fetch_sub (1, std::memory_order_relaxed);
+
+        // Nothing here reads the message's link after this, so it's safe for it to be posted again
+        first->isQueued.store (false, std::memory_order_release);
+
+        MessageManager::MessageBase::Ptr result (first);
+        first->decReferenceCount();
+        return result;
     }
 };
 
+//==============================================================================
+#if JUCE_LINUX
+/*
+    Waits for fds to become ready using epoll.
+
+    The kernel keeps track of the registered fds, so waiting and dispatching only cost time
+    proportional to the number of fds that are actually ready, rather than the number that
+    are registered.
+*/
+class EpollFdSet
+{
+public:
+    EpollFdSet()
+        : epollFd (epoll_create1 (EPOLL_CLOEXEC))
+    {
+        jassert (epollFd >= 0);
+    }
+
+    ~EpollFdSet()
+    {
+        close (epollFd);
+    }
+
+    bool add (int fd, short eventMask, bool edgeTriggered)
+    {
+        // The poll() event flags have the same values as their epoll equivalents on Linux
+        epoll_event event{};
+        event.events = (uint32_t) (unsigned short) eventMask | (edgeTriggered ? (uint32_t) EPOLLET : 0);
+        event.data.fd = fd;
+
+        return epoll_ctl (epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+    }
+
+    bool remove (int fd)
+    {
+        // If the fd has already been closed, the kernel will have removed it for us
+        return epoll_ctl (epollFd, EPOLL_CTL_DEL, fd, nullptr) == 0 || errno == EBADF;
+    }
+
+    /*  Returns true if any fds are ready. Ready fds are kept until they're collected by
+        takeReadyFds(), because an edge-triggered fd won't be reported a second time.
+    */
+    bool wait (int timeoutMs)
+    {
+        if (numReady > 0)
+            return true;
+
+        const auto result = epoll_wait (epollFd, ready.data(), (int) ready.size(), timeoutMs);
+        numReady = jmax (0, result);
+        return numReady > 0;
+    }
+
+    template <typename Callback>
+    void takeReadyFds (Callback&& callback)
+    {
+        const auto numToTake = std::exchange (numReady, 0);
+
+        for (int i = 0; i < numToTake; ++i)
+            callback (ready[(size_t) i].data.fd);
+    }
+
+private:
+    int epollFd = -1;
+    std::array<epoll_event, 64> ready;
+    int numReady = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (EpollFdSet)
+};
+
+using NativeFdSet = EpollFdSet;
+#else
+/*
+    Waits for fds to become ready using poll(), for platforms without epoll.
+*/
+class PollFdSet
+{
+public:
+    bool add (int fd, short eventMask, bool /*edgeTriggered*/)
+    {
+        const auto iter = getPollfd (fd);
+
+        if (iter != pfds.end() && iter->fd == fd)
+            return false;
+
+        pfds.insert (iter, { fd, eventMask, 0 });
+        jassert (pfdsAreSorted());
+        return true;
+    }
+
+    bool remove (int fd)
+    {
+        const auto iter = getPollfd (fd);
+
+        if (iter == pfds.end() || iter->fd != fd)
+            return false;
+
+        pfds.erase (iter);
+        return true;
+    }
+
+    bool wait (int timeoutMs)
+    {
+        return poll (pfds.data(), static_cast<nfds_t> (pfds.size()), timeoutMs) > 0;
+    }
+
+    template <typename Callback>
+    void takeReadyFds (Callback&& callback)
+    {
+        for (auto& pfd : pfds)
+            if (std::exchange (pfd.revents, 0) != 0)
+                callback (pfd.fd);
+    }
+
+private:
+    std::vector<pollfd>::iterator getPollfd (int fd)
+    {
+        return std::lower_bound (pfds.begin(), pfds.end(), fd, [] (auto descriptor, auto toFind)
+        {
+            return descriptor.fd < toFind;
+        });
+    }
+
+    bool pfdsAreSorted() const
+    {
+        return std::is_sorted (pfds.begin(), pfds.end(), [] (auto a, auto b) { return a.fd < b.fd; });
+    }
+
+    std::vector<pollfd> pfds;
+};
+
+using NativeFdSet = PollFdSet;
+#endif
+
 //==============================================================================
 /*
     Stores callbacks associated with file descriptors (FD).
 
     The callback for a particular FD should be called whenever that file has data to read.
 
-    For standalone apps, the main thread will call poll to wait for new data on any FD, and then
-    call the associated callbacks for any FDs that changed.
+    For standalone apps, the main thread will call epoll (or poll, where epoll isn't available)
+    to wait for new data on any FD, and then call the associated callbacks for any FDs that changed.
 
     For plugins, the host (generally) provides some kind of run loop mechanism instead.
     - In VST2 plugins, the host should call effEditIdle at regular intervals, and plugins can
@@ -140,21 +428,15 @@ struct InternalRunLoop
 public:
     InternalRunLoop() = default;
 
-    void registerFdCallback (int fd, std::function<void()>&& cb, short eventMask)
+    void registerFdCallback (int fd, std::function<void()>&& cb, short eventMask, bool edgeTriggered = false)
     {
         {
             const ScopedLock sl (lock);
 
             callbacks.emplace (fd, std::make_shared<std::function<void()>> (std::move (cb)));
 
-            const auto iter = getPollfd (fd);
-
-            if (iter == pfds.end() || iter->fd != fd)
-                pfds.insert (iter, { fd, eventMask, 0 });
-            else
-                jassertfalse;
-
-            jassert (pfdsAreSorted());
+            [[maybe_unused]] const auto added = fds.add (fd, eventMask, edgeTriggered);
+            jassert (added);
         }
 
         listeners.call ([] (auto& l) { l.fdCallbacksChanged(); });
@@ -165,16 +447,10 @@ public:
         {
             const ScopedLock sl (lock);
 
-            callbacks.erase (fd);
+            callbacks.remove (fd);
 
-            const auto iter = getPollfd (fd);
-
-            if (iter != pfds.end() && iter->fd == fd)
-                pfds.erase (iter);
-            else
-                jassertfalse;
-
-            jassert (pfdsAreSorted());
+            [[maybe_unused]] const auto removed = fds.remove (fd);
+            jassert (removed);
         }
 
         listeners.call ([] (auto& l) { l.fdCallbacksChanged(); });
@@ -208,15 +484,21 @@ public:
 
     bool sleepUntilNextEvent (int timeoutMs)
     {
+       #if JUCE_LINUX
+        // epoll_ctl may be called while another thread is waiting, so there's no need to stop
+        // other threads from registering fds while we sleep
+        return fds.wait (timeoutMs);
+       #else
         const ScopedLock sl (lock);
-        return poll (pfds.data(), static_cast<nfds_t> (pfds.size()), timeoutMs) != 0;
+        return fds.wait (timeoutMs);
+       #endif
     }
 
     std::vector<int> getRegisteredFds()
     {
         const ScopedLock sl (lock);
         std::vector<int> result;
-        result.reserve (callbacks.size());
+        result.reserve ((size_t) callbacks.size());
         std::transform (callbacks.begin(),
                         callbacks.end(),
                         std::back_inserter (result),
@@ -246,36 +528,20 @@ private:
         if (! sleepUntilNextEvent (0))
             return;
 
-        for (auto& pfd : pfds)
+        fds.takeReadyFds ([&] (int fd)
         {
-            if (std::exchange (pfd.revents, 0) != 0)
-            {
-                const auto iter = callbacks.find (pfd.fd);
-
-                if (iter != callbacks.end())
-                    functions.emplace_back (iter->second);
-            }
-        }
-    }
+            const auto iter = callbacks.find (fd);
 
-    std::vector<pollfd>::iterator getPollfd (int fd)
-    {
-        return std::lower_bound (pfds.begin(), pfds.end(), fd, [] (auto descriptor, auto toFind)
-        {
-            return descriptor.fd < toFind;
+            if (iter != callbacks.end())
+                functions.emplace_back (iter->second);
         });
     }
 
-    bool pfdsAreSorted() const
-    {
-        return std::is_sorted (pfds.begin(), pfds.end(), [] (auto a, auto b) { return a.fd < b.fd; });
-    }
-
     CriticalSection lock;
 
-    std::map<int, SharedCallback> callbacks;
+    FlatMap<int, SharedCallback> callbacks;
     std::vector<SharedCallback> callbackStorage;
-    std::vector<pollfd> pfds;
+    NativeFdSet fds;
 
     ListenerList<LinuxEventLoopInternal::Listener> listeners;
 };
@@ -374,7 +640,27 @@ void LinuxEventLoop::unregisterFdCallback (int fd)
         runLoop->unregisterFdCallback (fd);
 }
 
+LinuxEventLoop::MessageQueueStatistics LinuxEventLoop::getMessageQueueStatistics()
+{
+    if (auto* queue = InternalMessageQueue::getInstanceWithoutCreating())
+        return queue->getStatistics();
+
+    return {};
+}
+
+void LinuxEventLoop::resetMessageQueueStatistics()
+{
+    if (auto* queue = InternalMessageQueue::getInstanceWithoutCreating())
+        queue->resetStatistics();
+}
+
 //==============================================================================
+void LinuxEventLoopInternal::registerEdgeTriggeredFdCallback (int fd, std::function<void (int)> readCallback)
+{
+    if (auto* runLoop = InternalRunLoop::getInstanceWithoutCreating())
+        runLoop->registerFdCallback (fd, [cb = std::move (readCallback), fd] { cb (fd); }, POLLIN, true);
+}
+
 void LinuxEventLoopInternal::registerLinuxEventLoopListener (LinuxEventLoopInternal::Listener& listener)
 {
     if (auto* runLoop = InternalRunLoop::getInstanceWithoutCreating())
@@ -401,4 +687,155 @@ std::vector<int> LinuxEventLoopInternal::getRegisteredFds()
     return {};
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LinuxMessageQueueTests final : public UnitTest
+{
+public:
+    LinuxMessageQueueTests()
+        : UnitTest ("Linux message queue", UnitTestCategories::events)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Messages posted from several threads are all delivered, in the order each thread posted them");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+            LinuxEventLoop::resetMessageQueueStatistics();
+
+            constexpr int numThreads = 4, numMessagesPerThread = 5000;
+            std::vector<std::vector<int>> received ((size_t) numThreads);
+            int numReceived = 0;
+            std::atomic<bool> startPosting { false };
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([&, t]
+                {
+                    while (! startPosting)
+                        std::this_thread::yield();
+
+                    for (int i = 0; i < numMessagesPerThread; ++i)
+                        MessageManager::callAsync ([&, t, i] { received[(size_t) t].push_back (i); ++numReceived; });
+                });
+            }
+
+            startPosting = true;
+            const auto timeout = Time::getMillisecondCounter() + 10000;
+
+            while (numReceived < numThreads * numMessagesPerThread && Time::getMillisecondCounter() < timeout)
+                detail::dispatchNextMessageOnSystemQueue (true);
+
+            for (auto& thread : threads)
+                thread.join();
+
+            dispatchPendingMessages();
+
+            for (const auto& messages : received)
+            {
+                expectEquals ((int) messages.size(), numMessagesPerThread);
+                expect (std::is_sorted (messages.begin(), messages.end())
+                        && std::adjacent_find (messages.begin(), messages.end()) == messages.end());
+            }
+
+            const auto stats = LinuxEventLoop::getMessageQueueStatistics();
+            expect (stats.numMessagesPosted >= numThreads * numMessagesPerThread);
+            expect (stats.numMessagesDispatched >= numThreads * numMessagesPerThread);
+            expect (stats.numWakeups > 0 && stats.numWakeups <= stats.numMessagesPosted);
+            expect (stats.maxQueueLength > 0);
+            expect (stats.maxLatencySeconds >= stats.averageLatencySeconds && stats.averageLatencySeconds >= 0.0);
+        }
+
+        beginTest ("Wakeups are batched, and the statistics can be reset");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+            dispatchPendingMessages();
+            LinuxEventLoop::resetMessageQueueStatistics();
+
+            const auto cleared = LinuxEventLoop::getMessageQueueStatistics();
+            expectEquals (cleared.numMessagesPosted, (int64) 0);
+            expectEquals (cleared.numMessagesDispatched, (int64) 0);
+            expectEquals (cleared.maxQueueLength, 0);
+
+            constexpr int numMessages = 100;
+            int numCallbacks = 0;
+
+            for (int i = 0; i < numMessages; ++i)
+                MessageManager::callAsync ([&] { ++numCallbacks; });
+
+            const auto stats = LinuxEventLoop::getMessageQueueStatistics();
+            expect (stats.numMessagesPosted >= numMessages);
+            expect (stats.maxQueueLength >= numMessages);
+            expect (stats.numWakeups < numMessages);
+
+            dispatchPendingMessages();
+            expectEquals (numCallbacks, numMessages);
+        }
+
+        beginTest ("A message that's posted again before it has been delivered is delivered each time");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+
+            std::vector<String> calls;
+            const auto record = [&] (const String& label) { return [&calls, label] { calls.push_back (label); }; };
+
+            MessageManager::MessageBase::Ptr message = new TestMessage (record ("message"));
+
+            expect (message->post());
+            MessageManager::callAsync (record ("between"));
+            expect (message->post());
+            expect (message->post());
+            dispatchPendingMessages();
+
+            expect (calls == std::vector<String> { "message", "between", "message", "message" });
+
+            // The message can be queued again once it has been delivered, including from its own callback
+            calls.clear();
+            int numReposts = 0;
+
+            message = new TestMessage ([&]
+            {
+                calls.push_back ("message");
+
+                if (++numReposts < 3)
+                    message->post();
+            });
+
+            expect (message->post());
+
+            for (int i = 0; i < 3; ++i)
+                dispatchPendingMessages();
+
+            expect (calls == std::vector<String> { "message", "message", "message" });
+            expectEquals (message->getReferenceCount(), 1);
+        }
+    }
+
+private:
+    struct TestMessage final : public MessageManager::MessageBase
+    {
+        explicit TestMessage (std::function<void()> fn) : callback (std::move (fn)) {}
+        void messageCallback() override   { callback(); }
+
+        std::function<void()> callback;
+    };
+
+    // Delivers everything that's in the message queue so far
+    static void dispatchPendingMessages()
+    {
+        bool reachedEnd = false;
+        MessageManager::callAsync ([&reachedEnd] { reachedEnd = true; });
+
+        while (! reachedEnd)
+            detail::dispatchNextMessageOnSystemQueue (true);
+    }
+};
+
+static LinuxMessageQueueTests linuxMessageQueueTests;
+
+#endif
+
 } // namespace juce
@@ -0,0 +1,541 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/*  The transport used by an InterprocessConnection that was opened with
+    createSharedMemory() or connectToSharedMemory().
+
+    The region holds a pair of single-producer/single-consumer ring buffers, one in
+    each direction. It's a POSIX shared memory object so that the other process can
+    find it by name, like a NamedPipe, but the name is unlinked as soon as the other
+    end has mapped it, after which it's as anonymous as a memfd. When there's nothing
+    to read or no room to write, each side sleeps on a futex in the shared header.
+
+    Each side also holds an open file description lock on one byte of the object, which
+    the kernel releases when that process dies, so that the other side can tell that it
+    has gone even if it hasn't been reaped yet.
+
+    Each message is stored as a small header followed by the message bytes, and the
+    reader hands out a pointer to those bytes in the mapped region. Messages that are
+    too large to be stored contiguously are split into fragments, which the reader
+    joins back together before delivering them.
+*/
+class InterprocessConnection::SharedMemoryChannel
+{
+public:
+    ~SharedMemoryChannel()
+    {
+        close();
+        munmap (region, regionSize);
+        ::close (fd);
+
+        if (side == creatorSide)
+            shm_unlink (objectName.toRawUTF8());
+    }
+
+    static std::unique_ptr<SharedMemoryChannel> create (const String& name, int bufferSizeBytes,
+                                                        uint32 magic, bool mustNotExist)
+    {
+        const auto objectName = getObjectName (name);
+
+        if (! mustNotExist)
+            shm_unlink (objectName.toRawUTF8());
+
+        const auto fd = shm_open (objectName.toRawUTF8(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+
+        if (fd < 0)
+            return {};
+
+        const auto ringSize = (uint32) nextPowerOfTwo (jmax (minimumRingSize, bufferSizeBytes));
+        const auto size = getRegionSize (ringSize);
+        void* mapped = MAP_FAILED;
+
+        if (ftruncate (fd, (off_t) size) == 0 && lockSide (fd, creatorSide))
+            mapped = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (mapped == MAP_FAILED)
+        {
+            ::close (fd);
+            shm_unlink (objectName.toRawUTF8());
+            return {};
+        }
+
+        auto* header = new (mapped) Header();
+        header->ringSize = ringSize;
+        header->connectionMagic = magic;
+        header->pids[creatorSide] = (int32) getpid();
+        header->magic.store (regionMagic, std::memory_order_release);
+
+        return rawToUniquePtr (new SharedMemoryChannel (objectName, fd, mapped, size, creatorSide));
+    }
+
+    static std::unique_ptr<SharedMemoryChannel> open (const String& name, uint32 magic, int timeoutMs)
+    {
+        const auto objectName = getObjectName (name);
+        const auto endTime = Time::getMillisecondCounter() + (uint32) jmax (0, timeoutMs);
+
+        for (;;)
+        {
+            if (auto channel = tryToOpen (objectName, magic))
+                return channel;
+
+            // The other process may not have got round to creating the region yet..
+            if (Time::getMillisecondCounter() >= endTime)
+                return {};
+
+            Thread::sleep (5);
+        }
+    }
+
+    //==============================================================================
+    /** Marks this end as closed, and wakes up anything that's waiting on either end. */
+    void close()
+    {
+        header->closed[side] = 1;
+
+        for (auto& ring : header->rings)
+        {
+            ring.dataAvailable.notify();
+            ring.spaceAvailable.notify();
+        }
+    }
+
+    bool isOpen() const noexcept
+    {
+        return header->closed[creatorSide] == 0 && header->closed[connectorSide] == 0;
+    }
+
+    /** The largest message that can be written with writeInPlace(). */
+    size_t getMaxInPlaceMessageSize() const noexcept     { return maxPayloadSize; }
+
+    /** Copies a message into the outgoing ring, splitting it up if it's too big to go in one piece. */
+    bool write (const void* data, size_t numBytes, int timeoutMs)
+    {
+        if (numBytes > maxMessageSize)
+        {
+            // The other end would refuse to put this back together
+            jassertfalse;
+            return false;
+        }
+
+        const ScopedLock sl (writeLock);
+
+        for (;;)
+        {
+            const auto numThisTime = jmin (numBytes, maxPayloadSize);
+            const auto isLast = numThisTime == numBytes;
+
+            if (! writeRecord (numThisTime, isLast ? completeRecord : fragmentRecord, timeoutMs,
+                               [&] (void* dest) { memcpy (dest, data, numThisTime); }))
+                return false;
+
+            if (isLast)
+                return true;
+
+            data = addBytesToPointer (data, numThisTime);
+            numBytes -= numThisTime;
+        }
+    }
+
+    /** Reserves space for a message in the outgoing ring and lets the caller fill it in directly.
+        The size must be no larger than getMaxInPlaceMessageSize().
+    */
+    template <typename WriteFn>
+    bool writeInPlace (size_t numBytes, int timeoutMs, WriteFn&& writeMessage)
+    {
+        jassert (numBytes <= maxPayloadSize);
+
+        const ScopedLock sl (writeLock);
+        return writeRecord (numBytes, completeRecord, timeoutMs, writeMessage);
+    }
+
+    /** Waits for the next message and passes it to the callback as a pointer and size.
+
+        The data is only valid until the callback returns, after which its space in the
+        ring is handed back to the writer.
+
+        Returns 1 if a message was delivered, 0 if the timeout expired, or -1 if the
+        connection has been closed or the other process has died.
+    */
+    template <typename DeliverFn>
+    int read (int timeoutMs, DeliverFn&& deliverMessage)
+    {
+        auto& ring = header->rings[1 - side];
+        auto* data = getRingData (1 - side);
+
+        for (;;)
+        {
+            const auto readPos = ring.readPosition.load (std::memory_order_relaxed);
+
+            if (! waitFor (ring.dataAvailable, timeoutMs, [&]
+                           {
+                               return ring.writePosition.load (std::memory_order_acquire) != readPos;
+                           }))
+            {
+                return isOpen() ? 0 : -1;
+            }
+
+            const auto numBytesAvailable = ring.writePosition.load (std::memory_order_acquire) - readPos;
+            const auto offset = (uint32) (readPos & (ringSize - 1));
+            const auto record = readRecordHeader (data + offset);
+
+            if (! isValidRecord (record, offset, numBytesAvailable))
+            {
+                // The other end has written something that doesn't make sense..
+                jassertfalse;
+                close();
+                return -1;
+            }
+
+            if (record.flags == paddingRecord)
+            {
+                consume (ring, readPos + (ringSize - offset));
+                continue;
+            }
+
+            const auto* payload = data + offset + sizeof (RecordHeader);
+            const auto nextRecord = readPos + getRecordSize (record.size);
+
+            if (record.flags == fragmentRecord || ! partialMessage.isEmpty())
+            {
+                partialMessage.append (payload, record.size);
+                consume (ring, nextRecord);
+
+                if (record.flags == fragmentRecord)
+                    continue;
+
+                deliverMessage (partialMessage.getData(), partialMessage.getSize());
+                partialMessage.reset();
+                return 1;
+            }
+
+            if (record.size > 0)
+                deliverMessage (static_cast<const void*> (payload), (size_t) record.size);
+
+            consume (ring, nextRecord);
+            return 1;
+        }
+    }
+
+private:
+    //==============================================================================
+    // An event count: a waiter samples the sequence number before checking its condition,
+    // so a notification that arrives in between makes the futex wait return immediately.
+    struct Signal
+    {
+        std::atomic<uint32> sequence { 0 }, numWaiters { 0 };
+
+        void notify() noexcept
+        {
+            sequence.fetch_add (1);
+
+            if (numWaiters.load() != 0)
+                syscall (SYS_futex, getWord(), FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+        }
+
+        void wait (uint32 expected, int timeoutMs) noexcept
+        {
+            const timespec timeout { (time_t) (timeoutMs / 1000), (long) (timeoutMs % 1000) * 1000000L };
+            syscall (SYS_futex, getWord(), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+        }
+
+        uint32* getWord() noexcept    { return reinterpret_cast<uint32*> (&sequence); }
+    };
+
+    struct Ring
+    {
+        alignas (64) std::atomic<uint64> writePosition { 0 };
+        Signal dataAvailable;
+        alignas (64) std::atomic<uint64> readPosition { 0 };
+        Signal spaceAvailable;
+    };
+
+    struct Header
+    {
+        std::atomic<uint32> magic { 0 };
+        uint32 ringSize = 0, connectionMagic = 0;
+        std::atomic<int32> pids[2] { { 0 }, { 0 } };
+        std::atomic<uint32> closed[2] { { 0 }, { 0 } };
+        Ring rings[2];
+    };
+
+    struct RecordHeader
+    {
+        uint32 size, flags;
+    };
+
+    static_assert (std::atomic<uint32>::is_always_lock_free && std::atomic<uint64>::is_always_lock_free
+                     && sizeof (std::atomic<uint32>) == sizeof (uint32),
+                   "The shared header relies on lock-free atomics that can be used as futex words");
+
+    enum : uint32 { completeRecord = 0, fragmentRecord = 1, paddingRecord = 2 };
+    enum { creatorSide = 0, connectorSide = 1 };
+
+    // The largest message that can be sent in fragments, which is the same as for a socket or pipe
+    static constexpr size_t maxMessageSize = (size_t) std::numeric_limits<int>::max();
+
+    static constexpr uint32 regionMagic = 0x4a53484d;
+    static constexpr int minimumRingSize = 4096;
+    static constexpr int pollIntervalMs = 100;
+
+    SharedMemoryChannel (const String& name, int fileDescriptor, void* mappedRegion, size_t size, int sideIndex)
+        : objectName (name),
+          fd (fileDescriptor),
+          region (mappedRegion),
+          regionSize (size),
+          header (static_cast<Header*> (mappedRegion)),
+          side (sideIndex),
+          ringSize (header->ringSize),
+          maxPayloadSize (ringSize / 2 - sizeof (RecordHeader))
+    {
+    }
+
+    static String getObjectName (const String& name)
+    {
+        return "/juce_ipc_" + name.removeCharacters ("/");
+    }
+
+    static size_t getHeaderSize() noexcept
+    {
+        return (sizeof (Header) + 4095) & ~(size_t) 4095;
+    }
+
+    static size_t getRegionSize (uint32 ringSize) noexcept
+    {
+        return getHeaderSize() + 2 * (size_t) ringSize;
+    }
+
+    static uint64 getRecordSize (size_t payloadSize) noexcept
+    {
+        return (sizeof (RecordHeader) + payloadSize + 7) & ~(uint64) 7;
+    }
+
+    static std::unique_ptr<SharedMemoryChannel> tryToOpen (const String& objectName, uint32 magic)
+    {
+        const auto fd = shm_open (objectName.toRawUTF8(), O_RDWR | O_CLOEXEC, 0600);
+
+        if (fd < 0)
+            return {};
+
+        struct stat info;
+        void* mapped = MAP_FAILED;
+
+        if (fstat (fd, &info) == 0 && (size_t) info.st_size > getHeaderSize())
+            mapped = mmap (nullptr, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (mapped == MAP_FAILED)
+        {
+            ::close (fd);
+            return {};
+        }
+
+        auto* header = static_cast<Header*> (mapped);
+        auto expectedPid = 0;
+
+        if (header->magic.load (std::memory_order_acquire) != regionMagic
+             || header->connectionMagic != magic
+             || ! isPowerOfTwo (header->ringSize) || header->ringSize < (uint32) minimumRingSize
+             || getRegionSize (header->ringSize) != (size_t) info.st_size
+             || ! lockSide (fd, connectorSide)
+             || ! header->pids[connectorSide].compare_exchange_strong (expectedPid, (int32) getpid()))
+        {
+            munmap (mapped, (size_t) info.st_size);
+            ::close (fd);
+            return {};
+        }
+
+        // Now that both ends have it mapped, nobody else needs to be able to find it
+        shm_unlink (objectName.toRawUTF8());
+
+        return rawToUniquePtr (new SharedMemoryChannel (objectName, fd, mapped, (size_t) info.st_size, connectorSide));
+    }
+
+    static struct flock getLockForSide (int sideIndex) noexcept
+    {
+        struct flock lock {};
+        lock.l_type = F_WRLCK;
+        lock.l_whence = SEEK_SET;
+        lock.l_start = sideIndex;
+        lock.l_len = 1;
+        return lock;
+    }
+
+    static bool lockSide (int fd, int sideIndex) noexcept
+    {
+        auto lock = getLockForSide (sideIndex);
+        return fcntl (fd, F_OFD_SETLK, &lock) == 0;
+    }
+
+    //==============================================================================
+    uint8* getRingData (int ringIndex) const noexcept
+    {
+        return static_cast<uint8*> (region) + getHeaderSize() + (size_t) ringIndex * ringSize;
+    }
+
+    static RecordHeader readRecordHeader (const uint8* source) noexcept
+    {
+        RecordHeader record;
+        memcpy (&record, source, sizeof (record));
+        return record;
+    }
+
+    template <typename WriteFn>
+    bool writeRecord (size_t numBytes, uint32 flags, int timeoutMs, WriteFn&& writeMessage)
+    {
+        auto& ring = header->rings[side];
+        auto* data = getRingData (side);
+
+        auto writePos = ring.writePosition.load (std::memory_order_relaxed);
+        const auto recordSize = getRecordSize (numBytes);
+        const auto spaceBeforeEnd = ringSize - (uint32) (writePos & (ringSize - 1));
+        const auto padding = spaceBeforeEnd < recordSize ? (uint64) spaceBeforeEnd : 0;
+
+        if (! waitFor (ring.spaceAvailable, timeoutMs, [&]
+                       {
+                           return ringSize - (writePos - ring.readPosition.load (std::memory_order_acquire))
+                                    >= padding + recordSize;
+                       }))
+        {
+            return false;
+        }
+
+        if (padding > 0)
+        {
+            const RecordHeader record { 0, paddingRecord };
+            memcpy (data + (writePos & (ringSize - 1)), &record, sizeof (record));
+            writePos += padding;
+        }
+
+        auto* dest = data + (writePos & (ringSize - 1));
+        const RecordHeader record { (uint32) numBytes, flags };
+        memcpy (dest, &record, sizeof (record));
+        writeMessage (static_cast<void*> (dest + sizeof (record)));
+
+        ring.writePosition.store (writePos + recordSize, std::memory_order_release);
+        ring.dataAvailable.notify();
+        return true;
+    }
+
+    // Checks that a record lies entirely within the ring and within the part of it that the
+    // writer has published, and that it won't make a fragmented message too big.
+    bool isValidRecord (RecordHeader record, uint32 offset, uint64 numBytesAvailable) const noexcept
+    {
+        if (numBytesAvailable > ringSize)
+            return false;
+
+        // Padding fills up the rest of the ring
+        if (record.flags == paddingRecord)
+            return ringSize - offset <= numBytesAvailable;
+
+        const auto recordSize = getRecordSize (record.size);
+
+        return record.flags <= fragmentRecord
+            && record.size <= maxPayloadSize
+            && offset + recordSize <= ringSize
+            && recordSize <= numBytesAvailable
+            && record.size <= maxMessageSize - partialMessage.getSize();
+    }
+
+    void consume (Ring& ring, uint64 newReadPosition) noexcept
+    {
+        ring.readPosition.store (newReadPosition, std::memory_order_release);
+        ring.spaceAvailable.notify();
+    }
+
+    // Waits until the condition is true, returning false if the timeout expires (a negative
+    // timeout waits forever) or the connection closes first.
+    template <typename Condition>
+    bool waitFor (Signal& signal, int timeoutMs, Condition&& isReady)
+    {
+        const auto startTime = Time::getMillisecondCounter();
+
+        for (;;)
+        {
+            const auto sequence = signal.sequence.load();
+
+            if (isReady())
+                return true;
+
+            if (! isOpen())
+                return false;
+
+            const auto elapsed = (int) (Time::getMillisecondCounter() - startTime);
+
+            if (timeoutMs >= 0 && elapsed >= timeoutMs)
+                return false;
+
+            signal.numWaiters.fetch_add (1);
+
+            if (! isReady())
+                signal.wait (sequence, timeoutMs >= 0 ? jmin (pollIntervalMs, timeoutMs - elapsed)
+                                                      : pollIntervalMs);
+
+            signal.numWaiters.fetch_sub (1);
+
+            if (! isReady() && ! isOtherProcessRunning())
+                header->closed[1 - side] = 1;
+        }
+    }
+
+    bool isOtherProcessRunning() const noexcept
+    {
+        // The connector takes its lock before filling in its pid, so until then there's nothing to check
+        if (header->pids[1 - side].load() == 0)
+            return true;
+
+        auto lock = getLockForSide (1 - side);
+        return fcntl (fd, F_OFD_GETLK, &lock) != 0 || lock.l_type != F_UNLCK;
+    }
+
+    //==============================================================================
+    const String objectName;
+    const int fd;
+    void* const region;
+    const size_t regionSize;
+    Header* const header;
+    const int side;
+    const uint32 ringSize;
+    const size_t maxPayloadSize;
+
+    CriticalSection writeLock;
+    MemoryBlock partialMessage;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedMemoryChannel)
+};
+
+} // namespace juce
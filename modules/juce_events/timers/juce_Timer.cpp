@@ -80,6 +80,221 @@ private:
     JUCE_DECLARE_SINGLETON_INLINE (ShutdownDetector, false)
 };
 
+//==============================================================================
+/*  A hierarchical timing wheel, as described by Varghese and Lauck in "Hashed and Hierarchical
+    Timing Wheels".
+
+    Level 0 has a slot for each millisecond of the current 64ms block, level 1 has a slot for
+    each 64ms block of the current 4096ms block, and so on. A timer is linked into the slot
+    for its expiry time in the lowest level whose current block contains that time, and when
+    the wheel reaches that slot the timers in it are moved down to the level below. Timers that
+    expire after the end of the top level's current block wait in an overflow list until the
+    wheel gets there. Adding or removing a timer is O(1), and all the timers due in the same
+    millisecond are collected together in a single step.
+
+    The items are linked into the wheel through a Position member, which needs previous and
+    next pointers, an expiryTime and a list index.
+*/
+template <typename Item, typename Position, Position Item::* position>
+class TimerWheel
+{
+public:
+    bool isEmpty() const noexcept                  { return numTimers == 0; }
+    Item* getFirstDueTimer() const noexcept        { return lists[dueList]; }
+
+    void insert (Item* t, int64 expiryTime)
+    {
+        auto& pos = t->*position;
+        pos.expiryTime = jmax (expiryTime, currentTime + 1);
+        link (t, getListFor (pos.expiryTime));
+        ++numTimers;
+    }
+
+    void remove (Item* t)
+    {
+        unlink (t);
+        --numTimers;
+    }
+
+    /*  Moves the wheel forward, adding any timers that expire on the way to the end of the
+        due list, in the order in which they expired.
+    */
+    void advanceTo (int64 time)
+    {
+        while (currentTime < time)
+        {
+            if (numTimers == numInList (dueList))
+            {
+                currentTime = time;
+                break;
+            }
+
+            if (numInLevel[0] == 0)
+            {
+                // nothing can expire before the wheel reaches the next occupied slot, so skip straight to it
+                const auto nextSlot = getNextOccupiedSlotTime();
+
+                if (nextSlot > time)
+                {
+                    currentTime = time;
+                    break;
+                }
+
+                currentTime = nextSlot - 1;
+            }
+
+            ++currentTime;
+            cascade();
+
+            while (auto* t = lists[(size_t) getList (0, currentTime)])
+            {
+                unlink (t);
+                link (t, dueList);
+            }
+        }
+    }
+
+    /*  Returns a time at or before the earliest expiry time of any timer, which is when the
+        wheel next needs advancing, or std::numeric_limits<int64>::max() if there aren't any.
+    */
+    int64 getNextExpiryTime() const noexcept
+    {
+        if (lists[dueList] != nullptr)
+            return currentTime;
+
+        return getNextOccupiedSlotTime();
+    }
+
+    int64 getCurrentTime() const noexcept           { return currentTime; }
+
+private:
+    static constexpr int bitsPerLevel = 6, slotsPerLevel = 1 << bitsPerLevel, numLevels = 6;
+    static constexpr int totalBits = bitsPerLevel * numLevels;
+    static constexpr int overflowList = numLevels * slotsPerLevel, dueList = overflowList + 1;
+
+    std::array<Item*, dueList + 1> lists{};
+    Item* lastDueTimer = nullptr;
+    std::array<int, numLevels> numInLevel{};
+    int numOverflowTimers = 0, numDueTimers = 0, numTimers = 0;
+    int64 currentTime = 0;
+
+    // Returns the start of the next slot after the current time that has any timers in it
+    int64 getNextOccupiedSlotTime() const noexcept
+    {
+        for (int level = 0; level < numLevels; ++level)
+        {
+            if (numInLevel[(size_t) level] == 0)
+                continue;
+
+            const auto shift = bitsPerLevel * level;
+            const auto blockStart = (currentTime >> (shift + bitsPerLevel)) << (shift + bitsPerLevel);
+
+            // The timers on this level are all in later slots of the current block
+            for (auto slot = ((currentTime >> shift) & (slotsPerLevel - 1)) + 1; slot < slotsPerLevel; ++slot)
+                if (lists[(size_t) (level * slotsPerLevel + slot)] != nullptr)
+                    return blockStart + (slot << shift);
+
+            jassertfalse;
+        }
+
+        // The overflow list gets sorted out when the top level's next block starts
+        if (numOverflowTimers > 0)
+            return ((currentTime >> totalBits) + 1) << totalBits;
+
+        return std::numeric_limits<int64>::max();
+    }
+
+    static int getList (int level, int64 time) noexcept
+    {
+        return level * slotsPerLevel + (int) ((time >> (bitsPerLevel * level)) & (slotsPerLevel - 1));
+    }
+
+    int getListFor (int64 expiryTime) const noexcept
+    {
+        for (int level = 0; level < numLevels; ++level)
+            if (((expiryTime ^ currentTime) >> (bitsPerLevel * (level + 1))) == 0)
+                return getList (level, expiryTime);
+
+        return overflowList;
+    }
+
+    int& numInList (int list) noexcept
+    {
+        if (list == dueList)        return numDueTimers;
+        if (list == overflowList)   return numOverflowTimers;
+
+        return numInLevel[(size_t) (list / slotsPerLevel)];
+    }
+
+    // Moves the timers in the slots that the wheel has just reached down to the levels below
+    void cascade()
+    {
+        for (int level = 1; level <= numLevels; ++level)
+        {
+            if ((currentTime & ((int64 { 1 } << (bitsPerLevel * level)) - 1)) != 0)
+                break;
+
+            const auto list = level < numLevels ? getList (level, currentTime) : overflowList;
+
+            for (auto* t = lists[(size_t) list]; t != nullptr;)
+            {
+                auto* next = (t->*position).next;
+                unlink (t);
+                link (t, getListFor ((t->*position).expiryTime));
+                t = next;
+            }
+        }
+    }
+
+    void link (Item* t, int list) noexcept
+    {
+        auto& pos = t->*position;
+        pos.list = list;
+        ++numInList (list);
+
+        if (list == dueList)
+        {
+            // The due list is kept in expiry order, so new timers go on the end
+            pos.previous = std::exchange (lastDueTimer, t);
+            pos.next = nullptr;
+
+            if (pos.previous != nullptr)
+                (pos.previous->*position).next = t;
+            else
+                lists[dueList] = t;
+
+            return;
+        }
+
+        auto& head = lists[(size_t) list];
+        pos.previous = nullptr;
+        pos.next = std::exchange (head, t);
+
+        if (pos.next != nullptr)
+            (pos.next->*position).previous = t;
+    }
+
+    void unlink (Item* t) noexcept
+    {
+        auto& pos = t->*position;
+        --numInList (pos.list);
+
+        if (pos.previous != nullptr)
+            (pos.previous->*position).next = pos.next;
+        else
+            lists[(size_t) pos.list] = pos.next;
+
+        if (pos.next != nullptr)
+            (pos.next->*position).previous = pos.previous;
+        else if (pos.list == dueList)
+            lastDueTimer = pos.previous;
+
+        pos.previous = nullptr;
+        pos.next = nullptr;
+        pos.list = -1;
+    }
+};
+
 class Timer::TimerThread final : private Thread,
                                  private ShutdownDetector::Listener
 {
@@ -89,7 +304,6 @@ public:
     TimerThread()
         : Thread (SystemStats::getJUCEVersion() + ": Timer")
     {
-        timers.reserve (32);
         ShutdownDetector::addListener (this);
     }
 
@@ -105,17 +319,14 @@ public:
 
     void run() override
     {
-        auto lastTime = Time::getMillisecondCounter();
         ReferenceCountedObjectPtr<CallTimersMessage> messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            auto now = Time::getMillisecondCounter();
-            auto elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                  : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
+            // this also helps keep the Time::getApproximateMillisecondCounter value up-to-date
+            Time::getMillisecondCounter();
 
-            auto timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
+            auto timeUntilFirstTimer = getTimeUntilFirstTimer();
 
             if (timeUntilFirstTimer <= 0)
             {
@@ -151,31 +362,48 @@ public:
 
         const LockType::ScopedLockType sl (lock);
 
-        while (! timers.empty())
-        {
-            auto& first = timers.front();
+       #if JUCE_LINUX
+        timerFd.clear();
+       #endif
 
-            if (first.countdownMs > 0)
-                break;
+        wheel.advanceTo (getCurrentTime());
 
-            auto* timer = first.timer;
-            first.countdownMs = timer->timerPeriodMs;
-            shuffleTimerBackInQueue (0);
-            notify();
+        while (auto* timer = wheel.getFirstDueTimer())
+        {
+            const auto now = getCurrentTime();
+            const auto period = timer->timerPeriodMs;
+            const auto lateness = now - timer->positionInWheel.expiryTime;
 
-            const LockType::ScopedUnlockType ul (lock);
+            wheel.remove (timer);
+            wheel.insert (timer, now + period);
+
+            const auto callbackStart = Time::getHighResolutionTicks();
 
-            JUCE_TRY
             {
-                timer->timerCallback();
+                const LockType::ScopedUnlockType ul (lock);
+
+                JUCE_TRY
+                {
+                    timer->timerCallback();
+                }
+                JUCE_CATCH_EXCEPTION
             }
-            JUCE_CATCH_EXCEPTION
+
+            // The timer may have been deleted by its callback, so only use the values we took earlier
+            const auto callbackMs = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - callbackStart) * 1000.0;
+
+            ++statistics.numCallbacks;
+            statistics.numOverruns      += callbackMs > period ? 1 : 0;
+            statistics.numLateCallbacks += lateness >= period ? 1 : 0;
+            statistics.maxLatenessMs     = jmax (statistics.maxLatenessMs, (double) lateness);
+            statistics.maxCallbackMs     = jmax (statistics.maxCallbackMs, callbackMs);
 
             // avoid getting stuck in a loop if a timer callback repeatedly takes too long
             if (Time::getMillisecondCounter() > timeout)
                 break;
         }
 
+        scheduleWakeAt (wheel.getNextExpiryTime());
         callbackArrived.signal();
     }
 
@@ -188,78 +416,169 @@ public:
     {
         const LockType::ScopedLockType sl (lock);
 
-        if (! isThreadRunning())
-            startThread (Thread::Priority::high);
+        startTiming();
 
         // Trying to add a timer that's already here - shouldn't get to this point,
         // so if you get this assertion, let me know!
-        jassert (std::none_of (timers.begin(), timers.end(),
-                               [t] (TimerCountdown i) { return i.timer == t; }));
+        jassert (t->positionInWheel.list < 0);
 
-        auto pos = timers.size();
+        if (wheel.isEmpty())
+            wheel.advanceTo (getCurrentTime());
 
-        timers.push_back ({ t, t->timerPeriodMs });
-        t->positionInQueue = pos;
-        shuffleTimerForwardInQueue (pos);
-        notify();
+        insertTimer (t);
     }
 
     void removeTimer (Timer* t)
     {
         const LockType::ScopedLockType sl (lock);
 
-        auto pos = t->positionInQueue;
-        auto lastIndex = timers.size() - 1;
+        jassert (t->positionInWheel.list >= 0);
+        wheel.remove (t);
+    }
 
-        jassert (pos <= lastIndex);
-        jassert (timers[pos].timer == t);
+    void resetTimerCounter (Timer* t) noexcept
+    {
+        const LockType::ScopedLockType sl (lock);
 
-        for (auto i = pos; i < lastIndex; ++i)
-        {
-            timers[i] = timers[i + 1];
-            timers[i].timer->positionInQueue = i;
-        }
+        jassert (t->positionInWheel.list >= 0);
 
-        timers.pop_back();
+        wheel.remove (t);
+        insertTimer (t);
     }
 
-    void resetTimerCounter (Timer* t) noexcept
+    Statistics getStatistics() const
     {
         const LockType::ScopedLockType sl (lock);
+        return statistics;
+    }
 
-        auto pos = t->positionInQueue;
+    void resetStatistics()
+    {
+        const LockType::ScopedLockType sl (lock);
+        statistics = {};
+    }
 
-        jassert (pos < timers.size());
-        jassert (timers[pos].timer == t);
+private:
+    //==============================================================================
+    mutable LockType lock;
+    TimerWheel<Timer, PositionInWheel, &Timer::positionInWheel> wheel;
+    Statistics statistics;
+    int64 nextWakeTime = std::numeric_limits<int64>::max();
 
-        auto lastCountdown = timers[pos].countdownMs;
-        auto newCountdown = t->timerPeriodMs;
+    WaitableEvent callbackArrived;
+
+   #if JUCE_LINUX
+    /*  On Linux the message thread's event loop can wait on a timerfd directly, so instead of
+        running a thread that posts a message whenever a timer is due, we keep a timerfd armed
+        for the earliest timer and call the timers from the loop when it expires.
+    */
+    class TimerFd
+    {
+    public:
+        TimerFd() = default;
+        ~TimerFd()  { close(); }
 
-        if (newCountdown != lastCountdown)
+        bool isOpen() const noexcept  { return fd >= 0; }
+
+        bool open()
         {
-            timers[pos].countdownMs = newCountdown;
+            // The timerfd has to be registered with the message thread's event loop, which
+            // only exists while there's a MessageManager
+            auto* mm = MessageManager::getInstanceWithoutCreating();
+
+            if (mm == nullptr)
+                return false;
 
-            if (newCountdown > lastCountdown)
-                shuffleTimerBackInQueue (pos);
+            fd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+            if (fd < 0)
+                return false;
+
+            // The event loop's listeners expect to be told about new fds on the message thread.
+            // Until the fd is registered, it just stays readable if it expires.
+            if (mm->isThisTheMessageThread())
+            {
+                registerIfNeeded();
+            }
             else
-                shuffleTimerForwardInQueue (pos);
+            {
+                MessageManager::callAsync ([]
+                {
+                    if (auto instance = SharedResourcePointer<TimerThread>::getSharedObjectWithoutCreating())
+                    {
+                        const LockType::ScopedLockType sl ((*instance)->lock);
+                        (*instance)->timerFd.registerIfNeeded();
+                    }
+                });
+            }
 
-            notify();
+            return true;
         }
-    }
 
-private:
-    LockType lock;
+        void registerIfNeeded()
+        {
+            JUCE_ASSERT_MESSAGE_THREAD
 
-    struct TimerCountdown
-    {
-        Timer* timer;
-        int countdownMs;
-    };
+            if (fd < 0 || isRegistered)
+                return;
 
-    std::vector<TimerCountdown> timers;
+            LinuxEventLoop::registerFdCallback (fd, [] (int)
+            {
+                if (auto instance = SharedResourcePointer<TimerThread>::getSharedObjectWithoutCreating())
+                    (*instance)->callTimers();
+            });
 
-    WaitableEvent callbackArrived;
+            isRegistered = true;
+        }
+
+        void close()
+        {
+            if (fd < 0)
+                return;
+
+            if (std::exchange (isRegistered, false))
+                LinuxEventLoop::unregisterFdCallback (fd);
+
+            ::close (fd);
+            fd = -1;
+        }
+
+        // Schedules the fd to become readable after the given number of milliseconds
+        void arm (int milliseconds)
+        {
+            itimerspec spec{};
+
+            if (milliseconds > 0)
+            {
+                spec.it_value.tv_sec  = (time_t) (milliseconds / 1000);
+                spec.it_value.tv_nsec = (long) (milliseconds % 1000) * 1000000;
+            }
+            else
+            {
+                spec.it_value.tv_nsec = 1; // a zero value would disarm the timer
+            }
+
+            timerfd_settime (fd, 0, &spec, nullptr);
+        }
+
+        void clear()
+        {
+            if (fd < 0)
+                return;
+
+            uint64_t numExpirations;
+            [[maybe_unused]] auto numBytes = read (fd, &numExpirations, sizeof (numExpirations));
+        }
+
+    private:
+        int fd = -1;
+        bool isRegistered = false;
+
+        JUCE_DECLARE_NON_COPYABLE (TimerFd)
+    };
+
+    TimerFd timerFd;
+   #endif
 
     struct CallTimersMessage final : public MessageManager::MessageBase
     {
@@ -273,67 +592,57 @@ private:
     };
 
     //==============================================================================
-    void shuffleTimerBackInQueue (size_t pos)
+    static int64 getCurrentTime() noexcept
     {
-        auto numTimers = timers.size();
-
-        if (pos < numTimers - 1)
-        {
-            auto t = timers[pos];
-
-            for (;;)
-            {
-                auto next = pos + 1;
-
-                if (next == numTimers || timers[next].countdownMs >= t.countdownMs)
-                    break;
-
-                timers[pos] = timers[next];
-                timers[pos].timer->positionInQueue = pos;
-
-                ++pos;
-            }
-
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
-        }
+        return (int64) Time::getMillisecondCounterHiRes();
     }
 
-    void shuffleTimerForwardInQueue (size_t pos)
+    void startTiming()
     {
-        if (pos > 0)
-        {
-            auto t = timers[pos];
+       #if JUCE_LINUX
+        if (timerFd.isOpen() || timerFd.open())
+            return;
+       #endif
 
-            while (pos > 0)
-            {
-                auto& prev = timers[(size_t) pos - 1];
+        if (! isThreadRunning())
+            startThread (Thread::Priority::high);
+    }
 
-                if (prev.countdownMs <= t.countdownMs)
-                    break;
+    void insertTimer (Timer* t)
+    {
+        wheel.insert (t, getCurrentTime() + t->timerPeriodMs);
 
-                timers[pos] = prev;
-                timers[pos].timer->positionInQueue = pos;
+        if (t->positionInWheel.expiryTime < nextWakeTime)
+            scheduleWakeAt (t->positionInWheel.expiryTime);
+    }
 
-                --pos;
-            }
+    void scheduleWakeAt (int64 time)
+    {
+        nextWakeTime = time;
 
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
+       #if JUCE_LINUX
+        if (timerFd.isOpen())
+        {
+            // Like the timer thread, this wakes up at least every 100ms even if there's nothing
+            // due, because calling the timers keeps Time::getApproximateMillisecondCounter() fresh
+            timerFd.arm ((int) jlimit ((int64) 0, (int64) 100, time - getCurrentTime()));
+            return;
         }
+       #endif
+
+        notify();
     }
 
-    int getTimeUntilFirstTimer (int numMillisecsElapsed)
+    int getTimeUntilFirstTimer()
     {
         const LockType::ScopedLockType sl (lock);
 
-        if (timers.empty())
-            return 1000;
+        nextWakeTime = wheel.getNextExpiryTime();
 
-        for (auto& t : timers)
-            t.countdownMs -= numMillisecsElapsed;
+        if (nextWakeTime == std::numeric_limits<int64>::max())
+            return 1000;
 
-        return timers.front().countdownMs;
+        return (int) jlimit ((int64) -1, (int64) 1000, nextWakeTime - getCurrentTime());
     }
 
     //==============================================================================
@@ -344,6 +653,13 @@ private:
 
     void stopThreadAsync()
     {
+       #if JUCE_LINUX
+        {
+            const LockType::ScopedLockType sl (lock);
+            timerFd.close();
+        }
+       #endif
+
         signalThreadShouldExit();
         callbackArrived.signal();
     }
@@ -407,6 +723,20 @@ void JUCE_CALLTYPE Timer::callPendingTimersSynchronously()
         (*instance)->callTimersSynchronously();
 }
 
+Timer::Statistics JUCE_CALLTYPE Timer::getStatistics()
+{
+    if (auto instance = SharedResourcePointer<TimerThread>::getSharedObjectWithoutCreating())
+        return (*instance)->getStatistics();
+
+    return {};
+}
+
+void JUCE_CALLTYPE Timer::resetStatistics()
+{
+    if (auto instance = SharedResourcePointer<TimerThread>::getSharedObjectWithoutCreating())
+        (*instance)->resetStatistics();
+}
+
 struct LambdaInvoker final : private Timer,
                              private DeletedAtShutdown
 {
@@ -437,4 +767,250 @@ void JUCE_CALLTYPE Timer::callAfterDelay (int milliseconds, std::function<void()
     new LambdaInvoker (milliseconds, std::move (f));
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimerTests final : public UnitTest
+{
+public:
+    TimerTests()
+        : UnitTest ("Timers", UnitTestCategories::events)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Timers expire on time as they cascade down the wheel");
+        {
+            TestWheel wheel;
+            std::vector<Item> items (std::initializer_list<Item> { { 4097 }, { 1 }, { 64 }, { 300000 }, { 63 }, { 4096 },
+                                                                   { 65 }, { 262144 }, { 16777221 }, { 4095 }, { 1 } });
+
+            for (auto& item : items)
+                wheel.insert (&item, item.expiryTime);
+
+            expectAllExpireOnTime (wheel, items);
+        }
+
+        beginTest ("Very long periods");
+        {
+            TestWheel wheel;
+            wheel.advanceTo (12345);
+
+            std::vector<Item> items (std::initializer_list<Item> { { 12345 + (int64) std::numeric_limits<int>::max() },
+                                                                   { std::numeric_limits<int>::max() },
+                                                                   { 12346 } });
+
+            for (auto& item : items)
+                wheel.insert (&item, item.expiryTime);
+
+            expectAllExpireOnTime (wheel, items);
+        }
+
+        beginTest ("Timers keep expiring when the top level of the wheel wraps around");
+        {
+            constexpr auto wrapTime = (int64) 1 << 36;
+
+            TestWheel wheel;
+            wheel.advanceTo (wrapTime - 1000);
+
+            std::vector<Item> items (std::initializer_list<Item> { { wrapTime + 5 }, { wrapTime - 1 }, { wrapTime },
+                                                                   { wrapTime + 100000 }, { wrapTime - 999 },
+                                                                   { wrapTime + std::numeric_limits<int>::max() },
+                                                                   { 2 * wrapTime + 3 } });
+
+            for (auto& item : items)
+                wheel.insert (&item, item.expiryTime);
+
+            expect (wheel.getNextExpiryTime() <= wrapTime - 999);
+            expectAllExpireOnTime (wheel, items);
+        }
+
+        beginTest ("Repeating timers keep firing when the top level of the wheel wraps around");
+        {
+            constexpr auto wrapTime = (int64) 1 << 36;
+
+            TestWheel wheel;
+            wheel.advanceTo (wrapTime - 5000);
+
+            Item repeating;
+            wheel.insert (&repeating, wheel.getCurrentTime() + 700);
+
+            const auto endTime = wrapTime + 5000;
+            int numCallbacks = 0;
+
+            // This reschedules the timer in the same way as the timer thread
+            while (wheel.getCurrentTime() < endTime)
+            {
+                const auto next = wheel.getNextExpiryTime();
+                expect (next < std::numeric_limits<int64>::max());
+                wheel.advanceTo (jmin (next, endTime));
+
+                if (auto* due = wheel.getFirstDueTimer())
+                {
+                    expectEquals (due->position.expiryTime, wheel.getCurrentTime());
+                    wheel.remove (due);
+                    wheel.insert (due, wheel.getCurrentTime() + 700);
+                    ++numCallbacks;
+                }
+            }
+
+            expectEquals (numCallbacks, 10000 / 700);
+            wheel.remove (&repeating);
+            expect (wheel.isEmpty());
+        }
+
+        beginTest ("Timers that are removed don't expire");
+        {
+            TestWheel wheel;
+            std::vector<Item> items (std::initializer_list<Item> { { 10 }, { 20 }, { 5000 }, { 6000 }, { 1000000 }, { 2000000 } });
+
+            for (auto& item : items)
+                wheel.insert (&item, item.expiryTime);
+
+            wheel.advanceTo (15);
+            expect (wheel.getFirstDueTimer() == &items[0]);
+
+            for (auto* item : { &items[0], &items[3], &items[5] })
+                wheel.remove (item);
+
+            expect (wheel.getFirstDueTimer() == nullptr);
+            expectAllExpireOnTime (wheel, { items[1], items[2], items[4] });
+        }
+
+        beginTest ("Timers can be stopped and restarted from their own callbacks");
+        {
+            const ScopedJuceInitialiser_GUI libraryInitialiser;
+
+            CallbackTimer timer;
+            int numCallbacks = 0;
+
+            timer.callback = [&]
+            {
+                ++numCallbacks;
+                timer.stopTimer();
+            };
+
+            timer.startTimer (1);
+            callPendingTimers (5);
+            expectEquals (numCallbacks, 1);
+            expect (! timer.isTimerRunning());
+
+            numCallbacks = 0;
+            timer.callback = [&]
+            {
+                ++numCallbacks;
+                timer.startTimer (100000);
+            };
+
+            timer.startTimer (1);
+            callPendingTimers (5);
+            expectEquals (numCallbacks, 1);
+            expect (timer.isTimerRunning());
+            expectEquals (timer.getTimerInterval(), 100000);
+
+            numCallbacks = 0;
+            timer.callback = [&]
+            {
+                if (++numCallbacks < 3)
+                    timer.startTimer (1);
+                else
+                    timer.stopTimer();
+            };
+
+            timer.startTimer (1);
+            callPendingTimers (10);
+            expectEquals (numCallbacks, 3);
+            expect (! timer.isTimerRunning());
+
+            auto selfDeleting = std::make_unique<CallbackTimer>();
+            numCallbacks = 0;
+            selfDeleting->callback = [&]
+            {
+                ++numCallbacks;
+                selfDeleting.reset();
+            };
+
+            selfDeleting->startTimer (1);
+            callPendingTimers (5);
+            expectEquals (numCallbacks, 1);
+            expect (selfDeleting == nullptr);
+        }
+    }
+
+private:
+    struct Item
+    {
+        Item (int64 t = 0) : expiryTime (t) {}
+
+        struct Position
+        {
+            Item* previous = nullptr;
+            Item* next = nullptr;
+            int64 expiryTime = 0;
+            int list = -1;
+        };
+
+        int64 expiryTime;
+        Position position;
+    };
+
+    using TestWheel = TimerWheel<Item, Item::Position, &Item::position>;
+
+    struct CallbackTimer final : public Timer
+    {
+        ~CallbackTimer() override    { stopTimer(); }
+        void timerCallback() override { callback(); }
+
+        std::function<void()> callback;
+    };
+
+    // Advances the wheel the way the timer thread does, checking that each item becomes due at its expiry time
+    void expectAllExpireOnTime (TestWheel& wheel, const std::vector<Item>& items)
+    {
+        std::vector<int64> expected, actual;
+
+        for (auto& item : items)
+            expected.push_back (item.expiryTime);
+
+        std::sort (expected.begin(), expected.end());
+
+        while (! wheel.isEmpty())
+        {
+            const auto next = wheel.getNextExpiryTime();
+
+            if (next == std::numeric_limits<int64>::max())
+            {
+                expect (false, "The wheel has timers but no next expiry time");
+                return;
+            }
+
+            expect (next <= expected[actual.size()]);
+            wheel.advanceTo (next);
+
+            while (auto* due = wheel.getFirstDueTimer())
+            {
+                expectEquals (due->position.expiryTime, wheel.getCurrentTime());
+                actual.push_back (due->position.expiryTime);
+                wheel.remove (due);
+            }
+        }
+
+        expect (actual == expected);
+    }
+
+    static void callPendingTimers (int numTimes)
+    {
+        for (int i = 0; i < numTimes; ++i)
+        {
+            Thread::sleep (5);
+            Timer::callPendingTimersSynchronously();
+        }
+    }
+};
+
+static TimerTests timerTests;
+
+#endif
+
 } // namespace juce
@@ -137,9 +137,51 @@ public:
     */
     static void JUCE_CALLTYPE callPendingTimersSynchronously();
 
+    //==============================================================================
+    /** Counters describing how well the message thread is keeping up with the timers.
+
+        @see getStatistics
+    */
+    struct Statistics
+    {
+        /** The number of timer callbacks that have been made. */
+        int64 numCallbacks = 0;
+
+        /** The number of callbacks that took longer to run than their timer's interval. */
+        int64 numOverruns = 0;
+
+        /** The number of callbacks that were made a whole interval or more after they were
+            due, which means that at least one callback for that timer has been skipped.
+        */
+        int64 numLateCallbacks = 0;
+
+        /** The longest time that a callback has been made after it was due. */
+        double maxLatenessMs = 0.0;
+
+        /** The longest time that a timer callback has taken to run. */
+        double maxCallbackMs = 0.0;
+    };
+
+    /** Returns the counters gathered across all timers since they were last reset.
+        This can be called from any thread.
+    */
+    static Statistics JUCE_CALLTYPE getStatistics();
+
+    /** Clears the counters returned by getStatistics(). */
+    static void JUCE_CALLTYPE resetStatistics();
+
 private:
     class TimerThread;
-    size_t positionInQueue = (size_t) -1;
+
+    struct PositionInWheel
+    {
+        Timer* previous = nullptr;
+        Timer* next = nullptr;
+        int64 expiryTime = 0;
+        int list = -1;
+    };
+
+    PositionInWheel positionInWheel;
     int timerPeriodMs = 0;
     SharedResourcePointer<TimerThread> timerThread;
 
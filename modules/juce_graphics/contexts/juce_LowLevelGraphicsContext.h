@@ -114,6 +114,12 @@ public:
 
     virtual void strokePath (const Path& path, const PathStrokeType& strokeType, const AffineTransform& transform)
     {
+        if (auto cached = PathRasterisationCache::getStrokedPath (path, strokeType, transform, getPhysicalPixelScaleFactor()))
+        {
+            fillPath (*cached, {});
+            return;
+        }
+
         Path stroke;
         strokeType.createStrokedPath (stroke, path, transform, getPhysicalPixelScaleFactor());
         fillPath (stroke, {});
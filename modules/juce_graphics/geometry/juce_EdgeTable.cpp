@@ -291,6 +291,44 @@ static void copyEdgeTableData (int* dest,
     }
 }
 
+EdgeTable::EdgeTable (const EdgeTable& other, Rectangle<int> clipLimits)
+   : bounds (other.bounds.getIntersection (clipLimits)),
+     maxEdgesPerLine (other.maxEdgesPerLine),
+     lineStrideElements (other.lineStrideElements)
+{
+    if (bounds.isEmpty())
+    {
+        bounds.setHeight (0);
+        needToCheckEmptiness = false;
+        allocate();
+        table[0] = 0;
+        return;
+    }
+
+    allocate();
+
+    copyEdgeTableData (table.data(),
+                       (size_t) lineStrideElements,
+                       other.table.data() + (size_t) lineStrideElements * (size_t) (bounds.getY() - other.bounds.getY()),
+                       (size_t) lineStrideElements,
+                       (size_t) bounds.getHeight());
+
+    if (bounds.getX() > other.bounds.getX() || bounds.getRight() < other.bounds.getRight())
+    {
+        auto x1 = scale * bounds.getX();
+        auto x2 = scale * bounds.getRight();
+        int* line = table.data();
+
+        for (int i = bounds.getHeight(); --i >= 0;)
+        {
+            if (line[0] != 0)
+                clipEdgeTableLineToRange (line, x1, x2);
+
+            line += lineStrideElements;
+        }
+    }
+}
+
 //==============================================================================
 static size_t getEdgeTableAllocationSize (int lineStride, int height) noexcept
 {
@@ -72,6 +72,13 @@ public:
     /** Creates an edge table containing a rectangle list. */
     explicit EdgeTable (const RectangleList<float>& rectanglesToAdd);
 
+    /** Creates a copy of the part of another edge table that lies within the given area.
+
+        This is quicker than copying the whole table and then clipping it, because only
+        the lines that are needed get copied.
+    */
+    EdgeTable (const EdgeTable& tableToCopy, Rectangle<int> clipLimits);
+
     //==============================================================================
     void clipToRectangle (Rectangle<int> r);
     void excludeRectangle (Rectangle<int> r);
@@ -91,6 +98,9 @@ public:
     */
     void optimiseTable();
 
+    /** Returns the number of bytes that the table has allocated for its data. */
+    size_t getTableSizeInBytes() const noexcept                  { return table.size() * sizeof (int); }
+
 
     //==============================================================================
     /** Iterates the lines in the table, for rendering.
@@ -810,6 +810,7 @@ private:
     friend class PathFlatteningIterator;
     friend class Path::Iterator;
     friend class EdgeTable;
+    friend class PathRasterisationCache;
 
     Array<float> data;
 
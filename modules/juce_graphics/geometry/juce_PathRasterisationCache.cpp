@@ -0,0 +1,418 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static std::atomic<bool> pathRasterisationCacheEnabled { true };
+
+struct PathRasterisationCache::Pimpl  : private DeletedAtShutdown
+{
+    Pimpl() = default;
+
+    ~Pimpl() override
+    {
+        clearSingletonInstance();
+    }
+
+    JUCE_DECLARE_SINGLETON_INLINE (PathRasterisationCache::Pimpl, false)
+
+    //==============================================================================
+    struct Entry
+    {
+        bool matches (const Path& p, const AffineTransform& t, const PathStrokeType* s, float accuracy) const
+        {
+            return transform == t
+                && (s == nullptr ? ! strokeType.has_value() : (strokeType.has_value() && *strokeType == *s))
+                && exactlyEqual (extraAccuracy, accuracy)
+                && path == p;
+        }
+
+        uint64 hashCode;
+        Path path;
+        AffineTransform transform;
+        std::optional<PathStrokeType> strokeType;
+        float extraAccuracy;
+        std::shared_ptr<const EdgeTable> edgeTable;
+        std::shared_ptr<const Path> strokedPath;
+        size_t numBytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    //==============================================================================
+    std::shared_ptr<const EdgeTable> getEdgeTable (const Path& path, const AffineTransform& transform, Rectangle<int> clipBounds)
+    {
+        const auto bounds = path.getBoundsTransformed (transform).getSmallestIntegerContainer().expanded (1);
+
+        // A table that could never fit in the cache would just be built, thrown away and rebuilt on every paint
+        if (estimateEdgeTableSize (path, bounds) > maxBytes / 4)
+            return {};
+
+        const auto hashCode = combineHashes (getHashCode (path), transform, nullptr, 0.0f);
+        auto& shard = getShard (hashCode);
+        bool shouldCreate = false;
+
+        {
+            const SpinLock::ScopedLockType sl (shard.lock);
+
+            if (auto* entry = shard.lookUp (hashCode, path, transform, nullptr, 0.0f, shouldCreate))
+                return entry->edgeTable;
+        }
+
+        // If only a small part of the path is visible, it's cheaper for the caller to build a table for just that part
+        if (! shouldCreate || getArea (bounds) > maxAreaRatioToClip * getArea (clipBounds))
+            return {};
+
+        auto table = std::make_shared<EdgeTable> (bounds, path, transform);
+
+        addEntry (shard, { hashCode, path, transform, std::nullopt, 0.0f, table, nullptr,
+                           sizeof (Entry) + getSizeInBytes (path) + table->getTableSizeInBytes() });
+        return table;
+    }
+
+    std::shared_ptr<const Path> getStrokedPath (const Path& path, const PathStrokeType& strokeType,
+                                                const AffineTransform& transform, float extraAccuracy)
+    {
+        const auto hashCode = combineHashes (getHashCode (path), transform, &strokeType, extraAccuracy);
+        auto& shard = getShard (hashCode);
+        bool shouldCreate = false;
+
+        {
+            const SpinLock::ScopedLockType sl (shard.lock);
+
+            if (auto* entry = shard.lookUp (hashCode, path, transform, &strokeType, extraAccuracy, shouldCreate))
+                return entry->strokedPath;
+        }
+
+        if (! shouldCreate)
+            return {};
+
+        auto stroke = std::make_shared<Path>();
+        strokeType.createStrokedPath (*stroke, path, transform, extraAccuracy);
+
+        addEntry (shard, { hashCode, path, transform, strokeType, extraAccuracy, nullptr, stroke,
+                           sizeof (Entry) + getSizeInBytes (path) + getSizeInBytes (*stroke) });
+        return stroke;
+    }
+
+    //==============================================================================
+    void setMaximumMemoryUsage (size_t numBytes)
+    {
+        maxBytes = numBytes;
+
+        for (auto& shard : shards)
+        {
+            const SpinLock::ScopedLockType sl (shard.lock);
+            shard.removeOldestEntriesIfNeeded (*this);
+        }
+    }
+
+    void clear()
+    {
+        for (auto& shard : shards)
+        {
+            const SpinLock::ScopedLockType sl (shard.lock);
+            numBytesUsed -= shard.numBytesUsed;
+            shard.entries.clear();
+            shard.index.clear();
+            shard.candidates.clear();
+            shard.numBytesUsed = 0;
+        }
+    }
+
+    Statistics getStatistics() const
+    {
+        Statistics result;
+
+        for (auto& shard : shards)
+        {
+            const SpinLock::ScopedLockType sl (shard.lock);
+            result.numHits      += shard.numHits;
+            result.numMisses    += shard.numMisses;
+            result.numEvictions += shard.numEvictions;
+            result.numEntries   += (int) shard.entries.size();
+            result.numBytesUsed += shard.numBytesUsed;
+        }
+
+        return result;
+    }
+
+    void resetStatistics()
+    {
+        for (auto& shard : shards)
+        {
+            const SpinLock::ScopedLockType sl (shard.lock);
+            shard.numHits = shard.numMisses = shard.numEvictions = 0;
+        }
+    }
+
+private:
+    //==============================================================================
+    /*  The entries are spread across several independently-locked shards (chosen by their
+        hash code), so that threads which are rendering at the same time rarely have to
+        wait for each other. The memory limit applies to the total across all of them.
+    */
+    struct Shard
+    {
+        EntryList entries; // (the most recently used entries are at the front)
+        std::unordered_map<uint64, EntryList::iterator> index;
+        std::unordered_set<uint64> candidates;
+        int64 numHits = 0, numMisses = 0, numEvictions = 0;
+        size_t numBytesUsed = 0;
+        mutable SpinLock lock;
+
+        /*  Looks for a matching entry, and if there isn't one, decides whether the caller should
+            create one. That only happens the second time a particular shape is asked for, so that
+            one-off shapes don't displace the ones that are being drawn repeatedly.
+        */
+        Entry* lookUp (uint64 hashCode, const Path& path, const AffineTransform& transform,
+                       const PathStrokeType* strokeType, float extraAccuracy, bool& shouldCreate)
+        {
+            if (const auto iter = index.find (hashCode);
+                iter != index.end() && iter->second->matches (path, transform, strokeType, extraAccuracy))
+            {
+                ++numHits;
+                entries.splice (entries.begin(), entries, iter->second);
+                return &*iter->second;
+            }
+
+            ++numMisses;
+            shouldCreate = candidates.erase (hashCode) > 0;
+
+            if (! shouldCreate)
+            {
+                if (candidates.size() >= maxNumCandidatesPerShard)
+                    candidates.clear();
+
+                candidates.insert (hashCode);
+            }
+
+            return nullptr;
+        }
+
+        void removeEntry (Pimpl& owner, EntryList::iterator iter)
+        {
+            numBytesUsed -= iter->numBytes;
+            owner.numBytesUsed -= iter->numBytes;
+            index.erase (iter->hashCode);
+            entries.erase (iter);
+        }
+
+        // Returns false if the shard ran out of entries before the total was back within the limit
+        bool removeOldestEntriesIfNeeded (Pimpl& owner, size_t numEntriesToKeep = 0)
+        {
+            while (owner.numBytesUsed > owner.maxBytes)
+            {
+                if (entries.size() <= numEntriesToKeep)
+                    return false;
+
+                removeEntry (owner, std::prev (entries.end()));
+                ++numEvictions;
+            }
+
+            return true;
+        }
+    };
+
+    static constexpr size_t numShards = 8;
+    static constexpr size_t maxNumCandidatesPerShard = 512;
+    static constexpr int64 maxAreaRatioToClip = 4;
+
+    std::array<Shard, numShards> shards;
+    std::atomic<size_t> numBytesUsed { 0 }, maxBytes { 8 * 1024 * 1024 };
+
+    Shard& getShard (uint64 hashCode) noexcept
+    {
+        return shards[(size_t) (hashCode >> 32) % numShards];
+    }
+
+    static int64 getArea (Rectangle<int> r) noexcept
+    {
+        return (int64) jmax (0, r.getWidth()) * (int64) jmax (0, r.getHeight());
+    }
+
+    // This matches the initial allocation made by the EdgeTable constructor - it can only grow from there
+    static size_t estimateEdgeTableSize (const Path& path, Rectangle<int> bounds) noexcept
+    {
+        const auto edgesPerLine = jmax (16, 4 * (int) std::sqrt (path.data.size()));
+        return (size_t) (edgesPerLine * 2 + 1) * (size_t) (jmax (0, bounds.getHeight()) + 2) * sizeof (int);
+    }
+
+    static uint64 combineHashes (uint64 pathHash, const AffineTransform& t, const PathStrokeType* s, float accuracy) noexcept
+    {
+        auto hash = pathHash;
+
+        const auto add = [&hash] (float f)
+        {
+            hash = (hash ^ (uint64) readUnaligned<uint32> (&f)) * 1099511628211ull;
+        };
+
+        for (auto f : { t.mat00, t.mat01, t.mat02, t.mat10, t.mat11, t.mat12 })
+            add (f);
+
+        if (s != nullptr)
+        {
+            add (s->getStrokeThickness());
+            add ((float) s->getJointStyle());
+            add ((float) s->getEndStyle());
+            add (accuracy);
+            hash = ~hash;
+        }
+
+        return hash;
+    }
+
+    void addEntry (Shard& shard, Entry&& entry)
+    {
+        // Don't let a single enormous shape push everything else out
+        if (entry.numBytes > maxBytes / 4)
+            return;
+
+        bool needsEvictionElsewhere = false;
+
+        {
+            const SpinLock::ScopedLockType sl (shard.lock);
+
+            if (const auto existing = shard.index.find (entry.hashCode); existing != shard.index.end())
+                shard.removeEntry (*this, existing->second);
+
+            shard.entries.push_front (std::move (entry));
+            shard.index[shard.entries.front().hashCode] = shard.entries.begin();
+            shard.numBytesUsed += shard.entries.front().numBytes;
+            numBytesUsed += shard.entries.front().numBytes;
+
+            needsEvictionElsewhere = ! shard.removeOldestEntriesIfNeeded (*this, 1);
+        }
+
+        // Only one shard is ever locked at a time, so this can't deadlock with another thread
+        if (needsEvictionElsewhere)
+        {
+            for (auto& other : shards)
+            {
+                if (&other == &shard)
+                    continue;
+
+                const SpinLock::ScopedLockType sl (other.lock);
+
+                if (other.removeOldestEntriesIfNeeded (*this))
+                    break;
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+uint64 PathRasterisationCache::getHashCode (const Path& path) noexcept
+{
+    auto hash = path.useNonZeroWinding ? 14695981039346656037ull : 1469598103934665603ull;
+
+    for (auto f : path.data)
+        hash = (hash ^ (uint64) readUnaligned<uint32> (&f)) * 1099511628211ull;
+
+    return hash;
+}
+
+bool PathRasterisationCache::shouldUseCacheFor (const Path& path) noexcept
+{
+    // Flattening a handful of straight lines is quicker than hashing and looking them up
+    return isEnabled() && path.data.size() >= minNumPathElements;
+}
+
+size_t PathRasterisationCache::getSizeInBytes (const Path& path) noexcept
+{
+    return sizeof (Path) + (size_t) path.data.size() * sizeof (float);
+}
+
+void PathRasterisationCache::setEnabled (bool shouldBeEnabled)
+{
+    pathRasterisationCacheEnabled = shouldBeEnabled;
+
+    if (! shouldBeEnabled)
+        clear();
+}
+
+bool PathRasterisationCache::isEnabled() noexcept
+{
+    return pathRasterisationCacheEnabled;
+}
+
+void PathRasterisationCache::setMaximumMemoryUsage (size_t numBytes)
+{
+    Pimpl::getInstance()->setMaximumMemoryUsage (numBytes);
+}
+
+void PathRasterisationCache::clear()
+{
+    if (auto* instance = Pimpl::getInstanceWithoutCreating())
+        instance->clear();
+}
+
+PathRasterisationCache::Statistics PathRasterisationCache::getStatistics()
+{
+    if (auto* instance = Pimpl::getInstanceWithoutCreating())
+        return instance->getStatistics();
+
+    return {};
+}
+
+void PathRasterisationCache::resetStatistics()
+{
+    if (auto* instance = Pimpl::getInstanceWithoutCreating())
+        instance->resetStatistics();
+}
+
+std::shared_ptr<const EdgeTable> PathRasterisationCache::getEdgeTable (const Path& path, const AffineTransform& transform,
+                                                                      Rectangle<int> clipBounds)
+{
+    if (! shouldUseCacheFor (path))
+        return {};
+
+    return Pimpl::getInstance()->getEdgeTable (path, transform, clipBounds);
+}
+
+std::shared_ptr<const Path> PathRasterisationCache::getStrokedPath (const Path& path,
+                                                                    const PathStrokeType& strokeType,
+                                                                    const AffineTransform& transform,
+                                                                    float extraAccuracy)
+{
+    if (! shouldUseCacheFor (path))
+        return {};
+
+    return Pimpl::getInstance()->getStrokedPath (path, strokeType, transform, extraAccuracy);
+}
+
+} // namespace juce
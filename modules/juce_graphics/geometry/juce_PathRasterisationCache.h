@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A global cache of rasterised paths and stroke outlines.
+
+    Turning a Path into an EdgeTable (or stroking it with a PathStrokeType) means
+    flattening all of its curves, which is by far the most expensive part of drawing
+    a path with the software renderer. UIs tend to draw exactly the same shapes on
+    every repaint though, so the renderer keeps the results here, keyed by the content
+    of the path, the transform and the stroke parameters, and re-uses them whenever
+    the same geometry is drawn again.
+
+    A path is only stored the second time it's seen, so that shapes which change on
+    every frame don't push everything else out of the cache. Least-recently-used
+    entries are discarded when the cache grows beyond its memory limit. Very simple
+    paths, which are as quick to flatten as they are to look up, aren't cached at all.
+
+    You don't need to use this class directly unless you want to tune or monitor it.
+
+    @see EdgeTable, PathStrokeType, ImageCache
+
+    @tags{Graphics}
+*/
+class JUCE_API  PathRasterisationCache
+{
+public:
+    //==============================================================================
+    /** Enables or disables the cache. It's enabled by default.
+        Disabling it also frees everything that it's currently holding.
+    */
+    static void setEnabled (bool shouldBeEnabled);
+
+    /** Returns true if the cache is currently enabled. */
+    static bool isEnabled() noexcept;
+
+    /** Sets the maximum number of bytes that the cache may use. The default is 8MB. */
+    static void setMaximumMemoryUsage (size_t numBytes);
+
+    /** Discards everything that's currently in the cache. */
+    static void clear();
+
+    //==============================================================================
+    /** Some counters that describe how well the cache is working. */
+    struct Statistics
+    {
+        int64 numHits = 0;          /**< The number of times a cached result was re-used. */
+        int64 numMisses = 0;        /**< The number of times a result had to be calculated. */
+        int64 numEvictions = 0;     /**< The number of entries discarded to stay within the memory limit. */
+        int numEntries = 0;         /**< The number of entries currently in the cache. */
+        size_t numBytesUsed = 0;    /**< The approximate amount of memory that the cache is using. */
+    };
+
+    /** Returns the current statistics. */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and eviction counters. */
+    static void resetStatistics();
+
+    //==============================================================================
+    /** Returns a cached EdgeTable for a path and transform.
+
+        The table covers the entire transformed path, so it will need to be clipped
+        before rendering - use the EdgeTable constructor that takes a clip region to
+        copy just the part that's needed. This returns nullptr if the cache is disabled, if the
+        path hasn't been seen often enough to be worth caching, or if its table would be too
+        big to cache or much bigger than the area being drawn, in which case the caller should
+        build its own EdgeTable for the clip region.
+    */
+    static std::shared_ptr<const EdgeTable> getEdgeTable (const Path& path,
+                                                          const AffineTransform& transform,
+                                                          Rectangle<int> clipBounds);
+
+    /** Returns the cached result of calling PathStrokeType::createStrokedPath() with
+        the given arguments, or nullptr if it isn't available.
+
+        @see getEdgeTable
+    */
+    static std::shared_ptr<const Path> getStrokedPath (const Path& path,
+                                                       const PathStrokeType& strokeType,
+                                                       const AffineTransform& transform,
+                                                       float extraAccuracy);
+
+private:
+    //==============================================================================
+    struct Pimpl;
+
+    static constexpr int minNumPathElements = 32;
+
+    static uint64 getHashCode (const Path&) noexcept;
+    static bool shouldUseCacheFor (const Path&) noexcept;
+    static size_t getSizeInBytes (const Path&) noexcept;
+
+    PathRasterisationCache() = delete;
+};
+
+} // namespace juce
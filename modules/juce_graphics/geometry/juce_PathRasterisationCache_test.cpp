@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class PathRasterisationCacheTests final : public UnitTest
+{
+public:
+    PathRasterisationCacheTests() : UnitTest ("PathRasterisationCache", UnitTestCategories::graphics) {}
+
+    void runTest() override
+    {
+        const auto wasEnabled = PathRasterisationCache::isEnabled();
+
+        Path arc;
+        arc.addCentredArc (50.0f, 50.0f, 35.0f, 35.0f, 0.0f, -2.4f, 1.7f, true);
+
+        Path star;
+        star.addStar ({ 50.0f, 50.0f }, 7, 12.0f, 30.0f, 0.3f);
+
+        const auto transform = AffineTransform::rotation (0.3f, 50.0f, 50.0f).scaled (0.9f).translated (3.5f, 1.25f);
+        const PathStrokeType strokeType (6.0f, PathStrokeType::curved, PathStrokeType::rounded);
+        const Rectangle<int> area (0, 0, 100, 100);
+
+        const auto draw = [&] (const Image& image)
+        {
+            Graphics g (image);
+            g.fillAll (Colours::white);
+            g.reduceClipRegion (Rectangle<int> (5, 5, 80, 70));
+            g.setColour (Colours::blue);
+            g.strokePath (arc, strokeType, transform);
+            g.setColour (Colours::red.withAlpha (0.7f));
+            g.fillPath (star, transform);
+        };
+
+        beginTest ("Cached paths render identically to uncached ones");
+        {
+            PathRasterisationCache::setEnabled (false);
+
+            Image reference (Image::ARGB, 100, 100, true, SoftwareImageType());
+            draw (reference);
+
+            PathRasterisationCache::setEnabled (true);
+            PathRasterisationCache::resetStatistics();
+
+            for (int i = 0; i < 4; ++i)
+            {
+                Image image (Image::ARGB, 100, 100, true, SoftwareImageType());
+                draw (image);
+
+                expect (imagesAreIdentical (image, reference));
+            }
+
+            // The first two frames are misses (the first time a shape is seen it isn't cached),
+            // after which both the stroke outline and the two filled shapes should be hits
+            const auto stats = PathRasterisationCache::getStatistics();
+            expectEquals (stats.numHits, (int64) 6);
+            expectEquals (stats.numMisses, (int64) 6);
+            expectEquals (stats.numEntries, 3);
+            expect (stats.numBytesUsed > 0);
+        }
+
+        beginTest ("Changing the path or transform doesn't return stale results");
+        {
+            PathRasterisationCache::clear();
+
+            auto other = star;
+            other.applyTransform (AffineTransform::translation (1.0f, 0.0f));
+
+            for (int i = 0; i < 2; ++i)
+            {
+                PathRasterisationCache::getEdgeTable (star, transform, area);
+                PathRasterisationCache::getEdgeTable (star, {}, area);
+            }
+
+            expect (PathRasterisationCache::getEdgeTable (star, transform, area) != PathRasterisationCache::getEdgeTable (star, {}, area));
+            expect (PathRasterisationCache::getEdgeTable (other, transform, area) == nullptr);
+            expect (PathRasterisationCache::getStrokedPath (star, strokeType, transform, 1.0f) == nullptr);
+        }
+
+        beginTest ("Simple paths aren't cached");
+        {
+            PathRasterisationCache::clear();
+
+            Path rect;
+            rect.addRectangle (10.0f, 10.0f, 50.0f, 20.0f);
+
+            for (int i = 0; i < 3; ++i)
+            {
+                expect (PathRasterisationCache::getEdgeTable (rect, transform, area) == nullptr);
+                expect (PathRasterisationCache::getStrokedPath (rect, strokeType, transform, 1.0f) == nullptr);
+            }
+
+            expectEquals (PathRasterisationCache::getStatistics().numEntries, 0);
+        }
+
+        beginTest ("The cache stays within its memory limit");
+        {
+            PathRasterisationCache::clear();
+            PathRasterisationCache::resetStatistics();
+            PathRasterisationCache::setMaximumMemoryUsage (64 * 1024);
+
+            for (int i = 0; i < 100; ++i)
+            {
+                for (int j = 0; j < 2; ++j)
+                    PathRasterisationCache::getEdgeTable (star, AffineTransform::translation ((float) i, 0.0f), area);
+
+                expect (PathRasterisationCache::getStatistics().numBytesUsed <= 64 * 1024);
+            }
+
+            expect (PathRasterisationCache::getStatistics().numEvictions > 0);
+            PathRasterisationCache::setMaximumMemoryUsage (8 * 1024 * 1024);
+        }
+
+        beginTest ("Paths that are mostly outside the clip region aren't cached");
+        {
+            PathRasterisationCache::clear();
+            const auto zoom = AffineTransform::scale (40.0f);
+
+            for (int i = 0; i < 3; ++i)
+                expect (PathRasterisationCache::getEdgeTable (star, zoom, { 1000, 1000, 50, 50 }) == nullptr);
+
+            expectEquals (PathRasterisationCache::getStatistics().numEntries, 0);
+
+            PathRasterisationCache::setMaximumMemoryUsage (16 * 1024);
+
+            for (int i = 0; i < 3; ++i)
+                expect (PathRasterisationCache::getEdgeTable (star, zoom, star.getBoundsTransformed (zoom).getSmallestIntegerContainer()) == nullptr);
+
+            expectEquals (PathRasterisationCache::getStatistics().numEntries, 0);
+            PathRasterisationCache::setMaximumMemoryUsage (8 * 1024 * 1024);
+        }
+
+        beginTest ("Copying part of an edge table");
+        {
+            const EdgeTable table (area, star, transform);
+
+            const EdgeTable outside (table, { 200, 200, 10, 10 });
+            expect (outside.getMaximumBounds().isEmpty());
+
+            const EdgeTable above (table, { 0, -50, 100, 20 });
+            expect (above.getMaximumBounds().isEmpty());
+
+            const Rectangle<int> clip (20, 30, 40, 25);
+            EdgeTable expected (table);
+            expected.clipToRectangle (clip);
+            EdgeTable copied (table, clip);
+
+            expect (copied.getMaximumBounds() == clip);
+            expect (edgeTablesAreIdentical (copied, expected));
+        }
+
+        PathRasterisationCache::clear();
+        PathRasterisationCache::setEnabled (wasEnabled);
+    }
+
+private:
+    struct LevelRecorder
+    {
+        void setEdgeTableYPos (int newY)                          { y = newY; }
+        void handleEdgeTablePixel (int x, int level)              { levels[{ x, y }] = level; }
+        void handleEdgeTablePixelFull (int x)                     { levels[{ x, y }] = 255; }
+        void handleEdgeTableLine (int x, int width, int level)    { while (--width >= 0) levels[{ x++, y }] = level; }
+        void handleEdgeTableLineFull (int x, int width)           { handleEdgeTableLine (x, width, 255); }
+
+        std::map<std::pair<int, int>, int> levels;
+        int y = 0;
+    };
+
+    static bool edgeTablesAreIdentical (const EdgeTable& a, const EdgeTable& b)
+    {
+        LevelRecorder levelsA, levelsB;
+        a.iterate (levelsA);
+        b.iterate (levelsB);
+        return ! levelsA.levels.empty() && levelsA.levels == levelsB.levels;
+    }
+
+    static bool imagesAreIdentical (const Image& a, const Image& b)
+    {
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getPixelAt (x, y) != b.getPixelAt (x, y))
+                    return false;
+
+        return true;
+    }
+};
+
+static PathRasterisationCacheTests pathRasterisationCacheTests;
+
+} // namespace juce
@@ -179,6 +179,156 @@ namespace JPEGHelpers
     {
         return 0;
     }
+
+    /*  libjpeg can scale the image down by 1/2, 1/4 or 1/8 while it's still doing the
+        inverse DCT, so this picks the largest of those reductions that still leaves the
+        image at least as big as the thumbnail size that was asked for.
+    */
+    static void setUpScalingForThumbnail (jpeg_decompress_struct& decompStruct, int maxWidth, int maxHeight)
+    {
+        if (maxWidth <= 0 || maxHeight <= 0)
+            return;
+
+        const auto scale = jmin ((double) maxWidth  / (double) decompStruct.image_width,
+                                 (double) maxHeight / (double) decompStruct.image_height);
+
+        unsigned int denominator = 8;
+
+        while (denominator > 1 && scale * denominator > 1.0)
+            denominator /= 2;
+
+        decompStruct.scale_num = 1;
+        decompStruct.scale_denom = denominator;
+
+        // quality matters less than speed when the result is going to be shrunk anyway
+        decompStruct.dct_method = JDCT_IFAST;
+        decompStruct.do_fancy_upsampling = FALSE;
+    }
+
+    static bool canDecodeDirectlyInto (const Image::BitmapData& data) noexcept
+    {
+        return data.pixelFormat == Image::RGB
+            && data.pixelStride == 3
+            && (int) PixelRGB::indexR == 2 && (int) PixelRGB::indexG == 1 && (int) PixelRGB::indexB == 0;
+    }
+
+    static Image readImage (InputStream& in, int maxWidth, int maxHeight)
+    {
+        MemoryOutputStream mb;
+        mb << in;
+
+        Image image;
+
+        if (mb.getDataSize() > 16)
+        {
+            struct jpeg_decompress_struct jpegDecompStruct;
+
+            struct jpeg_error_mgr jerr;
+            setupSilentErrorHandler (jerr);
+            jpegDecompStruct.err = &jerr;
+
+            jpeg_create_decompress (&jpegDecompStruct);
+
+            jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
+                ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
+
+            bool hasFailed = false;
+            jpegDecompStruct.client_data = &hasFailed;
+
+            jpegDecompStruct.src->init_source       = dummyCallback1;
+            jpegDecompStruct.src->fill_input_buffer = jpegFill;
+            jpegDecompStruct.src->skip_input_data   = jpegSkip;
+            jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
+            jpegDecompStruct.src->term_source       = dummyCallback1;
+
+            jpegDecompStruct.src->next_input_byte   = static_cast<const unsigned char*> (mb.getData());
+            jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
+
+            jpeg_read_header (&jpegDecompStruct, TRUE);
+
+            if (! hasFailed)
+            {
+                setUpScalingForThumbnail (jpegDecompStruct, maxWidth, maxHeight);
+                jpeg_calc_output_dimensions (&jpegDecompStruct);
+
+                if (! hasFailed)
+                {
+                    const int width  = (int) jpegDecompStruct.output_width;
+                    const int height = (int) jpegDecompStruct.output_height;
+
+                    jpegDecompStruct.out_color_space = JCS_RGB;
+
+                    JSAMPARRAY buffer
+                        = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
+                                                                 JPOOL_IMAGE,
+                                                                 (JDIMENSION) width * 3, 1);
+
+                    if (jpeg_start_decompress (&jpegDecompStruct) && ! hasFailed)
+                    {
+                        image = Image (Image::RGB, width, height, false);
+                        image.getProperties()->set ("originalImageHadAlpha", false);
+                        const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+
+                        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+                        const bool decodeDirectly = canDecodeDirectlyInto (destData);
+
+                        for (int y = 0; y < height; ++y)
+                        {
+                            uint8* dest = destData.getLinePointer (y);
+
+                            JSAMPROW row = decodeDirectly ? dest : *buffer;
+                            jpeg_read_scanlines (&jpegDecompStruct, &row, 1);
+
+                            if (hasFailed)
+                                break;
+
+                            if (decodeDirectly)
+                            {
+                                // libjpeg gives us r, g, b, so just swap the red and blue bytes in place
+                                for (int i = width; --i >= 0;)
+                                {
+                                    std::swap (dest[0], dest[2]);
+                                    dest += 3;
+                                }
+                            }
+                            else if (hasAlphaChan)
+                            {
+                                const uint8* src = row;
+
+                                for (int i = width; --i >= 0;)
+                                {
+                                    ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                    ((PixelARGB*) dest)->premultiply();
+                                    dest += destData.pixelStride;
+                                    src += 3;
+                                }
+                            }
+                            else
+                            {
+                                const uint8* src = row;
+
+                                for (int i = width; --i >= 0;)
+                                {
+                                    ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                    dest += destData.pixelStride;
+                                    src += 3;
+                                }
+                            }
+                        }
+
+                        if (! hasFailed)
+                            jpeg_finish_decompress (&jpegDecompStruct);
+
+                        in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
+                    }
+                }
+            }
+
+            jpeg_destroy_decompress (&jpegDecompStruct);
+        }
+
+        return image;
+    }
    #endif
 
     //==============================================================================
@@ -259,108 +409,16 @@ Image JPEGImageFormat::decodeImage (InputStream& in)
    #if JUCE_USING_COREIMAGE_LOADER
     return juce_loadWithCoreImage (in);
    #else
-    using namespace jpeglibNamespace;
-    using namespace JPEGHelpers;
-
-    MemoryOutputStream mb;
-    mb << in;
-
-    Image image;
-
-    if (mb.getDataSize() > 16)
-    {
-        struct jpeg_decompress_struct jpegDecompStruct;
-
-        struct jpeg_error_mgr jerr;
-        setupSilentErrorHandler (jerr);
-        jpegDecompStruct.err = &jerr;
-
-        jpeg_create_decompress (&jpegDecompStruct);
-
-        jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
-            ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
-
-        bool hasFailed = false;
-        jpegDecompStruct.client_data = &hasFailed;
-
-        jpegDecompStruct.src->init_source       = dummyCallback1;
-        jpegDecompStruct.src->fill_input_buffer = jpegFill;
-        jpegDecompStruct.src->skip_input_data   = jpegSkip;
-        jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
-        jpegDecompStruct.src->term_source       = dummyCallback1;
-
-        jpegDecompStruct.src->next_input_byte   = static_cast<const unsigned char*> (mb.getData());
-        jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
-
-        jpeg_read_header (&jpegDecompStruct, TRUE);
-
-        if (! hasFailed)
-        {
-            jpeg_calc_output_dimensions (&jpegDecompStruct);
-
-            if (! hasFailed)
-            {
-                const int width  = (int) jpegDecompStruct.output_width;
-                const int height = (int) jpegDecompStruct.output_height;
-
-                jpegDecompStruct.out_color_space = JCS_RGB;
-
-                JSAMPARRAY buffer
-                    = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
-                                                             JPOOL_IMAGE,
-                                                             (JDIMENSION) width * 3, 1);
-
-                if (jpeg_start_decompress (&jpegDecompStruct) && ! hasFailed)
-                {
-                    image = Image (Image::RGB, width, height, false);
-                    image.getProperties()->set ("originalImageHadAlpha", false);
-                    const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
-
-                    const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
-
-                    for (int y = 0; y < height; ++y)
-                    {
-                        jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
-
-                        if (hasFailed)
-                            break;
-
-                        const uint8* src = *buffer;
-                        uint8* dest = destData.getLinePointer (y);
-
-                        if (hasAlphaChan)
-                        {
-                            for (int i = width; --i >= 0;)
-                            {
-                                ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                                ((PixelARGB*) dest)->premultiply();
-                                dest += destData.pixelStride;
-                                src += 3;
-                            }
-                        }
-                        else
-                        {
-                            for (int i = width; --i >= 0;)
-                            {
-                                ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                                dest += destData.pixelStride;
-                                src += 3;
-                            }
-                        }
-                    }
-
-                    if (! hasFailed)
-                        jpeg_finish_decompress (&jpegDecompStruct);
-
-                    in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
-                }
-            }
-        }
-
-        jpeg_destroy_decompress (&jpegDecompStruct);
-    }
+    return JPEGHelpers::readImage (in, 0, 0);
+   #endif
+}
 
-    return image;
+Image JPEGImageFormat::decodeThumbnail (InputStream& in, int maxWidth, int maxHeight)
+{
+   #if JUCE_USING_COREIMAGE_LOADER
+    return ImageFileFormat::decodeThumbnail (in, maxWidth, maxHeight);
+   #else
+    return rescaledToFit (JPEGHelpers::readImage (in, maxWidth, maxHeight), maxWidth, maxHeight);
    #endif
 }
 
@@ -276,6 +276,10 @@ namespace pnglibNamespace
 
   #define PNG_ARM_NEON_OPT 0
 
+  #if JUCE_GRAPHICS_USE_SSE2
+   #define PNG_FILTER_OPTIMIZATIONS juce_png_init_filter_functions_sse2
+  #endif
+
   #if ! defined (PNG_USER_WIDTH_MAX)
    #define PNG_USER_WIDTH_MAX 1000000
   #endif
@@ -326,6 +330,112 @@ namespace pnglibNamespace
   #include "pnglib/pngwtran.c"
   #include "pnglib/pngwutil.c"
 
+ #if JUCE_GRAPHICS_USE_SSE2
+  // SSE2 versions of the row unfiltering functions for 3 and 4 byte pixels, which
+  // libpng will use instead of its byte-at-a-time loops. Each step processes a whole
+  // pixel at once, carrying the previous reconstructed pixel along in a register.
+  namespace SSE2Filters
+  {
+      static __m128i load3 (const void* p)         { uint32_t tmp = 0; memcpy (&tmp, p, 3); return _mm_cvtsi32_si128 ((int) tmp); }
+      static __m128i load4 (const void* p)         { int tmp; memcpy (&tmp, p, 4); return _mm_cvtsi32_si128 (tmp); }
+      static void store3 (void* p, __m128i v)      { const auto tmp = _mm_cvtsi128_si32 (v); memcpy (p, &tmp, 3); }
+      static void store4 (void* p, __m128i v)      { const auto tmp = _mm_cvtsi128_si32 (v); memcpy (p, &tmp, 4); }
+
+      template <size_t bpp> static __m128i load (const void* p)      { return bpp == 3 ? load3 (p) : load4 (p); }
+      template <size_t bpp> static void store (void* p, __m128i v)   { if (bpp == 3) store3 (p, v); else store4 (p, v); }
+
+      template <size_t bpp>
+      static void sub (png_row_infop rowInfo, png_bytep row, png_const_bytep)
+      {
+          auto d = _mm_setzero_si128();
+
+          for (auto remaining = rowInfo->rowbytes; remaining >= bpp; remaining -= bpp, row += bpp)
+          {
+              d = _mm_add_epi8 (load<bpp> (row), d);
+              store<bpp> (row, d);
+          }
+      }
+
+      template <size_t bpp>
+      static void avg (png_row_infop rowInfo, png_bytep row, png_const_bytep prev)
+      {
+          const auto ones = _mm_set1_epi8 (1);
+          auto d = _mm_setzero_si128();
+
+          for (auto remaining = rowInfo->rowbytes; remaining >= bpp; remaining -= bpp, row += bpp, prev += bpp)
+          {
+              const auto a = d;
+              const auto b = load<bpp> (prev);
+
+              // _mm_avg_epu8 rounds up, but PNG wants (a + b) / 2 rounded down
+              auto average = _mm_avg_epu8 (a, b);
+              average = _mm_sub_epi8 (average, _mm_and_si128 (_mm_xor_si128 (a, b), ones));
+
+              d = _mm_add_epi8 (load<bpp> (row), average);
+              store<bpp> (row, d);
+          }
+      }
+
+      static __m128i abs16 (__m128i x)
+      {
+          return _mm_max_epi16 (x, _mm_sub_epi16 (_mm_setzero_si128(), x));
+      }
+
+      static __m128i select (__m128i condition, __m128i ifTrue, __m128i ifFalse)
+      {
+          return _mm_or_si128 (_mm_and_si128 (condition, ifTrue), _mm_andnot_si128 (condition, ifFalse));
+      }
+
+      template <size_t bpp>
+      static void paeth (png_row_infop rowInfo, png_bytep row, png_const_bytep prev)
+      {
+          // Paeth works on signed differences, so everything is widened to 16 bits
+          const auto zero = _mm_setzero_si128();
+          auto b = zero, d = zero;
+
+          for (auto remaining = rowInfo->rowbytes; remaining >= bpp; remaining -= bpp, row += bpp, prev += bpp)
+          {
+              const auto c = b;
+              const auto a = d;
+              b = _mm_unpacklo_epi8 (load<bpp> (prev), zero);
+              d = _mm_unpacklo_epi8 (load<bpp> (row),  zero);
+
+              auto pa = _mm_sub_epi16 (b, c);
+              auto pb = _mm_sub_epi16 (a, c);
+              auto pc = _mm_add_epi16 (pa, pb);
+
+              pa = abs16 (pa);
+              pb = abs16 (pb);
+              pc = abs16 (pc);
+
+              const auto smallest = _mm_min_epi16 (pc, _mm_min_epi16 (pa, pb));
+              const auto predictor = select (_mm_cmpeq_epi16 (smallest, pa), a,
+                                             select (_mm_cmpeq_epi16 (smallest, pb), b, c));
+
+              // the high bytes are all zero, so adding bytewise keeps the result mod 256
+              d = _mm_add_epi8 (d, predictor);
+              store<bpp> (row, _mm_packus_epi16 (d, d));
+          }
+      }
+  }
+
+  void juce_png_init_filter_functions_sse2 (png_structp pp, unsigned int bpp)
+  {
+      if (bpp == 3)
+      {
+          pp->read_filter[PNG_FILTER_VALUE_SUB - 1]   = SSE2Filters::sub<3>;
+          pp->read_filter[PNG_FILTER_VALUE_AVG - 1]   = SSE2Filters::avg<3>;
+          pp->read_filter[PNG_FILTER_VALUE_PAETH - 1] = SSE2Filters::paeth<3>;
+      }
+      else if (bpp == 4)
+      {
+          pp->read_filter[PNG_FILTER_VALUE_SUB - 1]   = SSE2Filters::sub<4>;
+          pp->read_filter[PNG_FILTER_VALUE_AVG - 1]   = SSE2Filters::avg<4>;
+          pp->read_filter[PNG_FILTER_VALUE_PAETH - 1] = SSE2Filters::paeth<4>;
+      }
+  }
+ #endif
+
   JUCE_END_IGNORE_WARNINGS_GCC_LIKE
 
 #else
@@ -407,14 +517,19 @@ namespace PNGHelpers
         return false;
     }
 
-    static bool readImageData (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf, png_bytepp rows) noexcept
+    static bool readImageData (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf, png_bytepp rows,
+                               bool swapRedAndBlue, bool addAlphaChannel) noexcept
     {
         if (setjmp (errorJumpBuf) == 0)
         {
             if (png_get_valid (pngReadStruct, pngInfoStruct, PNG_INFO_tRNS))
                 png_set_expand (pngReadStruct);
 
-            png_set_add_alpha (pngReadStruct, 0xff, PNG_FILLER_AFTER);
+            if (swapRedAndBlue)
+                png_set_bgr (pngReadStruct);
+
+            if (addAlphaChannel)
+                png_set_add_alpha (pngReadStruct, 0xff, PNG_FILLER_AFTER);
 
             png_read_image (pngReadStruct, rows);
             png_read_end (pngReadStruct, pngInfoStruct);
@@ -426,24 +541,66 @@ namespace PNGHelpers
 
     JUCE_END_IGNORE_WARNINGS_MSVC
 
-    static Image createImageFromData (bool hasAlphaChan, int width, int height, png_bytepp rows)
+    /*  libpng can write straight into the image's own pixel rows when they use the same
+        b, g, r (, a) byte order that it produces after png_set_bgr(), which avoids an
+        intermediate copy of the whole image and a per-pixel conversion pass.
+    */
+    static bool canDecodeDirectlyInto (const Image::BitmapData& data, bool sourceHasAlpha) noexcept
+    {
+        if (data.pixelFormat == Image::ARGB)
+            return data.pixelStride == 4
+                && (int) PixelARGB::indexB == 0 && (int) PixelARGB::indexG == 1
+                && (int) PixelARGB::indexR == 2 && (int) PixelARGB::indexA == 3;
+
+        return data.pixelFormat == Image::RGB
+            && data.pixelStride == 3
+            && ! sourceHasAlpha
+            && (int) PixelRGB::indexB == 0 && (int) PixelRGB::indexG == 1 && (int) PixelRGB::indexR == 2;
+    }
+
+   #if JUCE_GRAPHICS_USE_SSE2
+    static __m128i premultiplyTwoPixels (__m128i pixels) noexcept
     {
-        // now convert the data to a juce image format..
-        Image image (hasAlphaChan ? Image::ARGB : Image::RGB, width, height, hasAlphaChan);
+        // each pixel is four 16-bit lanes in b, g, r, a order
+        const auto alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (pixels, _MM_SHUFFLE (3, 3, 3, 3)), _MM_SHUFFLE (3, 3, 3, 3));
+        const auto scaled = _mm_srli_epi16 (_mm_add_epi16 (_mm_mullo_epi16 (pixels, alpha), _mm_set1_epi16 (0x7f)), 8);
 
-        image.getProperties()->set ("originalImageHadAlpha", image.hasAlphaChannel());
-        hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+        // leave the alpha channel itself, and any fully opaque pixels, untouched (like PixelARGB::premultiply())
+        const auto keep = _mm_or_si128 (_mm_set_epi16 (-1, 0, 0, 0, -1, 0, 0, 0),
+                                        _mm_cmpeq_epi16 (alpha, _mm_set1_epi16 (0xff)));
 
-        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+        return _mm_or_si128 (_mm_and_si128 (keep, pixels), _mm_andnot_si128 (keep, scaled));
+    }
+   #endif
+
+    static void premultiplyRow (uint8* pixels, int numPixels) noexcept
+    {
+       #if JUCE_GRAPHICS_USE_SSE2
+        const auto zero = _mm_setzero_si128();
 
-        for (int y = 0; y < (int) height; ++y)
+        for (; numPixels >= 4; numPixels -= 4, pixels += 16)
+        {
+            const auto block = _mm_loadu_si128 ((const __m128i*) pixels);
+            const auto lo = premultiplyTwoPixels (_mm_unpacklo_epi8 (block, zero));
+            const auto hi = premultiplyTwoPixels (_mm_unpackhi_epi8 (block, zero));
+            _mm_storeu_si128 ((__m128i*) pixels, _mm_packus_epi16 (lo, hi));
+        }
+       #endif
+
+        for (; numPixels > 0; --numPixels, pixels += 4)
+            ((PixelARGB*) pixels)->premultiply();
+    }
+
+    static void convertRows (const Image::BitmapData& destData, bool hasAlphaChan, png_bytepp rows)
+    {
+        for (int y = 0; y < destData.height; ++y)
         {
             const uint8* src = rows[y];
             uint8* dest = destData.getLinePointer (y);
 
             if (hasAlphaChan)
             {
-                for (int i = (int) width; --i >= 0;)
+                for (int i = destData.width; --i >= 0;)
                 {
                     ((PixelARGB*) dest)->setARGB (src[3], src[0], src[1], src[2]);
                     ((PixelARGB*) dest)->premultiply();
@@ -453,7 +610,7 @@ namespace PNGHelpers
             }
             else
             {
-                for (int i = (int) width; --i >= 0;)
+                for (int i = destData.width; --i >= 0;)
                 {
                     ((PixelRGB*) dest)->setARGB (0, src[0], src[1], src[2]);
                     dest += destData.pixelStride;
@@ -461,8 +618,6 @@ namespace PNGHelpers
                 }
             }
         }
-
-        return image;
     }
 
     static Image readImage (InputStream& in, png_structp pngReadStruct, png_infop pngInfoStruct)
@@ -476,22 +631,49 @@ namespace PNGHelpers
         if (readHeader (in, pngReadStruct, pngInfoStruct, errorJumpBuf,
                         width, height, bitDepth, colorType, interlaceType))
         {
+            png_bytep trans_alpha = nullptr;
+            png_color_16p trans_color = nullptr;
+            int num_trans = 0;
+            png_get_tRNS (pngReadStruct, pngInfoStruct, &trans_alpha, &num_trans, &trans_color);
+
+            const bool sourceHasAlpha = (colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0;
+
+            // now convert the data to a juce image format..
+            Image image (sourceHasAlpha ? Image::ARGB : Image::RGB, (int) width, (int) height, sourceHasAlpha);
+
+            image.getProperties()->set ("originalImageHadAlpha", image.hasAlphaChannel());
+            const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+
+            const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+            HeapBlock<png_bytep> rows (height);
+
+            if (canDecodeDirectlyInto (destData, sourceHasAlpha))
+            {
+                for (int y = 0; y < (int) height; ++y)
+                    rows[y] = (png_bytep) destData.getLinePointer (y);
+
+                if (! readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows, true, hasAlphaChan))
+                    return {};
+
+                if (sourceHasAlpha)
+                    for (int y = 0; y < (int) height; ++y)
+                        premultiplyRow (destData.getLinePointer (y), (int) width);
+
+                return image;
+            }
+
             // Load the image into a temp buffer..
             const size_t lineStride = width * 4;
             HeapBlock<uint8> tempBuffer (height * lineStride);
-            HeapBlock<png_bytep> rows (height);
 
             for (size_t y = 0; y < height; ++y)
                 rows[y] = (png_bytep) (tempBuffer + lineStride * y);
 
-            png_bytep trans_alpha = nullptr;
-            png_color_16p trans_color = nullptr;
-            int num_trans = 0;
-            png_get_tRNS (pngReadStruct, pngInfoStruct, &trans_alpha, &num_trans, &trans_color);
-
-            if (readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows))
-                return createImageFromData ((colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0,
-                                            (int) width, (int) height, rows);
+            if (readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows, false, true))
+            {
+                convertRows (destData, hasAlphaChan, rows);
+                return image;
+            }
         }
 
         return Image();
@@ -42,6 +42,16 @@ struct ImageCache::Pimpl     : private Timer,
 
     ~Pimpl() override
     {
+        // The pool is detached while holding the lock, so loadAsync() can't add jobs to it, but it's
+        // deleted after releasing it, because jobs that are still running need to take the lock
+        std::unique_ptr<ThreadPool> pool;
+
+        {
+            const ScopedLock sl (lock);
+            pool = std::move (loaderPool);
+        }
+
+        pool.reset();
         stopTimer();
         clearSingletonInstance();
     }
@@ -68,14 +78,59 @@ struct ImageCache::Pimpl     : private Timer,
     {
         if (image.isValid())
         {
+            // (images may be added by the loader threads, so the timer is only started while holding the lock)
+            const ScopedLock sl (lock);
+
             if (! isTimerRunning())
                 startTimer (2000);
 
-            const ScopedLock sl (lock);
             images.add ({ image, hashCode, Time::getApproximateMillisecondCounter() });
         }
     }
 
+    std::future<Image> loadAsync (const File& file, int maxWidth, int maxHeight, int64 hashCode)
+    {
+        auto image = getFromHashCode (hashCode);
+
+        if (image.isValid())
+        {
+            std::promise<Image> promise;
+            promise.set_value (image);
+            return promise.get_future();
+        }
+
+        auto* job = new LoadJob (*this, file, maxWidth, maxHeight, hashCode);
+        auto future = job->promise.get_future();
+
+        {
+            const ScopedLock sl (lock);
+
+            if (loaderPool == nullptr)
+                loaderPool = std::make_unique<ThreadPool> (ThreadPoolOptions{}.withThreadName ("ImageCache loader")
+                                                                              .withNumberOfThreads (jmax (1, SystemStats::getNumCpus() - 1)));
+
+            loaderPool->addJob (job, true);
+        }
+
+        return future;
+    }
+
+    static Image loadImage (const File& file, int maxWidth, int maxHeight)
+    {
+        if (maxWidth > 0 && maxHeight > 0)
+            return ImageFileFormat::loadThumbnailFrom (file, maxWidth, maxHeight);
+
+        return ImageFileFormat::loadFrom (file);
+    }
+
+    static int64 getHashCode (const File& file, int maxWidth, int maxHeight)
+    {
+        if (maxWidth > 0 && maxHeight > 0)
+            return (file.getFullPathName() + "@" + String (maxWidth) + "x" + String (maxHeight)).hashCode64();
+
+        return file.hashCode64();
+    }
+
     void timerCallback() override
     {
         auto now = Time::getApproximateMillisecondCounter();
@@ -117,8 +172,46 @@ struct ImageCache::Pimpl     : private Timer,
         uint32 lastUseTime;
     };
 
+    struct LoadJob final : public ThreadPoolJob
+    {
+        LoadJob (Pimpl& p, const File& f, int w, int h, int64 hash)
+            : ThreadPoolJob ("ImageCache loader"), owner (p), file (f), maxWidth (w), maxHeight (h), hashCode (hash)
+        {}
+
+        ~LoadJob() override
+        {
+            // If the pool was shut down before this job could run, make sure nobody is left waiting for it
+            if (! hasFinished)
+                promise.set_value ({});
+        }
+
+        JobStatus runJob() override
+        {
+            // another request for the same file may have finished while this one was queued
+            auto image = owner.getFromHashCode (hashCode);
+
+            if (image.isNull())
+            {
+                image = loadImage (file, maxWidth, maxHeight);
+                owner.addImageToCache (image, hashCode);
+            }
+
+            promise.set_value (image);
+            hasFinished = true;
+            return jobHasFinished;
+        }
+
+        Pimpl& owner;
+        const File file;
+        const int maxWidth, maxHeight;
+        const int64 hashCode;
+        std::promise<Image> promise;
+        bool hasFinished = false;
+    };
+
     Array<Item> images;
     CriticalSection lock;
+    std::unique_ptr<ThreadPool> loaderPool;
     unsigned int cacheTimeout = 5000;
 
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
@@ -152,6 +245,30 @@ Image ImageCache::getFromFile (const File& file)
     return image;
 }
 
+Image ImageCache::getThumbnailFromFile (const File& file, int maxWidth, int maxHeight)
+{
+    auto hashCode = Pimpl::getHashCode (file, maxWidth, maxHeight);
+    auto image = getFromHashCode (hashCode);
+
+    if (image.isNull())
+    {
+        image = Pimpl::loadImage (file, maxWidth, maxHeight);
+        addImageToCache (image, hashCode);
+    }
+
+    return image;
+}
+
+std::future<Image> ImageCache::getFromFileAsync (const File& file)
+{
+    return Pimpl::getInstance()->loadAsync (file, 0, 0, file.hashCode64());
+}
+
+std::future<Image> ImageCache::getThumbnailFromFileAsync (const File& file, int maxWidth, int maxHeight)
+{
+    return Pimpl::getInstance()->loadAsync (file, maxWidth, maxHeight, Pimpl::getHashCode (file, maxWidth, maxHeight));
+}
+
 Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
 {
     auto hashCode = (int64) (pointer_sized_int) imageData;
@@ -89,6 +89,45 @@ public:
     */
     static Image getFromMemory (const void* imageData, int dataSize);
 
+    /** Loads a reduced-size version of an image from a file, (or just returns it if it's already cached).
+
+        The image that is returned will fit within maxWidth x maxHeight, keeping its original
+        proportions. Thumbnails are cached separately from the full-size image, and separately
+        for each size that is requested.
+
+        @param file         the file to try to load
+        @param maxWidth     the maximum width of the image that is returned
+        @param maxHeight    the maximum height of the image that is returned
+        @returns            the image, or an invalid image if it there was an error loading it
+        @see getFromFile, getThumbnailFromFileAsync, ImageFileFormat::loadThumbnailFrom
+    */
+    static Image getThumbnailFromFile (const File& file, int maxWidth, int maxHeight);
+
+    //==============================================================================
+    /** Loads an image from a file on a background thread, (or just returns the image if it's already cached).
+
+        If the cache already contains an image that was loaded from this file, the future
+        that is returned will be ready immediately. Otherwise the file is decoded by a pool
+        of threads that the cache keeps internally, the image is added to the cache, and the
+        future is then given the image (or an invalid image if there was an error loading it).
+
+        This lets you request a whole folder of images without stalling the message thread
+        while they are decoded.
+
+        @see getFromFile, getThumbnailFromFileAsync
+    */
+    static std::future<Image> getFromFileAsync (const File& file);
+
+    /** Loads a reduced-size version of an image from a file on a background thread,
+        (or just returns it if it's already cached).
+
+        This works like getFromFileAsync(), but decodes the image in the same way as
+        getThumbnailFromFile().
+
+        @see getThumbnailFromFile, getFromFileAsync
+    */
+    static std::future<Image> getThumbnailFromFileAsync (const File& file, int maxWidth, int maxHeight);
+
     //==============================================================================
     /** Checks the cache for an image with a particular hashcode.
 
@@ -84,6 +84,25 @@ ImageFileFormat* ImageFileFormat::findImageFormatForFileExtension (const File& f
     return nullptr;
 }
 
+//==============================================================================
+Image ImageFileFormat::decodeThumbnail (InputStream& input, int maxWidth, int maxHeight)
+{
+    return rescaledToFit (decodeImage (input), maxWidth, maxHeight);
+}
+
+Image ImageFileFormat::rescaledToFit (const Image& image, int maxWidth, int maxHeight)
+{
+    if (image.isNull() || maxWidth <= 0 || maxHeight <= 0
+         || (image.getWidth() <= maxWidth && image.getHeight() <= maxHeight))
+        return image;
+
+    const auto scale = jmin ((double) maxWidth / image.getWidth(), (double) maxHeight / image.getHeight());
+
+    return image.rescaled (jmax (1, roundToInt (image.getWidth() * scale)),
+                           jmax (1, roundToInt (image.getHeight() * scale)),
+                           Graphics::mediumResamplingQuality);
+}
+
 //==============================================================================
 Image ImageFileFormat::loadFrom (InputStream& input)
 {
@@ -106,6 +125,21 @@ Image ImageFileFormat::loadFrom (const File& file)
     return Image();
 }
 
+Image ImageFileFormat::loadThumbnailFrom (const File& file, int maxWidth, int maxHeight)
+{
+    FileInputStream stream (file);
+
+    if (stream.openedOk())
+    {
+        BufferedInputStream b (stream, 8192);
+
+        if (auto* format = findImageFormatForStream (b))
+            return format->decodeThumbnail (b, maxWidth, maxHeight);
+    }
+
+    return Image();
+}
+
 Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes)
 {
     if (rawData != nullptr && numBytes > 4)
@@ -93,6 +93,21 @@ public:
     */
     virtual Image decodeImage (InputStream& input) = 0;
 
+    /** Tries to decode a reduced-size version of an image from the given stream.
+
+        The image that is returned will fit within maxWidth x maxHeight while keeping
+        its original proportions. Images that are already small enough are returned
+        at their original size.
+
+        Formats that are able to decode at a lower resolution (e.g. JPEG, which can
+        scale down while it's still in the DCT domain) will override this to do so,
+        which is much quicker than decoding the whole image and shrinking it afterwards.
+        The default implementation just calls decodeImage() and rescales the result.
+
+        @see decodeImage, loadThumbnailFrom
+    */
+    virtual Image decodeThumbnail (InputStream& input, int maxWidth, int maxHeight);
+
     //==============================================================================
     /** Attempts to write an image to a stream.
 
@@ -146,6 +161,22 @@ public:
     */
     static Image loadFrom (const void* rawData,
                            size_t numBytesOfData);
+
+    /** Tries to load a reduced-size version of an image from a file.
+
+        This will use the findImageFormatForStream() method to locate a suitable
+        codec, and use its decodeThumbnail() method to load the image.
+
+        @returns        the image that was decoded, or an invalid image if it fails.
+        @see decodeThumbnail
+    */
+    static Image loadThumbnailFrom (const File& file, int maxWidth, int maxHeight);
+
+protected:
+    /** Rescales an image so that it fits within the given size, keeping its proportions.
+        Images that already fit are returned unchanged.
+    */
+    static Image rescaledToFit (const Image& image, int maxWidth, int maxHeight);
 };
 
 //==============================================================================
@@ -200,6 +231,7 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeThumbnail (InputStream&, int maxWidth, int maxHeight) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 
 private:
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct ImageFileFormatTests final : public UnitTest
+{
+    ImageFileFormatTests() : UnitTest ("ImageFileFormat", UnitTestCategories::graphics) {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("PNG images with every filter type can be round-tripped");
+        {
+            for (auto format : { Image::RGB, Image::ARGB })
+            {
+                // Smooth gradients plus noise make libpng pick a mixture of sub, up, avg and paeth filters
+                Image source (format, 67, 45, true, SoftwareImageType());
+
+                for (int y = 0; y < source.getHeight(); ++y)
+                    for (int x = 0; x < source.getWidth(); ++x)
+                        source.setPixelAt (x, y, Colour ((uint8) (x * 3 + random.nextInt (4)),
+                                                         (uint8) (y * 5),
+                                                         (uint8) random.nextInt (256),
+                                                         (uint8) (format == Image::ARGB ? random.nextInt (256) : 255)));
+
+                MemoryOutputStream out;
+                expect (PNGImageFormat().writeImageToStream (source, out));
+
+                MemoryInputStream in (out.getData(), out.getDataSize(), false);
+                const auto decoded = PNGImageFormat().decodeImage (in);
+
+                expect (decoded.isValid());
+                expect (decoded.getBounds() == source.getBounds());
+                expect (decoded.hasAlphaChannel() == source.hasAlphaChannel());
+
+                const Image::BitmapData sourceData (source, Image::BitmapData::readOnly);
+                bool allPixelsMatch = true;
+
+                for (int y = 0; y < source.getHeight(); ++y)
+                {
+                    for (int x = 0; x < source.getWidth(); ++x)
+                    {
+                        // The writer stores unpremultiplied values, so this is what we expect to read back
+                        auto expected = source.getPixelAt (x, y).getPixelARGB();
+                        expected.unpremultiply();
+                        expected.premultiply();
+
+                        allPixelsMatch = allPixelsMatch && decoded.getPixelAt (x, y).getPixelARGB().getNativeARGB() == expected.getNativeARGB();
+                    }
+                }
+
+                expect (allPixelsMatch);
+            }
+        }
+
+        beginTest ("JPEG thumbnails fit within the requested size");
+        {
+            Image source (Image::RGB, 400, 300, true, SoftwareImageType());
+            source.clear (source.getBounds(), Colours::darkorange);
+
+            MemoryOutputStream out;
+            expect (JPEGImageFormat().writeImageToStream (source, out));
+
+            for (auto [maxWidth, maxHeight, expectedWidth, expectedHeight] : { std::tuple { 100, 100, 100, 75 },
+                                                                               std::tuple { 64, 300, 64, 48 },
+                                                                               std::tuple { 800, 800, 400, 300 } })
+            {
+                MemoryInputStream in (out.getData(), out.getDataSize(), false);
+                const auto thumbnail = JPEGImageFormat().decodeThumbnail (in, maxWidth, maxHeight);
+
+                expectEquals (thumbnail.getWidth(), expectedWidth);
+                expectEquals (thumbnail.getHeight(), expectedHeight);
+
+                const auto centre = thumbnail.getPixelAt (thumbnail.getWidth() / 2, thumbnail.getHeight() / 2);
+                expect (std::abs (centre.getRed()   - Colours::darkorange.getRed())   < 8
+                     && std::abs (centre.getGreen() - Colours::darkorange.getGreen()) < 8
+                     && std::abs (centre.getBlue()  - Colours::darkorange.getBlue())  < 8);
+            }
+        }
+
+        beginTest ("ImageCache can load images asynchronously");
+        {
+            Image source (Image::ARGB, 80, 60, true, SoftwareImageType());
+            source.clear (source.getBounds(), Colours::red);
+
+            TemporaryFile tempFile (".png");
+
+            {
+                FileOutputStream out (tempFile.getFile());
+                expect (out.openedOk() && PNGImageFormat().writeImageToStream (source, out));
+            }
+
+            auto thumbnail = ImageCache::getThumbnailFromFileAsync (tempFile.getFile(), 40, 40).get();
+            expectEquals (thumbnail.getWidth(), 40);
+            expectEquals (thumbnail.getHeight(), 30);
+
+            auto image = ImageCache::getFromFileAsync (tempFile.getFile()).get();
+            expect (image.getBounds() == source.getBounds());
+
+            // Once loaded, the same image should come straight back out of the cache
+            expect (ImageCache::getFromFile (tempFile.getFile()) == image);
+            expect (ImageCache::getThumbnailFromFile (tempFile.getFile(), 40, 40) == thumbnail);
+
+            thumbnail = {};
+            image = {};
+            ImageCache::releaseUnusedImages();
+        }
+    }
+};
+
+static ImageFileFormatTests imageFileFormatTests;
+
+} // namespace juce
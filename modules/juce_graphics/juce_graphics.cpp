@@ -127,6 +127,11 @@
  #include <fontconfig/fontconfig.h>
 #endif
 
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || defined (_M_AMD64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define JUCE_GRAPHICS_USE_SSE2 1
+ #include <emmintrin.h>
+#endif
+
 #undef SIZEOF
 
 #if (JUCE_MAC || JUCE_IOS) && USE_COREGRAPHICS_RENDERING && JUCE_USE_COREIMAGE_LOADER
@@ -175,6 +180,7 @@ extern "C"
 #include "geometry/juce_Path.cpp"
 #include "geometry/juce_PathIterator.cpp"
 #include "geometry/juce_PathStrokeType.cpp"
+#include "geometry/juce_PathRasterisationCache.cpp"
 #include "placement/juce_RectanglePlacement.cpp"
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
@@ -200,7 +206,9 @@ extern "C"
 
 #if JUCE_UNIT_TESTS
  #include "geometry/juce_Parallelogram_test.cpp"
+ #include "geometry/juce_PathRasterisationCache_test.cpp"
  #include "geometry/juce_Rectangle_test.cpp"
+ #include "images/juce_ImageFileFormat_test.cpp"
 #endif
 
 #if JUCE_USE_FREETYPE
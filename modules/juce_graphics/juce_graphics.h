@@ -127,6 +127,7 @@ namespace juce
 #include "geometry/juce_EdgeTable.h"
 #include "geometry/juce_PathIterator.h"
 #include "geometry/juce_PathStrokeType.h"
+#include "geometry/juce_PathRasterisationCache.h"
 #include "placement/juce_RectanglePlacement.h"
 #include "images/juce_ImageCache.h"
 #include "images/juce_ImageConvolutionKernel.h"
@@ -1570,6 +1570,7 @@ namespace ClipRegions
     struct EdgeTableRegion  : public Base<SavedStateType>
     {
         EdgeTableRegion (const EdgeTable& e)            : edgeTable (e) {}
+        EdgeTableRegion (const EdgeTable& e, Rectangle<int> clip) : edgeTable (e, clip) {}
         EdgeTableRegion (Rectangle<int> r)              : edgeTable (r) {}
         EdgeTableRegion (Rectangle<float> r)            : edgeTable (r) {}
         EdgeTableRegion (const RectangleList<int>& r)   : edgeTable (r) {}
@@ -2263,7 +2264,13 @@ public:
             auto clipRect = clip->getClipBounds();
 
             if (path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
-                fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+            {
+                // a cached table covers the whole path, so only copy the part that's inside the clip
+                if (auto cached = PathRasterisationCache::getEdgeTable (path, trans, clipRect))
+                    fillShape (*new EdgeTableRegionType (*cached, clipRect), false);
+                else
+                    fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+            }
         }
     }
 
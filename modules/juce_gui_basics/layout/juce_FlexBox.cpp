@@ -41,16 +41,6 @@ struct FlexBoxLayoutCalculation
 
     enum class Axis { main, cross };
 
-    FlexBoxLayoutCalculation (FlexBox& fb, Coord w, Coord h)
-        : owner (fb), parentWidth (w), parentHeight (h), numItems (owner.items.size()),
-          isRowDirection (fb.flexDirection == FlexBox::Direction::row
-                       || fb.flexDirection == FlexBox::Direction::rowReverse),
-          containerLineLength (getContainerSize (Axis::main))
-    {
-        lineItems.calloc (numItems * numItems);
-        lineInfo.calloc (numItems);
-    }
-
     struct ItemWithState
     {
         ItemWithState (FlexItem& source) noexcept   : item (&source) {}
@@ -74,10 +64,36 @@ struct FlexBoxLayoutCalculation
 
     struct RowInfo
     {
-        int numItems;
+        int firstItem, numItems;
         Coord crossSize, lineY, totalLength;
     };
 
+    /*  The working storage for a layout, which can be kept between calculations so that
+        laying out the same box repeatedly doesn't need to reallocate it.
+    */
+    struct Buffers
+    {
+        std::vector<ItemWithState> itemStates;
+        std::vector<ItemWithState*> lineItems;
+        std::vector<RowInfo> lineInfo;
+    };
+
+    FlexBoxLayoutCalculation (FlexBox& fb, Coord w, Coord h, Buffers& buffersToUse)
+        : owner (fb), parentWidth (w), parentHeight (h), numItems (owner.items.size()),
+          isRowDirection (fb.flexDirection == FlexBox::Direction::row
+                       || fb.flexDirection == FlexBox::Direction::rowReverse),
+          containerLineLength (getContainerSize (Axis::main)),
+          itemStates (buffersToUse.itemStates)
+    {
+        // Each item belongs to exactly one line, so the lines are stored one after the
+        // other in lineItems, with RowInfo::firstItem marking where each one starts.
+        itemStates.clear();
+        buffersToUse.lineItems.assign ((size_t) numItems, nullptr);
+        buffersToUse.lineInfo.assign ((size_t) numItems, RowInfo{});
+        lineItems = buffersToUse.lineItems.data();
+        lineInfo = buffersToUse.lineInfo.data();
+    }
+
     FlexBox& owner;
     const Coord parentWidth, parentHeight;
     const int numItems;
@@ -87,11 +103,11 @@ struct FlexBoxLayoutCalculation
     int numberOfRows = 1;
     Coord containerCrossLength = 0;
 
-    HeapBlock<ItemWithState*> lineItems;
-    HeapBlock<RowInfo> lineInfo;
-    Array<ItemWithState> itemStates;
+    std::vector<ItemWithState>& itemStates;
+    ItemWithState** lineItems = nullptr;
+    RowInfo* lineInfo = nullptr;
 
-    ItemWithState& getItem (int x, int y) const noexcept     { return *lineItems[y * numItems + x]; }
+    ItemWithState& getItem (int x, int y) const noexcept     { return *lineItems[lineInfo[y].firstItem + x]; }
 
     static bool isAuto (Coord value) noexcept
     {
@@ -167,10 +183,10 @@ struct FlexBoxLayoutCalculation
     //==============================================================================
     void createStates()
     {
-        itemStates.ensureStorageAllocated (numItems);
+        itemStates.reserve ((size_t) numItems);
 
         for (auto& item : owner.items)
-            itemStates.add (item);
+            itemStates.emplace_back (item);
 
         std::stable_sort (itemStates.begin(), itemStates.end(),
                           [] (const ItemWithState& i1, const ItemWithState& i2)  { return i1.item->order < i2.item->order; });
@@ -198,7 +214,7 @@ struct FlexBoxLayoutCalculation
         else // if multi-line, group the flexbox items into multiple lines
         {
             auto currentLength = containerLineLength;
-            int column = 0, row = 0;
+            int column = 0, row = 0, numPlaced = 0;
             bool firstRow = true;
 
             for (auto& item : itemStates)
@@ -218,10 +234,11 @@ struct FlexBoxLayoutCalculation
                     column = 0;
                     currentLength = containerLineLength;
                     numberOfRows = jmax (numberOfRows, row + 1);
+                    lineInfo[row].firstItem = numPlaced;
                 }
 
                 currentLength -= flexitemLength;
-                lineItems[row * numItems + column] = &item;
+                lineItems[numPlaced++] = &item;
                 ++column;
                 lineInfo[row].numItems = jmax (lineInfo[row].numItems, column);
                 firstRow = false;
@@ -762,23 +779,103 @@ FlexBox::FlexBox (Direction d, Wrap w, AlignContent ac, AlignItems ai, JustifyCo
 {
 }
 
+//==============================================================================
+/*  Remembers the inputs and results of the last layout, so that a box which is laid out
+    again with the same size, properties and items can reuse the results rather than
+    solving the whole layout again.
+*/
+struct FlexBox::LayoutCache
+{
+    bool restoreResultsIfUnchanged (FlexBox& box, Rectangle<float> area)
+    {
+        if (! hasResults
+             || ! exactlyEqual (area.getWidth(), width)
+             || ! exactlyEqual (area.getHeight(), height)
+             || box.flexDirection != flexDirection
+             || box.flexWrap != flexWrap
+             || box.alignContent != alignContent
+             || box.alignItems != alignItems
+             || box.justifyContent != justifyContent
+             || (size_t) box.items.size() != items.size()
+             || ! std::equal (items.begin(), items.end(), box.items.begin(), haveSameLayoutProperties))
+            return false;
+
+        for (size_t i = 0; i < items.size(); ++i)
+            box.items.getReference ((int) i).currentBounds = items[i].currentBounds;
+
+        return true;
+    }
+
+    void storeResults (const FlexBox& box, Rectangle<float> area)
+    {
+        width = area.getWidth();
+        height = area.getHeight();
+        flexDirection = box.flexDirection;
+        flexWrap = box.flexWrap;
+        alignContent = box.alignContent;
+        alignItems = box.alignItems;
+        justifyContent = box.justifyContent;
+        items.assign (box.items.begin(), box.items.end());
+        hasResults = true;
+    }
+
+    static bool haveSameLayoutProperties (const FlexItem& a, const FlexItem& b) noexcept
+    {
+        return a.order == b.order
+            && a.alignSelf == b.alignSelf
+            && exactlyEqual (a.flexGrow,      b.flexGrow)
+            && exactlyEqual (a.flexShrink,    b.flexShrink)
+            && exactlyEqual (a.flexBasis,     b.flexBasis)
+            && exactlyEqual (a.width,         b.width)
+            && exactlyEqual (a.minWidth,      b.minWidth)
+            && exactlyEqual (a.maxWidth,      b.maxWidth)
+            && exactlyEqual (a.height,        b.height)
+            && exactlyEqual (a.minHeight,     b.minHeight)
+            && exactlyEqual (a.maxHeight,     b.maxHeight)
+            && exactlyEqual (a.margin.left,   b.margin.left)
+            && exactlyEqual (a.margin.right,  b.margin.right)
+            && exactlyEqual (a.margin.top,    b.margin.top)
+            && exactlyEqual (a.margin.bottom, b.margin.bottom);
+    }
+
+    FlexBoxLayoutCalculation::Buffers buffers;
+    std::vector<FlexItem> items;
+    float width = 0.0f, height = 0.0f;
+    Direction flexDirection {};
+    Wrap flexWrap {};
+    AlignContent alignContent {};
+    AlignItems alignItems {};
+    JustifyContent justifyContent {};
+    bool hasResults = false;
+};
+
+//==============================================================================
 void FlexBox::performLayout (Rectangle<float> targetArea)
 {
     if (! items.isEmpty())
     {
-        FlexBoxLayoutCalculation layout (*this, targetArea.getWidth(), targetArea.getHeight());
-
-        layout.createStates();
-        layout.initialiseItems();
-        layout.resolveFlexibleLengths();
-        layout.resolveAutoMarginsOnMainAxis();
-        layout.calculateCrossSizesByLine();
-        layout.calculateCrossSizeOfAllItems();
-        layout.alignLinesPerAlignContent();
-        layout.resolveAutoMarginsOnCrossAxis();
-        layout.alignItemsInCrossAxisInLinesPerAlignSelf();
-        layout.alignItemsByJustifyContent();
-        layout.layoutAllItems();
+        // Copies of a FlexBox start out sharing a cache, so give this one its own before using it.
+        if (layoutCache == nullptr || layoutCache.use_count() > 1)
+            layoutCache = std::make_shared<LayoutCache>();
+
+        if (! layoutCache->restoreResultsIfUnchanged (*this, targetArea))
+        {
+            FlexBoxLayoutCalculation layout (*this, targetArea.getWidth(), targetArea.getHeight(), layoutCache->buffers);
+
+            layout.createStates();
+            layout.initialiseItems();
+            layout.resolveFlexibleLengths();
+            layout.resolveAutoMarginsOnMainAxis();
+            layout.calculateCrossSizesByLine();
+            layout.calculateCrossSizeOfAllItems();
+            layout.alignLinesPerAlignContent();
+            layout.resolveAutoMarginsOnCrossAxis();
+            layout.alignItemsInCrossAxisInLinesPerAlignSelf();
+            layout.alignItemsByJustifyContent();
+            layout.layoutAllItems();
+
+            layoutCache->storeResults (*this, targetArea);
+        }
 
         for (auto& item : items)
         {
@@ -1148,6 +1245,58 @@ public:
                 expect (flex.items[2].currentBounds == Rectangle<float> (rect.getX(), rect.getBottom() + spacer, 10.0f, 10.0f));
             }
         }
+
+        beginTest ("a box that is laid out repeatedly gives the same results as a new box");
+        {
+            const auto getBounds = [] (const FlexBox& box)
+            {
+                std::vector<Rectangle<float>> result;
+
+                for (const auto& item : box.items)
+                    result.push_back (item.currentBounds);
+
+                return result;
+            };
+
+            const auto layOutNewCopy = [&getBounds] (const FlexBox& box, Rectangle<float> area)
+            {
+                FlexBox copy;
+                copy.flexDirection = box.flexDirection;
+                copy.flexWrap = box.flexWrap;
+                copy.items = box.items;
+                copy.performLayout (area);
+                return getBounds (copy);
+            };
+
+            juce::FlexBox flex;
+            flex.flexWrap = FlexBox::Wrap::wrap;
+
+            for (int i = 0; i < 20; ++i)
+                flex.items.add (FlexItem().withWidth ((float) (10 + i * 7)).withHeight (20.0f).withFlex ((float) (i % 3)));
+
+            const auto checkLayout = [&] (Rectangle<float> area)
+            {
+                flex.performLayout (area);
+                expect (getBounds (flex) == layOutNewCopy (flex, area));
+            };
+
+            checkLayout (rect);
+            checkLayout (rect);
+            checkLayout (rect.translated (5.0f, 7.0f));
+            checkLayout (rect.withWidth (120.0f));
+
+            flex.items.getReference (3).minWidth = 90.0f;
+            checkLayout (rect.withWidth (120.0f));
+
+            flex.items.getReference (5).order = -1;
+            checkLayout (rect.withWidth (120.0f));
+
+            flex.flexDirection = Direction::column;
+            checkLayout (rect.withWidth (120.0f));
+
+            flex.items.removeRange (0, 10);
+            checkLayout (rect);
+        }
     }
 };
 
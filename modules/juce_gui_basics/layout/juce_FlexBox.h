@@ -109,7 +109,13 @@ public:
     FlexBox (JustifyContent) noexcept;
 
     //==============================================================================
-    /** Lays-out the box's items within the given rectangle. */
+    /** Lays-out the box's items within the given rectangle.
+
+        The box remembers the results of its last layout, so if it's laid out again with
+        the same size, properties and items, it won't need to recalculate anything. To take
+        advantage of this, keep the FlexBox as a member of your component rather than
+        building a new one in each resized() callback.
+    */
     void performLayout (Rectangle<float> targetArea);
 
     /** Lays-out the box's items within the given rectangle. */
@@ -146,6 +152,9 @@ public:
     Array<FlexItem> items;
 
 private:
+    struct LayoutCache;
+    std::shared_ptr<LayoutCache> layoutCache;
+
     JUCE_LEAK_DETECTOR (FlexBox)
 };
 
@@ -1104,10 +1104,112 @@ float Grid::TrackInfo::getAbsoluteSize (float relativeFractionalUnit) const
     return isFractional() ? size * relativeFractionalUnit : size;
 }
 
+//==============================================================================
+/*  Placing the items onto the grid's lines is the most expensive part of a layout, but it
+    only depends on the grid's templates and the items' placement properties, and not on the
+    size of the area being laid out. This remembers the last placement so that resizing a
+    grid only needs to recalculate the track sizes.
+*/
+struct Grid::LayoutCache
+{
+    using ItemPlacementArray = Helpers::AutoPlacement::ItemPlacementArray;
+
+    ItemPlacementArray getItemPlacements (Grid& grid)
+    {
+        if (! placementInputsMatch (grid))
+        {
+            storePlacementInputs (grid);
+            placements.clear();
+
+            for (const auto& [item, area] : Helpers::AutoPlacement::deduceAllItems (grid))
+                placements.push_back ({ (int) std::distance (grid.items.begin(), item), area });
+        }
+
+        ItemPlacementArray result;
+        result.ensureStorageAllocated ((int) placements.size());
+
+        for (const auto& [index, area] : placements)
+            result.add ({ &grid.items.getReference (index), area });
+
+        return result;
+    }
+
+private:
+    struct ItemInputs
+    {
+        int order;
+        GridItem::StartAndEndProperty column, row;
+        String area;
+    };
+
+    static bool isSameProperty (const GridItem::Property& a, const GridItem::Property& b)
+    {
+        return a.hasAuto() == b.hasAuto()
+            && a.hasSpan() == b.hasSpan()
+            && a.getNumber() == b.getNumber()
+            && a.getName() == b.getName();
+    }
+
+    static bool isSameProperty (const GridItem::StartAndEndProperty& a, const GridItem::StartAndEndProperty& b)
+    {
+        return isSameProperty (a.start, b.start) && isSameProperty (a.end, b.end);
+    }
+
+    static bool haveSameLineNames (const Array<TrackInfo>& a, const Array<TrackInfo>& b)
+    {
+        return std::equal (a.begin(), a.end(), b.begin(), b.end(), [] (const TrackInfo& x, const TrackInfo& y)
+        {
+            return x.getStartLineName() == y.getStartLineName()
+                && x.getEndLineName() == y.getEndLineName();
+        });
+    }
+
+    bool placementInputsMatch (const Grid& grid) const
+    {
+        return hasPlacements
+            && grid.autoFlow == autoFlow
+            && grid.templateAreas == templateAreas
+            && haveSameLineNames (grid.templateColumns, templateColumns)
+            && haveSameLineNames (grid.templateRows, templateRows)
+            && std::equal (grid.items.begin(), grid.items.end(), items.begin(), items.end(), [] (const GridItem& x, const ItemInputs& y)
+               {
+                   return x.order == y.order
+                       && x.area == y.area
+                       && isSameProperty (x.column, y.column)
+                       && isSameProperty (x.row, y.row);
+               });
+    }
+
+    void storePlacementInputs (const Grid& grid)
+    {
+        autoFlow = grid.autoFlow;
+        templateAreas = grid.templateAreas;
+        templateColumns = grid.templateColumns;
+        templateRows = grid.templateRows;
+        items.clear();
+
+        for (const auto& item : grid.items)
+            items.push_back ({ item.order, item.column, item.row, item.area });
+
+        hasPlacements = true;
+    }
+
+    std::vector<std::pair<int, Helpers::PlacementHelpers::LineArea>> placements;
+    std::vector<ItemInputs> items;
+    Array<TrackInfo> templateColumns, templateRows;
+    StringArray templateAreas;
+    AutoFlow autoFlow {};
+    bool hasPlacements = false;
+};
+
 //==============================================================================
 void Grid::performLayout (Rectangle<int> targetArea)
 {
-    const auto itemsAndAreas = Helpers::AutoPlacement::deduceAllItems (*this);
+    // Copies of a Grid start out sharing a cache, so give this one its own before using it.
+    if (layoutCache == nullptr || layoutCache.use_count() > 1)
+        layoutCache = std::make_shared<LayoutCache>();
+
+    const auto itemsAndAreas = layoutCache->getItemPlacements (*this);
 
     auto implicitTracks = Helpers::AutoPlacement::createImplicitTracks (*this, itemsAndAreas);
 
@@ -1715,6 +1817,67 @@ struct GridTests final : public UnitTest
             expect (grid.items[10].currentBounds == Rect { 50, 10, 10, 10 });
             expect (grid.items[11].currentBounds == Rect { 50, 20, 10, 10 });
         }
+
+        {
+            beginTest ("A grid that is laid out repeatedly gives the same results as a new grid");
+
+            const auto getBounds = [] (const Grid& g)
+            {
+                std::vector<Rect> result;
+
+                for (const auto& item : g.items)
+                    result.push_back (item.currentBounds);
+
+                return result;
+            };
+
+            const auto layOutNewCopy = [&getBounds] (const Grid& g, Rectangle<int> area)
+            {
+                Grid copy;
+                copy.templateColumns = g.templateColumns;
+                copy.templateRows = g.templateRows;
+                copy.templateAreas = g.templateAreas;
+                copy.autoColumns = g.autoColumns;
+                copy.autoRows = g.autoRows;
+                copy.autoFlow = g.autoFlow;
+                copy.items = g.items;
+                copy.performLayout (area);
+                return getBounds (copy);
+            };
+
+            Grid grid;
+            grid.templateColumns = { Tr (1_fr), Tr (20_px), Tr (2_fr) };
+            grid.templateRows = { Tr (10_px), Tr (1_fr) };
+            grid.autoRows = Tr (15_px);
+
+            for (int i = 0; i < 10; ++i)
+                grid.items.add (GridItem());
+
+            const auto checkLayout = [&] (Rectangle<int> area)
+            {
+                grid.performLayout (area);
+                expect (getBounds (grid) == layOutNewCopy (grid, area));
+            };
+
+            checkLayout ({ 200, 100 });
+            checkLayout ({ 200, 100 });
+            checkLayout ({ 320, 240 });
+
+            grid.items.getReference (2).column = { 3, 4 };
+            checkLayout ({ 320, 240 });
+
+            grid.items.getReference (4).order = 1;
+            checkLayout ({ 320, 240 });
+
+            grid.autoFlow = Grid::AutoFlow::rowDense;
+            checkLayout ({ 320, 240 });
+
+            grid.templateColumns.add (Tr (30_px));
+            checkLayout ({ 320, 240 });
+
+            grid.items.removeRange (0, 3);
+            checkLayout ({ 100, 400 });
+        }
     }
 };
 
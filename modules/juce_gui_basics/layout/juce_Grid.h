@@ -211,7 +211,12 @@ public:
     Array<GridItem> items;
 
     //==============================================================================
-    /** Lays-out the grid's items within the given rectangle. */
+    /** Lays-out the grid's items within the given rectangle.
+
+        The grid remembers where its items were placed during the last layout, and only
+        repeats the placement when the templates or the items' placement properties have
+        changed, so resizing a Grid that's kept as a member of your component is cheap.
+    */
     void performLayout (Rectangle<int>);
 
     //==============================================================================
@@ -223,6 +228,8 @@ public:
 private:
     //==============================================================================
     struct Helpers;
+    struct LayoutCache;
+    std::shared_ptr<LayoutCache> layoutCache;
 };
 
 constexpr Grid::Px operator""_px (long double px)          { return Grid::Px { px }; }
@@ -325,6 +325,11 @@ public:
             repainter->performAnyPendingRepaintsNow();
     }
 
+    FrameStatistics getFrameStatistics() const override
+    {
+        return repainter != nullptr ? repainter->getFrameStatistics() : FrameStatistics{};
+    }
+
     void setIcon (const Image& newIcon) override
     {
         XWindowSystem::getInstance()->setIcon (windowH, newIcon);
@@ -444,13 +449,18 @@ private:
         {
             XWindowSystem::getInstance()->processPendingPaintsForWindow (peer.windowH);
 
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
-                return;
-
             if (! regionsNeedingRepaint.isEmpty())
-                performAnyPendingRepaintsNow();
+            {
+                if (getFreeBufferIndex() >= 0)
+                    performAnyPendingRepaintsNow();
+                else
+                    ++statistics.numFramesDropped;
+            }
             else if (Time::getApproximateMillisecondCounter() > lastTimeImageUsed + 3000)
-                image = Image();
+            {
+                for (auto& buffer : buffers)
+                    buffer = {};
+            }
         }
 
         void repaint (Rectangle<int> area)
@@ -460,7 +470,9 @@ private:
 
         void performAnyPendingRepaintsNow()
         {
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
+            const auto bufferIndex = getFreeBufferIndex();
+
+            if (bufferIndex < 0)
                 return;
 
             auto originalRepaintRegion = regionsNeedingRepaint;
@@ -469,9 +481,12 @@ private:
 
             if (! totalArea.isEmpty())
             {
-                const auto wasImageNull = image.isNull();
+                const auto frameStartMs = Time::getMillisecondCounterHiRes();
+                auto& buffer = buffers[(size_t) bufferIndex];
+                auto& image = buffer.image;
+                const auto wasImageNull = std::all_of (buffers.begin(), buffers.end(), [] (const auto& b) { return b.image.isNull(); });
 
-                if (wasImageNull || image.getWidth() < totalArea.getWidth()
+                if (image.isNull() || image.getWidth() < totalArea.getWidth()
                      || image.getHeight() < totalArea.getHeight())
                 {
                     image = XWindowSystem::getInstance()->createImage (isSemiTransparentWindow,
@@ -510,19 +525,69 @@ private:
                     peer.handlePaint (*context);
                 }
 
+                // Shared-memory blits complete asynchronously, and the server reports their
+                // completions in the order they were issued. Remembering how many had been
+                // issued once this buffer's blits were queued lets us tell when the server has
+                // finished reading from it, so that the other buffer can be painted meanwhile.
+                auto* xws = XWindowSystem::getInstance();
+                const auto pendingBefore = xws->getNumPaintsPendingForWindow (peer.windowH);
+
                 for (auto& i : originalRepaintRegion)
-                   XWindowSystem::getInstance()->blitToWindow (peer.windowH, image, i, totalArea);
+                   xws->blitToWindow (peer.windowH, image, i, totalArea);
+
+                numShmBlitsIssued += (uint64) jmax (0, xws->getNumPaintsPendingForWindow (peer.windowH) - pendingBefore);
+                buffer.blitsIssuedWhenPresented = numShmBlitsIssued;
+                nextBufferIndex = (bufferIndex + 1) % (int) buffers.size();
+
+                updateStatistics (Time::getMillisecondCounterHiRes() - frameStartMs);
             }
 
             lastTimeImageUsed = Time::getApproximateMillisecondCounter();
         }
 
+        ComponentPeer::FrameStatistics getFrameStatistics() const noexcept   { return statistics; }
+
     private:
+        struct Buffer
+        {
+            Image image;
+            uint64 blitsIssuedWhenPresented = 0;
+        };
+
+        int getFreeBufferIndex() const
+        {
+            const auto numPending = (uint64) jmax (0, XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH));
+            const auto numCompleted = numShmBlitsIssued - jmin (numShmBlitsIssued, numPending);
+
+            for (size_t i = 0; i < buffers.size(); ++i)
+            {
+                const auto index = (nextBufferIndex + (int) i) % (int) buffers.size();
+
+                if (buffers[(size_t) index].blitsIssuedWhenPresented <= numCompleted)
+                    return index;
+            }
+
+            return -1;
+        }
+
+        void updateStatistics (double frameTimeMs)
+        {
+            ++statistics.numFramesPresented;
+            statistics.lastFrameTimeMs = frameTimeMs;
+            statistics.maxFrameTimeMs = jmax (statistics.maxFrameTimeMs, frameTimeMs);
+            statistics.averageFrameTimeMs = statistics.numFramesPresented == 1
+                                          ? frameTimeMs
+                                          : statistics.averageFrameTimeMs + 0.1 * (frameTimeMs - statistics.averageFrameTimeMs);
+        }
+
         LinuxComponentPeer& peer;
         const bool isSemiTransparentWindow;
-        Image image;
+        std::array<Buffer, 2> buffers;
+        int nextBufferIndex = 0;
+        uint64 numShmBlitsIssued = 0;
         uint32 lastTimeImageUsed = 0;
         RectangleList<int> regionsNeedingRepaint;
+        ComponentPeer::FrameStatistics statistics;
 
         bool useARGBImagesForRendering = XWindowSystem::getInstance()->canUseARGBImages();
 
@@ -589,7 +654,9 @@ private:
             const auto newIntFrequencyHz = roundToInt (display->verticalFrequencyHz.value_or (0.0));
             const auto frequencyToUse = newIntFrequencyHz != 0 ? newIntFrequencyHz : 100;
 
-            if (vBlankManager.getTimerInterval() != frequencyToUse)
+            // getTimerInterval() is in milliseconds, so compare against the interval that
+            // startTimerHz() would use rather than the frequency itself.
+            if (vBlankManager.getTimerInterval() != 1000 / frequencyToUse)
                 vBlankManager.startTimerHz (frequencyToUse);
         }
     }
@@ -353,9 +353,14 @@ public:
         return index + mod * ((startIndex / mod) + (index < (startIndex % mod) ? 1 : 0));
     }
 
+    /*  When the list has only been scrolled, rows that still show the same item with the same
+        selection state don't need to ask the model for their content again.
+    */
+    enum class RowRefresh { all, changedRowsOnly };
+
     void visibleAreaChanged (const Rectangle<int>&) override
     {
-        updateVisibleArea (true);
+        updateVisibleArea (true, RowRefresh::changedRowsOnly);
 
         if (auto* m = owner.getListBoxModel())
             m->listWasScrolled();
@@ -363,7 +368,7 @@ public:
         startTimer (50);
     }
 
-    void updateVisibleArea (const bool makeSureItUpdatesContent)
+    void updateVisibleArea (const bool makeSureItUpdatesContent, RowRefresh refresh = RowRefresh::all)
     {
         hasUpdated = false;
 
@@ -379,10 +384,10 @@ public:
         content.setBounds (newX, newY, newW, newH);
 
         if (makeSureItUpdatesContent && ! hasUpdated)
-            updateContents();
+            updateContents (refresh);
     }
 
-    void updateContents()
+    void updateContents (RowRefresh refresh = RowRefresh::all)
     {
         hasUpdated = true;
         auto rowH = owner.getRowHeight();
@@ -408,19 +413,27 @@ public:
 
             const auto startIndex = getIndexOfFirstVisibleRow();
             const auto lastIndex = startIndex + (int) rows.size();
+            const auto widthChanged = std::exchange (lastRefreshedWidth, w) != w;
+            const auto refreshAllRows = refresh == RowRefresh::all || widthChanged;
 
             for (auto row = startIndex; row < lastIndex; ++row)
             {
                 if (auto* rowComp = getComponentForRowIfOnscreen (row))
                 {
                     rowComp->setBounds (0, row * rowH, w, rowH);
-                    rowComp->update (row, owner.isRowSelected (row));
+
+                    const auto isSelected = owner.isRowSelected (row);
+
+                    if (refreshAllRows || rowComp->getRow() != row || rowComp->isSelected() != isSelected)
+                        rowComp->update (row, isSelected);
                 }
                 else
                 {
                     jassertfalse;
                 }
             }
+
+            updatePrefetchRange (startIndex, lastIndex, refreshAllRows);
         }
 
         if (owner.headerComponent != nullptr)
@@ -512,9 +525,30 @@ private:
             handler->notifyAccessibilityEvent (AccessibilityEvent::structureChanged);
     }
 
+    void updatePrefetchRange (int startIndex, int endIndex, bool forceNotification)
+    {
+        auto* m = owner.getListBoxModel();
+
+        if (m == nullptr)
+            return;
+
+        // Look ahead by a page in each direction, so that the model has a chance to get rows
+        // ready before they're scrolled onto the screen.
+        const auto pageSize = endIndex - startIndex;
+        const auto newRange = Range<int> (startIndex - pageSize, endIndex + pageSize)
+                                .getIntersectionWith ({ 0, owner.totalItems });
+
+        if (newRange.isEmpty())
+            return;
+
+        if (std::exchange (prefetchRange, newRange) != newRange || forceNotification)
+            m->prefetchRows (newRange);
+    }
+
     ListBox& owner;
     std::vector<std::unique_ptr<RowComponent>> rows;
-    int firstIndex = 0, firstWholeIndex = 0, lastWholeIndex = 0;
+    Range<int> prefetchRange;
+    int firstIndex = 0, firstWholeIndex = 0, lastWholeIndex = 0, lastRefreshedWidth = -1;
     bool hasUpdated = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ListViewport)
@@ -1256,8 +1290,130 @@ void ListBoxModel::selectedRowsChanged (int) {}
 void ListBoxModel::deleteKeyPressed (int) {}
 void ListBoxModel::returnKeyPressed (int) {}
 void ListBoxModel::listWasScrolled() {}
+void ListBoxModel::prefetchRows (Range<int>) {}
 var ListBoxModel::getDragSourceDescription (const SparseSet<int>&)      { return {}; }
 String ListBoxModel::getTooltipForRow (int)                             { return {}; }
 MouseCursor ListBoxModel::getMouseCursorForRow (int)                    { return MouseCursor::NormalCursor; }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ListBoxTests final : public UnitTest
+{
+public:
+    ListBoxTests() : UnitTest ("ListBox", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        ScopedJuceInitialiser_GUI libraryInitialiser;
+        const MessageManagerLock mml;
+
+        beginTest ("Scrolling only refreshes the rows that come onto the screen");
+        {
+            TestModel model;
+            ListBox list ({}, &model);
+            list.setVisible (true);
+            list.setRowHeight (10);
+            list.setBounds (0, 0, 100, 100);
+
+            // The first layout refreshes every row component, which tells us how many there are
+            const auto numRowComponents = (int) model.refreshedRows.size();
+            expectGreaterThan (numRowComponents, 10);
+            expect (model.refreshedRows == getRows ({ 0, numRowComponents }));
+
+            // The first row component is kept for the partly hidden row above the top one
+            model.refreshedRows.clear();
+            list.getViewport()->setViewPosition (0, 50);
+            expect (model.refreshedRows == getRows ({ numRowComponents, numRowComponents + 4 }));
+
+            model.refreshedRows.clear();
+            list.getViewport()->setViewPosition (0, 5000);
+            expect (model.refreshedRows == getRows ({ 499, 499 + numRowComponents }));
+
+            // Moving by less than a row shows the same rows, so none of them need refreshing
+            model.refreshedRows.clear();
+            list.getViewport()->setViewPosition (0, 5005);
+            expect (model.refreshedRows.empty());
+
+            model.refreshedRows.clear();
+            list.updateContent();
+            expect (model.refreshedRows == getRows ({ 499, 499 + numRowComponents }));
+
+            model.refreshedRows.clear();
+            list.setSize (120, 100);
+            expect (model.refreshedRows == getRows ({ 499, 499 + numRowComponents }));
+        }
+
+        beginTest ("The prefetched rows extend a page beyond each side of the visible rows");
+        {
+            TestModel model;
+            ListBox list ({}, &model);
+            list.setVisible (true);
+            list.setRowHeight (10);
+            list.setBounds (0, 0, 100, 100);
+
+            const auto numRowComponents = (int) model.refreshedRows.size();
+            const auto expectedRange = [&] (int firstRow)
+            {
+                return Range<int> (firstRow - numRowComponents, firstRow + 2 * numRowComponents)
+                         .getIntersectionWith ({ 0, TestModel::numRows });
+            };
+
+            expect (! model.prefetchedRanges.empty());
+            expect (model.prefetchedRanges.back() == expectedRange (0));
+
+            list.getViewport()->setViewPosition (0, 5000);
+            expect (model.prefetchedRanges.back() == expectedRange (499));
+
+            // Scrolling within a row doesn't change the range, so the model isn't told again
+            const auto numPrefetches = model.prefetchedRanges.size();
+            list.getViewport()->setViewPosition (0, 5005);
+            expectEquals (model.prefetchedRanges.size(), numPrefetches);
+
+            // ...but updating the content always reports the range, because the rows may have changed
+            list.updateContent();
+            expectEquals (model.prefetchedRanges.size(), numPrefetches + 1);
+            expect (model.prefetchedRanges.back() == expectedRange (499));
+
+            list.getViewport()->setViewPosition (0, TestModel::numRows * 10);
+            expectEquals (model.prefetchedRanges.back().getEnd(), TestModel::numRows);
+            expect (model.prefetchedRanges.back().contains (TestModel::numRows - 10));
+        }
+    }
+
+private:
+    struct TestModel final : public ListBoxModel
+    {
+        static constexpr int numRows = 1000;
+
+        int getNumRows() override                                   { return numRows; }
+        void paintListBoxItem (int, Graphics&, int, int, bool) override {}
+        void prefetchRows (Range<int> rows) override                { prefetchedRanges.push_back (rows); }
+
+        Component* refreshComponentForRow (int row, bool, Component* existing) override
+        {
+            refreshedRows.insert (row);
+            return existing;
+        }
+
+        std::set<int> refreshedRows;
+        std::vector<Range<int>> prefetchedRanges;
+    };
+
+    static std::set<int> getRows (Range<int> range)
+    {
+        std::set<int> result;
+
+        for (auto row = range.getStart(); row < range.getEnd(); ++row)
+            result.insert (row);
+
+        return result;
+    }
+};
+
+static ListBoxTests listBoxTests;
+
+#endif
+
 } // namespace juce
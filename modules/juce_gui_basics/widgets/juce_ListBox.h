@@ -71,7 +71,9 @@ public:
         and handle mouse clicks with listBoxItemClicked().
 
         This method will be called whenever a custom component might need to be updated - e.g.
-        when the list is changed, or ListBox::updateContent() is called.
+        when the list is changed, or ListBox::updateContent() is called. When the list is only
+        scrolled, rows that are still showing the same row number and selection state aren't
+        refreshed again.
 
         If you don't need a custom component for the specified row, then return nullptr.
         (Bear in mind that even if you're not creating a new component, you may still need to
@@ -154,6 +156,19 @@ public:
     */
     virtual void listWasScrolled();
 
+    /** Called when the range of rows that are on screen, or are likely to be scrolled onto
+        the screen soon, changes.
+
+        The range includes the visible rows plus roughly a page of rows either side of them.
+        For lists whose content is expensive to produce (e.g. rows that come from a database
+        or from files on disk), you can use this to start loading the data for these rows on
+        a background thread, so that it's ready by the time refreshComponentForRow() or
+        paintListBoxItem() needs it.
+
+        This is called on the message thread, so it should return quickly.
+    */
+    virtual void prefetchRows (Range<int> rowsToPrefetch);
+
     /** To allow rows from your list to be dragged-and-dropped, implement this method.
 
         If this returns a non-null variant then when the user drags a row, the listbox will
@@ -515,6 +515,12 @@ void TableListBox::listWasScrolled()
         model->listWasScrolled();
 }
 
+void TableListBox::prefetchRows (Range<int> rowsToPrefetch)
+{
+    if (model != nullptr)
+        model->prefetchRows (rowsToPrefetch);
+}
+
 void TableListBox::tableColumnsChanged (TableHeaderComponent*)
 {
     setMinimumContentWidth (header->getTotalWidth());
@@ -675,6 +681,7 @@ void TableListBoxModel::selectedRowsChanged (int)                       {}
 void TableListBoxModel::deleteKeyPressed (int)                          {}
 void TableListBoxModel::returnKeyPressed (int)                          {}
 void TableListBoxModel::listWasScrolled()                               {}
+void TableListBoxModel::prefetchRows (Range<int>)                       {}
 
 String TableListBoxModel::getCellTooltip (int /*rowNumber*/, int /*columnId*/)    { return {}; }
 var TableListBoxModel::getDragSourceDescription (const SparseSet<int>&)           { return {}; }
@@ -185,6 +185,15 @@ public:
     */
     virtual void listWasScrolled();
 
+    /** Called when the range of rows that are on screen, or are likely to be scrolled onto
+        the screen soon, changes.
+
+        You can use this to start loading the data for these rows on a background thread, so
+        that it's ready by the time paintCell() or refreshComponentForCell() needs it.
+        @see ListBoxModel::prefetchRows
+    */
+    virtual void prefetchRows (Range<int> rowsToPrefetch);
+
     /** To allow rows from your table to be dragged-and-dropped, implement this method.
 
         If this returns a non-null variant then when the user drags a row, the table will try to
@@ -331,6 +340,8 @@ public:
     /** @internal */
     void listWasScrolled() override;
     /** @internal */
+    void prefetchRows (Range<int>) override;
+    /** @internal */
     void tableColumnsChanged (TableHeaderComponent*) override;
     /** @internal */
     void tableColumnsResized (TableHeaderComponent*) override;
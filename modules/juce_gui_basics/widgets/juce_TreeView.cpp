@@ -362,12 +362,16 @@ public:
     void updateComponents()
     {
         std::set<ItemComponent*> componentsToKeep;
+        std::map<const TreeViewItem*, ItemComponent*> existingComponents;
+
+        for (auto& comp : itemComponents)
+            existingComponents.emplace (&comp->getRepresentedItem(), comp.get());
 
         for (auto* treeItem : getAllVisibleItems())
         {
-            if (auto* itemComp = getComponentForItem (treeItem))
+            if (const auto existing = existingComponents.find (treeItem); existing != existingComponents.end())
             {
-                componentsToKeep.insert (itemComp);
+                componentsToKeep.insert (existing->second);
             }
             else
             {
@@ -630,38 +634,81 @@ private:
         }
     }
 
+    static int getIndexInParent (const TreeViewItem& item)
+    {
+        auto* parent = item.parentItem;
+
+        if (parent == nullptr)
+            return 0;
+
+        // The sub-items are laid out in order, so their cached positions let us find an item
+        // without a linear search through a potentially huge list of siblings.
+        const auto& siblings = parent->subItems;
+        const auto iter = std::lower_bound (siblings.begin(), siblings.end(), item.y,
+                                            [] (const TreeViewItem* sibling, int y) { return sibling->y < y; });
+
+        for (auto i = iter; i != siblings.end() && (*i)->y == item.y; ++i)
+            if (*i == &item)
+                return (int) std::distance (siblings.begin(), i);
+
+        return siblings.indexOf (&item);
+    }
+
     static TreeViewItem* getNextVisibleItem (TreeViewItem* item, bool forwards)
     {
         if (item == nullptr || item->ownerView == nullptr)
             return nullptr;
 
-        auto* nextItem = item->ownerView->getItemOnRow (item->getRowNumberInTree() + (forwards ? 1 : -1));
+        if (forwards)
+        {
+            if (item->isOpen() && item->getNumSubItems() > 0)
+                return item->getSubItem (0);
+
+            for (auto* current = item; current->parentItem != nullptr; current = current->parentItem)
+                if (auto* sibling = current->parentItem->getSubItem (getIndexInParent (*current) + 1))
+                    return sibling;
+
+            return nullptr;
+        }
+
+        auto* parent = item->parentItem;
+
+        if (parent == nullptr)
+            return nullptr;
+
+        const auto index = getIndexInParent (*item);
+
+        if (index == 0)
+            return parent == item->ownerView->rootItem && ! item->ownerView->rootItemVisible ? nullptr
+                                                                                             : parent;
+
+        auto* previous = parent->getSubItem (index - 1);
 
-        return nextItem == item->ownerView->rootItem && ! item->ownerView->rootItemVisible ? nullptr
-                                                                                           : nextItem;
+        while (previous->isOpen() && previous->getNumSubItems() > 0)
+            previous = previous->getSubItem (previous->getNumSubItems() - 1);
+
+        return previous;
     }
 
+    /*  Visits the items that overlap the given vertical range, using the cached item positions
+        to skip over any branches that lie entirely outside it. This means that the cost only
+        depends on the number of items on screen, and not on the size of the open hierarchy.
+    */
     template <typename Fn>
-    static void forEachDepthFirst (TreeViewItem* item, bool includeItem, Fn&& callback)
+    static void forEachItemInRange (TreeViewItem* item, bool includeItem, int top, int bottom, Fn&& callback)
     {
-        if (includeItem)
+        if (includeItem && item->y <= bottom && item->y + item->itemHeight >= top)
             callback (item);
 
-        if (item->isOpen())
-            for (auto i = 0; i < item->getNumSubItems(); ++i)
-                forEachDepthFirst (item->getSubItem (i), true, callback);
-    }
-
-    std::vector<TreeViewItem*> collectAllItems() const
-    {
-        size_t count{};
-        forEachDepthFirst (owner.rootItem, owner.rootItemVisible, [&] (auto*) { ++count; });
+        if (! item->isOpen())
+            return;
 
-        std::vector<TreeViewItem*> allItems;
-        allItems.reserve (count);
-        forEachDepthFirst (owner.rootItem, owner.rootItemVisible, [&] (auto* item) { allItems.push_back (item); });
+        const auto& subItems = item->subItems;
+        const auto first = std::lower_bound (subItems.begin(), subItems.end(), top,
+                                             [] (const TreeViewItem* subItem, int y) { return subItem->y + subItem->totalHeight < y; });
 
-        return allItems;
+        for (auto i = first; i != subItems.end() && (*i)->y <= bottom; ++i)
+            forEachItemInRange (*i, true, top, bottom, callback);
     }
 
     std::vector<TreeViewItem*> getAllVisibleItems() const
@@ -671,27 +718,42 @@ private:
 
         const auto visibleTop = -getY();
         const auto visibleBottom = visibleTop + getParentHeight();
-        auto allItems = collectAllItems();
 
-        const auto lower = std::lower_bound (allItems.begin(), allItems.end(), visibleTop, [] (TreeViewItem* item, const auto y)
-        {
-            return item->y + item->getItemHeight() < y;
-        });
+        std::vector<TreeViewItem*> items;
+        forEachItemInRange (owner.rootItem, owner.rootItemVisible, visibleTop, visibleBottom,
+                            [&] (auto* item) { items.push_back (item); });
+
+        if (items.empty())
+            return items;
+
+        // Keep a couple of items beyond each edge of the visible area.
+        constexpr auto padding = 2;
+        const auto numInRange = (int) items.size();
+        std::vector<TreeViewItem*> before;
 
-        const auto upper = std::upper_bound (allItems.begin(), allItems.end(), visibleBottom, [] (const auto y, TreeViewItem* item)
+        for (auto* item = items.front(); (int) before.size() < padding;)
         {
-            return y < item->y;
-        });
+            item = getNextVisibleItem (item, false);
 
-        const std::ptrdiff_t padding = 2;
+            if (item == nullptr)
+                break;
 
-        const auto frontToErase = std::max (padding, std::distance (allItems.begin(), lower)) - padding;
-        const auto backToErase  = std::max (padding, std::distance (upper, allItems.end()))   - padding;
+            before.push_back (item);
+        }
+
+        items.insert (items.begin(), before.rbegin(), before.rend());
+
+        for (auto* item = items.back(); (int) items.size() < (int) before.size() + numInRange + padding;)
+        {
+            item = getNextVisibleItem (item, true);
+
+            if (item == nullptr)
+                break;
 
-        allItems.erase (allItems.begin(), std::next (allItems.begin(), frontToErase));
-        allItems.erase (std::prev (allItems.end(), backToErase), allItems.end());
+            items.push_back (item);
+        }
 
-        return allItems;
+        return items;
     }
 
     //==============================================================================
@@ -2283,4 +2345,94 @@ void TreeViewItem::draw (Graphics& g, int width, bool isMouseOverButton)
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TreeViewTests final : public UnitTest
+{
+public:
+    TreeViewTests() : UnitTest ("TreeView", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        ScopedJuceInitialiser_GUI libraryInitialiser;
+        const MessageManagerLock mml;
+
+        beginTest ("Components are created for the items on screen, plus two either side");
+        {
+            // Every third branch is closed, so some of the items in range have hidden children
+            TestItem root;
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto* branch = new TestItem();
+                root.addSubItem (branch);
+
+                for (int j = 0; j < 20; ++j)
+                    branch->addSubItem (new TestItem());
+
+                branch->setOpen (i % 3 != 0);
+            }
+
+            TreeView tree;
+            tree.setBounds (0, 0, 200, 200);
+            tree.setRootItemVisible (false);
+            tree.setRootItem (&root);
+
+            const auto numRows = tree.getNumRowsInTree();
+            expectEquals (numRows, 50 + 20 * 33);
+
+            auto& viewport = *tree.getViewport();
+
+            for (const auto position : { 0, 10, 3000, 5555, 100000 })
+            {
+                viewport.setViewPosition (0, position);
+
+                const auto top = viewport.getViewPositionY();
+                const auto bottom = top + viewport.getViewHeight();
+
+                // Find the items that overlap the visible area by checking every row
+                int firstRow = -1, lastRow = -1;
+
+                for (int row = 0; row < numRows; ++row)
+                {
+                    const auto* item = tree.getItemOnRow (row);
+                    const auto y = item->getItemPosition (false).getY();
+
+                    if (y <= bottom && y + item->getItemHeight() >= top)
+                    {
+                        if (firstRow < 0)
+                            firstRow = row;
+
+                        lastRow = row;
+                    }
+                }
+
+                const Range<int> expectedRows (jmax (0, firstRow - 2), jmin (numRows, lastRow + 3));
+
+                StringArray wrongRows;
+
+                for (int row = 0; row < numRows; ++row)
+                    if ((tree.getItemComponent (tree.getItemOnRow (row)) != nullptr) != expectedRows.contains (row))
+                        wrongRows.add (String (row));
+
+                expect (wrongRows.isEmpty(), "Wrong components at position " + String (top) + ": " + wrongRows.joinIntoString (", "));
+            }
+
+            tree.setRootItem (nullptr);
+        }
+    }
+
+private:
+    struct TestItem final : public TreeViewItem
+    {
+        bool mightContainSubItems() override    { return getNumSubItems() > 0; }
+    };
+};
+
+static TreeViewTests treeViewTests;
+
+#endif
+
 } // namespace juce
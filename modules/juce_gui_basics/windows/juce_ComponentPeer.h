@@ -578,6 +578,38 @@ public:
     */
     uint64_t getNumFramesPainted() const { return peerFrameNumber; }
 
+    /** Timing information about the frames that a peer has presented to the screen.
+
+        @see getFrameStatistics
+    */
+    struct FrameStatistics
+    {
+        /** The number of frames that were painted and handed to the windowing system. */
+        uint64_t numFramesPresented = 0;
+
+        /** The number of vblank intervals in which pending repaints had to be postponed
+            because the windowing system was still busy with earlier frames.
+        */
+        uint64_t numFramesDropped = 0;
+
+        /** The time taken to paint and present the most recent frame, in milliseconds. */
+        double lastFrameTimeMs = 0.0;
+
+        /** A smoothed average of the time taken to paint and present a frame, in milliseconds. */
+        double averageFrameTimeMs = 0.0;
+
+        /** The longest time taken to paint and present a single frame, in milliseconds. */
+        double maxFrameTimeMs = 0.0;
+    };
+
+    /** Returns timing information about the frames painted by this peer.
+
+        This is mainly useful for diagnosing rendering performance problems. Peers that don't
+        collect this information will return a default-constructed object; currently only the
+        Linux peer does so.
+    */
+    virtual FrameStatistics getFrameStatistics() const { return {}; }
+
 protected:
     //==============================================================================
     static void forceDisplayUpdate();